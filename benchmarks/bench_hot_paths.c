@@ -0,0 +1,148 @@
+/**
+ * Microbenchmarks for the C hot paths of the distributed example
+ *
+ * memory_alloc(), network_send() and log_message() are timed in batches of
+ * BENCH_BATCH calls with CLOCK_MONOTONIC; each batch gives one per-call
+ * sample, so the clock's own cost is spread over the batch. Setup and
+ * teardown (frees, socket draining, ring flushes) happen outside the timed
+ * region. One JSON object per benchmark is printed on stdout for
+ * run_benchmarks.py.
+ *
+ * Build: gcc -O2 -I../examples bench_hot_paths.c -o bench_hot_paths -pthread
+ * Usage: bench_hot_paths [calls per benchmark]
+ */
+
+#define DISTRIBUTED_AI_NO_MAIN
+#include "../examples/distributed_ai_example.c"
+
+#define BENCH_BATCH         64
+
+struct bench_samples {
+    double* per_call_ns;
+    size_t count;
+    double total_ns;
+    uint64_t calls;
+};
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_record(struct bench_samples* s, uint64_t elapsed_ns)
+{
+    s->per_call_ns[s->count++] = (double)elapsed_ns / BENCH_BATCH;
+    s->total_ns += (double)elapsed_ns;
+    s->calls += BENCH_BATCH;
+}
+
+static int bench_compare(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_report(const char* name, struct bench_samples* s)
+{
+    qsort(s->per_call_ns, s->count, sizeof(double), bench_compare);
+    double p50 = s->per_call_ns[s->count / 2];
+    double p99 = s->per_call_ns[(size_t)((double)(s->count - 1) * 0.99)];
+    printf("{\"name\": \"%s\", \"calls\": %llu, \"throughput\": %.1f, \"unit\": \"calls/s\", "
+           "\"p50_us\": %.4f, \"p99_us\": %.4f}\n",
+           name, (unsigned long long)s->calls, s->calls / (s->total_ns / 1e9), p50 / 1000, p99 / 1000);
+    fflush(stdout);
+}
+
+static void bench_memory_alloc(struct bench_samples* s, size_t batches)
+{
+    void* blocks[BENCH_BATCH];
+    for (size_t b = 0; b < batches; b++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < BENCH_BATCH; i++)
+            blocks[i] = memory_alloc((size_t)(i % 32 + 1) * 24);
+        bench_record(s, bench_now_ns() - start);
+        for (int i = 0; i < BENCH_BATCH; i++)
+            memory_free(blocks[i]);
+    }
+}
+
+// Reader end of the socket pair, so sends never stall on a full buffer
+static void* bench_drain_main(void* arg)
+{
+    int fd = *(int*)arg;
+    char buf[64 * 1024];
+    while (read(fd, buf, sizeof(buf)) > 0)
+        ;
+    return NULL;
+}
+
+static void bench_network_send(struct bench_samples* s, size_t batches)
+{
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+        perror("socketpair");
+        return;
+    }
+    pthread_t reader;
+    pthread_create(&reader, NULL, bench_drain_main, &sv[1]);
+    network_attach(sv[0]);
+
+    char record[64];
+    memset(record, 'r', sizeof(record));
+    for (size_t b = 0; b < batches; b++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < BENCH_BATCH; i++)
+            network_send(record, sizeof(record));
+        bench_record(s, bench_now_ns() - start);
+    }
+    network_close();
+    pthread_join(reader, NULL);
+    close(sv[1]);
+}
+
+static void bench_log_message(struct bench_samples* s, size_t batches)
+{
+    ring_log_init("/dev/null", LOG_INFO);
+    for (size_t b = 0; b < batches; b++) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < BENCH_BATCH; i++)
+            log_message("benchmark: compile result ready");
+        bench_record(s, bench_now_ns() - start);
+        // A full ring drops records, which would time the drop path instead
+        if ((b + 1) * BENCH_BATCH % (RING_LOG_CAPACITY / 2) == 0)
+            ring_log_flush();
+    }
+    ring_log_flush();
+}
+
+int main(int argc, char** argv)
+{
+    size_t calls = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    size_t batches = calls / BENCH_BATCH ? calls / BENCH_BATCH : 1;
+
+    static const struct {
+        const char* name;
+        void (*run)(struct bench_samples*, size_t);
+    } benches[] = {
+        { "memory_alloc", bench_memory_alloc },
+        { "network_send", bench_network_send },
+        { "log_message", bench_log_message },
+    };
+
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        struct bench_samples s = { .per_call_ns = calloc(batches, sizeof(double)) };
+        if (s.per_call_ns == NULL)
+            return 1;
+        benches[i].run(&s, batches / 10 ? batches / 10 : 1);       // Warm-up
+        s.count = 0;
+        s.total_ns = 0;
+        s.calls = 0;
+        benches[i].run(&s, batches);
+        if (s.count > 0)
+            bench_report(benches[i].name, &s);
+        free(s.per_call_ns);
+    }
+    return 0;
+}
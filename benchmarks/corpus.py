@@ -0,0 +1,191 @@
+"""
+Synthetic Benchmark Corpora
+AROS-scale source trees full of breadcrumbs and large GCC build logs
+
+Everything is generated from a seed, so a corpus of given parameters is the
+same on every machine. Generated corpora are cached on disk and reused while
+their parameters match.
+"""
+
+import json
+import random
+from pathlib import Path
+from typing import Dict, Any, List, Iterator
+
+# Bump when the generators change so stale caches are rebuilt
+CORPUS_VERSION = 1
+
+SUBSYSTEMS = [
+    'rom/exec', 'rom/dos', 'rom/graphics', 'rom/intuition', 'rom/kernel', 'rom/timer',
+    'workbench/libs/mesa', 'workbench/devs/ahi', 'workbench/hidds/radeonsi',
+    'workbench/network/stacks', 'arch/x86_64-pc', 'compiler/clib'
+]
+PHASES = [
+    'MEMORY_MANAGER', 'SHADER_COMPILER', 'GPU_INIT', 'NETWORK_STACK', 'FILESYSTEM',
+    'SCHEDULER', 'INTERRUPTS', 'USB_STACK', 'AUDIO_MIXER', 'CONFIG_PARSER'
+]
+STATUSES = ['NOT_STARTED', 'PARTIAL', 'IMPLEMENTED', 'FIXED', 'NEEDS_REVIEW']
+COMPLEXITIES = ['LOW', 'MEDIUM', 'HIGH', 'CRITICAL']
+LINUX_REFS = ['mm/slab.c', 'kernel/sched/core.c', 'drivers/gpu/drm/radeon/radeon_cs.c',
+              'net/ipv4/tcp.c', 'fs/ext4/inode.c', 'sound/core/pcm.c']
+
+ERROR_TEMPLATES = [
+    "error: '{ident}' undeclared (first use in this function)",
+    "error: implicit declaration of function '{ident}' [-Werror=implicit-function-declaration]",
+    "error: expected ';' before '{ident}'",
+    "error: incompatible types when assigning to type '{type}' from type 'struct {ident}'",
+    "error: too few arguments to function '{ident}'",
+    "error: unknown type name '{type}'",
+    "warning: unused variable '{ident}' [-Wunused-variable]",
+    "warning: passing argument {n} of '{ident}' makes pointer from integer without a cast [-Wint-conversion]",
+    "warning: comparison of integer expressions of different signedness [-Wsign-compare]",
+    "warning: '{ident}' may be used uninitialized [-Wmaybe-uninitialized]",
+]
+TYPES = ['ULONG', 'APTR', 'struct Library *', 'BPTR', 'UWORD', 'struct Task *', 'size_t']
+
+
+def _ident(rng: random.Random) -> str:
+    return rng.choice(['gpu', 'mem', 'net', 'dos', 'exec', 'gfx', 'usb']) + '_' + \
+        rng.choice(['alloc', 'init', 'flush', 'open', 'close', 'map', 'submit', 'wait']) + \
+        str(rng.randint(0, 400))
+
+
+def error_message(rng: random.Random) -> str:
+    """One GCC diagnostic text (severity included)"""
+    return rng.choice(ERROR_TEMPLATES).format(ident=_ident(rng), type=rng.choice(TYPES), n=rng.randint(1, 6))
+
+
+def _context_block(rng: random.Random, prefix: str, keys: int) -> List[str]:
+    context = {
+        'gpu_family': rng.choice(['GCN', 'RDNA', 'RDNA2']),
+        'registers': {f'reg_{i}': hex(rng.getrandbits(32)) for i in range(keys)},
+        'features': rng.sample(['vulkan', 'opengl', 'compute', 'dma', 'irq', 'smp', 'hotplug'], 3),
+        'limits': [rng.randint(1, 1 << 16) for _ in range(keys // 2 + 1)],
+        'notes': ' '.join(rng.choice(['bring', 'up', 'the', 'ring', 'before', 'fences']) for _ in range(12))
+    }
+    text = json.dumps(context, indent=2).splitlines()
+    return [f'{prefix}AI_CONTEXT: {text[0]}'] + [prefix + line for line in text[1:]]
+
+
+def _breadcrumb(rng: random.Random, index: int, block: bool, context_keys: int) -> List[str]:
+    prefix = ' * ' if block else '// '
+    lines = [
+        f'{prefix}AI_PHASE: {rng.choice(PHASES)}_{index % 50}',
+        f'{prefix}AI_STATUS: {rng.choice(STATUSES)}',
+        f'{prefix}AI_PATTERN: {rng.choice(PHASES)}_V{rng.randint(1, 3)}',
+        f'{prefix}AI_STRATEGY: Implement {_ident(rng)} following the Linux driver model',
+        f'{prefix}AI_COMPLEXITY: {rng.choice(COMPLEXITIES)}',
+        f'{prefix}AI_PRIORITY: {rng.randint(1, 10)}',
+    ]
+    if rng.random() < 0.5:
+        lines.append(f'{prefix}AI_DEPENDENCIES: {rng.choice(PHASES)}, {rng.choice(PHASES)}')
+    if rng.random() < 0.5:
+        lines.append(f'{prefix}LINUX_REF: {rng.choice(LINUX_REFS)}')
+    if rng.random() < 0.3:
+        lines.append(f'{prefix}COMPILER_ERR: {error_message(rng)}')
+    if context_keys and rng.random() < 0.6:
+        lines.extend(_context_block(rng, prefix, context_keys))
+    if block:
+        return ['/*'] + lines + [' */']
+    return lines
+
+
+def source_file(rng: random.Random, breadcrumbs: int, context_keys: int) -> str:
+    """One C file: breadcrumbs of both comment styles between functions"""
+    out = ['#include <exec/types.h>', '#include <proto/exec.h>', '']
+    for i in range(breadcrumbs):
+        out.extend(_breadcrumb(rng, i, rng.random() < 0.4, context_keys))
+        name = _ident(rng)
+        out.append(f'ULONG {name}(APTR base, ULONG flags)')
+        out.append('{')
+        for _ in range(rng.randint(4, 16)):
+            out.append(f'    flags |= {_ident(rng)}(base, {rng.randint(0, 255)});')
+        out.append('    return flags;')
+        out.append('}')
+        out.append('')
+    return '\n'.join(out) + '\n'
+
+
+def _cached(root: Path, params: Dict[str, Any]) -> bool:
+    marker = root / '.corpus.json'
+    try:
+        return json.loads(marker.read_text()) == params
+    except (OSError, ValueError):
+        return False
+
+
+def _mark(root: Path, params: Dict[str, Any]) -> None:
+    (root / '.corpus.json').write_text(json.dumps(params))
+
+
+def generate_tree(
+    root: str,
+    files: int,
+    breadcrumbs_per_file: int = 6,
+    context_keys: int = 24,
+    seed: int = 1
+) -> List[str]:
+    """
+    Source tree of `files` C files spread over AROS-like subsystem directories
+    
+    Returns:
+        Paths of the generated files, in a fixed order
+    """
+    root = Path(root)
+    params = {'kind': 'tree', 'version': CORPUS_VERSION, 'files': files,
+              'breadcrumbs': breadcrumbs_per_file, 'context_keys': context_keys, 'seed': seed}
+    paths = [root / SUBSYSTEMS[i % len(SUBSYSTEMS)] / f'd{i // 500:03d}' / f'file_{i:06d}.c'
+             for i in range(files)]
+    if _cached(root, params):
+        return [str(p) for p in paths]
+    
+    root.mkdir(parents=True, exist_ok=True)
+    for i, path in enumerate(paths):
+        rng = random.Random(seed * 1000003 + i)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(source_file(rng, breadcrumbs_per_file, context_keys))
+    _mark(root, params)
+    return [str(p) for p in paths]
+
+
+def gcc_log_lines(rng: random.Random) -> Iterator[str]:
+    """Endless make/GCC output: recipes, context lines, diagnostics, notes"""
+    while True:
+        subsystem = rng.choice(SUBSYSTEMS)
+        source = f'{subsystem}/file_{rng.randint(0, 99999):06d}.c'
+        yield f'make[{rng.randint(1, 4)}]: Entering directory \'/build/aros/{subsystem}\''
+        yield f'gcc -O2 -Wall -I/build/aros/include -c {source} -o {source[:-2]}.o'
+        for _ in range(rng.randint(0, 6)):
+            if rng.random() < 0.3:
+                yield f'In file included from {subsystem}/include/{_ident(rng)}.h:{rng.randint(1, 400)},'
+                yield f'                 from {source}:{rng.randint(1, 40)}:'
+            if rng.random() < 0.4:
+                yield f"{source}: In function '{_ident(rng)}':"
+            line, column = rng.randint(1, 3000), rng.randint(1, 80)
+            yield f'{source}:{line}:{column}: {error_message(rng)}'
+            yield f'  {line} |     flags |= {_ident(rng)}(base, 0);'
+            yield '      |              ^~~~~~~~'
+            if rng.random() < 0.2:
+                yield f"{source}:{line - 1}:{column}: note: declared here"
+        if rng.random() < 0.05:
+            yield f'make[2]: *** [Makefile:{rng.randint(10, 900)}: {source[:-2]}.o] Error 1'
+
+
+def generate_gcc_log(path: str, size_mb: int, seed: int = 1) -> str:
+    """Write a GCC stderr log of about size_mb megabytes"""
+    path = Path(path)
+    params = {'kind': 'gcc_log', 'version': CORPUS_VERSION, 'size_mb': size_mb, 'seed': seed}
+    if path.exists() and _cached(path.parent, params):
+        return str(path)
+    
+    path.parent.mkdir(parents=True, exist_ok=True)
+    target = size_mb * 1024 * 1024
+    written = 0
+    lines = gcc_log_lines(random.Random(seed))
+    with open(path, 'w') as f:
+        while written < target:
+            chunk = '\n'.join(next(lines) for _ in range(4096)) + '\n'
+            f.write(chunk)
+            written += len(chunk)
+    _mark(path.parent, params)
+    return str(path)
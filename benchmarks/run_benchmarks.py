@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""
+Benchmark Suite
+Throughput and p50/p99 latency of the parser, compiler-log parsing, the
+error tracker and the C hot paths, checked against stored baselines
+
+Corpora are generated from fixed seeds (benchmarks/corpus.py) and cached
+under --corpus-dir, so reruns measure the same inputs. Baselines are kept
+per scale in benchmarks/baselines/<scale>.json; a run compares against the
+stored one and exits with status 1 when a benchmark's throughput drops or
+its p50 latency grows by more than --tolerance.
+
+Usage:
+    python3 benchmarks/run_benchmarks.py                    # quick scale
+    python3 benchmarks/run_benchmarks.py --scale full       # 100k files, 512 MB log
+    python3 benchmarks/run_benchmarks.py --only parse_file,log_message
+    python3 benchmarks/run_benchmarks.py --save-baseline    # record this machine's numbers
+"""
+
+import os
+import sys
+import json
+import time
+import random
+import shutil
+import argparse
+import platform
+import tempfile
+import subprocess
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, Any, List, Optional, Callable
+
+benchmarks_dir = Path(__file__).parent
+project_root = benchmarks_dir.parent
+sys.path.insert(0, str(project_root))
+sys.path.insert(0, str(benchmarks_dir))
+
+import corpus
+from src.breadcrumb_parser import BreadcrumbParser
+from src.breadcrumb_parser import parser as parser_module
+from src.compiler_loop import CompilerLoop, ErrorTracker
+
+
+SCALES = {
+    # Seconds; for checking the harness itself
+    'smoke': {'files': 200, 'log_mb': 2, 'errors': 2000, 'queries': 50, 'c_calls': 100000},
+    # A minute or two; the default
+    'quick': {'files': 10000, 'log_mb': 64, 'errors': 100000, 'queries': 500, 'c_calls': 1000000},
+    # AROS scale, before a release
+    'full': {'files': 100000, 'log_mb': 512, 'errors': 100000, 'queries': 2000, 'c_calls': 10000000},
+}
+
+# Compiler stderr handed to _parse_errors per call
+LOG_CHUNK_BYTES = 1024 * 1024
+
+DEFAULT_TOLERANCE = 0.25
+BASELINE_DIR = benchmarks_dir / 'baselines'
+
+
+def summarize(name: str, latencies: List[float], unit: str, work: Optional[float] = None,
+              **extra: Any) -> Dict[str, Any]:
+    """
+    Result record from per-call latencies in seconds
+    
+    Args:
+        name: Benchmark name
+        latencies: One entry per call
+        unit: What throughput counts ('files/s', 'MB/s', ...)
+        work: Total work done in unit's numerator (default: the call count)
+    """
+    ordered = sorted(latencies)
+    total = sum(ordered)
+    work = len(ordered) if work is None else work
+    return {
+        'name': name,
+        'calls': len(ordered),
+        'throughput': work / total if total else 0.0,
+        'unit': unit,
+        'p50_us': ordered[len(ordered) // 2] * 1e6,
+        'p99_us': ordered[int((len(ordered) - 1) * 0.99)] * 1e6,
+        **extra
+    }
+
+
+def bench_parse_file(params: Dict[str, Any], corpus_dir: Path) -> List[Dict[str, Any]]:
+    """BreadcrumbParser.parse_file over a generated source tree"""
+    files = corpus.generate_tree(str(corpus_dir / f"tree_{params['files']}"), params['files'])
+    backends = [('parse_file', True)] if parser_module._scanner is not None else []
+    backends.append(('parse_file_python', False))
+    
+    results = []
+    for name, native in backends:
+        parser = BreadcrumbParser(use_native=native)
+        latencies = []
+        found = 0
+        size = 0
+        for path in files:
+            start = time.perf_counter()
+            crumbs = parser.parse_file(path)
+            latencies.append(time.perf_counter() - start)
+            found += len(crumbs)
+            size += os.path.getsize(path)
+            # Keep memory flat over 100k files
+            parser.breadcrumbs.clear()
+        results.append(summarize(name, latencies, 'files/s', breadcrumbs=found,
+                                 mb_per_s=size / 1e6 / sum(latencies)))
+    return results
+
+
+def bench_parse_errors(params: Dict[str, Any], corpus_dir: Path) -> List[Dict[str, Any]]:
+    """CompilerLoop._parse_errors on 1 MB slices of a large GCC stderr log"""
+    log = corpus.generate_gcc_log(str(corpus_dir / f"gcc_log_{params['log_mb']}" / 'build.log'), params['log_mb'])
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        loop = CompilerLoop(aros_path=tmp, log_path=str(Path(tmp) / 'logs'))
+        latencies = []
+        errors = 0
+        size = 0
+        with open(log) as f:
+            rest = ''
+            while True:
+                data = f.read(LOG_CHUNK_BYTES)
+                if not data:
+                    break
+                # Slices end on a line boundary, like one build's stderr
+                data, _, tail = (rest + data).rpartition('\n')
+                rest = tail
+                start = time.perf_counter()
+                errors += len(loop._parse_errors(data))
+                latencies.append(time.perf_counter() - start)
+                size += len(data)
+    return [summarize('parse_errors', latencies, 'MB/s', work=size / 1e6, errors=errors)]
+
+
+def _tracked_error(rng: random.Random) -> str:
+    source = f'{rng.choice(corpus.SUBSYSTEMS)}/file_{rng.randint(0, 99999):06d}.c'
+    return f'{source}:{rng.randint(1, 3000)}:{rng.randint(1, 80)}: {corpus.error_message(rng)}'
+
+
+def bench_error_tracker(params: Dict[str, Any], corpus_dir: Path) -> List[Dict[str, Any]]:
+    """ErrorTracker.track_error up to N entries, then find_similar_errors"""
+    rng = random.Random(7)
+    with tempfile.TemporaryDirectory() as tmp:
+        tracker = ErrorTracker(tmp)
+        latencies = []
+        for i in range(params['errors']):
+            message = _tracked_error(rng)
+            start = time.perf_counter()
+            tracker.track_error(message, {'iteration': i})
+            latencies.append(time.perf_counter() - start)
+        results = [summarize('track_error', latencies, 'calls/s', entries=len(tracker.error_database))]
+        
+        # The similarity index is built on the first query
+        start = time.perf_counter()
+        tracker.find_similar_errors(_tracked_error(rng))
+        index_build = time.perf_counter() - start
+        latencies = []
+        for _ in range(params['queries']):
+            message = _tracked_error(rng)
+            start = time.perf_counter()
+            tracker.find_similar_errors(message)
+            latencies.append(time.perf_counter() - start)
+        results.append(summarize('find_similar_errors', latencies, 'calls/s',
+                                 entries=len(tracker.error_database), index_build_s=index_build))
+        tracker.close()
+    return results
+
+
+def build_c_bench(build_dir: Path) -> Optional[Path]:
+    """Compile bench_hot_paths.c; None when no C compiler is available"""
+    compiler = os.environ.get('CC') or shutil.which('gcc') or shutil.which('cc')
+    if compiler is None:
+        return None
+    build_dir.mkdir(parents=True, exist_ok=True)
+    binary = build_dir / 'bench_hot_paths'
+    subprocess.run(
+        [compiler, '-O2', '-I', str(project_root / 'examples'), str(benchmarks_dir / 'bench_hot_paths.c'),
+         '-o', str(binary), '-pthread'],
+        check=True
+    )
+    return binary
+
+
+def bench_c_hot_paths(params: Dict[str, Any], corpus_dir: Path) -> List[Dict[str, Any]]:
+    """memory_alloc, network_send and log_message microbenchmarks"""
+    binary = build_c_bench(corpus_dir / 'build')
+    if binary is None:
+        print("⚠ No C compiler found, skipping C hot paths")
+        return []
+    output = subprocess.run([str(binary), str(params['c_calls'])], check=True,
+                            capture_output=True, text=True).stdout
+    return [json.loads(line) for line in output.splitlines() if line.startswith('{')]
+
+
+# Benchmark groups; --only picks by group or benchmark name
+BENCHMARKS: Dict[str, Callable[[Dict[str, Any], Path], List[Dict[str, Any]]]] = {
+    'parse_file': bench_parse_file,
+    'parse_errors': bench_parse_errors,
+    'error_tracker': bench_error_tracker,
+    'c_hot_paths': bench_c_hot_paths,
+}
+GROUP_MEMBERS = {
+    'error_tracker': ('track_error', 'find_similar_errors'),
+    'c_hot_paths': ('memory_alloc', 'network_send', 'log_message'),
+    'parse_file': ('parse_file_python',),
+}
+
+
+def compare(results: List[Dict[str, Any]], baseline: Dict[str, Any], tolerance: float) -> List[str]:
+    """Regressions of results against a baseline, as printable lines"""
+    regressions = []
+    previous = baseline.get('results', {})
+    for result in results:
+        base = previous.get(result['name'])
+        if base is None:
+            continue
+        if result['throughput'] < base['throughput'] * (1 - tolerance):
+            regressions.append(f"{result['name']}: throughput {result['throughput']:.1f} {result['unit']} "
+                               f"vs baseline {base['throughput']:.1f}")
+        if result['p50_us'] > base['p50_us'] * (1 + tolerance):
+            regressions.append(f"{result['name']}: p50 {result['p50_us']:.3f} us "
+                               f"vs baseline {base['p50_us']:.3f} us")
+    return regressions
+
+
+def print_results(results: List[Dict[str, Any]], baseline: Optional[Dict[str, Any]]) -> None:
+    previous = (baseline or {}).get('results', {})
+    print(f"\n{'benchmark':<22} {'throughput':>20} {'p50 (us)':>12} {'p99 (us)':>12} {'vs baseline':>12}")
+    print('-' * 82)
+    for result in results:
+        base = previous.get(result['name'])
+        change = f"{(result['throughput'] / base['throughput'] - 1) * 100:+.1f}%" if base else '-'
+        throughput = f"{result['throughput']:,.1f} {result['unit']}"
+        print(f"{result['name']:<22} {throughput:>20} {result['p50_us']:>12.3f} {result['p99_us']:>12.3f} {change:>12}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the benchmark suite')
+    parser.add_argument('--scale', choices=sorted(SCALES), default='quick', help='Corpus sizes')
+    parser.add_argument('--only', default=None,
+                        help='Comma-separated benchmarks or groups (' + ', '.join(BENCHMARKS) + ')')
+    parser.add_argument('--corpus-dir', default=str(Path(tempfile.gettempdir()) / 'aros_benchmark_corpus'),
+                        help='Where generated corpora are cached')
+    parser.add_argument('--baseline', default=None,
+                        help='Baseline file (default: benchmarks/baselines/<scale>.json)')
+    parser.add_argument('--save-baseline', action='store_true', help='Store these results as the baseline')
+    parser.add_argument('--tolerance', type=float, default=DEFAULT_TOLERANCE,
+                        help='Allowed relative slowdown before a benchmark counts as regressed')
+    parser.add_argument('--json', default=None, help='Also write the results here')
+    args = parser.parse_args()
+    
+    params = SCALES[args.scale]
+    corpus_dir = Path(args.corpus_dir)
+    baseline_path = Path(args.baseline) if args.baseline else BASELINE_DIR / f'{args.scale}.json'
+    wanted = set(args.only.split(',')) if args.only else None
+    
+    print(f"Benchmarks at '{args.scale}' scale: {params}")
+    results = []
+    for group, bench in BENCHMARKS.items():
+        names = {group, *GROUP_MEMBERS.get(group, ())}
+        if wanted is not None and not names & wanted:
+            continue
+        print(f"  running {group}...", flush=True)
+        results.extend(r for r in bench(params, corpus_dir)
+                       if wanted is None or r['name'] in wanted or group in wanted)
+    
+    baseline = None
+    if baseline_path.exists():
+        with open(baseline_path) as f:
+            baseline = json.load(f)
+    print_results(results, baseline)
+    
+    report = {
+        'scale': args.scale,
+        'params': params,
+        'timestamp': datetime.now().isoformat(),
+        'machine': {'node': platform.node(), 'processor': platform.processor() or platform.machine(),
+                    'cpus': os.cpu_count(), 'python': platform.python_version()},
+        'native_scanner': parser_module._scanner is not None,
+        'results': {r['name']: r for r in results}
+    }
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+    
+    if args.save_baseline:
+        if baseline:
+            # Benchmarks not run this time keep their old numbers
+            report['results'] = {**baseline.get('results', {}), **report['results']}
+        baseline_path.parent.mkdir(parents=True, exist_ok=True)
+        with open(baseline_path, 'w') as f:
+            json.dump(report, f, indent=2)
+        print(f"\n✓ Baseline saved to {baseline_path}")
+        return 0
+    
+    if baseline is None:
+        print(f"\nNo baseline at {baseline_path}; run with --save-baseline to record one")
+        return 0
+    
+    regressions = compare(results, baseline, args.tolerance)
+    if regressions:
+        print(f"\n✗ {len(regressions)} regression(s) beyond {args.tolerance:.0%}:")
+        for line in regressions:
+            print(f"  {line}")
+        return 1
+    print(f"\n✓ No regressions beyond {args.tolerance:.0%} (baseline from {baseline.get('timestamp', '?')})")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
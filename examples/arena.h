@@ -0,0 +1,224 @@
+/**
+ * Hugepage-backed arena with per-phase bump regions
+ *
+ * arena_init() reserves one large mapping up front, backed by 2 MB pages:
+ * hugetlbfs pages when the system has them reserved, otherwise a 2 MB
+ * aligned mapping with transparent hugepages requested. Subsystems carve
+ * fixed-size regions out of it; a region hands out memory by bumping an
+ * offset, checks every request against its bounds, and is emptied in O(1)
+ * by arena_reset() when its phase ends. Nothing is ever returned to the
+ * general heap because nothing is taken from it.
+ *
+ * Build with -DARENA_DEBUG to put a PROT_NONE guard page after every
+ * region (an overrun faults at the offending store) and to poison memory
+ * on reset. Guard pages need 4 KB granularity, so debug arenas use small
+ * pages.
+ *
+ * Header-only so the standalone examples keep building with a plain
+ * `gcc file.c -pthread`.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <stdatomic.h>
+
+#include "ring_log.h"
+
+#define ARENA_HUGE_PAGE     ((size_t)2 << 20)
+#define ARENA_MIN_ALIGN     16
+#define ARENA_POISON        0xA5
+
+#ifdef ARENA_DEBUG
+#define ARENA_GUARD_PAGES   1
+#else
+#define ARENA_GUARD_PAGES   0
+#endif
+
+enum arena_backing {
+    ARENA_HUGETLB,                              // Reserved hugetlbfs pages
+    ARENA_THP,                                  // Transparent hugepages requested
+    ARENA_SMALL_PAGES                           // Debug build: guard pages need 4 KB pages
+};
+
+struct arena {
+    char* base;
+    size_t size;
+    _Atomic size_t top;                         // Bytes carved into regions
+    size_t page_size;
+    enum arena_backing backing;
+};
+
+struct arena_region {
+    const char* name;
+    char* base;
+    size_t size;
+    _Atomic size_t top;
+    size_t high_water;                          // Largest top seen at a reset
+    _Atomic size_t failed;                      // Requests refused for lack of space
+};
+
+static inline size_t arena_align_up(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+static inline const char* arena_backing_name(enum arena_backing backing)
+{
+    static const char* const names[] = { "hugetlb", "transparent hugepages", "4 KB pages + guards" };
+    return names[backing];
+}
+
+/**
+ * Reserve size bytes (rounded up to 2 MB)
+ *
+ * Hugetlb pages are reserved at once; otherwise this is address space only
+ * and pages fault in on first touch. Returns 0, or -1 if no mapping could
+ * be made.
+ */
+static inline int arena_init(struct arena* arena, size_t size)
+{
+    memset(arena, 0, sizeof(*arena));
+    arena->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size = arena_align_up(size, ARENA_HUGE_PAGE);
+
+    void* base = MAP_FAILED;
+    if (!ARENA_GUARD_PAGES) {
+#ifdef MAP_HUGETLB
+        // No MAP_NORESERVE: the pages must be reserved now, not SIGBUS later
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        arena->backing = ARENA_HUGETLB;
+    }
+
+    if (base == MAP_FAILED) {
+        // Over-reserve by one hugepage and trim to a 2 MB aligned window
+        size_t span = size + ARENA_HUGE_PAGE;
+        char* raw = mmap(NULL, span, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == MAP_FAILED)
+            return -1;
+        char* aligned = (char*)arena_align_up((uintptr_t)raw, ARENA_HUGE_PAGE);
+        if (aligned > raw)
+            munmap(raw, (size_t)(aligned - raw));
+        if (aligned + size < raw + span)
+            munmap(aligned + size, (size_t)(raw + span - (aligned + size)));
+        base = aligned;
+        arena->backing = ARENA_GUARD_PAGES ? ARENA_SMALL_PAGES : ARENA_THP;
+#ifdef MADV_HUGEPAGE
+        if (!ARENA_GUARD_PAGES)
+            madvise(base, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    arena->base = base;
+    arena->size = size;
+    atomic_init(&arena->top, 0);
+    return 0;
+}
+
+static inline void arena_destroy(struct arena* arena)
+{
+    if (arena->base != NULL)
+        munmap(arena->base, arena->size);
+    arena->base = NULL;
+    arena->size = 0;
+}
+
+// Largest region that can still be carved
+static inline size_t arena_available(struct arena* arena)
+{
+    size_t used = atomic_load_explicit(&arena->top, memory_order_relaxed);
+    size_t guard = ARENA_GUARD_PAGES ? arena->page_size : 0;
+    return arena->size - used > guard ? (arena->size - used - guard) & ~(arena->page_size - 1) : 0;
+}
+
+/**
+ * Carve a region of size bytes for one subsystem phase
+ *
+ * Regions start page-aligned. Returns -1 if the arena is exhausted.
+ */
+static inline int arena_region_init(struct arena* arena, struct arena_region* region,
+                                    const char* name, size_t size)
+{
+    size = arena_align_up(size, arena->page_size);
+    size_t guard = ARENA_GUARD_PAGES ? arena->page_size : 0;
+    size_t start = atomic_load_explicit(&arena->top, memory_order_relaxed);
+    do {
+        if (start + size + guard > arena->size || start + size + guard < start) {
+            ring_log(LOG_ERROR, "arena: no room for %zu-byte region %s", size, name);
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&arena->top, &start, start + size + guard,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    region->name = name;
+    region->base = arena->base + start;
+    region->size = size;
+    region->high_water = 0;
+    atomic_init(&region->failed, 0);
+    atomic_init(&region->top, 0);
+    if (guard && mprotect(region->base + size, guard, PROT_NONE) != 0)
+        ring_log(LOG_WARN, "arena: guard page for region %s not installed", name);
+    return 0;
+}
+
+/**
+ * size bytes aligned to align (a power of two), or NULL if the region is full
+ *
+ * Lock-free; safe to call from several threads. Memory is not zeroed after
+ * a reset.
+ */
+static inline void* arena_alloc(struct arena_region* region, size_t size, size_t align)
+{
+    if (align < ARENA_MIN_ALIGN)
+        align = ARENA_MIN_ALIGN;
+    uintptr_t base = (uintptr_t)region->base;
+    size_t top = atomic_load_explicit(&region->top, memory_order_relaxed);
+    size_t start, end;
+    do {
+        start = (size_t)(arena_align_up(base + top, align) - base);
+        end = start + size;
+        if (end > region->size || end < start) {
+            atomic_fetch_add_explicit(&region->failed, 1, memory_order_relaxed);
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&region->top, &top, end,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return region->base + start;
+}
+
+// Nonzero if [ptr, ptr + len) lies inside the part of region handed out
+static inline int arena_contains(const struct arena_region* region, const void* ptr, size_t len)
+{
+    size_t top = atomic_load_explicit(&region->top, memory_order_relaxed);
+    uintptr_t p = (uintptr_t)ptr, base = (uintptr_t)region->base;
+    return p >= base && len <= top && p - base <= top - len;
+}
+
+// End of phase: every allocation from region is released at once.
+// Callers must ensure no thread is still allocating from it.
+static inline void arena_reset(struct arena_region* region)
+{
+    size_t top = atomic_load_explicit(&region->top, memory_order_relaxed);
+    if (top > region->high_water)
+        region->high_water = top;
+    if (ARENA_GUARD_PAGES)
+        memset(region->base, ARENA_POISON, top);
+    atomic_store_explicit(&region->top, 0, memory_order_relaxed);
+}
+
+static inline size_t arena_region_used(const struct arena_region* region)
+{
+    return atomic_load_explicit(&region->top, memory_order_relaxed);
+}
+
+#endif // ARENA_H
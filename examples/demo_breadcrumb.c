@@ -5,48 +5,293 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "ring_log.h"
+#include "arena.h"
+#include "shader_cache.h"
 
 // AI_PHASE: KERNEL_INIT
 // AI_STATUS: IMPLEMENTED
 // AI_PATTERN: SAFE_MEMORY_INIT_V1
 // AI_STRATEGY: Initialize kernel memory subsystem with safety checks
-// AI_DETAILS: Implemented memory initialization with bounds checking and error handling
-// AI_NOTE: This demonstrates a complete AI breadcrumb implementation
-// AI_VERSION: 1.0
+// AI_DETAILS: Reserves a hugepage-backed arena; each phase gets a bounds-checked bump region reset in O(1)
+// AI_NOTE: Build with -DARENA_DEBUG for guard pages after every region and poisoning on reset
+// AI_VERSION: 1.1
 // AI_CONTEXT: { "target_arch": "x86_64", "safety_level": "high", "critical": true }
+#define KERNEL_ARENA_SIZE   ((size_t)64 << 20)
+#define BOOT_REGION_SIZE    ((size_t)4 << 20)
+
+static struct arena kernel_arena;
+static struct arena_region boot_region;     // KERNEL_INIT scratch, reset once init is done
+
 static int init_kernel_memory(void) {
     printf("Initializing kernel memory subsystem...\n");
     
-    // Memory initialization code would go here
+    if (arena_init(&kernel_arena, KERNEL_ARENA_SIZE) != 0 ||
+        arena_region_init(&kernel_arena, &boot_region, "boot", BOOT_REGION_SIZE) != 0) {
+        ring_log(LOG_ERROR, "Error: kernel arena reservation failed");
+        return -1;
+    }
+    
+    // Boot scratch: a frame bitmap covering the arena
+    size_t bitmap_len = kernel_arena.size / kernel_arena.page_size / 8;
+    unsigned char* bitmap = arena_alloc(&boot_region, bitmap_len, 64);
+    if (bitmap == NULL || !arena_contains(&boot_region, bitmap, bitmap_len)) {
+        ring_log(LOG_ERROR, "Error: boot region allocation out of bounds");
+        return -1;
+    }
+    memset(bitmap, 0, bitmap_len);
+    
+    // Requests past the end of a region must be refused, not overrun
+    if (arena_alloc(&boot_region, BOOT_REGION_SIZE, 16) != NULL) {
+        ring_log(LOG_ERROR, "Error: boot region bounds check failed");
+        return -1;
+    }
+    arena_reset(&boot_region);
     
-    printf("Kernel memory initialized successfully\n");
+    printf("Kernel memory initialized successfully (%zu MB arena, %s)\n",
+           kernel_arena.size >> 20, arena_backing_name(kernel_arena.backing));
     return 0;
 }
 
 // AI_PHASE: GRAPHICS_PIPELINE
-// AI_STATUS: PARTIAL
+// AI_STATUS: FIXED
 // AI_PATTERN: GPU_INIT_V2
 // AI_STRATEGY: Initialize GPU pipeline for RadeonSI driver
-// AI_DETAILS: Basic initialization working, advanced features pending
-// AI_NOTE: Need to implement shader compilation support
+// AI_DETAILS: Staged async bring-up: device probe -> command ring, overlapped with the shader-cache load, each behind a fence
+// AI_CHANGE: Added InitializeGPUShaders on top of the shader compile service (shader_cache.h)
+// AI_NOTE: init_gpu_pipeline returns a handle at once; only the first gpu_submit waits on the fences
 // COMPILER_ERR: undefined reference to 'InitializeGPUShaders'
 // FIX_REASON: Shader initialization function not yet implemented
 // LINUX_REF: drivers/gpu/drm/radeon/radeon_cs.c:init_cs()
 // AROS_IMPL: Integrated with HIDD graphics system
-// AI_VERSION: 1.1
+// AI_VERSION: 1.3
 // AI_CONTEXT: { "gpu_family": "GCN", "opengl_version": "4.5", "vulkan_support": false }
-static int init_gpu_pipeline(void) {
-    printf("Initializing GPU pipeline...\n");
+static const char* const gpu_pipeline_shaders[] = {
+    "#version 450\n"
+    "layout(location = 0) in vec3 position;\n"
+    "layout(location = 1) in vec2 uv;\n"
+    "layout(location = 0) out vec2 frag_uv;\n"
+    "void main() { frag_uv = uv; gl_Position = vec4(position, 1.0); }\n",
+
+    "#version 450\n"
+    "layout(binding = 0) uniform sampler2D tex;\n"
+    "layout(location = 0) in vec2 frag_uv;\n"
+    "layout(location = 0) out vec4 color;\n"
+    "void main() { color = texture(tex, frag_uv); }\n",
+
+    "#version 450\n"
+    "layout(location = 0) out vec4 color;\n"
+    "void main() { color = vec4(0.0, 0.0, 0.0, 1.0); }  // Clear\n",
+
+    "#version 450\n"
+    "layout(local_size_x = 64) in;\n"
+    "layout(binding = 0) buffer Data { float values[]; };\n"
+    "void main() { values[gl_GlobalInvocationID.x] *= 2.0; }\n",
+};
+
+#define GPU_NUM_SHADERS     (sizeof(gpu_pipeline_shaders) / sizeof(gpu_pipeline_shaders[0]))
+#define GPU_RING_DWORDS     4096                // Command ring size, one page of packets
+#define GPU_PACKET3_NOP     0xC0001000u         // PACKET3(PACKET3_NOP, 0)
+
+// One-shot completion fence: a stage signals it once with its status, any
+// number of threads may wait on it
+struct gpu_fence {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int signaled;
+    int status;
+    uint64_t signaled_ns;
+};
+
+static void gpu_fence_init(struct gpu_fence* fence) {
+    pthread_mutex_init(&fence->lock, NULL);
+    pthread_cond_init(&fence->cond, NULL);
+    fence->signaled = 0;
+    fence->status = 0;
+}
+
+static void gpu_fence_signal(struct gpu_fence* fence, int status) {
+    pthread_mutex_lock(&fence->lock);
+    fence->status = status;
+    fence->signaled_ns = shader_now();
+    fence->signaled = 1;
+    pthread_cond_broadcast(&fence->cond);
+    pthread_mutex_unlock(&fence->lock);
+}
+
+static int gpu_fence_wait(struct gpu_fence* fence) {
+    pthread_mutex_lock(&fence->lock);
+    while (!fence->signaled)
+        pthread_cond_wait(&fence->cond, &fence->lock);
+    int status = fence->status;
+    pthread_mutex_unlock(&fence->lock);
+    return status;
+}
+
+static void gpu_fence_destroy(struct gpu_fence* fence) {
+    pthread_cond_destroy(&fence->cond);
+    pthread_mutex_destroy(&fence->lock);
+}
+
+// Bring-up runs as three stages on their own threads: device probe, then
+// command-ring setup, with the shader-cache load overlapping both. Each stage
+// signals its fence; the handle is only waited on by the first gpu_submit(),
+// which must come from a single submitting thread
+struct gpu_pipeline {
+    struct gpu_fence probe_done;
+    struct gpu_fence ring_done;
+    struct gpu_fence shaders_done;
+    pthread_t stages[3];
+    unsigned num_stages;
+    uint64_t started_ns;
+    int ready;                                  // Set by the first waiter
+
+    char device[64];
+    uint32_t* ring;
+    uint32_t ring_wptr;
+    struct shader_binary binaries[GPU_NUM_SHADERS];
+    size_t shaders_warm;
+    size_t shaders_failed;
+};
+
+static int InitializeGPUShaders(struct gpu_pipeline* gpu) {
+    const struct shader_target target = { "GCN", SHADER_REFERENCE_VERSION };
+    if (shader_service_init(NULL, &target, 0, NULL) != 0) {
+        ring_log(LOG_ERROR, "Error: shader service failed to start");
+        return -1;
+    }
+    
+    gpu->shaders_failed = shader_compile_all(gpu_pipeline_shaders, GPU_NUM_SHADERS, gpu->binaries);
+    for (size_t i = 0; i < GPU_NUM_SHADERS; i++) {
+        if (gpu->binaries[i].status != 0)
+            ring_log(LOG_ERROR, "Error: shader %zu: %s", i, gpu->binaries[i].error);
+        gpu->shaders_warm += (size_t)gpu->binaries[i].from_cache;
+    }
+    shader_service_shutdown();
+    return gpu->shaders_failed == 0 ? 0 : -1;
+}
+
+// Stage: find the GPU
+static void* gpu_probe_stage(void* arg) {
+    struct gpu_pipeline* gpu = arg;
+    
+    snprintf(gpu->device, sizeof(gpu->device), "GCN (no DRM device, simulated)");
+    for (int card = 0; card < 8; card++) {
+        char path[64];
+        unsigned vendor = 0;
+        snprintf(path, sizeof(path), "/sys/class/drm/card%d/device/vendor", card);
+        FILE* f = fopen(path, "r");
+        if (f == NULL)
+            continue;
+        int found = fscanf(f, "%x", &vendor) == 1 && vendor == 0x1002;
+        fclose(f);
+        if (found) {
+            snprintf(gpu->device, sizeof(gpu->device), "AMD card%d", card);
+            break;
+        }
+    }
+    gpu_fence_signal(&gpu->probe_done, 0);
+    return NULL;
+}
+
+// Stage: set up the command ring once the device is known
+static void* gpu_ring_stage(void* arg) {
+    struct gpu_pipeline* gpu = arg;
     
-    // Basic GPU initialization
-    printf("Basic GPU initialization complete\n");
+    if (gpu_fence_wait(&gpu->probe_done) != 0) {
+        gpu_fence_signal(&gpu->ring_done, -1);
+        return NULL;
+    }
+    gpu->ring = aligned_alloc(4096, GPU_RING_DWORDS * sizeof(uint32_t));
+    if (gpu->ring == NULL) {
+        ring_log(LOG_ERROR, "Error: command ring allocation failed");
+        gpu_fence_signal(&gpu->ring_done, -1);
+        return NULL;
+    }
+    for (size_t i = 0; i < GPU_RING_DWORDS; i++)
+        gpu->ring[i] = GPU_PACKET3_NOP;
+    gpu->ring_wptr = 0;
+    gpu_fence_signal(&gpu->ring_done, 0);
+    return NULL;
+}
+
+// Stage: compile the pipeline shaders or load them warm from the cache.
+// The cache is keyed on the expected family, so it needn't wait for the probe
+static void* gpu_shader_stage(void* arg) {
+    struct gpu_pipeline* gpu = arg;
+    gpu_fence_signal(&gpu->shaders_done, InitializeGPUShaders(gpu));
+    return NULL;
+}
+
+// Start bring-up and return at once; NULL if the stages couldn't be started
+static struct gpu_pipeline* init_gpu_pipeline(void) {
+    struct gpu_pipeline* gpu = calloc(1, sizeof(*gpu));
+    if (gpu == NULL)
+        return NULL;
     
-    // TODO: Implement shader compilation
-    // InitializeGPUShaders();  // Not yet implemented
+    gpu_fence_init(&gpu->probe_done);
+    gpu_fence_init(&gpu->ring_done);
+    gpu_fence_init(&gpu->shaders_done);
+    gpu->started_ns = shader_now();
     
+    // A stage that can't start fails its fence, which fails the stages after it
+    static void* (*const stages[])(void*) = { gpu_shader_stage, gpu_ring_stage, gpu_probe_stage };
+    struct gpu_fence* fences[] = { &gpu->shaders_done, &gpu->ring_done, &gpu->probe_done };
+    for (unsigned i = 0; i < 3; i++) {
+        if (pthread_create(&gpu->stages[gpu->num_stages], NULL, stages[i], gpu) == 0)
+            gpu->num_stages++;
+        else
+            gpu_fence_signal(fences[i], -1);
+    }
+    return gpu;
+}
+
+// Wait for every stage's fence; 0 when the pipeline is usable
+static int gpu_pipeline_wait(struct gpu_pipeline* gpu) {
+    int status = gpu_fence_wait(&gpu->ring_done);
+    if (gpu_fence_wait(&gpu->shaders_done) != 0)
+        status = -1;
+    if (gpu->ready == 0)
+        gpu->ready = status == 0 ? 1 : -1;
+    return gpu->ready == 1 ? 0 : -1;
+}
+
+// Queue count dwords of packets; blocks on bring-up only the first time
+static int gpu_submit(struct gpu_pipeline* gpu, const uint32_t* packets, size_t count) {
+    if (gpu->ready != 1 && gpu_pipeline_wait(gpu) != 0)
+        return -1;
+    for (size_t i = 0; i < count; i++) {
+        gpu->ring[gpu->ring_wptr] = packets[i];
+        gpu->ring_wptr = (gpu->ring_wptr + 1) & (GPU_RING_DWORDS - 1);
+    }
     return 0;
 }
 
+static void gpu_pipeline_print_stats(const struct gpu_pipeline* gpu) {
+    printf("GPU %s: probe %.3f ms, ring %.3f ms, shaders %.3f ms (%zu warm, %zu compiled)\n",
+           gpu->device,
+           (gpu->probe_done.signaled_ns - gpu->started_ns) / 1e6,
+           (gpu->ring_done.signaled_ns - gpu->started_ns) / 1e6,
+           (gpu->shaders_done.signaled_ns - gpu->started_ns) / 1e6,
+           gpu->shaders_warm, GPU_NUM_SHADERS - gpu->shaders_warm - gpu->shaders_failed);
+}
+
+static void gpu_pipeline_destroy(struct gpu_pipeline* gpu) {
+    if (gpu == NULL)
+        return;
+    for (unsigned i = 0; i < gpu->num_stages; i++)
+        pthread_join(gpu->stages[i], NULL);
+    for (size_t i = 0; i < GPU_NUM_SHADERS; i++)
+        shader_binary_release(&gpu->binaries[i]);
+    free(gpu->ring);
+    gpu_fence_destroy(&gpu->probe_done);
+    gpu_fence_destroy(&gpu->ring_done);
+    gpu_fence_destroy(&gpu->shaders_done);
+    free(gpu);
+}
+
 // AI_PHASE: ERROR_HANDLING
 // AI_STATUS: FIXED
 // AI_PATTERN: ERROR_RECOVERY_V1
@@ -58,15 +303,16 @@ static int init_gpu_pipeline(void) {
 // COMPILER_ERR: warning: pointer may be NULL [-Wnull-dereference]
 // CORRECTION_REF: commit a3f9d2c - Fixed NULL pointer handling
 // AI_TRAIN_HASH: 9d34a0b7d1c9f282f48b65ea04d7f19262a88d09f75f2fa9e2f937fe2846b5c9
-// AI_VERSION: 1.2
+// AI_NOTE: Logged through ring_log.h so error storms don't serialize threads on the stdio lock
+// AI_VERSION: 1.3
 // AI_CONTEXT: { "error_handling": "strict", "recovery": "enabled" }
 static void handle_error(const char *message) {
     if (message == NULL) {
-        fprintf(stderr, "Error: NULL error message\n");
+        ring_log(LOG_ERROR, "Error: NULL error message");
         return;
     }
     
-    fprintf(stderr, "Error: %s\n", message);
+    ring_log(LOG_ERROR, "Error: %s", message);
     // Graceful error recovery
 }
 
@@ -82,21 +328,29 @@ static void handle_error(const char *message) {
 static int run_tests(void) {
     printf("\n=== Running Demo Tests ===\n");
     
+    // GPU bring-up runs in the background while kernel memory initializes
+    struct gpu_pipeline* gpu = init_gpu_pipeline();
+    
     // Test 1: Kernel initialization
     printf("Test 1: Kernel Memory Init... ");
     if (init_kernel_memory() == 0) {
         printf("PASS\n");
     } else {
         printf("FAIL\n");
+        gpu_pipeline_destroy(gpu);
         return 1;
     }
     
-    // Test 2: GPU initialization
+    // Test 2: GPU initialization, waited on by the first submission
     printf("Test 2: GPU Pipeline Init... ");
-    if (init_gpu_pipeline() == 0) {
-        printf("PASS (with TODOs)\n");
+    static const uint32_t first_frame[] = { GPU_PACKET3_NOP, GPU_PACKET3_NOP };
+    if (gpu != NULL && gpu_submit(gpu, first_frame, 2) == 0) {
+        printf("PASS\n");
+        gpu_pipeline_print_stats(gpu);
+        gpu_pipeline_destroy(gpu);
     } else {
         printf("FAIL\n");
+        gpu_pipeline_destroy(gpu);
         return 1;
     }
     
@@ -104,6 +358,7 @@ static int run_tests(void) {
     printf("Test 3: Error Handling... ");
     handle_error("Test error message");
     handle_error(NULL);  // Should not crash
+    ring_log_flush();
     printf("PASS\n");
     
     printf("\nAll tests completed!\n");
@@ -7,6 +7,28 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/errqueue.h>
+
+#include "ring_log.h"
+#include "arena.h"
+#include "shader_cache.h"
 
 // Example 1: Traditional breadcrumb (backward compatible)
 // AI_PHASE: INITIALIZATION
@@ -20,7 +42,7 @@ void system_init(void)
 
 // Example 2: Distributed AI task - High priority, assigned
 // AI_PHASE: MEMORY_MANAGER
-// AI_STATUS: PARTIAL
+// AI_STATUS: IMPLEMENTED
 // AI_ASSIGNED_TO: agent_memory_001
 // AI_CLAIMED_AT: 2025-10-15T14:30:00Z
 // AI_ESTIMATED_TIME: 2h
@@ -30,32 +52,417 @@ void system_init(void)
 // AI_RETRY_COUNT: 0
 // AI_MAX_RETRIES: 3
 // AI_STRATEGY: Implement high-performance memory allocation system
-// AI_DETAILS: Basic allocation working, need to add pool management
+// AI_DETAILS: Size-class slab caches with per-thread magazines, shared depot and allocation statistics
+// AI_NOTE: Thread-local magazines stand in for per-CPU caches; the depot lock is only taken on refill/flush
+// AI_CHANGE: Class slabs are carved from a hugepage-backed arena (arena.h), heap pages only once it is full
 // LINUX_REF: mm/slab.c
+
+// Slabs are SLAB_SIZE-aligned so any object pointer can be mapped back to
+// its slab header by masking, which is what makes memory_free() O(1).
+#define SLAB_SIZE           (64 * 1024)
+#define SLAB_HEADER_SIZE    64
+#define SLAB_MAGIC          0x51AB51ABu
+#define SLAB_MIN_SHIFT      4               // 16-byte smallest class
+#define SLAB_NUM_CLASSES    9               // 16 .. 4096 bytes
+#define SLAB_MAX_OBJECT     (1u << (SLAB_MIN_SHIFT + SLAB_NUM_CLASSES - 1))
+#define SLAB_CLASS_LARGE    0xFFFFFFFFu
+#define SLAB_ARENA_SIZE     ((size_t)64 << 20) // Hugepage-backed reserve for class slabs
+#define MAGAZINE_SIZE       64
+#define MAGAZINE_BATCH      (MAGAZINE_SIZE / 2)
+
+struct slab_header {
+    uint32_t magic;
+    uint32_t size_class;                    // Index into slab_depots, or SLAB_CLASS_LARGE
+    size_t span;                            // Bytes backing this slab (large allocations only)
+    struct slab_header* next;               // Depot slab list
+};
+
+// Shared per-class pool: a free list of objects plus the slabs that back it
+struct slab_depot {
+    pthread_mutex_t lock;
+    void* free_list;
+    struct slab_header* slabs;
+    size_t slab_count;
+};
+
+struct memory_class_stats {
+    size_t object_size;
+    size_t allocs;
+    size_t frees;
+    size_t slabs;
+};
+
+struct memory_stats {
+    size_t allocs;
+    size_t frees;
+    size_t bytes_in_use;
+    size_t slab_bytes;
+    size_t large_allocs;
+    size_t large_bytes_in_use;
+    size_t arena_bytes;                     // Slab pages served from the hugepage arena
+    struct memory_class_stats classes[SLAB_NUM_CLASSES];
+};
+
+// Per-thread cache; counters are only written by the owning thread and are
+// read with relaxed loads by memory_get_stats()
+struct thread_cache {
+    void* magazine[SLAB_NUM_CLASSES][MAGAZINE_SIZE];
+    unsigned count[SLAB_NUM_CLASSES];
+    _Atomic size_t allocs[SLAB_NUM_CLASSES];
+    _Atomic size_t frees[SLAB_NUM_CLASSES];
+    struct thread_cache* next;
+    struct thread_cache* prev;
+};
+
+static struct slab_depot slab_depots[SLAB_NUM_CLASSES];
+static pthread_once_t slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t slab_cache_key;
+static struct arena slab_arena;
+static struct arena_region slab_region;
+static int slab_arena_ready;
+
+// Registry of live thread caches plus counters folded in from exited threads
+static pthread_mutex_t slab_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct thread_cache* slab_registry;
+static size_t retired_allocs[SLAB_NUM_CLASSES];
+static size_t retired_frees[SLAB_NUM_CLASSES];
+
+static _Atomic size_t large_allocs;
+static _Atomic size_t large_frees;
+static _Atomic size_t large_bytes;
+
+static __thread struct thread_cache* local_cache;
+
+#define COUNTER_INC(c) \
+    atomic_store_explicit(&(c), atomic_load_explicit(&(c), memory_order_relaxed) + 1, \
+                          memory_order_relaxed)
+
+static inline size_t slab_class_size(unsigned cls)
+{
+    return (size_t)1 << (SLAB_MIN_SHIFT + cls);
+}
+
+static inline unsigned slab_size_to_class(size_t size)
+{
+    if (size <= ((size_t)1 << SLAB_MIN_SHIFT))
+        return 0;
+    // ceil(log2(size)) - SLAB_MIN_SHIFT
+    return (unsigned)(64 - __builtin_clzll((unsigned long long)(size - 1))) - SLAB_MIN_SHIFT;
+}
+
+static inline struct slab_header* slab_of(void* ptr)
+{
+    return (struct slab_header*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+}
+
+// Single source of class slab pages. Class slabs are never released, so
+// they come from the hugepage arena (fewer TLB misses across the pool) and
+// only fall back to the heap once it is exhausted.
+static void* slab_page_alloc(void)
+{
+    void* page = slab_arena_ready ? arena_alloc(&slab_region, SLAB_SIZE, SLAB_SIZE) : NULL;
+    if (page == NULL && posix_memalign(&page, SLAB_SIZE, SLAB_SIZE) != 0)
+        return NULL;
+    return page;
+}
+
+static void slab_cache_destroy(void* arg);
+
+static void slab_init_once(void)
+{
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        pthread_mutex_init(&slab_depots[cls].lock, NULL);
+        slab_depots[cls].free_list = NULL;
+        slab_depots[cls].slabs = NULL;
+        slab_depots[cls].slab_count = 0;
+    }
+    pthread_key_create(&slab_cache_key, slab_cache_destroy);
+    slab_arena_ready = arena_init(&slab_arena, SLAB_ARENA_SIZE) == 0 &&
+                       arena_region_init(&slab_arena, &slab_region, "slab", arena_available(&slab_arena)) == 0;
+}
+
+// Carve a fresh slab into the depot free list. Caller holds depot->lock.
+static int slab_grow(unsigned cls)
+{
+    struct slab_depot* depot = &slab_depots[cls];
+    size_t object_size = slab_class_size(cls);
+    struct slab_header* slab = slab_page_alloc();
+    if (slab == NULL)
+        return -1;
+
+    slab->magic = SLAB_MAGIC;
+    slab->size_class = cls;
+    slab->span = SLAB_SIZE;
+    slab->next = depot->slabs;
+    depot->slabs = slab;
+    depot->slab_count++;
+
+    char* base = (char*)slab + SLAB_HEADER_SIZE;
+    size_t objects = (SLAB_SIZE - SLAB_HEADER_SIZE) / object_size;
+    for (size_t i = objects; i > 0; i--) {
+        void** obj = (void**)(base + (i - 1) * object_size);
+        *obj = depot->free_list;
+        depot->free_list = obj;
+    }
+    return 0;
+}
+
+// Move up to MAGAZINE_BATCH objects from the depot into the thread magazine
+static int slab_refill(struct thread_cache* cache, unsigned cls)
+{
+    struct slab_depot* depot = &slab_depots[cls];
+    unsigned moved = 0;
+
+    pthread_mutex_lock(&depot->lock);
+    while (moved < MAGAZINE_BATCH) {
+        if (depot->free_list == NULL && slab_grow(cls) != 0)
+            break;
+        void** obj = depot->free_list;
+        depot->free_list = *obj;
+        cache->magazine[cls][cache->count[cls]++] = obj;
+        moved++;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    return moved > 0 ? 0 : -1;
+}
+
+// Return the oldest `n` objects of a magazine to the depot
+static void slab_flush(struct thread_cache* cache, unsigned cls, unsigned n)
+{
+    struct slab_depot* depot = &slab_depots[cls];
+
+    pthread_mutex_lock(&depot->lock);
+    for (unsigned i = 0; i < n; i++) {
+        void** obj = cache->magazine[cls][i];
+        *obj = depot->free_list;
+        depot->free_list = obj;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    cache->count[cls] -= n;
+    memmove(cache->magazine[cls], cache->magazine[cls] + n, cache->count[cls] * sizeof(void*));
+}
+
+static struct thread_cache* slab_cache_get(void)
+{
+    if (local_cache != NULL)
+        return local_cache;
+
+    pthread_once(&slab_once, slab_init_once);
+
+    struct thread_cache* cache = calloc(1, sizeof(*cache));
+    if (cache == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&slab_registry_lock);
+    cache->next = slab_registry;
+    if (slab_registry != NULL)
+        slab_registry->prev = cache;
+    slab_registry = cache;
+    pthread_mutex_unlock(&slab_registry_lock);
+
+    pthread_setspecific(slab_cache_key, cache);
+    local_cache = cache;
+    return cache;
+}
+
+// Thread exit: drain magazines back to the depots and keep the counters
+static void slab_cache_destroy(void* arg)
+{
+    struct thread_cache* cache = arg;
+
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        if (cache->count[cls] > 0)
+            slab_flush(cache, cls, cache->count[cls]);
+    }
+
+    pthread_mutex_lock(&slab_registry_lock);
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        retired_allocs[cls] += atomic_load_explicit(&cache->allocs[cls], memory_order_relaxed);
+        retired_frees[cls] += atomic_load_explicit(&cache->frees[cls], memory_order_relaxed);
+    }
+    if (cache->prev != NULL)
+        cache->prev->next = cache->next;
+    else
+        slab_registry = cache->next;
+    if (cache->next != NULL)
+        cache->next->prev = cache->prev;
+    pthread_mutex_unlock(&slab_registry_lock);
+
+    if (local_cache == cache)
+        local_cache = NULL;
+    free(cache);
+}
+
+// Allocations above SLAB_MAX_OBJECT get a dedicated aligned heap span with
+// its own header, released by memory_free()
+static void* memory_alloc_large(size_t size)
+{
+    size_t span = SLAB_HEADER_SIZE + size;
+    struct slab_header* slab = NULL;
+    if (posix_memalign((void**)&slab, SLAB_SIZE, span) != 0)
+        return NULL;
+
+    slab->magic = SLAB_MAGIC;
+    slab->size_class = SLAB_CLASS_LARGE;
+    slab->span = span;
+    slab->next = NULL;
+
+    atomic_fetch_add_explicit(&large_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&large_bytes, size, memory_order_relaxed);
+    return (char*)slab + SLAB_HEADER_SIZE;
+}
+
 void* memory_alloc(size_t size)
 {
-    // Basic implementation
-    return malloc(size);
+    if (size > SLAB_MAX_OBJECT)
+        return memory_alloc_large(size);
+
+    struct thread_cache* cache = slab_cache_get();
+    if (cache == NULL)
+        return NULL;
+
+    unsigned cls = slab_size_to_class(size);
+    if (cache->count[cls] == 0 && slab_refill(cache, cls) != 0)
+        return NULL;
+
+    COUNTER_INC(cache->allocs[cls]);
+    return cache->magazine[cls][--cache->count[cls]];
+}
+
+void memory_free(void* ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    struct slab_header* slab = slab_of(ptr);
+    if (slab->magic != SLAB_MAGIC) {
+        ring_log(LOG_ERROR, "memory_free: %p was not allocated by memory_alloc", ptr);
+        return;
+    }
+
+    if (slab->size_class == SLAB_CLASS_LARGE) {
+        atomic_fetch_add_explicit(&large_frees, 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&large_bytes, slab->span - SLAB_HEADER_SIZE, memory_order_relaxed);
+        slab->magic = 0;
+        free(slab);
+        return;
+    }
+
+    struct thread_cache* cache = slab_cache_get();
+    unsigned cls = slab->size_class;
+    if (cache == NULL) {
+        // No cache available (out of memory): hand the object straight to the depot
+        struct slab_depot* depot = &slab_depots[cls];
+        pthread_mutex_lock(&depot->lock);
+        *(void**)ptr = depot->free_list;
+        depot->free_list = ptr;
+        pthread_mutex_unlock(&depot->lock);
+        return;
+    }
+
+    if (cache->count[cls] == MAGAZINE_SIZE)
+        slab_flush(cache, cls, MAGAZINE_BATCH);
+
+    cache->magazine[cls][cache->count[cls]++] = ptr;
+    COUNTER_INC(cache->frees[cls]);
+}
+
+void memory_get_stats(struct memory_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    pthread_once(&slab_once, slab_init_once);
+
+    pthread_mutex_lock(&slab_registry_lock);
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        struct memory_class_stats* cs = &stats->classes[cls];
+        cs->object_size = slab_class_size(cls);
+        cs->allocs = retired_allocs[cls];
+        cs->frees = retired_frees[cls];
+        for (struct thread_cache* c = slab_registry; c != NULL; c = c->next) {
+            cs->allocs += atomic_load_explicit(&c->allocs[cls], memory_order_relaxed);
+            cs->frees += atomic_load_explicit(&c->frees[cls], memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&slab_registry_lock);
+
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        struct memory_class_stats* cs = &stats->classes[cls];
+        pthread_mutex_lock(&slab_depots[cls].lock);
+        cs->slabs = slab_depots[cls].slab_count;
+        pthread_mutex_unlock(&slab_depots[cls].lock);
+
+        stats->allocs += cs->allocs;
+        stats->frees += cs->frees;
+        stats->bytes_in_use += (cs->allocs - cs->frees) * cs->object_size;
+        stats->slab_bytes += cs->slabs * SLAB_SIZE;
+    }
+
+    size_t big_allocs = atomic_load_explicit(&large_allocs, memory_order_relaxed);
+    stats->large_allocs = big_allocs;
+    stats->large_bytes_in_use = atomic_load_explicit(&large_bytes, memory_order_relaxed);
+    stats->allocs += big_allocs;
+    stats->frees += atomic_load_explicit(&large_frees, memory_order_relaxed);
+    stats->bytes_in_use += stats->large_bytes_in_use;
+    stats->arena_bytes = slab_arena_ready ? arena_region_used(&slab_region) : 0;
+}
+
+void memory_print_stats(void)
+{
+    struct memory_stats stats;
+    memory_get_stats(&stats);
+
+    printf("Memory manager: %zu allocs, %zu frees, %zu bytes in use, %zu bytes in slabs\n",
+           stats.allocs, stats.frees, stats.bytes_in_use, stats.slab_bytes);
+    for (unsigned cls = 0; cls < SLAB_NUM_CLASSES; cls++) {
+        const struct memory_class_stats* cs = &stats.classes[cls];
+        if (cs->allocs == 0)
+            continue;
+        printf("  %5zu-byte class: %zu allocs, %zu frees, %zu slabs\n",
+               cs->object_size, cs->allocs, cs->frees, cs->slabs);
+    }
+    if (stats.large_allocs > 0)
+        printf("  large: %zu allocs, %zu bytes in use\n",
+               stats.large_allocs, stats.large_bytes_in_use);
+    if (slab_arena_ready)
+        printf("  %zu of %zu slab bytes from the arena (%s)\n", stats.arena_bytes, stats.slab_bytes,
+               arena_backing_name(slab_arena.backing));
 }
 
 // Example 3: Distributed AI task - Waiting on dependencies
 // AI_PHASE: SHADER_COMPILER
-// AI_STATUS: NOT_STARTED
+// AI_STATUS: IMPLEMENTED
 // AI_PRIORITY: 8
 // AI_COMPLEXITY: HIGH
 // AI_DEPENDENCIES: MEMORY_MANAGER, LLVM_INIT
 // AI_BLOCKS: RENDER_PIPELINE, GRAPHICS_EFFECTS
 // AI_STRATEGY: Implement shader compilation using LLVM backend
-// AI_NOTE: Cannot start until MEMORY_MANAGER and LLVM_INIT are complete
+// AI_DETAILS: Worker-pool compile service with a persistent cache keyed on hash(source, GPU family, compiler version) (shader_cache.h)
+// AI_NOTE: LLVM is not in this tree; the compiler is a backend hook with a reference tokenizer standing in until LLVM_INIT lands
 // LINUX_REF: drivers/gpu/drm/amd/amdgpu/amdgpu_cs.c
+#define SHADER_GPU_FAMILY   "GCN"
+
+// Queue source on the compile pool; the binary lands in the shader cache,
+// so the next start loads it instead of compiling
 void compile_shader(const char* source)
 {
-    // TODO: Implementation blocked by dependencies
+    struct shader_job* job = shader_submit(source);
+    if (job == NULL) {
+        const struct shader_target target = { SHADER_GPU_FAMILY, SHADER_REFERENCE_VERSION };
+        shader_service_init(NULL, &target, 0, NULL);
+        job = shader_submit(source);
+    }
+    if (job == NULL) {
+        ring_log(LOG_ERROR, "compile_shader: shader service unavailable");
+        return;
+    }
+    shader_detach(job);
 }
 
 // Example 4: Distributed AI task - Failed and retrying
 // AI_PHASE: NETWORK_STACK
-// AI_STATUS: PARTIAL
+// AI_STATUS: IMPLEMENTED
 // AI_ASSIGNED_TO: agent_network_002
 // AI_CLAIMED_AT: 2025-10-15T15:00:00Z
 // AI_ESTIMATED_TIME: 3.5h
@@ -65,27 +472,482 @@ void compile_shader(const char* source)
 // AI_RETRY_COUNT: 1
 // AI_MAX_RETRIES: 3
 // AI_STRATEGY: Implement TCP/IP stack with modern optimizations
-// AI_DETAILS: Basic packet handling working, retrying due to performance issues
-// COMPILER_ERR: warning: possible memory leak in tcp_send()
-// FIX_REASON: Previous attempt had memory leak in error path
-// AI_NOTE: Retrying with improved error handling
+// AI_DETAILS: Batched scatter-gather sendmsg over pool buffers, MSG_ZEROCOPY for large batches of owned buffers
+// AI_NOTE: Every error path hands queued buffers back to memory_free(); io_uring left out to avoid a liburing dependency
 // LINUX_REF: net/ipv4/tcp.c
-int network_send(void* data, size_t len)
+
+// Small sends are copied into pool chunks and queued; the queue goes out as
+// one sendmsg() when it reaches NET_BATCH_BYTES, NET_MAX_IOV segments or on
+// network_flush(). Large sends are referenced in place and written before
+// network_send() returns. Buffers from network_buffer_alloc() can be handed
+// over with network_send_buffer() and are never copied: when a batch is all
+// pool buffers and big enough, it goes out with MSG_ZEROCOPY and its buffers
+// are returned to the pool once the kernel reports completion.
+#define NET_CHUNK_SIZE      SLAB_MAX_OBJECT         // Coalescing buffer, largest slab class
+#define NET_MAX_IOV         64
+#define NET_BATCH_BYTES     (64 * 1024)
+#define NET_ZEROCOPY_MIN    (16 * 1024)             // Below this, pinning pages costs more than copying
+#define NET_MAX_INFLIGHT    256
+#define NET_ZC_RANGES       64                      // Zerocopy ids outstanding at once
+
+struct net_segment {
+    void* base;
+    size_t len;
+    void* owned;                            // Pool buffer to release once sent, or NULL
+};
+
+// A pool buffer the kernel may still read, until zerocopy id last_seq completes
+struct net_inflight {
+    void* buf;
+    uint32_t last_seq;
+};
+
+struct net_stats {
+    size_t sends;
+    size_t bytes;
+    size_t syscalls;
+    size_t copied_bytes;
+    size_t zerocopy_batches;
+    size_t zerocopy_copied;                 // Completions where the kernel copied anyway
+    size_t errors;
+};
+
+struct net_transport {
+    pthread_mutex_t lock;
+    int fd;
+    int zerocopy;
+
+    struct net_segment queue[NET_MAX_IOV];
+    unsigned queued;
+    size_t queued_bytes;
+
+    char* chunk;                            // Coalescing buffer being filled
+    size_t chunk_used;
+
+    struct net_inflight inflight[NET_MAX_INFLIGHT];
+    unsigned inflight_count;
+    uint32_t zc_next_seq;                   // Id the kernel assigns the next zerocopy sendmsg()
+    uint32_t zc_acked;                      // Every id below this has completed
+    uint32_t zc_early[NET_ZC_RANGES][2];    // Completed ranges past zc_acked; fewer than
+                                            // the outstanding ids, so it never fills
+    unsigned zc_early_count;
+
+    struct net_stats stats;
+};
+
+static struct net_transport net_tx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1
+};
+
+// Empty the queue. Pool buffers go back to the pool, unless zc_calls
+// sendmsg() calls of this batch used MSG_ZEROCOPY: the kernel may then still
+// read them, so they wait in inflight for the batch's last zerocopy id.
+static void net_release_queue(struct net_transport* tx, int zc_calls)
+{
+    for (unsigned i = 0; i < tx->queued; i++) {
+        void* owned = tx->queue[i].owned;
+        if (owned == NULL)
+            continue;
+        if (zc_calls > 0)
+            tx->inflight[tx->inflight_count++] = (struct net_inflight){ owned, tx->zc_next_seq - 1 };
+        else
+            memory_free(owned);
+    }
+    tx->queued = 0;
+    tx->queued_bytes = 0;
+}
+
+// Error path: drop everything queued
+static void net_discard_queue(struct net_transport* tx, int zc_calls)
+{
+    net_release_queue(tx, zc_calls);
+    tx->chunk_used = 0;
+    tx->stats.errors++;
+}
+
+static void net_zc_complete(struct net_transport* tx, uint32_t lo, uint32_t hi)
+{
+    if (lo != tx->zc_acked) {
+        // Room guaranteed: net_write_queue() keeps fewer than NET_ZC_RANGES
+        // ids outstanding, and each early range holds at least one of them
+        tx->zc_early[tx->zc_early_count][0] = lo;
+        tx->zc_early[tx->zc_early_count][1] = hi;
+        tx->zc_early_count++;
+        return;
+    }
+    tx->zc_acked = hi + 1;
+
+    // Fold in ranges that completed out of order
+    for (unsigned i = 0; i < tx->zc_early_count; ) {
+        if (tx->zc_early[i][0] != tx->zc_acked) {
+            i++;
+            continue;
+        }
+        tx->zc_acked = tx->zc_early[i][1] + 1;
+        tx->zc_early_count--;
+        tx->zc_early[i][0] = tx->zc_early[tx->zc_early_count][0];
+        tx->zc_early[i][1] = tx->zc_early[tx->zc_early_count][1];
+        i = 0;
+    }
+
+    unsigned kept = 0;
+    for (unsigned i = 0; i < tx->inflight_count; i++) {
+        // Ids wrap, so compare by distance
+        if ((int32_t)(tx->inflight[i].last_seq - tx->zc_acked) < 0)
+            memory_free(tx->inflight[i].buf);
+        else
+            tx->inflight[kept++] = tx->inflight[i];
+    }
+    tx->inflight_count = kept;
+}
+
+// Read zerocopy completions off the socket error queue
+static void net_reap_zerocopy(struct net_transport* tx, int timeout_ms)
+{
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+    while (tx->inflight_count > 0) {
+        char control[128];
+        struct msghdr msg = { .msg_control = control, .msg_controllen = sizeof(control) };
+
+        if (recvmsg(tx->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN || timeout_ms == 0)
+                return;
+            // Error queue data shows up as POLLERR
+            struct pollfd pfd = { .fd = tx->fd, .events = 0 };
+            if (poll(&pfd, 1, timeout_ms) <= 0)
+                return;
+            continue;
+        }
+
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != NULL; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                  (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)))
+                continue;
+            struct sock_extended_err err;
+            memcpy(&err, CMSG_DATA(cm), sizeof(err));
+            if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                tx->stats.zerocopy_copied++;
+            net_zc_complete(tx, err.ee_info, err.ee_data);
+        }
+    }
+#else
+    (void)tx;
+    (void)timeout_ms;
+#endif
+}
+
+// Write every queued segment with as few sendmsg() calls as possible.
+// Caller holds tx->lock.
+static int net_write_queue(struct net_transport* tx)
+{
+    if (tx->queued == 0)
+        return 0;
+    if (tx->fd < 0) {
+        net_discard_queue(tx, 0);
+        errno = ENOTCONN;
+        return -1;
+    }
+
+    // Zerocopy needs every segment to be a pool buffer we can hold until completion
+    int zerocopy = 0;
+#ifdef MSG_ZEROCOPY
+    if (tx->zerocopy && tx->queued_bytes >= NET_ZEROCOPY_MIN) {
+        if (tx->inflight_count + tx->queued > NET_MAX_INFLIGHT)
+            net_reap_zerocopy(tx, 0);
+        zerocopy = tx->inflight_count + tx->queued <= NET_MAX_INFLIGHT;
+        for (unsigned i = 0; zerocopy && i < tx->queued; i++)
+            zerocopy = tx->queue[i].owned != NULL;
+    }
+#endif
+
+    struct iovec iov[NET_MAX_IOV];
+    for (unsigned i = 0; i < tx->queued; i++) {
+        iov[i].iov_base = tx->queue[i].base;
+        iov[i].iov_len = tx->queue[i].len;
+    }
+
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = tx->queued };
+    int zc_calls = 0;
+    while (msg.msg_iovlen > 0) {
+        int flags = MSG_NOSIGNAL;
+        int zc_call = 0;
+#ifdef MSG_ZEROCOPY
+        if (zerocopy) {
+            // Bound the ids in flight so zc_early can hold every completion
+            // that arrives out of order; at the bound, this call copies
+            if (tx->zc_next_seq - tx->zc_acked >= NET_ZC_RANGES - 1)
+                net_reap_zerocopy(tx, 0);
+            zc_call = tx->zc_next_seq - tx->zc_acked < NET_ZC_RANGES - 1;
+            if (zc_call)
+                flags |= MSG_ZEROCOPY;
+        }
+#endif
+        ssize_t sent = sendmsg(tx->fd, &msg, flags);
+        tx->stats.syscalls++;
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = { .fd = tx->fd, .events = POLLOUT };
+                if (poll(&pfd, 1, -1) >= 0)
+                    continue;
+            }
+            if (errno == ENOBUFS && zc_call && zc_calls == 0) {
+                // Out of optmem for pinned pages; copy this batch instead
+                zerocopy = 0;
+                continue;
+            }
+            int saved = errno;
+            net_discard_queue(tx, zc_calls);
+            errno = saved;
+            return -1;
+        }
+        if (zc_call) {
+            tx->zc_next_seq++;
+            zc_calls++;
+        }
+
+        while (msg.msg_iovlen > 0 && (size_t)sent >= msg.msg_iov->iov_len) {
+            sent -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (char*)msg.msg_iov->iov_base + sent;
+            msg.msg_iov->iov_len -= (size_t)sent;
+        }
+    }
+
+    if (zc_calls > 0)
+        tx->stats.zerocopy_batches++;
+    tx->stats.bytes += tx->queued_bytes;
+    net_release_queue(tx, zc_calls);
+
+    net_reap_zerocopy(tx, 0);
+    return 0;
+}
+
+static int net_append(struct net_transport* tx, void* base, size_t len, void* owned)
+{
+    if (tx->queued == NET_MAX_IOV && net_write_queue(tx) != 0)
+        return -1;
+    tx->queue[tx->queued++] = (struct net_segment){ base, len, owned };
+    tx->queued_bytes += len;
+    return 0;
+}
+
+// Queue the coalescing chunk; the next small send starts a new one
+static int net_seal_chunk(struct net_transport* tx)
+{
+    char* chunk = tx->chunk;
+    size_t used = tx->chunk_used;
+    if (chunk == NULL || used == 0)
+        return 0;
+
+    tx->chunk = NULL;
+    tx->chunk_used = 0;
+    if (net_append(tx, chunk, used, chunk) != 0) {
+        memory_free(chunk);
+        return -1;
+    }
+    return 0;
+}
+
+static int net_flush_locked(struct net_transport* tx)
+{
+    if (net_seal_chunk(tx) != 0)
+        return -1;
+    return net_write_queue(tx);
+}
+
+// Attach an already connected stream socket
+int network_attach(int fd)
 {
-    // Implementation with retry improvements
+    pthread_mutex_lock(&net_tx.lock);
+    net_tx.fd = fd;
+    net_tx.zerocopy = 0;
+    net_tx.zc_next_seq = 0;
+    net_tx.zc_acked = 0;
+    net_tx.zc_early_count = 0;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    // Refused by sockets without zerocopy support (e.g. AF_UNIX); they just copy
+    int one = 1;
+    net_tx.zerocopy = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#endif
+    pthread_mutex_unlock(&net_tx.lock);
     return 0;
 }
 
+int network_connect(const char* host, const char* port)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo* res;
+    if (getaddrinfo(host, port, &hints, &res) != 0)
+        return -1;
+
+    int fd = -1;
+    for (struct addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+            break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0)
+        return -1;
+
+    // Sends are batched here already; Nagle would only add latency
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return network_attach(fd);
+}
+
+// Buffer from the memory_alloc() pool for network_send_buffer()
+void* network_buffer_alloc(size_t len)
+{
+    return memory_alloc(len);
+}
+
+// Queue a network_buffer_alloc() buffer without copying; the transport frees it
+int network_send_buffer(void* buf, size_t len)
+{
+    struct net_transport* tx = &net_tx;
+    int ret;
+
+    pthread_mutex_lock(&tx->lock);
+    tx->stats.sends++;
+    ret = net_seal_chunk(tx);
+    if (ret == 0)
+        ret = net_append(tx, buf, len, buf);
+    if (ret != 0)
+        memory_free(buf);               // Never queued, so no one else frees it
+    else if (tx->queued_bytes >= NET_BATCH_BYTES)
+        ret = net_write_queue(tx);
+    pthread_mutex_unlock(&tx->lock);
+    return ret;
+}
+
+// Send len bytes. Small sends are batched until network_flush() or a batch
+// limit; on error, everything queued is dropped and -1 returned with errno set.
+int network_send(void* data, size_t len)
+{
+    struct net_transport* tx = &net_tx;
+    int ret = 0;
+
+    pthread_mutex_lock(&tx->lock);
+    tx->stats.sends++;
+
+    if (len >= NET_CHUNK_SIZE) {
+        // Referenced in place, so it goes out before returning
+        ret = net_seal_chunk(tx);
+        if (ret == 0)
+            ret = net_append(tx, data, len, NULL);
+        if (ret == 0)
+            ret = net_write_queue(tx);
+        pthread_mutex_unlock(&tx->lock);
+        return ret;
+    }
+
+    const char* src = data;
+    while (ret == 0 && len > 0) {
+        if (tx->chunk == NULL) {
+            tx->chunk = memory_alloc(NET_CHUNK_SIZE);
+            if (tx->chunk == NULL) {
+                net_discard_queue(tx, 0);
+                errno = ENOMEM;
+                ret = -1;
+                break;
+            }
+            tx->chunk_used = 0;
+        }
+
+        size_t n = NET_CHUNK_SIZE - tx->chunk_used;
+        if (n > len)
+            n = len;
+        memcpy(tx->chunk + tx->chunk_used, src, n);
+        tx->chunk_used += n;
+        tx->stats.copied_bytes += n;
+        src += n;
+        len -= n;
+
+        if (tx->chunk_used == NET_CHUNK_SIZE)
+            ret = net_seal_chunk(tx);
+    }
+
+    if (ret == 0 && tx->queued_bytes + tx->chunk_used >= NET_BATCH_BYTES)
+        ret = net_flush_locked(tx);
+    pthread_mutex_unlock(&tx->lock);
+    return ret;
+}
+
+int network_flush(void)
+{
+    pthread_mutex_lock(&net_tx.lock);
+    int ret = net_flush_locked(&net_tx);
+    pthread_mutex_unlock(&net_tx.lock);
+    return ret;
+}
+
+// Flush, wait for zerocopy completions and close the socket
+int network_close(void)
+{
+    pthread_mutex_lock(&net_tx.lock);
+    int ret = net_flush_locked(&net_tx);
+    net_reap_zerocopy(&net_tx, 1000);
+    if (net_tx.inflight_count > 0) {
+        // The kernel may still read them; leaking beats handing them out again
+        ring_log(LOG_WARN, "network_close: %u zerocopy buffers not acknowledged", net_tx.inflight_count);
+        net_tx.inflight_count = 0;
+    }
+    if (net_tx.chunk != NULL) {
+        memory_free(net_tx.chunk);
+        net_tx.chunk = NULL;
+        net_tx.chunk_used = 0;
+    }
+    if (net_tx.fd >= 0)
+        close(net_tx.fd);
+    net_tx.fd = -1;
+    pthread_mutex_unlock(&net_tx.lock);
+    return ret;
+}
+
+void network_get_stats(struct net_stats* stats)
+{
+    pthread_mutex_lock(&net_tx.lock);
+    *stats = net_tx.stats;
+    pthread_mutex_unlock(&net_tx.lock);
+}
+
+void network_print_stats(void)
+{
+    struct net_stats stats;
+    network_get_stats(&stats);
+
+    printf("Network: %zu sends, %zu bytes in %zu syscalls, %zu bytes copied, "
+           "%zu zerocopy batches (%zu copied by kernel), %zu errors\n",
+           stats.sends, stats.bytes, stats.syscalls, stats.copied_bytes,
+           stats.zerocopy_batches, stats.zerocopy_copied, stats.errors);
+}
+
 // Example 5: Low priority, simple task
 // AI_PHASE: LOGGING_SYSTEM
-// AI_STATUS: NOT_STARTED
+// AI_STATUS: IMPLEMENTED
 // AI_PRIORITY: 3
 // AI_COMPLEXITY: LOW
 // AI_STRATEGY: Add debug logging infrastructure
-// AI_NOTE: Low priority, can be done by any available agent
+// AI_DETAILS: Per-thread lock-free SPSC rings drained by a background thread (ring_log.h)
+// AI_NOTE: Callers never block; records from a full ring are dropped and reported
 void log_message(const char* msg)
 {
-    // TODO: Simple logging implementation
+    ring_log_str(LOG_INFO, msg);
 }
 
 // Example 6: Completed distributed task
@@ -99,15 +961,740 @@ void log_message(const char* msg)
 // AI_RETRY_COUNT: 0
 // AI_MAX_RETRIES: 3
 // AI_STRATEGY: Parse configuration files in INI format
-// AI_DETAILS: Complete implementation with error handling
-// AI_NOTE: Completed successfully on first attempt
-// AI_VERSION: 1.0
+// AI_DETAILS: mmap'd INI/JSON parsed into one flat, string-interned table; inotify reloads swapped in RCU-style
+// AI_NOTE: Readers are lock-free (per-thread epoch); the old table is freed once every reader has moved past it
+// AI_VERSION: 1.1
+
+// The file is mapped, never read into a buffer. Nested JSON objects and
+// arrays flatten to dotted keys ("training.batch_size", "gpu_arch.0"), INI
+// sections prefix their keys the same way. A table is one heap block:
+// entries, a hash index, and a pool holding each distinct key and value
+// string once, so building it costs a few growing buffers rather than an
+// allocation per key.
+//
+// Readers bracket lookups with config_read_begin()/config_read_end(), which
+// only publish the reader's epoch; a reload swaps the table pointer and frees
+// the old table after every reader that could still hold it has finished.
+#define CONFIG_KEY_MAX      256
+#define CONFIG_MAX_DEPTH    32
+#define CONFIG_POLL_MS      200
+
+struct config_entry {
+    uint32_t key;                           // Pool offsets
+    uint32_t value;
+    uint32_t hash;
+};
+
+struct config_table {
+    size_t count;
+    size_t index_mask;
+    size_t pool_len;
+    size_t interned;                        // Strings shared instead of stored again
+    uint64_t generation;
+    const uint32_t* index;                  // Entry number + 1, 0 when empty
+    const struct config_entry* entries;
+    const char* pool;
+};
+
+struct config_builder {
+    char* pool;
+    size_t pool_len, pool_cap;
+    struct config_entry* entries;
+    size_t count, entries_cap;
+    uint32_t* intern;                       // Pool offset + 1 of each distinct string
+    size_t intern_mask, interned;
+    char* scratch;                          // Unescaped JSON string
+    size_t scratch_cap;
+    char path[CONFIG_KEY_MAX];
+    const char* start;                      // For error line numbers
+    const char* error;
+    const char* error_at;
+};
+
+struct config_reader {
+    _Atomic uint64_t epoch;                 // 0 outside a read section
+    _Atomic int in_use;
+    struct config_reader* next;
+};
+
+static _Atomic(struct config_table*) config_current;
+static _Atomic uint64_t config_epoch = 1;
+static _Atomic uint64_t config_generation;
+static pthread_mutex_t config_write_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t config_readers_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct config_reader* config_readers;
+static pthread_once_t config_once = PTHREAD_ONCE_INIT;
+static pthread_key_t config_reader_key;
+static __thread struct config_reader* config_local_reader;
+
+static char config_path[512];
+static pthread_t config_watcher;
+static int config_watching;
+static _Atomic int config_stop;
+
+static inline uint32_t config_hash(const char* s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int config_grow(void** buf, size_t* cap, size_t need, size_t elem)
+{
+    if (need <= *cap)
+        return 0;
+    size_t n = *cap ? *cap : 64;
+    while (n < need)
+        n *= 2;
+    void* grown = realloc(*buf, n * elem);
+    if (grown == NULL)
+        return -1;
+    *buf = grown;
+    *cap = n;
+    return 0;
+}
+
+// Pool offset of s, stored once however often it occurs
+static int64_t config_intern(struct config_builder* b, const char* s, size_t len)
+{
+    if (b->intern == NULL || (b->interned + 1) * 2 > b->intern_mask + 1) {
+        size_t size = b->intern ? (b->intern_mask + 1) * 2 : 256;
+        uint32_t* table = calloc(size, sizeof(*table));
+        if (table == NULL)
+            return -1;
+        for (size_t i = 0; b->intern != NULL && i <= b->intern_mask; i++) {
+            if (b->intern[i] == 0)
+                continue;
+            const char* str = b->pool + b->intern[i] - 1;
+            size_t slot = config_hash(str, strlen(str)) & (size - 1);
+            while (table[slot] != 0)
+                slot = (slot + 1) & (size - 1);
+            table[slot] = b->intern[i];
+        }
+        free(b->intern);
+        b->intern = table;
+        b->intern_mask = size - 1;
+    }
+
+    size_t slot = config_hash(s, len) & b->intern_mask;
+    for (; b->intern[slot] != 0; slot = (slot + 1) & b->intern_mask) {
+        const char* str = b->pool + b->intern[slot] - 1;
+        if (strncmp(str, s, len) == 0 && str[len] == '\0')
+            return b->intern[slot] - 1;
+    }
+
+    if (b->pool_len + len + 1 > UINT32_MAX - 1 ||
+        config_grow((void**)&b->pool, &b->pool_cap, b->pool_len + len + 1, 1) != 0)
+        return -1;
+    size_t offset = b->pool_len;
+    memcpy(b->pool + offset, s, len);
+    b->pool[offset + len] = '\0';
+    b->pool_len += len + 1;
+    b->intern[slot] = (uint32_t)offset + 1;
+    b->interned++;
+    return (int64_t)offset;
+}
+
+static int config_add(struct config_builder* b, size_t path_len, const char* value, size_t len)
+{
+    int64_t key = config_intern(b, b->path, path_len);
+    int64_t val = key < 0 ? -1 : config_intern(b, value, len);
+    if (val < 0 || config_grow((void**)&b->entries, &b->entries_cap, b->count + 1, sizeof(*b->entries)) != 0) {
+        b->error = "out of memory";
+        return -1;
+    }
+    b->entries[b->count].key = (uint32_t)key;
+    b->entries[b->count].value = (uint32_t)val;
+    b->entries[b->count].hash = config_hash(b->path, path_len);
+    b->count++;
+    return 0;
+}
+
+// Append ".name" (or "name" at the top level) to the key path
+static int config_path_push(struct config_builder* b, size_t path_len, const char* name, size_t len)
+{
+    size_t sep = path_len > 0;
+    if (path_len + sep + len >= CONFIG_KEY_MAX) {
+        b->error = "key too long";
+        return -1;
+    }
+    if (sep)
+        b->path[path_len] = '.';
+    memcpy(b->path + path_len + sep, name, len);
+    b->path[path_len + sep + len] = '\0';
+    return (int)(path_len + sep + len);
+}
+
+static const char* config_skip_ws(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        p++;
+    return p;
+}
+
+static size_t config_put_utf8(char* out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+static int config_hex4(const char* p, const char* end, uint32_t* out)
+{
+    if (end - p < 4)
+        return -1;
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') v |= (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') v |= (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') v |= (uint32_t)(c - 'A' + 10);
+        else return -1;
+    }
+    *out = v;
+    return 0;
+}
+
+// JSON string starting after the opening quote, unescaped into b->scratch
+static const char* config_json_string(struct config_builder* b, const char* p, const char* end, size_t* len)
+{
+    // Unescaping never grows the text (\uXXXX is 6 bytes for at most 4)
+    const char* close = p;
+    while (close < end && *close != '"')
+        close += *close == '\\' ? 2 : 1;
+    if (close >= end || config_grow((void**)&b->scratch, &b->scratch_cap, (size_t)(close - p) + 1, 1) != 0) {
+        b->error = close >= end ? "unterminated string" : "out of memory";
+        b->error_at = p;
+        return NULL;
+    }
+
+    size_t n = 0;
+    while (p < close) {
+        if (*p != '\\') {
+            b->scratch[n++] = *p++;
+            continue;
+        }
+        char c = p[1];
+        p += 2;
+        switch (c) {
+        case '"': case '\\': case '/': b->scratch[n++] = c; break;
+        case 'b': b->scratch[n++] = '\b'; break;
+        case 'f': b->scratch[n++] = '\f'; break;
+        case 'n': b->scratch[n++] = '\n'; break;
+        case 'r': b->scratch[n++] = '\r'; break;
+        case 't': b->scratch[n++] = '\t'; break;
+        case 'u': {
+            uint32_t cp, lo;
+            if (config_hex4(p, close, &cp) != 0)
+                goto bad;
+            p += 4;
+            if (cp >= 0xD800 && cp < 0xDC00 && close - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                config_hex4(p + 2, close, &lo) == 0 && lo >= 0xDC00 && lo < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                p += 6;
+            }
+            n += config_put_utf8(b->scratch + n, cp);
+            break;
+        }
+        default:
+            goto bad;
+        }
+    }
+    b->scratch[n] = '\0';
+    *len = n;
+    return close + 1;
+
+bad:
+    b->error = "bad escape";
+    b->error_at = p;
+    return NULL;
+}
+
+static const char* config_json_value(struct config_builder* b, const char* p, const char* end,
+                                     size_t path_len, int depth)
+{
+    p = config_skip_ws(p, end);
+    if (p >= end || depth > CONFIG_MAX_DEPTH) {
+        b->error = p >= end ? "unexpected end of file" : "nested too deeply";
+        b->error_at = p;
+        return NULL;
+    }
+
+    if (*p == '{' || *p == '[') {
+        char close = *p == '{' ? '}' : ']';
+        p = config_skip_ws(p + 1, end);
+        for (unsigned i = 0; p < end && *p != close; i++) {
+            char name[24];
+            int child;
+            if (close == '}') {
+                size_t len;
+                if (*p != '"' || (p = config_json_string(b, p + 1, end, &len)) == NULL) {
+                    if (b->error == NULL) {
+                        b->error = "expected key";
+                        b->error_at = p;
+                    }
+                    return NULL;
+                }
+                p = config_skip_ws(p, end);
+                if (p >= end || *p != ':') {
+                    b->error = "expected ':'";
+                    b->error_at = p;
+                    return NULL;
+                }
+                p++;
+                child = config_path_push(b, path_len, b->scratch, len);
+            } else {
+                int len = snprintf(name, sizeof(name), "%u", i);
+                child = config_path_push(b, path_len, name, (size_t)len);
+            }
+            if (child < 0 || (p = config_json_value(b, p, end, (size_t)child, depth + 1)) == NULL)
+                return NULL;
+            b->path[path_len] = '\0';
+            p = config_skip_ws(p, end);
+            if (p < end && *p == ',')
+                p = config_skip_ws(p + 1, end);
+            else if (p < end && *p != close)
+                break;
+        }
+        if (p >= end || *p != close) {
+            b->error = close == '}' ? "expected ',' or '}'" : "expected ',' or ']'";
+            b->error_at = p;
+            return NULL;
+        }
+        return p + 1;
+    }
+
+    if (*p == '"') {
+        size_t len;
+        p = config_json_string(b, p + 1, end, &len);
+        return p != NULL && config_add(b, path_len, b->scratch, len) == 0 ? p : NULL;
+    }
+
+    // Number, true, false or null: stored as written
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' &&
+           *p != '\n' && *p != '\r')
+        p++;
+    if (p == start) {
+        b->error = "expected value";
+        b->error_at = p;
+        return NULL;
+    }
+    return config_add(b, path_len, start, (size_t)(p - start)) == 0 ? p : NULL;
+}
+
+static int config_parse_ini(struct config_builder* b, const char* p, const char* end)
+{
+    size_t section_len = 0;
+    b->path[0] = '\0';
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL)
+            eol = end;
+        const char* line = config_skip_ws(p, eol);
+        const char* last = eol;
+        while (last > line && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+            last--;
+        p = eol + 1;
+        if (line == last || *line == ';' || *line == '#')
+            continue;
+
+        if (*line == '[') {
+            if (last[-1] != ']' || last - line < 3) {
+                b->error = "bad section header";
+                b->error_at = line;
+                return -1;
+            }
+            b->path[0] = '\0';
+            int len = config_path_push(b, 0, line + 1, (size_t)(last - line - 2));
+            if (len < 0)
+                return -1;
+            section_len = (size_t)len;
+            continue;
+        }
+
+        const char* eq = memchr(line, '=', (size_t)(last - line));
+        if (eq == NULL) {
+            b->error = "expected key = value";
+            b->error_at = line;
+            return -1;
+        }
+        const char* key_end = eq;
+        while (key_end > line && (key_end[-1] == ' ' || key_end[-1] == '\t'))
+            key_end--;
+        const char* value = config_skip_ws(eq + 1, last);
+        if (last - value >= 2 && (*value == '"' || *value == '\'') && last[-1] == *value) {
+            value++;
+            last--;
+        }
+        b->path[section_len] = '\0';
+        int len = config_path_push(b, section_len, line, (size_t)(key_end - line));
+        if (len < 0 || config_add(b, (size_t)len, value, (size_t)(last - value)) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Pack the builder into one block: header, entries, hash index, pool
+static struct config_table* config_finish(struct config_builder* b)
+{
+    size_t slots = 16;
+    while (slots < b->count * 2)
+        slots *= 2;
+    size_t entries_off = sizeof(struct config_table);
+    size_t index_off = entries_off + b->count * sizeof(struct config_entry);
+    size_t pool_off = index_off + slots * sizeof(uint32_t);
+    struct config_table* table = calloc(1, pool_off + b->pool_len);
+    if (table == NULL)
+        return NULL;
+
+    struct config_entry* entries = (struct config_entry*)((char*)table + entries_off);
+    uint32_t* index = (uint32_t*)((char*)table + index_off);
+    char* pool = (char*)table + pool_off;
+    if (b->pool_len)                    // b->pool is NULL for an empty file
+        memcpy(pool, b->pool, b->pool_len);
+    table->count = 0;
+
+    // A key defined twice keeps its last value
+    for (size_t i = 0; i < b->count; i++) {
+        const struct config_entry* e = &b->entries[i];
+        size_t slot = e->hash & (slots - 1);
+        for (; index[slot] != 0; slot = (slot + 1) & (slots - 1))
+            if (entries[index[slot] - 1].key == e->key)
+                break;
+        if (index[slot] != 0) {
+            entries[index[slot] - 1].value = e->value;
+            continue;
+        }
+        entries[table->count] = *e;
+        index[slot] = (uint32_t)++table->count;
+    }
+
+    table->index_mask = slots - 1;
+    table->pool_len = b->pool_len;
+    table->interned = b->count * 2 - b->interned;
+    table->index = index;
+    table->entries = entries;
+    table->pool = pool;
+    return table;
+}
+
+static int config_line_of(const struct config_builder* b, const char* at)
+{
+    int line = 1;
+    for (const char* p = b->start; at != NULL && p < at; p++)
+        line += *p == '\n';
+    return line;
+}
+
+// Parse filename into a new table, or NULL (logged)
+static struct config_table* config_load(const char* filename)
+{
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        ring_log(LOG_ERROR, "parse_config: cannot open %s", filename);
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    const char* data = "";
+    if (st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ring_log(LOG_ERROR, "parse_config: cannot map %s", filename);
+            close(fd);
+            return NULL;
+        }
+    }
+    close(fd);
+    const char* end = data + st.st_size;
+
+    struct config_builder b;
+    memset(&b, 0, sizeof(b));
+    b.start = data;
+    const char* p = config_skip_ws(data, end);
+    int ok;
+    if (p < end && *p == '{') {
+        p = config_json_value(&b, p, end, 0, 0);
+        ok = p != NULL && config_skip_ws(p, end) == end;
+        if (p != NULL && !ok) {
+            b.error = "trailing data";
+            b.error_at = p;
+        }
+    } else {
+        ok = config_parse_ini(&b, data, end) == 0;
+    }
+
+    struct config_table* table = ok ? config_finish(&b) : NULL;
+    if (!ok)
+        ring_log(LOG_ERROR, "parse_config: %s:%d: %s", filename, config_line_of(&b, b.error_at),
+                 b.error ? b.error : "parse error");
+    if (st.st_size > 0)
+        munmap((void*)data, (size_t)st.st_size);
+    free(b.pool);
+    free(b.entries);
+    free(b.intern);
+    free(b.scratch);
+    return table;
+}
+
+static void config_reader_release(void* arg)
+{
+    struct config_reader* reader = arg;
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+    atomic_store_explicit(&reader->in_use, 0, memory_order_release);
+}
+
+static void config_init_once(void)
+{
+    pthread_key_create(&config_reader_key, config_reader_release);
+}
+
+// Per-thread reader slot; slots of exited threads are reused
+static struct config_reader* config_reader_get(void)
+{
+    if (config_local_reader != NULL)
+        return config_local_reader;
+
+    pthread_once(&config_once, config_init_once);
+    pthread_mutex_lock(&config_readers_lock);
+    struct config_reader* reader = config_readers;
+    for (; reader != NULL; reader = reader->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&reader->in_use, &expected, 1))
+            break;
+    }
+    if (reader == NULL && (reader = calloc(1, sizeof(*reader))) != NULL) {
+        atomic_store(&reader->in_use, 1);
+        reader->next = config_readers;
+        config_readers = reader;
+    }
+    pthread_mutex_unlock(&config_readers_lock);
+
+    if (reader != NULL)
+        pthread_setspecific(config_reader_key, reader);
+    config_local_reader = reader;
+    return reader;
+}
+
+/**
+ * Current table, valid until config_read_end(); NULL before parse_config()
+ *
+ * Never blocks. Read sections must not nest.
+ */
+const struct config_table* config_read_begin(void)
+{
+    struct config_reader* reader = config_reader_get();
+    if (reader == NULL)
+        return NULL;
+    // seq_cst store then load: a reload that swaps the table after this
+    // store is guaranteed to see the epoch and wait for us
+    atomic_store(&reader->epoch, atomic_load(&config_epoch));
+    return atomic_load(&config_current);
+}
+
+void config_read_end(void)
+{
+    if (config_local_reader != NULL)
+        atomic_store_explicit(&config_local_reader->epoch, 0, memory_order_release);
+}
+
+const char* config_lookup(const struct config_table* table, const char* key)
+{
+    if (table == NULL)
+        return NULL;
+    size_t len = strlen(key);
+    size_t slot = config_hash(key, len) & table->index_mask;
+    for (; table->index[slot] != 0; slot = (slot + 1) & table->index_mask) {
+        const struct config_entry* e = &table->entries[table->index[slot] - 1];
+        if (strcmp(table->pool + e->key, key) == 0)
+            return table->pool + e->value;
+    }
+    return NULL;
+}
+
+long config_get_int(const char* key, long fallback)
+{
+    const char* value = config_lookup(config_read_begin(), key);
+    char* end;
+    long result = value != NULL ? strtol(value, &end, 0) : fallback;
+    if (value != NULL && (end == value || *end != '\0'))
+        result = fallback;
+    config_read_end();
+    return result;
+}
+
+// Copy key's value into out; returns its length, or -1 if unset
+int config_get_string(const char* key, char* out, size_t cap)
+{
+    const char* value = config_lookup(config_read_begin(), key);
+    int len = value != NULL ? snprintf(out, cap, "%s", value) : -1;
+    config_read_end();
+    return len;
+}
+
+// Swap in table (NULL to clear) and free the one it replaces once no reader
+// can still hold it. Caller holds config_write_lock and is not a reader.
+static void config_publish(struct config_table* table)
+{
+    if (table != NULL)
+        table->generation = atomic_fetch_add(&config_generation, 1) + 1;
+    struct config_table* old = atomic_exchange(&config_current, table);
+    uint64_t retire = atomic_fetch_add(&config_epoch, 1) + 1;
+    if (old == NULL)
+        return;
+
+    pthread_mutex_lock(&config_readers_lock);
+    for (struct config_reader* reader = config_readers; reader != NULL; reader = reader->next) {
+        uint64_t epoch;
+        while ((epoch = atomic_load(&reader->epoch)) != 0 && epoch < retire)
+            sched_yield();
+    }
+    pthread_mutex_unlock(&config_readers_lock);
+    free(old);
+}
+
+static int config_reload(void)
+{
+    struct config_table* table = config_load(config_path);
+    if (table == NULL)
+        return -1;
+    pthread_mutex_lock(&config_write_lock);
+    config_publish(table);
+    pthread_mutex_unlock(&config_write_lock);
+    return 0;
+}
+
+// Watches the directory, since editors and deploy tools replace files by rename
+static void* config_watch_main(void* arg)
+{
+    int fd = (int)(intptr_t)arg;
+    const char* slash = strrchr(config_path, '/');
+    const char* name = slash ? slash + 1 : config_path;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (!atomic_load(&config_stop)) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, CONFIG_POLL_MS) <= 0)
+            continue;
+        ssize_t n = read(fd, buf, sizeof(buf));
+        int changed = 0;
+        for (char* p = buf; n > 0 && p < buf + n; ) {
+            struct inotify_event* ev = (struct inotify_event*)p;
+            if (ev->len > 0 && strcmp(ev->name, name) == 0)
+                changed = 1;
+            p += sizeof(*ev) + ev->len;
+        }
+        if (changed && config_reload() == 0)
+            ring_log(LOG_INFO, "parse_config: reloaded %s (generation %llu)", config_path,
+                     (unsigned long long)atomic_load(&config_generation));
+    }
+    close(fd);
+    return NULL;
+}
+
+static void config_watch_start(void)
+{
+    char dir[sizeof(config_path)];
+    snprintf(dir, sizeof(dir), "%s", config_path);
+    char* slash = strrchr(dir, '/');
+    if (slash == dir)
+        slash[1] = '\0';
+    else if (slash != NULL)
+        *slash = '\0';
+    else
+        snprintf(dir, sizeof(dir), ".");
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        ring_log(LOG_WARN, "parse_config: cannot watch %s, changes need a restart", dir);
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+    atomic_store(&config_stop, 0);
+    config_watching = pthread_create(&config_watcher, NULL, config_watch_main, (void*)(intptr_t)fd) == 0;
+    if (!config_watching)
+        close(fd);
+}
+
+/**
+ * Load filename (INI or JSON) as the process-wide config and watch it
+ *
+ * Later calls with the same file just reload it. Returns -1 (keeping any
+ * previous table) if the file can't be read or parsed. Must not be called
+ * inside a read section.
+ */
 int parse_config(const char* filename)
 {
-    // Completed implementation
+    struct config_table* table = config_load(filename);
+    if (table == NULL)
+        return -1;
+
+    pthread_mutex_lock(&config_write_lock);
+    int same = strcmp(config_path, filename) == 0;
+    if (!same) {
+        // The watcher reads config_path; stop it before switching files
+        if (config_watching) {
+            atomic_store(&config_stop, 1);
+            pthread_join(config_watcher, NULL);
+            config_watching = 0;
+        }
+        snprintf(config_path, sizeof(config_path), "%s", filename);
+    }
+    config_publish(table);
+    pthread_mutex_unlock(&config_write_lock);
+
+    if (!same || !config_watching)
+        config_watch_start();
     return 0;
 }
 
+void config_shutdown(void)
+{
+    if (config_watching) {
+        atomic_store(&config_stop, 1);
+        pthread_join(config_watcher, NULL);
+        config_watching = 0;
+    }
+    pthread_mutex_lock(&config_write_lock);
+    config_publish(NULL);
+    config_path[0] = '\0';
+    pthread_mutex_unlock(&config_write_lock);
+}
+
+void config_print_stats(void)
+{
+    const struct config_table* table = config_read_begin();
+    if (table != NULL)
+        printf("Config: %zu keys, %zu pool bytes, %zu strings shared, generation %llu\n",
+               table->count, table->pool_len, table->interned, (unsigned long long)table->generation);
+    config_read_end();
+}
+
 // Example 7: Critical task with bounty
 // AI_PHASE: SECURITY_MODULE
 // AI_STATUS: NOT_STARTED
@@ -127,15 +1714,90 @@ void security_init(void)
     // TODO: Critical security implementation
 }
 
+// benchmarks/bench_hot_paths.c includes this file for the functions above
+#ifndef DISTRIBUTED_AI_NO_MAIN
 int main(int argc, char** argv)
 {
     printf("Distributed AI Development Example\n");
     printf("Demonstrating breadcrumb usage for multi-agent coordination\n");
     
     system_init();
+    log_message("Distributed AI example started");
+    
+    // Exercise the memory manager across several size classes
+    ring_log_span_begin("memory");
+    void* blocks[64];
+    for (int i = 0; i < 64; i++)
+        blocks[i] = memory_alloc((size_t)(i + 1) * 24);
+    for (int i = 0; i < 64; i++)
+        memory_free(blocks[i]);
+    ring_log_span_end("memory");
+    memory_print_stats();
+    
+    // Ship small records and one large pool buffer over a local socket pair
+    int sv[2];
+    ring_log_span_begin("network");
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+        network_attach(sv[0]);
+        char record[64];
+        size_t expected = 0;
+        for (int i = 0; i < 100; i++) {
+            int n = snprintf(record, sizeof(record), "compile result %d\n", i);
+            network_send(record, (size_t)n);
+            expected += (size_t)n;
+        }
+        char* result = network_buffer_alloc(32 * 1024);
+        if (result != NULL) {
+            memset(result, 'x', 32 * 1024);
+            network_send_buffer(result, 32 * 1024);
+            expected += 32 * 1024;
+        }
+        network_close();
+        
+        size_t received = 0;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(sv[1], buf, sizeof(buf))) > 0)
+            received += (size_t)n;
+        close(sv[1]);
+        ring_log(received == expected ? LOG_INFO : LOG_ERROR,
+                 "network: received %zu of %zu bytes", received, expected);
+        network_print_stats();
+    }
+    ring_log_span_end("network");
+    
+    // Warm the shader cache; a second run loads every binary from disk
+    static const char* const shaders[] = {
+        "#version 450\nlayout(location = 0) in vec3 pos;\nvoid main() { gl_Position = vec4(pos, 1.0); }\n",
+        "#version 450\nlayout(location = 0) out vec4 color;\nvoid main() { color = vec4(1.0); }\n",
+        "#version 450\nlayout(local_size_x = 64) in;\nvoid main() { /* clear */ }\n",
+    };
+    ring_log_span_begin("shader_cache");
+    for (size_t i = 0; i < sizeof(shaders) / sizeof(shaders[0]); i++)
+        compile_shader(shaders[i]);
+    shader_service_shutdown();
+    ring_log_span_end("shader_cache");
+    shader_service_print_stats();
+    
+    // Parse the shared config once; edits are picked up by the watcher
+    const char* config_file = argc > 1 ? argv[1] : "../config/config.json";
+    ring_log_span_begin("parse_config");
+    int config_status = parse_config(config_file);
+    ring_log_span_end("parse_config");
+    if (config_status == 0) {
+        char model[128];
+        if (config_get_string("training.model_base", model, sizeof(model)) < 0)
+            snprintf(model, sizeof(model), "(unset)");
+        printf("Config %s: model_base %s, max_iterations %ld, ui port %ld\n", config_file, model,
+               config_get_int("compiler_loop.max_iterations", 0), config_get_int("ui.port", 0));
+        config_print_stats();
+        config_shutdown();
+    }
     
     // Other components will be implemented by distributed AI agents
     // based on priority, dependencies, and complexity
     
+    ring_log_flush();
     return 0;
 }
+#endif // DISTRIBUTED_AI_NO_MAIN
@@ -0,0 +1,786 @@
+/**
+ * Lock-free ring buffer logger
+ *
+ * Each logging thread owns a single-producer/single-consumer ring of
+ * fixed-size records; one background thread drains every ring, orders the
+ * records by timestamp and writes them out with one write() per round.
+ * A call site only takes a timestamp and copies its arguments: formatting is
+ * deferred to the drain thread, so the format string must outlive the
+ * program (use string literals). %s arguments are copied at the call.
+ *
+ * Nothing here blocks a caller: when a thread's ring is full the record is
+ * dropped and counted, and the drain thread reports the drops.
+ *
+ * When AROS_TRACE_FILE is set (src/tracing.py does this for the processes it
+ * launches) the drain thread also appends Chrome trace events to that file:
+ * one instant event per log record and the spans marked with
+ * ring_log_span_begin()/ring_log_span_end(). Timestamps are CLOCK_REALTIME
+ * like the Python side's, and AROS_TRACE_PARENT names the Python span the
+ * process runs under. Without the variable a span call is one pthread_once
+ * check.
+ *
+ * Header-only so the standalone examples keep building with a plain
+ * `gcc file.c -pthread`.
+ */
+
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+enum log_level {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR
+};
+
+#define RING_LOG_RECORD_SIZE    256
+#define RING_LOG_CAPACITY       512             // Records per thread, power of two
+#define RING_LOG_BATCH          4096            // Records formatted per drain round
+#define RING_LOG_IDLE_NS        1000000         // Drain thread poll interval when idle
+#define RING_LOG_LINE_MAX       1024
+#define RING_LOG_TRACE_ENV      "AROS_TRACE_FILE"
+#define RING_LOG_TRACE_PARENT_ENV "AROS_TRACE_PARENT"
+
+enum ring_log_kind {
+    RING_LOG_MESSAGE,
+    RING_LOG_SPAN_BEGIN,
+    RING_LOG_SPAN_END
+};
+
+struct ring_log_record {
+    uint64_t timestamp_ns;
+    const char* fmt;                            // NULL: data is the message text
+    uint32_t thread;
+    uint16_t len;                               // Bytes of data used
+    uint8_t level;
+    uint8_t truncated;
+    uint8_t kind;                               // enum ring_log_kind
+    unsigned char data[RING_LOG_RECORD_SIZE - 25];
+};
+
+_Static_assert(sizeof(struct ring_log_record) == RING_LOG_RECORD_SIZE, "ring_log record size");
+
+// head is only written by the drain thread and tail by the owning thread,
+// so they sit on separate cache lines
+struct ring_log_ring {
+    _Atomic uint32_t head;
+    char pad_head[60];
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;
+    char pad_tail[56];
+    uint32_t id;
+    uint32_t dropped_reported;
+    _Atomic int retired;
+    struct ring_log_ring* next;
+    struct ring_log_record records[RING_LOG_CAPACITY];
+};
+
+static struct {
+    pthread_once_t once;
+    pthread_key_t key;
+    pthread_mutex_t lock;                       // Ring list; never taken on the logging path
+    struct ring_log_ring* rings;
+    uint32_t next_id;
+    _Atomic int min_level;
+    int fd;
+    int owns_fd;
+    int trace_fd;                               // -1: not tracing
+    int trace_pid;
+    char trace_parent[24];                      // Python span id, digits only
+
+    pthread_t thread;
+    _Atomic int running;
+    _Atomic int stop;
+
+    pthread_mutex_t flush_lock;
+    pthread_cond_t flush_cond;
+    uint64_t flush_requested;
+    uint64_t flush_done;
+} ring_log_state = {
+    .once = PTHREAD_ONCE_INIT,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .min_level = LOG_INFO,
+    .fd = 2,
+    .trace_fd = -1,
+    .flush_lock = PTHREAD_MUTEX_INITIALIZER,
+    .flush_cond = PTHREAD_COND_INITIALIZER
+};
+
+static __thread struct ring_log_ring* ring_log_local;
+
+static inline void ring_log_shutdown(void);
+static void* ring_log_drain_main(void* arg);
+
+static inline uint64_t ring_log_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Thread exit: the drain thread frees the ring once it is empty
+static void ring_log_retire(void* arg)
+{
+    struct ring_log_ring* ring = arg;
+    atomic_store_explicit(&ring->retired, 1, memory_order_release);
+}
+
+// Tracing is decided once per process, from the environment
+static void ring_log_trace_open(void)
+{
+    const char* path = getenv(RING_LOG_TRACE_ENV);
+    if (path == NULL || *path == '\0')
+        return;
+    ring_log_state.trace_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    ring_log_state.trace_pid = (int)getpid();
+
+    const char* parent = getenv(RING_LOG_TRACE_PARENT_ENV);
+    if (parent != NULL && *parent != '\0' && strlen(parent) < sizeof(ring_log_state.trace_parent) &&
+        strspn(parent, "0123456789") == strlen(parent))
+        strcpy(ring_log_state.trace_parent, parent);
+}
+
+static void ring_log_start(void)
+{
+    ring_log_trace_open();
+    pthread_key_create(&ring_log_state.key, ring_log_retire);
+    atomic_store(&ring_log_state.running, 1);
+    if (pthread_create(&ring_log_state.thread, NULL, ring_log_drain_main, NULL) != 0) {
+        atomic_store(&ring_log_state.running, 0);
+        return;
+    }
+    atexit(ring_log_shutdown);
+}
+
+static inline struct ring_log_ring* ring_log_ring_get(void)
+{
+    if (ring_log_local != NULL)
+        return ring_log_local;
+
+    pthread_once(&ring_log_state.once, ring_log_start);
+    struct ring_log_ring* ring = calloc(1, sizeof(*ring));
+    if (ring == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&ring_log_state.lock);
+    ring->id = ring_log_state.next_id++;
+    ring->next = ring_log_state.rings;
+    ring_log_state.rings = ring;
+    pthread_mutex_unlock(&ring_log_state.lock);
+
+    pthread_setspecific(ring_log_state.key, ring);
+    ring_log_local = ring;
+    return ring;
+}
+
+// Reserve the next record of this thread's ring, or NULL (full)
+static inline struct ring_log_record* ring_log_reserve(struct ring_log_ring** ring_out, int level, int kind)
+{
+    struct ring_log_ring* ring = ring_log_ring_get();
+    if (ring == NULL)
+        return NULL;
+
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head == RING_LOG_CAPACITY) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    struct ring_log_record* rec = &ring->records[tail & (RING_LOG_CAPACITY - 1)];
+    rec->timestamp_ns = ring_log_now();
+    rec->thread = ring->id;
+    rec->level = (uint8_t)level;
+    rec->truncated = 0;
+    rec->kind = (uint8_t)kind;
+    *ring_out = ring;
+    return rec;
+}
+
+// Reserve a message record, or NULL (filtered or full)
+static inline struct ring_log_record* ring_log_claim(struct ring_log_ring** ring_out, int level)
+{
+    if (level < atomic_load_explicit(&ring_log_state.min_level, memory_order_relaxed))
+        return NULL;
+    return ring_log_reserve(ring_out, level, RING_LOG_MESSAGE);
+}
+
+static inline void ring_log_publish(struct ring_log_ring* ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+// Walk fmt's conversions and copy each argument: 8-byte slots for numbers
+// and pointers, length-prefixed bytes for strings
+static inline size_t ring_log_pack(struct ring_log_record* rec, const char* fmt, va_list ap)
+{
+    unsigned char* out = rec->data;
+    size_t cap = sizeof(rec->data), used = 0;
+
+#define RING_LOG_PUT(value) do { \
+        __typeof__(value) v_ = (value); \
+        if (used + sizeof(v_) > cap) { rec->truncated = 1; return used; } \
+        memcpy(out + used, &v_, sizeof(v_)); \
+        used += sizeof(v_); \
+    } while (0)
+
+    for (const char* p = fmt; *p != '\0'; p++) {
+        if (*p != '%')
+            continue;
+        p++;
+        if (*p == '%')
+            continue;
+
+        while (*p != '\0' && strchr("-+ #0'", *p) != NULL)
+            p++;
+        // Width, then precision; a negative * precision counts as none
+        long long precision = -1;
+        for (; (*p >= '0' && *p <= '9') || *p == '.' || *p == '*'; p++) {
+            if (*p == '.') {
+                precision = 0;
+            } else if (*p == '*') {
+                int arg = va_arg(ap, int);
+                RING_LOG_PUT((long long)arg);
+                if (precision == 0)
+                    precision = arg;
+            } else if (precision >= 0 && precision < 1000000) {
+                precision = precision * 10 + (*p - '0');
+            }
+        }
+
+        int longness = 0;               // 0 int, 1 long, 2 long long, 3 size_t, 4 intmax_t, 5 ptrdiff_t
+        int long_double = 0;
+        for (;; p++) {
+            if (*p == 'h') continue;
+            else if (*p == 'l') longness = longness == 1 ? 2 : 1;
+            else if (*p == 'z') longness = 3;
+            else if (*p == 'j') longness = 4;
+            else if (*p == 't') longness = 5;
+            else if (*p == 'L') long_double = 1;
+            else break;
+        }
+
+        switch (*p) {
+        case 'd': case 'i':
+            switch (longness) {
+            case 1: RING_LOG_PUT((long long)va_arg(ap, long)); break;
+            case 2: RING_LOG_PUT((long long)va_arg(ap, long long)); break;
+            case 3: RING_LOG_PUT((long long)va_arg(ap, ssize_t)); break;
+            case 4: RING_LOG_PUT((long long)va_arg(ap, intmax_t)); break;
+            case 5: RING_LOG_PUT((long long)va_arg(ap, ptrdiff_t)); break;
+            default: RING_LOG_PUT((long long)va_arg(ap, int)); break;
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            switch (longness) {
+            case 1: RING_LOG_PUT((unsigned long long)va_arg(ap, unsigned long)); break;
+            case 2: RING_LOG_PUT((unsigned long long)va_arg(ap, unsigned long long)); break;
+            case 3: RING_LOG_PUT((unsigned long long)va_arg(ap, size_t)); break;
+            case 4: RING_LOG_PUT((unsigned long long)va_arg(ap, uintmax_t)); break;
+            case 5: RING_LOG_PUT((unsigned long long)va_arg(ap, ptrdiff_t)); break;
+            default: RING_LOG_PUT((unsigned long long)va_arg(ap, unsigned int)); break;
+            }
+            break;
+        case 'c':
+            RING_LOG_PUT((long long)va_arg(ap, int));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (long_double)
+                RING_LOG_PUT((double)va_arg(ap, long double));
+            else
+                RING_LOG_PUT(va_arg(ap, double));
+            break;
+        case 'p':
+            RING_LOG_PUT(va_arg(ap, void*));
+            break;
+        case 's': {
+            const char* s = va_arg(ap, const char*);
+            if (s == NULL)
+                s = "(null)";
+            // %.*s may point at a buffer without a terminator
+            size_t len = precision >= 0 ? strnlen(s, (size_t)precision) : strlen(s);
+            if (used + sizeof(uint16_t) + 1 > cap) {
+                rec->truncated = 1;
+                return used;
+            }
+            size_t room = cap - used - sizeof(uint16_t) - 1;
+            if (len > room) {
+                len = room;
+                rec->truncated = 1;
+            }
+            uint16_t n = (uint16_t)len;
+            memcpy(out + used, &n, sizeof(n));
+            memcpy(out + used + sizeof(n), s, len);
+            out[used + sizeof(n) + len] = '\0';
+            used += sizeof(n) + len + 1;
+            break;
+        }
+        case 'n':
+            // Never written back; drop the pointer
+            (void)va_arg(ap, void*);
+            break;
+        case '\0':
+            return used;
+        default:
+            break;
+        }
+    }
+#undef RING_LOG_PUT
+    return used;
+}
+
+// Log with deferred formatting; fmt must be a string literal
+__attribute__((format(printf, 2, 3)))
+static inline void ring_log(int level, const char* fmt, ...)
+{
+    struct ring_log_ring* ring;
+    struct ring_log_record* rec = ring_log_claim(&ring, level);
+    if (rec == NULL)
+        return;
+
+    va_list ap;
+    va_start(ap, fmt);
+    rec->fmt = fmt;
+    rec->len = (uint16_t)ring_log_pack(rec, fmt, ap);
+    va_end(ap);
+    ring_log_publish(ring);
+}
+
+// Log a message that is already text (copied; may be any string)
+static inline void ring_log_str(int level, const char* msg)
+{
+    struct ring_log_ring* ring;
+    struct ring_log_record* rec = ring_log_claim(&ring, level);
+    if (rec == NULL)
+        return;
+
+    size_t len = strlen(msg);
+    if (len > sizeof(rec->data)) {
+        len = sizeof(rec->data);
+        rec->truncated = 1;
+    }
+    memcpy(rec->data, msg, len);
+    rec->fmt = NULL;
+    rec->len = (uint16_t)len;
+    ring_log_publish(ring);
+}
+
+// Nonzero when this process writes a trace (AROS_TRACE_FILE was set)
+static inline int ring_log_tracing(void)
+{
+    pthread_once(&ring_log_state.once, ring_log_start);
+    return ring_log_state.trace_fd >= 0;
+}
+
+static inline void ring_log_span_mark(int kind, const char* name)
+{
+    if (!ring_log_tracing())
+        return;
+
+    // Spans ignore the level filter; a full ring drops them like messages
+    struct ring_log_ring* ring;
+    struct ring_log_record* rec = ring_log_reserve(&ring, LOG_DEBUG, kind);
+    if (rec == NULL)
+        return;
+
+    size_t len = strlen(name);
+    if (len > sizeof(rec->data))
+        len = sizeof(rec->data);
+    memcpy(rec->data, name, len);
+    rec->fmt = NULL;
+    rec->len = (uint16_t)len;
+    ring_log_publish(ring);
+}
+
+// Start a span named name on this thread's timeline; pair with
+// ring_log_span_end() on the same thread. Spans nest.
+static inline void ring_log_span_begin(const char* name)
+{
+    ring_log_span_mark(RING_LOG_SPAN_BEGIN, name);
+}
+
+static inline void ring_log_span_end(const char* name)
+{
+    ring_log_span_mark(RING_LOG_SPAN_END, name);
+}
+
+// Re-run the conversions of rec->fmt against the packed arguments
+static size_t ring_log_render(const struct ring_log_record* rec, char* out, size_t cap)
+{
+    if (rec->fmt == NULL) {
+        size_t n = rec->len < cap ? rec->len : cap;
+        memcpy(out, rec->data, n);
+        return n;
+    }
+
+    const unsigned char* in = rec->data;
+    size_t avail = rec->len, pos = 0;
+    size_t written = 0;
+
+#define RING_LOG_EMIT(...) do { \
+        int n_ = snprintf(out + written, cap - written, __VA_ARGS__); \
+        if (n_ > 0) \
+            written += (size_t)n_ < cap - written ? (size_t)n_ : cap - written - 1; \
+    } while (0)
+#define RING_LOG_TAKE(var) \
+    (pos + sizeof(var) <= avail ? (memcpy(&(var), in + pos, sizeof(var)), pos += sizeof(var), 1) : 0)
+
+    for (const char* p = rec->fmt; *p != '\0' && written + 1 < cap; p++) {
+        if (*p != '%') {
+            out[written++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[written++] = '%';
+            p++;
+            continue;
+        }
+
+        // Rebuild the conversion with '*' resolved and lengths widened
+        char spec[48];
+        size_t s = 0;
+        spec[s++] = '%';
+        p++;
+        while (*p != '\0' && strchr("-+ #0'", *p) != NULL && s < 16)
+            spec[s++] = *p++;
+        for (; ((*p >= '0' && *p <= '9') || *p == '.' || *p == '*') && s < 40; p++) {
+            if (*p == '*') {
+                long long v = 0;
+                RING_LOG_TAKE(v);
+                if (v < 0 && spec[s - 1] == '.')
+                    s--;                // Negative precision: as if omitted
+                else
+                    s += (size_t)snprintf(spec + s, sizeof(spec) - s, "%d", (int)v);
+            } else {
+                spec[s++] = *p;
+            }
+        }
+        while (*p != '\0' && strchr("hlzjtL", *p) != NULL)
+            p++;
+        if (*p == '\0')
+            break;
+
+        char conv = *p;
+        int ok = 1;
+        switch (conv) {
+        case 'd': case 'i': case 'c': {
+            long long v;
+            if (!(ok = RING_LOG_TAKE(v)))
+                break;
+            if (conv == 'c') {
+                spec[s++] = 'c';
+                spec[s] = '\0';
+                RING_LOG_EMIT(spec, (int)v);
+            } else {
+                spec[s++] = 'l';
+                spec[s++] = 'l';
+                spec[s++] = 'd';
+                spec[s] = '\0';
+                RING_LOG_EMIT(spec, v);
+            }
+            break;
+        }
+        case 'u': case 'o': case 'x': case 'X': {
+            unsigned long long v;
+            if (!(ok = RING_LOG_TAKE(v)))
+                break;
+            spec[s++] = 'l';
+            spec[s++] = 'l';
+            spec[s++] = conv;
+            spec[s] = '\0';
+            RING_LOG_EMIT(spec, v);
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+            double v;
+            if (!(ok = RING_LOG_TAKE(v)))
+                break;
+            spec[s++] = conv;
+            spec[s] = '\0';
+            RING_LOG_EMIT(spec, v);
+            break;
+        }
+        case 'p': {
+            void* v;
+            if (!(ok = RING_LOG_TAKE(v)))
+                break;
+            spec[s++] = 'p';
+            spec[s] = '\0';
+            RING_LOG_EMIT(spec, v);
+            break;
+        }
+        case 's': {
+            uint16_t n;
+            if (!(ok = RING_LOG_TAKE(n)) || pos + n + 1 > avail) {
+                ok = 0;
+                break;
+            }
+            spec[s++] = 's';
+            spec[s] = '\0';
+            RING_LOG_EMIT(spec, (const char*)in + pos);
+            pos += n + 1;
+            break;
+        }
+        default:
+            break;
+        }
+        if (!ok)
+            break;              // Arguments were truncated at the call site
+    }
+#undef RING_LOG_TAKE
+#undef RING_LOG_EMIT
+    return written;
+}
+
+static const char* const ring_log_level_names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+
+static int ring_log_compare(const void* a, const void* b)
+{
+    const struct ring_log_record* ra = *(const struct ring_log_record* const*)a;
+    const struct ring_log_record* rb = *(const struct ring_log_record* const*)b;
+    return (ra->timestamp_ns > rb->timestamp_ns) - (ra->timestamp_ns < rb->timestamp_ns);
+}
+
+static void ring_log_write_all(int fd, const char* buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n <= 0)
+            return;
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+// s as the inside of a JSON string, cut short rather than overrun out
+static size_t ring_log_json_escape(char* out, size_t cap, const char* s, size_t len)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < len && n + 7 <= cap; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            out[n++] = '\\';
+            out[n++] = (char)c;
+        } else if (c < 0x20) {
+            n += (size_t)snprintf(out + n, cap - n, "\\u%04x", c);
+        } else {
+            out[n++] = (char)c;
+        }
+    }
+    return n;
+}
+
+// One Chrome trace event line: a span edge, or an instant event for a message
+static size_t ring_log_trace_event(char* out, size_t cap, const struct ring_log_record* rec,
+                                   const char* name, size_t name_len)
+{
+    static const char phases[] = { 'i', 'B', 'E' };
+    size_t n = (size_t)snprintf(out, cap, "{\"name\":\"");
+    n += ring_log_json_escape(out + n, cap - n - 192, name, name_len);
+    n += (size_t)snprintf(out + n, cap - n,
+                          "\",\"cat\":\"native\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":%d,\"tid\":%u",
+                          phases[rec->kind % 3], (unsigned long long)(rec->timestamp_ns / 1000),
+                          (unsigned)(rec->timestamp_ns % 1000), ring_log_state.trace_pid, rec->thread);
+    if (rec->kind == RING_LOG_MESSAGE)
+        n += (size_t)snprintf(out + n, cap - n, ",\"s\":\"t\",\"args\":{\"level\":\"%s\"%s%s%s}",
+                              ring_log_level_names[rec->level & 3],
+                              ring_log_state.trace_parent[0] ? ",\"parent\":\"" : "",
+                              ring_log_state.trace_parent, ring_log_state.trace_parent[0] ? "\"" : "");
+    else if (ring_log_state.trace_parent[0])
+        n += (size_t)snprintf(out + n, cap - n, ",\"args\":{\"parent\":\"%s\"}", ring_log_state.trace_parent);
+    n += (size_t)snprintf(out + n, cap - n, "}\n");
+    return n;
+}
+
+// One drain round: every record published so far, in timestamp order.
+// Only the drain thread calls this. Returns the number of records written.
+static size_t ring_log_drain_once(void)
+{
+    static const struct ring_log_record* batch[RING_LOG_BATCH];
+    static struct ring_log_ring* owners[RING_LOG_BATCH];
+    static char out[64 * 1024];
+    static char trace[64 * 1024];
+    size_t count = 0, used = 0, traced = 0;
+    int trace_fd = ring_log_state.trace_fd;
+
+    pthread_mutex_lock(&ring_log_state.lock);
+    for (struct ring_log_ring* ring = ring_log_state.rings; ring != NULL; ring = ring->next) {
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        for (; head != tail && count < RING_LOG_BATCH; head++) {
+            batch[count] = &ring->records[head & (RING_LOG_CAPACITY - 1)];
+            owners[count++] = ring;
+        }
+
+        // A report that does not fit waits for the next round
+        uint32_t dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+        if (dropped != ring->dropped_reported && sizeof(out) - used >= RING_LOG_LINE_MAX) {
+            used += (size_t)snprintf(out + used, sizeof(out) - used,
+                                     "[ring_log] thread %u dropped %u records (ring full)\n",
+                                     ring->id, dropped - ring->dropped_reported);
+            ring->dropped_reported = dropped;
+        }
+    }
+    // Registration must not wait on the writes below. The collected rings
+    // stay valid unlocked because only this thread frees them.
+    pthread_mutex_unlock(&ring_log_state.lock);
+
+    qsort(batch, count, sizeof(batch[0]), ring_log_compare);
+    for (size_t i = 0; i < count; i++) {
+        const struct ring_log_record* rec = batch[i];
+        if (trace_fd >= 0 && sizeof(trace) - traced < 2 * RING_LOG_LINE_MAX) {
+            ring_log_write_all(trace_fd, trace, traced);
+            traced = 0;
+        }
+        if (rec->kind != RING_LOG_MESSAGE) {
+            if (trace_fd >= 0)
+                traced += ring_log_trace_event(trace + traced, sizeof(trace) - traced, rec,
+                                               (const char*)rec->data, rec->len);
+            continue;
+        }
+        if (sizeof(out) - used < RING_LOG_LINE_MAX) {
+            ring_log_write_all(ring_log_state.fd, out, used);
+            used = 0;
+        }
+
+        time_t secs = (time_t)(rec->timestamp_ns / 1000000000u);
+        struct tm tm;
+        localtime_r(&secs, &tm);
+        char* line = out + used;
+        size_t n = strftime(line, RING_LOG_LINE_MAX, "[%Y-%m-%d %H:%M:%S", &tm);
+        n += (size_t)snprintf(line + n, RING_LOG_LINE_MAX - n, ".%06u] %-5s [t%u] ",
+                              (unsigned)(rec->timestamp_ns % 1000000000u / 1000),
+                              ring_log_level_names[rec->level & 3], rec->thread);
+        size_t text = n;
+        n += ring_log_render(rec, line + n, RING_LOG_LINE_MAX - n - 16);
+        if (trace_fd >= 0)
+            traced += ring_log_trace_event(trace + traced, sizeof(trace) - traced, rec, line + text, n - text);
+        if (rec->truncated)
+            n += (size_t)snprintf(line + n, RING_LOG_LINE_MAX - n, " [...]");
+        line[n++] = '\n';
+        used += n;
+    }
+    if (used > 0)
+        ring_log_write_all(ring_log_state.fd, out, used);
+    if (traced > 0)
+        ring_log_write_all(trace_fd, trace, traced);
+
+    // Hand the slots back, then free rings of exited threads once empty
+    for (size_t i = 0; i < count; i++)
+        atomic_fetch_add_explicit(&owners[i]->head, 1, memory_order_release);
+
+    pthread_mutex_lock(&ring_log_state.lock);
+    for (struct ring_log_ring** link = &ring_log_state.rings; *link != NULL; ) {
+        struct ring_log_ring* ring = *link;
+        if (atomic_load_explicit(&ring->retired, memory_order_acquire) &&
+            atomic_load_explicit(&ring->head, memory_order_relaxed) ==
+            atomic_load_explicit(&ring->tail, memory_order_acquire)) {
+            *link = ring->next;
+            free(ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&ring_log_state.lock);
+    return count;
+}
+
+static void* ring_log_drain_main(void* arg)
+{
+    (void)arg;
+    while (!atomic_load(&ring_log_state.stop)) {
+        pthread_mutex_lock(&ring_log_state.flush_lock);
+        uint64_t requested = ring_log_state.flush_requested;
+        pthread_mutex_unlock(&ring_log_state.flush_lock);
+
+        size_t drained = ring_log_drain_once();
+
+        pthread_mutex_lock(&ring_log_state.flush_lock);
+        ring_log_state.flush_done = requested;
+        pthread_cond_broadcast(&ring_log_state.flush_cond);
+        int pending = ring_log_state.flush_requested != requested;
+        pthread_mutex_unlock(&ring_log_state.flush_lock);
+
+        if (drained == 0 && !pending) {
+            struct timespec idle = { 0, RING_LOG_IDLE_NS };
+            nanosleep(&idle, NULL);
+        }
+    }
+    // Everything published before stop was set
+    while (ring_log_drain_once() > 0)
+        ;
+    return NULL;
+}
+
+// Send output to path (appended) instead of stderr and set the minimum level
+static inline int ring_log_init(const char* path, int min_level)
+{
+    atomic_store(&ring_log_state.min_level, min_level);
+    if (path != NULL) {
+        int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return -1;
+        ring_log_state.fd = fd;
+        ring_log_state.owns_fd = 1;
+    }
+    pthread_once(&ring_log_state.once, ring_log_start);
+    return 0;
+}
+
+static inline void ring_log_set_level(int min_level)
+{
+    atomic_store(&ring_log_state.min_level, min_level);
+}
+
+// Wait until everything logged before this call has been written
+static inline void ring_log_flush(void)
+{
+    if (!atomic_load(&ring_log_state.running))
+        return;
+
+    pthread_mutex_lock(&ring_log_state.flush_lock);
+    uint64_t ticket = ++ring_log_state.flush_requested;
+    while (ring_log_state.flush_done < ticket && !atomic_load(&ring_log_state.stop))
+        pthread_cond_wait(&ring_log_state.flush_cond, &ring_log_state.flush_lock);
+    pthread_mutex_unlock(&ring_log_state.flush_lock);
+}
+
+// Drain what is left and stop the drain thread (also run at exit)
+static inline void ring_log_shutdown(void)
+{
+    if (!atomic_exchange(&ring_log_state.running, 0))
+        return;
+
+    atomic_store(&ring_log_state.stop, 1);
+    pthread_join(ring_log_state.thread, NULL);
+
+    pthread_mutex_lock(&ring_log_state.flush_lock);
+    pthread_cond_broadcast(&ring_log_state.flush_cond);
+    pthread_mutex_unlock(&ring_log_state.flush_lock);
+
+    if (ring_log_state.owns_fd) {
+        close(ring_log_state.fd);
+        ring_log_state.fd = 2;
+        ring_log_state.owns_fd = 0;
+    }
+    if (ring_log_state.trace_fd >= 0) {
+        close(ring_log_state.trace_fd);
+        ring_log_state.trace_fd = -1;
+    }
+}
+
+#endif /* RING_LOG_H */
@@ -0,0 +1,648 @@
+/**
+ * Shader compilation service with a persistent binary cache
+ *
+ * Shaders are compiled on a pool of worker threads, so a whole pipeline's
+ * worth of sources compiles concurrently. Every binary is stored on disk
+ * under a 128-bit hash of (source, GPU family, compiler version): the next
+ * start loads it instead of compiling, and a new driver or compiler
+ * version simply misses. Identical sources submitted while one is still in
+ * flight share a single compile.
+ *
+ * The compiler itself is a backend hook. The built-in reference backend
+ * only tokenizes and validates the source into a deterministic blob, which
+ * is enough to exercise the service in the examples; a real driver plugs
+ * its LLVM lowering in through shader_service_init().
+ *
+ * Header-only so the standalone examples keep building with a plain
+ * `gcc file.c -pthread`.
+ */
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ring_log.h"
+
+#define SHADER_CACHE_MAGIC      0x43444853u     // "SHDC"
+#define SHADER_FORMAT_VERSION   1               // Bump when the file layout changes
+#define SHADER_MAX_WORKERS      16
+#define SHADER_TABLE_SIZE       256             // In-flight buckets, power of two
+#define SHADER_PATH_MAX         512
+#define SHADER_ERROR_MAX        128
+#define SHADER_REFERENCE_VERSION "aros-reference-1"
+
+struct shader_target {
+    const char* gpu_family;                     // e.g. "GCN"
+    const char* compiler_version;               // Changes every cache key
+};
+
+// Compile source for target into a malloc'd binary; NULL with error set on failure
+typedef void* (*shader_backend_fn)(const char* source, const struct shader_target* target,
+                                   size_t* size, char* error, size_t error_len);
+
+struct shader_binary {
+    void* data;                                 // malloc'd; release with shader_binary_release()
+    size_t size;
+    uint64_t key[2];
+    int from_cache;
+    int status;                                 // 0, or -1 when compilation failed
+    char error[SHADER_ERROR_MAX];
+};
+
+struct shader_stats {
+    size_t submitted;
+    size_t deduplicated;                        // Attached to an in-flight compile
+    size_t cache_hits;
+    size_t compiled;
+    size_t failed;
+    size_t cache_writes;
+    uint64_t compile_ns;                        // Summed over workers
+    uint64_t load_ns;
+};
+
+struct shader_job {
+    uint64_t key[2];
+    char* source;
+    int done;
+    int refs;                                   // Outstanding handles
+    struct shader_binary result;
+    struct shader_job* next_queued;
+    struct shader_job* next_inflight;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    struct shader_job* queue_head;
+    struct shader_job* queue_tail;
+    struct shader_job* inflight[SHADER_TABLE_SIZE];
+    pthread_t workers[SHADER_MAX_WORKERS];
+    unsigned num_workers;
+    int running;
+    int stopping;
+
+    struct shader_target target;
+    char gpu_family[64];
+    char compiler_version[64];
+    char dir[SHADER_PATH_MAX];                  // Empty: no persistence
+    shader_backend_fn backend;
+    struct shader_stats stats;
+    _Atomic unsigned tmp_counter;
+} shader_state = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER
+};
+
+static inline uint64_t shader_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// FNV-1a, continued from h; fields are NUL-separated so ("ab","c") != ("a","bc")
+static inline uint64_t shader_fnv1a(uint64_t h, const void* data, size_t len)
+{
+    const unsigned char* p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static inline uint64_t shader_hash_fields(uint64_t seed, const char* source, const struct shader_target* target)
+{
+    static const char format[] = { SHADER_FORMAT_VERSION, 0 };
+    uint64_t h = shader_fnv1a(seed, format, sizeof(format));
+    h = shader_fnv1a(h, source, strlen(source) + 1);
+    h = shader_fnv1a(h, target->gpu_family, strlen(target->gpu_family) + 1);
+    return shader_fnv1a(h, target->compiler_version, strlen(target->compiler_version) + 1);
+}
+
+// Two independently seeded hashes, so a 64-bit collision can't alias binaries
+static inline void shader_cache_key(const char* source, const struct shader_target* target, uint64_t key[2])
+{
+    key[0] = shader_hash_fields(0xcbf29ce484222325ull, source, target);
+    key[1] = shader_hash_fields(0x84222325cbf29ce4ull, source, target);
+}
+
+struct shader_file_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key[2];
+    uint64_t size;
+    uint64_t checksum;                          // FNV-1a of the binary
+};
+
+static void shader_cache_path(const uint64_t key[2], char* out, size_t cap)
+{
+    snprintf(out, cap, "%s/%016llx%016llx.bin", shader_state.dir,
+             (unsigned long long)key[0], (unsigned long long)key[1]);
+}
+
+static int shader_read_all(int fd, void* buf, size_t len)
+{
+    char* p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int shader_write_all(int fd, const void* buf, size_t len)
+{
+    const char* p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Cached binary for key, or NULL on a miss; damaged entries count as misses
+static void* shader_cache_load(const uint64_t key[2], size_t* size)
+{
+    if (shader_state.dir[0] == '\0')
+        return NULL;
+
+    char path[SHADER_PATH_MAX + 48];
+    shader_cache_path(key, path, sizeof(path));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    struct shader_file_header header;
+    void* data = NULL;
+    if (shader_read_all(fd, &header, sizeof(header)) != 0 ||
+        header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_FORMAT_VERSION ||
+        header.key[0] != key[0] || header.key[1] != key[1] || header.size == 0)
+        goto bad;
+
+    data = malloc(header.size);
+    if (data == NULL || shader_read_all(fd, data, header.size) != 0 ||
+        shader_fnv1a(0xcbf29ce484222325ull, data, header.size) != header.checksum)
+        goto bad;
+
+    close(fd);
+    *size = header.size;
+    return data;
+
+bad:
+    ring_log(LOG_WARN, "shader cache: discarding damaged entry %s", path);
+    free(data);
+    close(fd);
+    unlink(path);
+    return NULL;
+}
+
+// Write to a private temporary then rename, so readers never see a partial file
+static int shader_cache_store(const uint64_t key[2], const void* data, size_t size)
+{
+    if (shader_state.dir[0] == '\0')
+        return -1;
+
+    char path[SHADER_PATH_MAX + 48], tmp[SHADER_PATH_MAX + 80];
+    shader_cache_path(key, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.%ld.%u.tmp", path, (long)getpid(),
+             atomic_fetch_add(&shader_state.tmp_counter, 1));
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return -1;
+
+    struct shader_file_header header = {
+        .magic = SHADER_CACHE_MAGIC,
+        .version = SHADER_FORMAT_VERSION,
+        .key = { key[0], key[1] },
+        .size = size,
+        .checksum = shader_fnv1a(0xcbf29ce484222325ull, data, size)
+    };
+    int rc = shader_write_all(fd, &header, sizeof(header)) == 0 &&
+             shader_write_all(fd, data, size) == 0 ? 0 : -1;
+    if (close(fd) != 0)
+        rc = -1;
+    if (rc == 0 && rename(tmp, path) != 0)
+        rc = -1;
+    if (rc != 0)
+        unlink(tmp);
+    return rc;
+}
+
+static int shader_mkdirs(const char* dir)
+{
+    char path[SHADER_PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s", dir) >= (int)sizeof(path))
+        return -1;
+    for (char* p = path + 1; *p != '\0'; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if (mkdir(path, 0755) != 0 && errno != EEXIST)
+            return -1;
+        *p = '/';
+    }
+    return mkdir(path, 0755) != 0 && errno != EEXIST ? -1 : 0;
+}
+
+// Where binaries live (override with AROS_SHADER_CACHE_DIR)
+static void shader_default_dir(char* out, size_t cap)
+{
+    const char* env = getenv("AROS_SHADER_CACHE_DIR");
+    const char* home = getenv("HOME");
+    if (env != NULL && env[0] != '\0')
+        snprintf(out, cap, "%s", env);
+    else if (home != NULL && home[0] != '\0')
+        snprintf(out, cap, "%s/.cache/aros-cognito/shaders", home);
+    else
+        snprintf(out, cap, "/tmp/aros-cognito-shaders");
+}
+
+// Reference backend (SHADER_REFERENCE_VERSION): strips comments and whitespace, checks brackets balance
+// and emits one 32-bit token hash per token after a small header
+static void* shader_backend_reference(const char* source, const struct shader_target* target,
+                                      size_t* size, char* error, size_t error_len)
+{
+    size_t cap = 64, len = 0;
+    uint32_t* out = malloc(cap * sizeof(*out));
+    if (out == NULL) {
+        snprintf(error, error_len, "out of memory");
+        return NULL;
+    }
+    out[len++] = 0x31534941u;                   // "AIS1"
+    out[len++] = (uint32_t)shader_fnv1a(0xcbf29ce484222325ull, target->gpu_family, strlen(target->gpu_family));
+
+    int depth = 0, line = 1;
+    const char* p = source;
+    while (*p != '\0') {
+        if (*p == '\n')
+            line++;
+        if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+            p++;
+            continue;
+        }
+        if (p[0] == '/' && p[1] == '/') {
+            while (*p != '\0' && *p != '\n')
+                p++;
+            continue;
+        }
+        if (p[0] == '/' && p[1] == '*') {
+            const char* end = strstr(p + 2, "*/");
+            if (end == NULL) {
+                snprintf(error, error_len, "line %d: unterminated comment", line);
+                goto fail;
+            }
+            for (; p < end; p++)
+                line += *p == '\n';
+            p = end + 2;
+            continue;
+        }
+
+        const char* start = p;
+        if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_' || (*p >= '0' && *p <= '9')) {
+            while ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_' ||
+                   (*p >= '0' && *p <= '9') || *p == '.')
+                p++;
+        } else {
+            if (*p == '(' || *p == '{' || *p == '[')
+                depth++;
+            else if ((*p == ')' || *p == '}' || *p == ']') && --depth < 0)
+                break;
+            p++;
+        }
+
+        if (len == cap) {
+            uint32_t* grown = realloc(out, cap * 2 * sizeof(*out));
+            if (grown == NULL) {
+                snprintf(error, error_len, "out of memory");
+                goto fail;
+            }
+            out = grown;
+            cap *= 2;
+        }
+        out[len++] = (uint32_t)shader_fnv1a(0xcbf29ce484222325ull, start, (size_t)(p - start));
+    }
+    if (depth != 0) {
+        snprintf(error, error_len, "line %d: unbalanced brackets", line);
+        goto fail;
+    }
+
+    *size = len * sizeof(*out);
+    return out;
+
+fail:
+    free(out);
+    return NULL;
+}
+
+static void shader_compile_job(struct shader_job* job)
+{
+    struct shader_binary* result = &job->result;
+    uint64_t start = shader_now();
+
+    result->data = shader_cache_load(job->key, &result->size);
+    if (result->data != NULL) {
+        result->from_cache = 1;
+        pthread_mutex_lock(&shader_state.lock);
+        shader_state.stats.cache_hits++;
+        shader_state.stats.load_ns += shader_now() - start;
+        pthread_mutex_unlock(&shader_state.lock);
+        return;
+    }
+
+    result->data = shader_state.backend(job->source, &shader_state.target, &result->size,
+                                        result->error, sizeof(result->error));
+    uint64_t elapsed = shader_now() - start;
+    int stored = result->data != NULL && shader_cache_store(job->key, result->data, result->size) == 0;
+    if (result->data == NULL) {
+        result->status = -1;
+        ring_log(LOG_ERROR, "shader compile failed: %s", result->error);
+    }
+
+    pthread_mutex_lock(&shader_state.lock);
+    if (result->status == 0)
+        shader_state.stats.compiled++;
+    else
+        shader_state.stats.failed++;
+    shader_state.stats.cache_writes += (size_t)stored;
+    shader_state.stats.compile_ns += elapsed;
+    pthread_mutex_unlock(&shader_state.lock);
+}
+
+static void shader_job_free(struct shader_job* job)
+{
+    free(job->result.data);
+    free(job->source);
+    free(job);
+}
+
+// Caller holds the lock; a job still compiling is freed by its worker
+static void shader_job_unref(struct shader_job* job)
+{
+    if (--job->refs == 0 && job->done)
+        shader_job_free(job);
+}
+
+static void* shader_worker_main(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&shader_state.lock);
+    for (;;) {
+        while (shader_state.queue_head == NULL && !shader_state.stopping)
+            pthread_cond_wait(&shader_state.work_cond, &shader_state.lock);
+        struct shader_job* job = shader_state.queue_head;
+        if (job == NULL)
+            break;
+        shader_state.queue_head = job->next_queued;
+        if (shader_state.queue_head == NULL)
+            shader_state.queue_tail = NULL;
+        pthread_mutex_unlock(&shader_state.lock);
+
+        shader_compile_job(job);
+
+        pthread_mutex_lock(&shader_state.lock);
+        struct shader_job** link = &shader_state.inflight[job->key[0] & (SHADER_TABLE_SIZE - 1)];
+        while (*link != job)
+            link = &(*link)->next_inflight;
+        *link = job->next_inflight;
+        job->done = 1;
+        if (job->refs == 0)
+            shader_job_free(job);               // Every handle was detached
+        pthread_cond_broadcast(&shader_state.done_cond);
+    }
+    pthread_mutex_unlock(&shader_state.lock);
+    return NULL;
+}
+
+/**
+ * Start the service for target
+ *
+ * cache_dir NULL uses the default directory; if it can't be created the
+ * service still runs, just without persistence. workers 0 picks one per
+ * online CPU, backend NULL the reference backend.
+ */
+static inline int shader_service_init(const char* cache_dir, const struct shader_target* target,
+                                      unsigned workers, shader_backend_fn backend)
+{
+    pthread_mutex_lock(&shader_state.lock);
+    if (shader_state.running) {
+        pthread_mutex_unlock(&shader_state.lock);
+        return -1;
+    }
+
+    snprintf(shader_state.gpu_family, sizeof(shader_state.gpu_family), "%s", target->gpu_family);
+    snprintf(shader_state.compiler_version, sizeof(shader_state.compiler_version), "%s",
+             target->compiler_version);
+    shader_state.target.gpu_family = shader_state.gpu_family;
+    shader_state.target.compiler_version = shader_state.compiler_version;
+    shader_state.backend = backend != NULL ? backend : shader_backend_reference;
+    memset(&shader_state.stats, 0, sizeof(shader_state.stats));
+
+    if (cache_dir != NULL)
+        snprintf(shader_state.dir, sizeof(shader_state.dir), "%s", cache_dir);
+    else
+        shader_default_dir(shader_state.dir, sizeof(shader_state.dir));
+    if (shader_mkdirs(shader_state.dir) != 0) {
+        ring_log(LOG_WARN, "shader cache: %s unavailable, binaries will not persist", shader_state.dir);
+        shader_state.dir[0] = '\0';
+    }
+
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (workers > SHADER_MAX_WORKERS)
+        workers = SHADER_MAX_WORKERS;
+
+    shader_state.stopping = 0;
+    shader_state.num_workers = 0;
+    while (shader_state.num_workers < workers &&
+           pthread_create(&shader_state.workers[shader_state.num_workers], NULL, shader_worker_main, NULL) == 0)
+        shader_state.num_workers++;
+    shader_state.running = shader_state.num_workers > 0;
+    pthread_mutex_unlock(&shader_state.lock);
+    return shader_state.running ? 0 : -1;
+}
+
+/**
+ * Queue source for compilation and return a handle for shader_wait()
+ *
+ * Returns NULL if the service isn't running. Every handle must be consumed
+ * by exactly one shader_wait() or shader_detach().
+ */
+static inline struct shader_job* shader_submit(const char* source)
+{
+    uint64_t key[2];
+    pthread_mutex_lock(&shader_state.lock);
+    if (!shader_state.running) {
+        pthread_mutex_unlock(&shader_state.lock);
+        return NULL;
+    }
+    shader_cache_key(source, &shader_state.target, key);
+    shader_state.stats.submitted++;
+
+    struct shader_job** bucket = &shader_state.inflight[key[0] & (SHADER_TABLE_SIZE - 1)];
+    for (struct shader_job* job = *bucket; job != NULL; job = job->next_inflight) {
+        if (job->key[0] == key[0] && job->key[1] == key[1]) {
+            job->refs++;
+            shader_state.stats.deduplicated++;
+            pthread_mutex_unlock(&shader_state.lock);
+            return job;
+        }
+    }
+
+    struct shader_job* job = calloc(1, sizeof(*job));
+    char* copy = strdup(source);
+    if (job == NULL || copy == NULL) {
+        shader_state.stats.submitted--;
+        pthread_mutex_unlock(&shader_state.lock);
+        free(job);
+        free(copy);
+        return NULL;
+    }
+    job->key[0] = job->result.key[0] = key[0];
+    job->key[1] = job->result.key[1] = key[1];
+    job->source = copy;
+    job->refs = 1;
+    job->next_inflight = *bucket;
+    *bucket = job;
+    if (shader_state.queue_tail != NULL)
+        shader_state.queue_tail->next_queued = job;
+    else
+        shader_state.queue_head = job;
+    shader_state.queue_tail = job;
+    pthread_cond_signal(&shader_state.work_cond);
+    pthread_mutex_unlock(&shader_state.lock);
+    return job;
+}
+
+/**
+ * Wait for job and take its result
+ *
+ * out->data belongs to the caller afterwards. Returns out->status.
+ */
+static inline int shader_wait(struct shader_job* job, struct shader_binary* out)
+{
+    pthread_mutex_lock(&shader_state.lock);
+    while (!job->done)
+        pthread_cond_wait(&shader_state.done_cond, &shader_state.lock);
+
+    *out = job->result;
+    if (job->refs > 1) {
+        // Shared compile: the last handle takes the buffer, others get copies
+        out->data = job->result.data != NULL ? malloc(job->result.size) : NULL;
+        if (out->data != NULL)
+            memcpy(out->data, job->result.data, job->result.size);
+        else if (job->result.data != NULL) {
+            out->status = -1;
+            snprintf(out->error, sizeof(out->error), "out of memory");
+        }
+    } else {
+        job->result.data = NULL;
+    }
+    shader_job_unref(job);
+    pthread_mutex_unlock(&shader_state.lock);
+    return out->status;
+}
+
+// Drop a handle without waiting; the binary still lands in the cache
+static inline void shader_detach(struct shader_job* job)
+{
+    pthread_mutex_lock(&shader_state.lock);
+    shader_job_unref(job);
+    pthread_mutex_unlock(&shader_state.lock);
+}
+
+static inline void shader_binary_release(struct shader_binary* binary)
+{
+    free(binary->data);
+    binary->data = NULL;
+    binary->size = 0;
+}
+
+/**
+ * Compile count sources concurrently; results in out[i]
+ *
+ * Returns the number of shaders that failed.
+ */
+static inline size_t shader_compile_all(const char* const* sources, size_t count, struct shader_binary* out)
+{
+    struct shader_job** jobs = calloc(count ? count : 1, sizeof(*jobs));
+    size_t failures = 0;
+    for (size_t i = 0; i < count; i++)
+        jobs[i] = jobs != NULL ? shader_submit(sources[i]) : NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (jobs == NULL || jobs[i] == NULL) {
+            memset(&out[i], 0, sizeof(out[i]));
+            out[i].status = -1;
+            snprintf(out[i].error, sizeof(out[i].error), "shader service not running");
+            failures++;
+        } else if (shader_wait(jobs[i], &out[i]) != 0) {
+            failures++;
+        }
+    }
+    free(jobs);
+    return failures;
+}
+
+static inline void shader_service_get_stats(struct shader_stats* stats)
+{
+    pthread_mutex_lock(&shader_state.lock);
+    *stats = shader_state.stats;
+    pthread_mutex_unlock(&shader_state.lock);
+}
+
+static inline void shader_service_print_stats(void)
+{
+    struct shader_stats stats;
+    shader_service_get_stats(&stats);
+    printf("Shader service: %zu submitted, %zu cache hits, %zu compiled, %zu failed, %zu shared\n",
+           stats.submitted, stats.cache_hits, stats.compiled, stats.failed, stats.deduplicated);
+    printf("  compile %.3f ms, cache load %.3f ms (summed over workers)\n",
+           stats.compile_ns / 1e6, stats.load_ns / 1e6);
+}
+
+// Finish queued work (detached jobs included) and stop the workers
+static inline void shader_service_shutdown(void)
+{
+    pthread_mutex_lock(&shader_state.lock);
+    if (!shader_state.running) {
+        pthread_mutex_unlock(&shader_state.lock);
+        return;
+    }
+    shader_state.stopping = 1;
+    shader_state.running = 0;
+    pthread_cond_broadcast(&shader_state.work_cond);
+    pthread_mutex_unlock(&shader_state.lock);
+
+    for (unsigned i = 0; i < shader_state.num_workers; i++)
+        pthread_join(shader_state.workers[i], NULL);
+    shader_state.num_workers = 0;
+}
+
+#endif // SHADER_CACHE_H
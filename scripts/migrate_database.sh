@@ -206,11 +206,17 @@ backup_databases() {
     if [ -f "$LOGS_DIR/errors/error_database.json" ]; then
         cp "$LOGS_DIR/errors/error_database.json" "$BACKUP_DIR/"
     fi
+    if [ -f "$LOGS_DIR/errors/error_database.wal" ]; then
+        cp "$LOGS_DIR/errors/error_database.wal" "$BACKUP_DIR/"
+    fi
     
     # Backup reasoning database
     if [ -f "$LOGS_DIR/reasoning/reasoning_database.json" ]; then
         cp "$LOGS_DIR/reasoning/reasoning_database.json" "$BACKUP_DIR/"
     fi
+    if [ -f "$LOGS_DIR/reasoning/reasoning_store.jsonl" ]; then
+        cp "$LOGS_DIR/reasoning/reasoning_store.jsonl" "$BACKUP_DIR/"
+    fi
     
     print_success "Backup created at: $BACKUP_DIR"
 }
@@ -224,7 +230,8 @@ main() {
     echo ""
     
     # Create backup if databases exist
-    if [ -f "$LOGS_DIR/errors/error_database.json" ] || [ -f "$LOGS_DIR/reasoning/reasoning_database.json" ]; then
+    if [ -f "$LOGS_DIR/errors/error_database.json" ] || [ -f "$LOGS_DIR/reasoning/reasoning_database.json" ] || \
+       [ -f "$LOGS_DIR/reasoning/reasoning_store.jsonl" ]; then
         backup_databases
     fi
     
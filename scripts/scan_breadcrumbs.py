@@ -11,9 +11,11 @@ from pathlib import Path
 # Add parent directory to path for imports
 sys.path.insert(0, str(Path(__file__).parent.parent))
 
-from src.breadcrumb_parser import BreadcrumbParser, BreadcrumbValidator
+from src.breadcrumb_parser import BreadcrumbParser, BreadcrumbValidator, BreadcrumbIndex
+from src.breadcrumb_parser.parser import collect_source_files
 
-def scan_directory(directory_path: Path, max_files: int = None, extensions: list = None):
+def scan_directory(directory_path: Path, max_files: int = None, extensions: list = None, jobs: int = 1,
+                   index_path: Path = None):
     """
     Scan a directory for files with breadcrumbs
     
@@ -21,6 +23,8 @@ def scan_directory(directory_path: Path, max_files: int = None, extensions: list
         directory_path: Path to directory to scan
         max_files: Maximum number of files to scan (None for all)
         extensions: List of file extensions to scan (default: ['.c', '.h'])
+        jobs: Worker processes for a parallel scan (0 for all cores, 1 for serial)
+        index_path: Persistent breadcrumb index; only changed files are re-parsed
     
     Returns:
         Tuple of (parser, validator) with results
@@ -35,6 +39,30 @@ def scan_directory(directory_path: Path, max_files: int = None, extensions: list
     print(f"Looking for extensions: {', '.join(extensions)}")
     print("")
     
+    if index_path and not max_files:
+        index = BreadcrumbIndex(str(index_path))
+        stats = index.refresh_from_git(str(directory_path), extensions, workers=jobs or None)
+        parser.breadcrumbs = index.get_breadcrumbs(str(directory_path))
+        files_with_breadcrumbs = len(set(b.file_path for b in parser.breadcrumbs))
+        print(f"Index {index_path}: checked {stats['checked']} files, "
+              f"re-parsed {stats['reparsed']}, removed {stats['removed']}")
+        print(f"Found {len(parser.breadcrumbs)} breadcrumbs in {files_with_breadcrumbs} files")
+        print("")
+        _validate(parser, validator)
+        return parser, validator
+    
+    if jobs != 1:
+        files = collect_source_files(str(directory_path), extensions)
+        if max_files:
+            files = files[:max_files]
+        breadcrumbs = parser.parse_files(files, workers=jobs or None)
+        files_with_breadcrumbs = len(set(b.file_path for b in breadcrumbs))
+        print(f"Parallel scan of {len(files)} files found {len(breadcrumbs)} breadcrumbs "
+              f"in {files_with_breadcrumbs} files")
+        print("")
+        _validate(parser, validator)
+        return parser, validator
+    
     # Find all matching files
     all_files = []
     for ext in extensions:
@@ -65,7 +93,11 @@ def scan_directory(directory_path: Path, max_files: int = None, extensions: list
     print(f"Total breadcrumbs found: {len(parser.breadcrumbs)}")
     print("")
     
-    # Validate breadcrumbs
+    _validate(parser, validator)
+    return parser, validator
+
+def _validate(parser: BreadcrumbParser, validator: BreadcrumbValidator):
+    """Validate parsed breadcrumbs and print a report"""
     if parser.breadcrumbs:
         print("Validating breadcrumbs...")
         validator.validate_breadcrumbs(parser.breadcrumbs)
@@ -85,8 +117,6 @@ def scan_directory(directory_path: Path, max_files: int = None, extensions: list
             print("\nValidation Warnings:")
             for warning in report['warnings'][:10]:  # Show first 10 warnings
                 print(f"  - {warning['file']}:{warning['line']}: {warning['warning']}")
-    
-    return parser, validator
 
 def print_statistics(parser: BreadcrumbParser):
     """Print detailed statistics about parsed breadcrumbs"""
@@ -174,6 +204,17 @@ def main():
         default=['.c', '.h', '.cpp', '.hpp'],
         help='File extensions to scan (default: .c .h .cpp .hpp)'
     )
+    parser_args.add_argument(
+        '--jobs',
+        '-j',
+        type=int,
+        default=1,
+        help='Parallel worker processes (0 for all cores, default: 1)'
+    )
+    parser_args.add_argument(
+        '--index',
+        help='Persistent index file; re-parses only files changed since the last scan'
+    )
     
     args = parser_args.parse_args()
     
@@ -192,7 +233,9 @@ def main():
     parser, validator = scan_directory(
         directory,
         max_files=args.max_files,
-        extensions=args.extensions
+        extensions=args.extensions,
+        jobs=args.jobs,
+        index_path=Path(args.index) if args.index else None
     )
     
     # Print statistics
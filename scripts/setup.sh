@@ -263,6 +263,16 @@ else
     fi
 fi
 
+# Build the optional native accelerators (falls back to pure Python if this fails)
+echo ""
+echo "Building native extensions..."
+if (cd "$PROJECT_ROOT" && python3 setup.py build_ext --inplace > /dev/null 2>&1); then
+    echo "✓ Native breadcrumb and diagnostic scanners built"
+else
+    echo "⚠ Could not build native extensions (python3-dev and a C compiler are required)"
+    echo "   The pure Python parsers will be used instead"
+fi
+
 echo ""
 echo "╔════════════════════════════════════════════════════════════╗"
 echo "║                 Setup Complete!                            ║"
@@ -0,0 +1,27 @@
+"""
+Build script for the native extensions
+
+Only the optional C accelerators are built here; the Python sources are used
+in place. Build them with:
+
+    python3 setup.py build_ext --inplace
+"""
+
+from setuptools import setup, Extension
+
+setup(
+    name='ai-breadcrumb-automated-development',
+    packages=[],
+    ext_modules=[
+        Extension(
+            'src.breadcrumb_parser._scanner',
+            sources=['src/breadcrumb_parser/_scanner.c'],
+            extra_compile_args=['-O3'],
+        ),
+        Extension(
+            'src.compiler_loop._diagnostics',
+            sources=['src/compiler_loop/_diagnostics.c'],
+            extra_compile_args=['-O3'],
+        ),
+    ],
+)
@@ -3,7 +3,8 @@ AI Breadcrumb Parser Module
 Parses and validates AI breadcrumb metadata from source files
 """
 
-from .parser import BreadcrumbParser, Breadcrumb, TAG_SET
+from .parser import BreadcrumbParser, Breadcrumb, CompactBreadcrumb, TAG_SET
 from .validator import BreadcrumbValidator
+from .index import BreadcrumbIndex
 
-__all__ = ['BreadcrumbParser', 'Breadcrumb', 'BreadcrumbValidator', 'TAG_SET']
+__all__ = ['BreadcrumbParser', 'Breadcrumb', 'CompactBreadcrumb', 'BreadcrumbValidator', 'BreadcrumbIndex', 'TAG_SET']
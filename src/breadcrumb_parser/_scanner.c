@@ -0,0 +1,597 @@
+/*
+ * Native breadcrumb scanner
+ *
+ * Mirrors BreadcrumbParser._parse_line() byte-for-byte, but mmaps the source
+ * file and only inspects lines that can change parser state. Outside of block
+ * comments (and while no breadcrumb is pending) every line without a '/' is a
+ * no-op for the parser, so those regions are skipped with a SIMD search for
+ * '/' that counts newlines as it goes.
+ *
+ * Text is interpreted exactly as open(..., encoding='utf-8', errors='ignore')
+ * followed by readlines() would: invalid UTF-8 is dropped, '\r' and '\r\n'
+ * terminate lines, and whitespace/word characters use the same Unicode
+ * predicates as the `re` module.
+ *
+ * Build with: python3 setup.py build_ext --inplace
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static PyObject* json_loads;
+static PyObject* json_decode_error;
+
+/* Decode the next valid code point at or after p, skipping invalid UTF-8 the
+ * way the 'ignore' error handler does (one maximal invalid subpart at a time).
+ * Returns the position after the code point, or NULL at end of input. */
+static const unsigned char* next_cp(const unsigned char* p, const unsigned char* end, Py_UCS4* out)
+{
+    while (p < end) {
+        unsigned char c = p[0];
+        if (c < 0x80) {
+            *out = c;
+            return p + 1;
+        }
+
+        int need;
+        Py_UCS4 cp;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            need = 1; cp = c & 0x1F;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            need = 2; cp = c & 0x0F;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            need = 3; cp = c & 0x07;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            p++;
+            continue;
+        }
+
+        const unsigned char* q = p + 1;
+        int ok = 1;
+        for (int i = 0; i < need; i++, q++) {
+            if (q >= end || *q < lo || *q > hi) {
+                ok = 0;
+                break;
+            }
+            cp = (cp << 6) | (*q & 0x3F);
+            lo = 0x80;
+            hi = 0xBF;
+        }
+        if (ok) {
+            *out = cp;
+            return q;
+        }
+        p = q;
+    }
+    return NULL;
+}
+
+static inline int is_word(Py_UCS4 cp)
+{
+    return cp == '_' || Py_UNICODE_ISALNUM(cp);
+}
+
+/* Position of the first non-whitespace code point (possibly preceded by
+ * bytes the decoder drops), or end if the rest of the line is blank */
+static const unsigned char* skip_ws(const unsigned char* p, const unsigned char* end)
+{
+    Py_UCS4 cp;
+    const unsigned char* next;
+    while ((next = next_cp(p, end, &cp)) != NULL) {
+        if (!Py_UNICODE_ISSPACE(cp))
+            return p;
+        p = next;
+    }
+    return end;
+}
+
+/* Match `\s*<a><b>\s*$` starting at the first non-whitespace position */
+static int is_marker_line(const unsigned char* p, const unsigned char* end, char a, char b)
+{
+    Py_UCS4 cp;
+    if ((p = next_cp(p, end, &cp)) == NULL || cp != (Py_UCS4)a)
+        return 0;
+    if ((p = next_cp(p, end, &cp)) == NULL || cp != (Py_UCS4)b)
+        return 0;
+    return skip_ws(p, end) == end;
+}
+
+/* Match `\*?\s*(?P<tag>\w+):` (star optional) or `//\s*(?P<tag>\w+):` at p.
+ * On success stores the tag byte range and the start of the value. */
+static int match_tag(const unsigned char* p, const unsigned char* end, int slashes,
+                     const unsigned char** tag_start, const unsigned char** tag_end,
+                     const unsigned char** value_start)
+{
+    Py_UCS4 cp;
+    const unsigned char* next;
+
+    if (slashes) {
+        for (int i = 0; i < 2; i++) {
+            if ((p = next_cp(p, end, &cp)) == NULL || cp != '/')
+                return 0;
+        }
+    } else if ((next = next_cp(p, end, &cp)) != NULL && cp == '*') {
+        p = next;
+    }
+    p = skip_ws(p, end);
+
+    *tag_start = p;
+    int word_chars = 0;
+    while ((next = next_cp(p, end, &cp)) != NULL && is_word(cp)) {
+        p = next;
+        word_chars++;
+    }
+    if (word_chars == 0 || next == NULL || cp != ':')
+        return 0;
+
+    *tag_end = p;
+    *value_start = next;
+    return 1;
+}
+
+static PyObject* decode(const unsigned char* start, const unsigned char* end)
+{
+    return PyUnicode_DecodeUTF8((const char*)start, end - start, "ignore");
+}
+
+static PyObject* decode_stripped(const unsigned char* start, const unsigned char* end)
+{
+    PyObject* raw = decode(start, end);
+    if (raw == NULL)
+        return NULL;
+    PyObject* stripped = PyObject_CallMethod(raw, "strip", NULL);
+    Py_DECREF(raw);
+    return stripped;
+}
+
+struct scan_state {
+    PyObject* tag_set;
+    PyObject* results;
+    PyObject* tags;             /* _current_tags */
+    PyObject* json_buffer;      /* _json_buffer (list of str) */
+    long start_line;            /* _start_line, 0 when None */
+    int in_block;
+    int in_json;
+    int lazy_context;           /* compact=True: keep AI_CONTEXT as text */
+};
+
+static int flush(struct scan_state* st, long line_num)
+{
+    long start = st->start_line ? st->start_line : line_num;
+    PyObject* item = Py_BuildValue("(lO)", start, st->tags);
+    if (item == NULL)
+        return -1;
+    int rc = PyList_Append(st->results, item);
+    Py_DECREF(item);
+    if (rc < 0)
+        return -1;
+
+    Py_DECREF(st->tags);
+    st->tags = PyDict_New();
+    st->start_line = 0;
+    return st->tags ? 0 : -1;
+}
+
+/* context_complete(): one whole JSON object by brace matching outside strings */
+static int context_complete(PyObject* text)
+{
+    Py_ssize_t start = 0, end = PyUnicode_GET_LENGTH(text);
+    while (start < end && Py_UNICODE_ISSPACE(PyUnicode_READ_CHAR(text, start)))
+        start++;
+    while (end > start && Py_UNICODE_ISSPACE(PyUnicode_READ_CHAR(text, end - 1)))
+        end--;
+    if (start == end || PyUnicode_READ_CHAR(text, start) != '{')
+        return 0;
+
+    int kind = PyUnicode_KIND(text);
+    const void* data = PyUnicode_DATA(text);
+    long depth = 0;
+    int in_string = 0, escaped = 0;
+    for (Py_ssize_t i = start; i < end; i++) {
+        Py_UCS4 ch = PyUnicode_READ(kind, data, i);
+        if (in_string) {
+            if (escaped)
+                escaped = 0;
+            else if (ch == '\\')
+                escaped = 1;
+            else if (ch == '"')
+                in_string = 0;
+        } else if (ch == '"') {
+            in_string = 1;
+        } else if (ch == '{') {
+            depth++;
+        } else if (ch == '}' && --depth == 0) {
+            return i == end - 1;
+        }
+    }
+    return 0;
+}
+
+static int try_parse_json(struct scan_state* st)
+{
+    PyObject* sep = PyUnicode_FromString(" ");
+    if (sep == NULL)
+        return -1;
+    PyObject* joined = PyUnicode_Join(sep, st->json_buffer);
+    Py_DECREF(sep);
+    if (joined == NULL)
+        return -1;
+
+    PyObject* parsed;
+    if (st->lazy_context) {
+        if (!context_complete(joined)) {
+            Py_DECREF(joined);
+            return 0;
+        }
+        parsed = joined;
+    } else {
+        parsed = PyObject_CallOneArg(json_loads, joined);
+        Py_DECREF(joined);
+    }
+    if (parsed == NULL) {
+        if (PyErr_ExceptionMatches(json_decode_error)) {
+            PyErr_Clear();      /* Incomplete JSON: keep collecting */
+            return 0;
+        }
+        return -1;
+    }
+
+    int rc = PyDict_SetItemString(st->tags, "AI_CONTEXT", parsed);
+    Py_DECREF(parsed);
+    if (rc < 0)
+        return -1;
+
+    st->in_json = 0;
+    Py_SETREF(st->json_buffer, PyList_New(0));
+    return st->json_buffer ? 0 : -1;
+}
+
+/* _handle_json_start / _handle_json_continue; steals a reference to value */
+static int json_value(struct scan_state* st, PyObject* value, int start)
+{
+    if (start) {
+        st->in_json = 1;
+        Py_SETREF(st->json_buffer, PyList_New(0));
+        if (st->json_buffer == NULL) {
+            Py_DECREF(value);
+            return -1;
+        }
+    } else if (!st->in_json) {
+        Py_DECREF(value);
+        return 0;
+    }
+
+    if (PyList_Append(st->json_buffer, value) < 0) {
+        Py_DECREF(value);
+        return -1;
+    }
+
+    Py_ssize_t len = PyUnicode_GET_LENGTH(value);
+    int complete;
+    if (start) {
+        complete = len > 0 &&
+                   PyUnicode_READ_CHAR(value, 0) == '{' &&
+                   PyUnicode_READ_CHAR(value, len - 1) == '}';
+    } else {
+        complete = PyUnicode_FindChar(value, '}', 0, len, 1) >= 0;
+    }
+    Py_DECREF(value);
+
+    return complete ? try_parse_json(st) : 0;
+}
+
+static int handle_tag(struct scan_state* st, long line_num,
+                      const unsigned char* tag_start, const unsigned char* tag_end,
+                      const unsigned char* value_start, const unsigned char* line_end)
+{
+    PyObject* raw_tag = decode(tag_start, tag_end);
+    if (raw_tag == NULL)
+        return -1;
+    PyObject* tag = PyObject_CallMethod(raw_tag, "upper", NULL);
+    Py_DECREF(raw_tag);
+    if (tag == NULL)
+        return -1;
+
+    int known = PySet_Contains(st->tag_set, tag);
+    if (known <= 0) {
+        Py_DECREF(tag);
+        return known;
+    }
+
+    PyObject* value = decode_stripped(value_start, line_end);
+    if (value == NULL) {
+        Py_DECREF(tag);
+        return -1;
+    }
+
+    if (PyDict_GET_SIZE(st->tags) == 0)
+        st->start_line = line_num;
+
+    int rc;
+    if (PyUnicode_CompareWithASCIIString(tag, "AI_CONTEXT") == 0) {
+        rc = json_value(st, value, 1);
+    } else if (st->in_json) {
+        rc = json_value(st, value, 0);
+    } else {
+        rc = PyDict_SetItem(st->tags, tag, value);
+        Py_DECREF(value);
+    }
+    Py_DECREF(tag);
+    return rc;
+}
+
+/* JSON continuation for a comment line without a tag: strip the line, then
+ * drop `skip` leading code points (the `//`) or any leading '*' characters */
+static int json_continue_line(struct scan_state* st, const unsigned char* start,
+                              const unsigned char* end, int slashes)
+{
+    PyObject* stripped = decode_stripped(start, end);
+    if (stripped == NULL)
+        return -1;
+
+    PyObject* rest;
+    if (slashes) {
+        rest = PyUnicode_Substring(stripped, 2, PyUnicode_GET_LENGTH(stripped));
+    } else {
+        rest = PyObject_CallMethod(stripped, "lstrip", "s", "*");
+    }
+    Py_DECREF(stripped);
+    if (rest == NULL)
+        return -1;
+
+    PyObject* value = PyObject_CallMethod(rest, "strip", NULL);
+    Py_DECREF(rest);
+    if (value == NULL)
+        return -1;
+
+    return json_value(st, value, 0);
+}
+
+/* One line, without its terminator. Same decision order as _parse_line(). */
+static int scan_line(struct scan_state* st, const unsigned char* start,
+                     const unsigned char* end, long line_num)
+{
+    const unsigned char* first = skip_ws(start, end);
+    const unsigned char *tag_start, *tag_end, *value_start;
+
+    if (!st->in_block && is_marker_line(first, end, '/', '*')) {
+        st->in_block = 1;
+        if (PyDict_GET_SIZE(st->tags) == 0)
+            st->start_line = line_num;
+        return 0;
+    }
+
+    if (st->in_block && is_marker_line(first, end, '*', '/')) {
+        st->in_block = 0;
+        if (PyDict_GET_SIZE(st->tags) > 0 && !st->in_json)
+            return flush(st, line_num);
+        return 0;
+    }
+
+    if (st->in_block) {
+        if (match_tag(first, end, 0, &tag_start, &tag_end, &value_start))
+            return handle_tag(st, line_num, tag_start, tag_end, value_start, end);
+        if (st->in_json)
+            return json_continue_line(st, start, end, 0);
+        return 0;
+    }
+
+    Py_UCS4 cp1 = 0, cp2 = 0;
+    const unsigned char* p = next_cp(first, end, &cp1);
+    if (p != NULL)
+        next_cp(p, end, &cp2);
+
+    if (cp1 == '/' && cp2 == '/') {
+        if (match_tag(first, end, 1, &tag_start, &tag_end, &value_start))
+            return handle_tag(st, line_num, tag_start, tag_end, value_start, end);
+        if (st->in_json)
+            return json_continue_line(st, start, end, 1);
+        return 0;
+    }
+
+    /* Non-comment line: flush the pending breadcrumb */
+    if (PyDict_GET_SIZE(st->tags) > 0 && !st->in_json && first != end)
+        return flush(st, line_num);
+    return 0;
+}
+
+/* Find the next '/' in [p, end), adding the number of '\n' bytes before it
+ * to *lines. Returns end if there is none. */
+static const unsigned char* find_slash(const unsigned char* p, const unsigned char* end, long* lines)
+{
+#if defined(__SSE2__)
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        unsigned s = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, slash));
+        unsigned n = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if (s) {
+            unsigned pos = (unsigned)__builtin_ctz(s);
+            *lines += __builtin_popcount(n & ((1u << pos) - 1));
+            return p + pos;
+        }
+        *lines += __builtin_popcount(n);
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == '/')
+            return p;
+        if (*p == '\n')
+            (*lines)++;
+    }
+    return end;
+}
+
+static const unsigned char* line_end_of(const unsigned char* p, const unsigned char* end, int has_cr)
+{
+    if (!has_cr) {
+        const unsigned char* nl = memchr(p, '\n', end - p);
+        return nl ? nl : end;
+    }
+    while (p < end && *p != '\n' && *p != '\r')
+        p++;
+    return p;
+}
+
+static int scan_buffer(struct scan_state* st, const unsigned char* buf, size_t size)
+{
+    const unsigned char* end = buf + size;
+    const unsigned char* p = buf;
+    int has_cr = memchr(buf, '\r', size) != NULL;
+    long line_num = 0;      /* Number of the last line processed */
+
+    while (p < end) {
+        /* Lines with no '/' cannot change state here, so skip straight to
+         * the line holding the next one. Needs '\n'-only line endings. */
+        if (!has_cr && !st->in_block && (PyDict_GET_SIZE(st->tags) == 0 || st->in_json)) {
+            long skipped = 0;
+            const unsigned char* slash = find_slash(p, end, &skipped);
+            if (slash == end) {
+                line_num += skipped + (end[-1] != '\n');
+                break;
+            }
+            if (skipped > 0) {
+                line_num += skipped;
+                p = (const unsigned char*)memrchr(p, '\n', slash - p) + 1;
+            }
+        }
+
+        const unsigned char* le = line_end_of(p, end, has_cr);
+        line_num++;
+        if (scan_line(st, p, le, line_num) < 0)
+            return -1;
+
+        if (le == end)
+            break;
+        p = le + 1;
+        if (*le == '\r') {
+            /* '\r\n' is one terminator, even with dropped bytes between */
+            Py_UCS4 cp;
+            const unsigned char* next = next_cp(p, end, &cp);
+            if (next != NULL && cp == '\n')
+                p = next;
+        }
+    }
+
+    /* Flush any remaining breadcrumb at EOF */
+    if (PyDict_GET_SIZE(st->tags) > 0)
+        return flush(st, line_num);
+    return 0;
+}
+
+PyDoc_STRVAR(scan_file_doc,
+"scan_file(path, tag_set, lazy_context=False) -> list of (start_line, tags)\n\n"
+"Scan a source file for breadcrumbs. Each entry is the breadcrumb's start\n"
+"line and its tag dict, ready for BreadcrumbParser._create_breadcrumb().\n"
+"With lazy_context, AI_CONTEXT is left as its JSON text.");
+
+static PyObject* scan_file(PyObject* self, PyObject* args)
+{
+    PyObject* path_obj;
+    PyObject* tag_set;
+    int lazy_context = 0;
+    (void)self;
+
+    if (!PyArg_ParseTuple(args, "O&O!|p", PyUnicode_FSConverter, &path_obj, &PyFrozenSet_Type, &tag_set,
+                          &lazy_context))
+        return NULL;
+
+    const char* path = PyBytes_AS_STRING(path_obj);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        Py_DECREF(path_obj);
+        return NULL;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        close(fd);
+        Py_DECREF(path_obj);
+        return NULL;
+    }
+
+    void* map = NULL;
+    if (sb.st_size > 0) {
+        map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+            close(fd);
+            Py_DECREF(path_obj);
+            return NULL;
+        }
+        madvise(map, (size_t)sb.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    Py_DECREF(path_obj);
+
+    struct scan_state st = {
+        .tag_set = tag_set,
+        .results = PyList_New(0),
+        .tags = PyDict_New(),
+        .json_buffer = PyList_New(0),
+        .lazy_context = lazy_context,
+    };
+
+    int rc = -1;
+    if (st.results && st.tags && st.json_buffer)
+        rc = map ? scan_buffer(&st, map, (size_t)sb.st_size) : 0;
+
+    if (map)
+        munmap(map, (size_t)sb.st_size);
+    Py_XDECREF(st.tags);
+    Py_XDECREF(st.json_buffer);
+
+    if (rc < 0) {
+        Py_XDECREF(st.results);
+        return NULL;
+    }
+    return st.results;
+}
+
+static PyMethodDef scanner_methods[] = {
+    {"scan_file", scan_file, METH_VARARGS, scan_file_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef scanner_module = {
+    PyModuleDef_HEAD_INIT,
+    "_scanner",
+    "Native breadcrumb scanner used by BreadcrumbParser.parse_file",
+    -1,
+    scanner_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__scanner(void)
+{
+    PyObject* json = PyImport_ImportModule("json");
+    if (json == NULL)
+        return NULL;
+    json_loads = PyObject_GetAttrString(json, "loads");
+    json_decode_error = PyObject_GetAttrString(json, "JSONDecodeError");
+    Py_DECREF(json);
+    if (json_loads == NULL || json_decode_error == NULL)
+        return NULL;
+
+    return PyModule_Create(&scanner_module);
+}
@@ -0,0 +1,275 @@
+"""
+Breadcrumb Index
+Persistent on-disk cache of parsed breadcrumbs, keyed by file stat and content hash
+Only files that changed since the last refresh are re-parsed
+"""
+
+import os
+import json
+import hashlib
+import subprocess
+from dataclasses import asdict
+from pathlib import Path
+from typing import List, Dict, Optional, Any, Iterable, Set
+
+from .parser import BreadcrumbParser, Breadcrumb, DEFAULT_EXTENSIONS, collect_source_files
+
+
+class BreadcrumbIndex:
+    """Incremental breadcrumb index stored as a single JSON file
+    
+    Each indexed file records its mtime, size, SHA-256 and parsed breadcrumbs.
+    A refresh stats every file and only hashes those whose stat changed; only
+    files whose content hash changed are re-parsed. When the tree is a git
+    checkout, refresh_from_git() skips the walk entirely and only looks at
+    paths reported by git diff since the last refresh, plus the paths that
+    had uncommitted changes then (a reverted edit no longer shows in the diff).
+    """
+    
+    VERSION = 1
+    
+    def __init__(self, index_path: str, use_native: bool = True):
+        self.index_path = Path(index_path)
+        self.use_native = use_native
+        
+        # path -> {'mtime_ns', 'size', 'sha256', 'breadcrumbs': [Breadcrumb]}
+        self.files: Dict[str, Dict[str, Any]] = {}
+        # indexed root -> {'extensions': [...], 'git_head': str or None,
+        #                  'git_dirty': [paths uncommitted at that head]}
+        self.roots: Dict[str, Dict[str, Any]] = {}
+        self._dirty = False
+        
+        self.load()
+    
+    def load(self) -> None:
+        """Load the index from disk, starting empty if missing or stale"""
+        if not self.index_path.exists():
+            return
+        
+        try:
+            with open(self.index_path, 'r') as f:
+                data = json.load(f)
+        except (OSError, json.JSONDecodeError) as e:
+            print(f"Ignoring unreadable breadcrumb index {self.index_path}: {e}")
+            return
+        
+        if data.get('version') != self.VERSION:
+            return
+        
+        self.roots = data.get('roots', {})
+        for path, entry in data.get('files', {}).items():
+            entry['breadcrumbs'] = [Breadcrumb(**bc) for bc in entry['breadcrumbs']]
+            self.files[path] = entry
+    
+    def save(self) -> None:
+        """Write the index atomically if anything changed"""
+        if not self._dirty:
+            return
+        
+        data = {
+            'version': self.VERSION,
+            'roots': self.roots,
+            'files': {
+                path: dict(entry, breadcrumbs=[asdict(bc) for bc in entry['breadcrumbs']])
+                for path, entry in self.files.items()
+            }
+        }
+        
+        self.index_path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path = self.index_path.with_suffix(self.index_path.suffix + '.tmp')
+        with open(tmp_path, 'w') as f:
+            json.dump(data, f, separators=(',', ':'))
+        os.replace(tmp_path, self.index_path)
+        self._dirty = False
+    
+    def refresh(
+        self,
+        directory: str,
+        extensions: Optional[Iterable[str]] = None,
+        changed: Optional[Iterable[str]] = None,
+        workers: Optional[int] = 1
+    ) -> Dict[str, int]:
+        """Bring the index up to date for a directory tree
+        
+        Args:
+            directory: Root of the tree to index
+            extensions: File extensions to include (default: DEFAULT_EXTENSIONS)
+            changed: Paths known to have changed; when given (and the root was
+                indexed before with the same extensions) no walk is done
+            workers: Worker processes for re-parsing (None for one per core)
+        
+        Returns:
+            Counts of files checked, re-parsed and removed
+        """
+        root = os.path.abspath(directory)
+        suffixes = tuple(extensions or DEFAULT_EXTENSIONS)
+        known = self.roots.get(root)
+        
+        if changed is not None and known and tuple(known['extensions']) == suffixes:
+            candidates = {
+                os.path.abspath(p) for p in changed
+                if p.endswith(suffixes) and _is_under(os.path.abspath(p), root)
+            }
+        else:
+            candidates = set(collect_source_files(root, suffixes))
+            # Files that vanished since the last full walk
+            candidates.update(p for p in self.files if _is_under(p, root))
+        
+        stats = self._update(candidates, workers)
+        
+        if not known or tuple(known['extensions']) != suffixes:
+            self.roots[root] = {'extensions': list(suffixes), 'git_head': None}
+            self._dirty = True
+        
+        self.save()
+        return stats
+    
+    def refresh_from_git(
+        self,
+        directory: str,
+        extensions: Optional[Iterable[str]] = None,
+        workers: Optional[int] = 1
+    ) -> Dict[str, int]:
+        """Refresh using git to find changed files, e.g. after sync_aros_upstream.sh
+        
+        Falls back to a full stat walk when the directory is not a git
+        checkout or has not been indexed at a known commit yet.
+        """
+        root = os.path.abspath(directory)
+        head = _git_head(root)
+        known = self.roots.get(root, {})
+        
+        dirty = git_changed_files(root, head) if head else None
+        
+        changed = None
+        if dirty is not None and known.get('git_head'):
+            if known['git_head'] == head:
+                changed = list(dirty)
+            else:
+                changed = git_changed_files(root, known['git_head'])
+            if changed is not None:
+                changed.extend(known.get('git_dirty', []))
+        
+        stats = self.refresh(root, extensions, changed=changed, workers=workers)
+        
+        entry = self.roots[root]
+        if dirty is None:
+            if entry.get('git_head') is not None:
+                # Not a usable checkout any more; walk next time
+                entry['git_head'] = None
+                entry.pop('git_dirty', None)
+                self._dirty = True
+        elif entry.get('git_head') != head or entry.get('git_dirty') != sorted(dirty):
+            entry['git_head'] = head
+            entry['git_dirty'] = sorted(dirty)
+            self._dirty = True
+        self.save()
+        
+        return stats
+    
+    def get_breadcrumbs(self, directory: Optional[str] = None) -> List[Breadcrumb]:
+        """Get indexed breadcrumbs, optionally limited to a directory tree
+        
+        Returns:
+            Breadcrumbs sorted by file and line
+        """
+        root = os.path.abspath(directory) if directory else None
+        breadcrumbs = []
+        
+        for path in sorted(self.files):
+            if root is None or _is_under(path, root):
+                breadcrumbs.extend(self.files[path]['breadcrumbs'])
+        
+        return breadcrumbs
+    
+    def _update(self, candidates: Set[str], workers: Optional[int]) -> Dict[str, int]:
+        """Re-stat candidate paths and re-parse those whose content changed"""
+        stale = {}
+        removed = 0
+        
+        for path in candidates:
+            try:
+                st = os.stat(path)
+            except OSError:
+                if self.files.pop(path, None) is not None:
+                    removed += 1
+                continue
+            
+            entry = self.files.get(path)
+            if entry and entry['mtime_ns'] == st.st_mtime_ns and entry['size'] == st.st_size:
+                continue
+            
+            try:
+                digest = _hash_file(path)
+            except OSError:
+                continue
+            
+            if entry and entry['sha256'] == digest:
+                # Touched but unchanged
+                entry['mtime_ns'] = st.st_mtime_ns
+                entry['size'] = st.st_size
+                self._dirty = True
+                continue
+            
+            stale[path] = {
+                'mtime_ns': st.st_mtime_ns,
+                'size': st.st_size,
+                'sha256': digest,
+                'breadcrumbs': []
+            }
+        
+        if stale:
+            parser = BreadcrumbParser(use_native=self.use_native)
+            for bc in parser.parse_files(list(stale), workers):
+                stale[bc.file_path]['breadcrumbs'].append(bc)
+            self.files.update(stale)
+            self._dirty = True
+        
+        if removed:
+            self._dirty = True
+        
+        return {'checked': len(candidates), 'reparsed': len(stale), 'removed': removed}
+
+
+def git_changed_files(repo_path: str, since: str) -> Optional[List[str]]:
+    """List files changed in a git checkout since a commit
+    
+    Covers committed changes (e.g. an upstream merge), uncommitted edits and
+    untracked files. Renames are listed as both paths, so the old one is
+    dropped from the index. Returns absolute paths, or None if git can't answer.
+    """
+    try:
+        top = _git(repo_path, 'rev-parse', '--show-toplevel').strip()
+        diff = _git(repo_path, 'diff', '--name-only', '--no-renames', since, '--', '.')
+        untracked = _git(repo_path, 'ls-files', '--others', '--exclude-standard', '--full-name', '--', '.')
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    
+    names = diff.splitlines() + untracked.splitlines()
+    return [os.path.join(top, name) for name in names if name]
+
+
+def _git(repo_path: str, *args: str) -> str:
+    return subprocess.run(
+        ['git', '-C', repo_path, *args],
+        capture_output=True, text=True, check=True
+    ).stdout
+
+
+def _git_head(repo_path: str) -> Optional[str]:
+    try:
+        return _git(repo_path, 'rev-parse', 'HEAD').strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def _hash_file(path: str) -> str:
+    digest = hashlib.sha256()
+    with open(path, 'rb') as f:
+        for chunk in iter(lambda: f.read(1 << 20), b''):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def _is_under(path: str, root: str) -> bool:
+    return path == root or path.startswith(root.rstrip(os.sep) + os.sep)
@@ -4,11 +4,22 @@ Extracts AI breadcrumb metadata from source files
 Supports both // line comments and /* */ block comments
 """
 
+import os
 import re
+import sys
 import json
+import queue
+import multiprocessing
 from dataclasses import dataclass, field
 from typing import List, Dict, Optional, Any, Iterable
 
+try:
+    from . import _scanner
+except ImportError:
+    # Native scanner not built (python3 setup.py build_ext --inplace);
+    # parse_file falls back to the regex loop
+    _scanner = None
+
 
 # Complete tag set for breadcrumb metadata
 TAG_SET = {
@@ -27,6 +38,15 @@ TAG_SET = {
     'AI_TIMEOUT', 'AI_RETRY_COUNT', 'AI_MAX_RETRIES'
 }
 
+# Source file extensions scanned by default
+DEFAULT_EXTENSIONS = ('.c', '.h', '.cpp', '.hpp')
+
+# Files a worker claims from its own range at a time during parallel scans
+_SCAN_BATCH = 4
+
+# How often parse_files() checks that its workers are still alive
+_WORKER_POLL_SECONDS = 0.5
+
 
 @dataclass
 class Breadcrumb:
@@ -78,11 +98,211 @@ class Breadcrumb:
     raw_tags: Dict[str, str] = field(default_factory=dict)
 
 
+# Breadcrumb attribute -> the tag it holds
+FIELD_TAGS = {
+    'phase': 'AI_PHASE',
+    'status': 'AI_STATUS',
+    'pattern': 'AI_PATTERN',
+    'strategy': 'AI_STRATEGY',
+    'details': 'AI_DETAILS',
+    'compiler_err': 'COMPILER_ERR',
+    'runtime_err': 'RUNTIME_ERR',
+    'fix_reason': 'FIX_REASON',
+    'ai_note': 'AI_NOTE',
+    'ai_breadcrumb': 'AI_BREADCRUMB',
+    'ai_history': 'AI_HISTORY',
+    'ai_change': 'AI_CHANGE',
+    'ai_version': 'AI_VERSION',
+    'ai_train_hash': 'AI_TRAIN_HASH',
+    'linux_ref': 'LINUX_REF',
+    'amigaos_ref': 'AMIGAOS_REF',
+    'aros_impl': 'AROS_IMPL',
+    'ref_github_issue': 'REF_GITHUB_ISSUE',
+    'ref_pr': 'REF_PR',
+    'ref_trouble_ticket': 'REF_TROUBLE_TICKET',
+    'ref_user_feedback': 'REF_USER_FEEDBACK',
+    'ref_audit_log': 'REF_AUDIT_LOG',
+    'human_override': 'HUMAN_OVERRIDE',
+    'previous_implementation_ref': 'PREVIOUS_IMPLEMENTATION_REF',
+    'correction_ref': 'CORRECTION_REF',
+    'ai_context': 'AI_CONTEXT',
+    # Distributed AI Development Fields
+    'ai_assigned_to': 'AI_ASSIGNED_TO',
+    'ai_claimed_at': 'AI_CLAIMED_AT',
+    'ai_estimated_time': 'AI_ESTIMATED_TIME',
+    'ai_priority': 'AI_PRIORITY',
+    'ai_dependencies': 'AI_DEPENDENCIES',
+    'ai_blocks': 'AI_BLOCKS',
+    'ai_complexity': 'AI_COMPLEXITY',
+    'ai_bounty': 'AI_BOUNTY',
+    'ai_timeout': 'AI_TIMEOUT',
+    'ai_retry_count': 'AI_RETRY_COUNT',
+    'ai_max_retries': 'AI_MAX_RETRIES',
+}
+
+# Tags drawn from small vocabularies (statuses, phases, agents, reference
+# paths); compact breadcrumbs share one copy of each distinct value
+INTERNED_TAGS = frozenset({
+    'AI_PHASE', 'AI_STATUS', 'AI_PATTERN', 'AI_VERSION', 'AI_BREADCRUMB',
+    'LINUX_REF', 'AMIGAOS_REF', 'AROS_IMPL', 'HUMAN_OVERRIDE',
+    'AI_ASSIGNED_TO', 'AI_ESTIMATED_TIME', 'AI_PRIORITY', 'AI_DEPENDENCIES',
+    'AI_BLOCKS', 'AI_COMPLEXITY', 'AI_BOUNTY', 'AI_RETRY_COUNT', 'AI_MAX_RETRIES'
+})
+
+
+class _TagLayout:
+    """The tags a compact breadcrumb has, in order; shared by every
+    breadcrumb with the same tag set"""
+    
+    __slots__ = ('tags', 'index')
+    
+    def __init__(self, tags: tuple):
+        self.tags = tags
+        self.index = {tag: i for i, tag in enumerate(tags)}
+
+
+_layouts: Dict[tuple, _TagLayout] = {}
+
+
+def _layout_for(tags: tuple) -> _TagLayout:
+    layout = _layouts.get(tags)
+    if layout is None:
+        layout = _layouts.setdefault(tags, _TagLayout(tuple(sys.intern(tag) for tag in tags)))
+    return layout
+
+
+def context_complete(text: str) -> bool:
+    """Whether collected AI_CONTEXT text is one whole JSON object
+    
+    Matches braces outside string literals instead of parsing, so compact
+    parsing can defer json.loads until the context is read.
+    """
+    text = text.strip()
+    if not text.startswith('{'):
+        return False
+    depth = 0
+    in_string = False
+    escaped = False
+    for i, ch in enumerate(text):
+        if in_string:
+            if escaped:
+                escaped = False
+            elif ch == '\\':
+                escaped = True
+            elif ch == '"':
+                in_string = False
+        elif ch == '"':
+            in_string = True
+        elif ch == '{':
+            depth += 1
+        elif ch == '}':
+            depth -= 1
+            if depth == 0:
+                return i == len(text) - 1
+    return False
+
+
+class CompactBreadcrumb:
+    """Read-only Breadcrumb for holding a whole tree's worth in memory
+    
+    Stores only the tags present, as a tuple of values laid out by a shared
+    _TagLayout, instead of ~40 attribute slots plus a raw_tags dict.
+    Vocabulary values (INTERNED_TAGS), the file path and AI_CONTEXT text
+    are interned, and AI_CONTEXT stays JSON text until ai_context is first
+    read (None if it doesn't parse; each breadcrumb then keeps its own
+    parsed copy). Attributes read the same as on Breadcrumb.
+    """
+    
+    __slots__ = ('file_path', 'line_number', '_layout', '_values', '_context')
+    __hash__ = None  # Like the Breadcrumb dataclass
+    
+    def __init__(self, file_path: str, line_number: int, tags: Dict[str, Any]):
+        names = tuple(tag for tag in tags if tag != 'AI_CONTEXT')
+        self.file_path = sys.intern(file_path)
+        self.line_number = line_number
+        self._layout = _layout_for(names)
+        self._values = tuple(
+            sys.intern(tags[tag]) if tag in INTERNED_TAGS else tags[tag] for tag in names
+        )
+        context = tags.get('AI_CONTEXT')
+        # Context blocks are often copied verbatim between breadcrumbs
+        self._context = sys.intern(context) if isinstance(context, str) else context
+    
+    def __getattr__(self, name: str):
+        # Only reached for names that aren't slots: the Breadcrumb fields
+        tag = FIELD_TAGS.get(name)
+        if tag is None:
+            raise AttributeError(f"'CompactBreadcrumb' object has no attribute '{name}'")
+        return self.get_tag(tag)
+    
+    def get_tag(self, tag: str) -> Any:
+        """Value of a tag, or None when absent"""
+        if tag == 'AI_CONTEXT':
+            return self.ai_context
+        i = self._layout.index.get(tag)
+        return None if i is None else self._values[i]
+    
+    @property
+    def ai_context(self) -> Optional[Dict[str, Any]]:
+        context = self._context
+        if isinstance(context, str):
+            try:
+                context = json.loads(context)
+            except json.JSONDecodeError:
+                context = None
+            self._context = context
+        return context
+    
+    @property
+    def raw_tags(self) -> Dict[str, Any]:
+        """All tags as a new dict, as on Breadcrumb"""
+        tags = dict(zip(self._layout.tags, self._values))
+        if self._context is not None and self.ai_context is not None:
+            tags['AI_CONTEXT'] = self.ai_context
+        return tags
+    
+    def to_breadcrumb(self) -> Breadcrumb:
+        """Full Breadcrumb with the same contents"""
+        fields = {name: self.get_tag(tag) for name, tag in FIELD_TAGS.items()}
+        return Breadcrumb(file_path=self.file_path, line_number=self.line_number,
+                          raw_tags=self.raw_tags, **fields)
+    
+    def __eq__(self, other: Any) -> bool:
+        if other is self:
+            return True
+        if isinstance(other, CompactBreadcrumb):
+            if (other.file_path, other.line_number) != (self.file_path, self.line_number):
+                return False
+            other = other.to_breadcrumb()
+        elif not isinstance(other, Breadcrumb):
+            return NotImplemented
+        return self.to_breadcrumb() == other
+    
+    def __reduce__(self):
+        # Unpickled strings are fresh copies; re-intern them (parallel scans)
+        return (_compact_from_state,
+                (self.file_path, self.line_number, self._layout.tags, self._values, self._context))
+    
+    def __repr__(self) -> str:
+        tags = ', '.join(f"{tag}={value!r}" for tag, value in zip(self._layout.tags, self._values))
+        return f"CompactBreadcrumb({self.file_path!r}, {self.line_number}, {tags})"
+
+
+def _compact_from_state(file_path, line_number, tags, values, context) -> CompactBreadcrumb:
+    state = dict(zip(tags, values))
+    if context is not None:
+        state['AI_CONTEXT'] = context
+    return CompactBreadcrumb(file_path, line_number, state)
+
+
 class BreadcrumbParser:
     """Parser for AI breadcrumb metadata in source files
     
     Supports both // line comments and /* */ block comments.
     Handles JSON AI_CONTEXT blocks and flushes at EOF.
+    Uses the native scanner when it has been built, unless use_native is False.
+    With compact=True it produces CompactBreadcrumbs, for full-tree scans
+    held in memory; AI_CONTEXT is then only parsed when read.
     """
     
     # Use the global TAG_SET
@@ -94,14 +314,91 @@ class BreadcrumbParser:
     _block_tag_re = re.compile(r'^\s*\*?\s*(?P<tag>\w+):\s*(?P<value>.*)$')
     _block_end_re = re.compile(r'^\s*\*/\s*$')
     
-    def __init__(self):
-        self.breadcrumbs: List[Breadcrumb] = []
+    # Single-valued fields with a lookup index: index name -> Breadcrumb attribute
+    _INDEXED_FIELDS = {
+        'phase': 'phase',
+        'status': 'status',
+        'pattern': 'pattern',
+        'assigned_to': 'ai_assigned_to',
+        'marker': 'ai_breadcrumb',
+        'linux_ref': 'linux_ref',
+        'amigaos_ref': 'amigaos_ref',
+        'correction_ref': 'correction_ref',
+        'previous_ref': 'previous_implementation_ref',
+        'file': 'file_path',
+    }
+    
+    def __init__(self, use_native: bool = True, compact: bool = False):
+        self.use_native = use_native and _scanner is not None
+        self.compact = compact
+        self.breadcrumbs = []
         self._in_block_comment = False
         self._current_tags: Dict[str, Any] = {}
         self._start_line: Optional[int] = None
         self._json_buffer: List[str] = []
         self._in_json = False
     
+    @property
+    def breadcrumbs(self) -> List[Breadcrumb]:
+        """All parsed breadcrumbs, in parse order"""
+        return self._breadcrumbs
+    
+    @breadcrumbs.setter
+    def breadcrumbs(self, breadcrumbs: List[Breadcrumb]) -> None:
+        self._breadcrumbs = breadcrumbs
+        self._reset_indexes()
+    
+    def _reset_indexes(self) -> None:
+        """Drop all lookup indexes; they are rebuilt on the next query"""
+        # Index name -> key -> positions in self._breadcrumbs, ascending
+        self._indexes: Dict[str, Dict[str, List[int]]] = {
+            name: {} for name in self._INDEXED_FIELDS
+        }
+        # Phase -> positions of breadcrumbs listing it in AI_DEPENDENCIES / AI_BLOCKS
+        self._indexes['dependents'] = {}
+        self._indexes['blocked_by'] = {}
+        self._indexed_count = 0
+        self._related_cache: Dict[int, Any] = {}
+    
+    def _ensure_indexed(self) -> None:
+        """Index breadcrumbs added since the last query
+        
+        Appends (including direct appends to self.breadcrumbs) are indexed
+        incrementally; a list that shrank is re-indexed from scratch.
+        """
+        total = len(self._breadcrumbs)
+        if total == self._indexed_count:
+            return
+        if total < self._indexed_count:
+            self._reset_indexes()
+        
+        indexes = self._indexes
+        for pos in range(self._indexed_count, total):
+            bc = self._breadcrumbs[pos]
+            for name, attr in self._INDEXED_FIELDS.items():
+                key = getattr(bc, attr)
+                if key is not None:
+                    indexes[name].setdefault(key, []).append(pos)
+            for phase in _split_phases(bc.ai_dependencies):
+                indexes['dependents'].setdefault(phase, []).append(pos)
+            for phase in _split_phases(bc.ai_blocks):
+                indexes['blocked_by'].setdefault(phase, []).append(pos)
+        
+        self._indexed_count = total
+        self._related_cache.clear()
+    
+    def _lookup(self, index: str, *keys: Optional[str]) -> List[Breadcrumb]:
+        """Breadcrumbs matching any of the keys in an index, in parse order"""
+        self._ensure_indexed()
+        table = self._indexes[index]
+        
+        if len(keys) == 1:
+            positions = table.get(keys[0], [])
+        else:
+            positions = sorted(set(pos for key in keys for pos in table.get(key, [])))
+        
+        return [self._breadcrumbs[pos] for pos in positions]
+    
     def parse_file(self, file_path: str) -> List[Breadcrumb]:
         """Parse breadcrumbs from a single file
         
@@ -111,36 +408,144 @@ class BreadcrumbParser:
         breadcrumbs = []
         
         try:
-            with open(file_path, 'r', encoding='utf-8', errors='ignore') as f:
-                lines = f.readlines()
-            
-            # Reset parser state
-            self._in_block_comment = False
-            self._current_tags = {}
-            self._start_line = None
-            self._json_buffer = []
-            self._in_json = False
-            
-            for i, line in enumerate(lines, 1):
-                self._parse_line(line, i, file_path, breadcrumbs)
-            
-            # Flush any remaining breadcrumb at EOF
-            if self._current_tags:
-                breadcrumb = self._create_breadcrumb(
-                    file_path, 
-                    self._start_line or len(lines), 
-                    self._current_tags
-                )
-                breadcrumbs.append(breadcrumb)
-                self._current_tags = {}
-                self._start_line = None
-            
+            if self.use_native:
+                self._parse_file_native(file_path, breadcrumbs)
+            else:
+                self._parse_file_python(file_path, breadcrumbs)
         except Exception as e:
             print(f"Error parsing {file_path}: {e}")
         
         self.breadcrumbs.extend(breadcrumbs)
         return breadcrumbs
     
+    def parse_directory(
+        self,
+        directory: str,
+        extensions: Optional[Iterable[str]] = None,
+        workers: Optional[int] = None
+    ) -> List[Breadcrumb]:
+        """Parse every matching file under a directory tree in parallel
+        
+        Args:
+            directory: Root of the tree to scan
+            extensions: File extensions to include (default: DEFAULT_EXTENSIONS)
+            workers: Number of worker processes (default: one per core)
+            
+        Returns:
+            List of breadcrumbs found, sorted by file and line
+        """
+        return self.parse_files(collect_source_files(directory, extensions), workers)
+    
+    def parse_files(self, files: List[str], workers: Optional[int] = None) -> List[Breadcrumb]:
+        """Parse a list of files in parallel
+        
+        Files are split into one contiguous range per worker process, each
+        with its own parser state. A worker that runs out of files steals the
+        back half of the largest remaining range, so a few huge files don't
+        leave the other cores idle. Results are merged deterministically,
+        ordered by file path and line number.
+        
+        Args:
+            files: Paths of the files to parse
+            workers: Number of worker processes (default: one per core)
+            
+        Returns:
+            List of breadcrumbs found, sorted by file and line
+        
+        Raises:
+            RuntimeError: A worker process died before reporting its results
+        """
+        files = sorted(files)
+        workers = min(workers or os.cpu_count() or 1, len(files))
+        
+        if workers <= 1 or len(files) < workers * _SCAN_BATCH * 2:
+            # Not worth starting processes for
+            found = []
+            for file_path in files:
+                found.extend(self.parse_file(file_path))
+            return found
+        
+        # Each worker owns files[bounds[2w]:bounds[2w + 1]], guarded by locks[w]
+        bounds = multiprocessing.Array('q', 2 * workers, lock=False)
+        chunk = len(files) // workers
+        for w in range(workers):
+            bounds[2 * w] = w * chunk
+            bounds[2 * w + 1] = len(files) if w == workers - 1 else (w + 1) * chunk
+        locks = [multiprocessing.Lock() for _ in range(workers)]
+        results = multiprocessing.Queue()
+        
+        processes = [
+            multiprocessing.Process(
+                target=_scan_worker,
+                args=(w, files, bounds, locks, results, self.use_native, self.compact),
+                daemon=True
+            )
+            for w in range(workers)
+        ]
+        for process in processes:
+            process.start()
+        
+        # Drain results before joining so large payloads can't block a worker.
+        # A worker killed mid-scan (OOM killer, a crash in the native scanner)
+        # never reports and may hold a range lock, so don't wait on it forever.
+        found = []
+        pending = len(processes)
+        try:
+            while pending:
+                try:
+                    found.extend(results.get(timeout=_WORKER_POLL_SECONDS))
+                    pending -= 1
+                except queue.Empty:
+                    for process in processes:
+                        if process.exitcode not in (None, 0):
+                            raise RuntimeError(
+                                f"Breadcrumb scan worker {process.pid} died "
+                                f"(exit code {process.exitcode})"
+                            )
+        except BaseException:
+            for process in processes:
+                if process.is_alive():
+                    process.terminate()
+            raise
+        finally:
+            for process in processes:
+                process.join()
+        
+        found.sort(key=lambda bc: (bc.file_path, bc.line_number))
+        self.breadcrumbs.extend(found)
+        return found
+    
+    def _parse_file_native(self, file_path: str, breadcrumbs: List[Breadcrumb]) -> None:
+        """Scan a file with the native scanner (same records as the regex loop)"""
+        for start_line, tags in _scanner.scan_file(file_path, frozenset(self.BREADCRUMB_TAGS), self.compact):
+            breadcrumbs.append(self._create_breadcrumb(file_path, start_line, tags))
+    
+    def _parse_file_python(self, file_path: str, breadcrumbs: List[Breadcrumb]) -> None:
+        """Scan a file line by line with the regex patterns"""
+        with open(file_path, 'r', encoding='utf-8', errors='ignore') as f:
+            lines = f.readlines()
+        
+        # Reset parser state
+        self._in_block_comment = False
+        self._current_tags = {}
+        self._start_line = None
+        self._json_buffer = []
+        self._in_json = False
+        
+        for i, line in enumerate(lines, 1):
+            self._parse_line(line, i, file_path, breadcrumbs)
+        
+        # Flush any remaining breadcrumb at EOF
+        if self._current_tags:
+            breadcrumb = self._create_breadcrumb(
+                file_path, 
+                self._start_line or len(lines), 
+                self._current_tags
+            )
+            breadcrumbs.append(breadcrumb)
+            self._current_tags = {}
+            self._start_line = None
+    
     def _parse_line(self, line: str, line_num: int, file_path: str, breadcrumbs: List[Breadcrumb]) -> None:
         """Parse a single line for breadcrumb tags"""
         stripped = line.strip()
@@ -236,7 +641,13 @@ class BreadcrumbParser:
         """Try to parse accumulated JSON buffer"""
         try:
             json_str = ' '.join(self._json_buffer)
-            self._current_tags['AI_CONTEXT'] = json.loads(json_str)
+            if self.compact:
+                # Kept as text; CompactBreadcrumb parses it on first access
+                if not context_complete(json_str):
+                    return
+                self._current_tags['AI_CONTEXT'] = json_str
+            else:
+                self._current_tags['AI_CONTEXT'] = json.loads(json_str)
             self._in_json = False
             self._json_buffer = []
         except json.JSONDecodeError:
@@ -244,75 +655,41 @@ class BreadcrumbParser:
             pass
     
     def _create_breadcrumb(self, file_path: str, line_number: int, tags: Dict[str, Any]) -> Breadcrumb:
-        """Create a Breadcrumb object from parsed tags"""
-        return Breadcrumb(
-            file_path=file_path,
-            line_number=line_number,
-            phase=tags.get('AI_PHASE'),
-            status=tags.get('AI_STATUS'),
-            pattern=tags.get('AI_PATTERN'),
-            strategy=tags.get('AI_STRATEGY'),
-            details=tags.get('AI_DETAILS'),
-            compiler_err=tags.get('COMPILER_ERR'),
-            runtime_err=tags.get('RUNTIME_ERR'),
-            fix_reason=tags.get('FIX_REASON'),
-            ai_note=tags.get('AI_NOTE'),
-            ai_breadcrumb=tags.get('AI_BREADCRUMB'),
-            ai_history=tags.get('AI_HISTORY'),
-            ai_change=tags.get('AI_CHANGE'),
-            ai_version=tags.get('AI_VERSION'),
-            ai_train_hash=tags.get('AI_TRAIN_HASH'),
-            linux_ref=tags.get('LINUX_REF'),
-            amigaos_ref=tags.get('AMIGAOS_REF'),
-            aros_impl=tags.get('AROS_IMPL'),
-            ref_github_issue=tags.get('REF_GITHUB_ISSUE'),
-            ref_pr=tags.get('REF_PR'),
-            ref_trouble_ticket=tags.get('REF_TROUBLE_TICKET'),
-            ref_user_feedback=tags.get('REF_USER_FEEDBACK'),
-            ref_audit_log=tags.get('REF_AUDIT_LOG'),
-            human_override=tags.get('HUMAN_OVERRIDE'),
-            previous_implementation_ref=tags.get('PREVIOUS_IMPLEMENTATION_REF'),
-            correction_ref=tags.get('CORRECTION_REF'),
-            ai_context=tags.get('AI_CONTEXT'),
-            # Distributed AI Development Fields
-            ai_assigned_to=tags.get('AI_ASSIGNED_TO'),
-            ai_claimed_at=tags.get('AI_CLAIMED_AT'),
-            ai_estimated_time=tags.get('AI_ESTIMATED_TIME'),
-            ai_priority=tags.get('AI_PRIORITY'),
-            ai_dependencies=tags.get('AI_DEPENDENCIES'),
-            ai_blocks=tags.get('AI_BLOCKS'),
-            ai_complexity=tags.get('AI_COMPLEXITY'),
-            ai_bounty=tags.get('AI_BOUNTY'),
-            ai_timeout=tags.get('AI_TIMEOUT'),
-            ai_retry_count=tags.get('AI_RETRY_COUNT'),
-            ai_max_retries=tags.get('AI_MAX_RETRIES'),
-            raw_tags=tags
-        )
+        """Create a Breadcrumb (or CompactBreadcrumb) object from parsed tags"""
+        if self.compact:
+            return CompactBreadcrumb(file_path, line_number, tags)
+        fields = {name: tags.get(tag) for name, tag in FIELD_TAGS.items()}
+        return Breadcrumb(file_path=file_path, line_number=line_number, raw_tags=tags, **fields)
     
     def get_breadcrumbs_by_phase(self, phase: str) -> List[Breadcrumb]:
         """Get all breadcrumbs for a specific phase"""
-        return [b for b in self.breadcrumbs if b.phase == phase]
+        return self._lookup('phase', phase)
     
     def get_breadcrumbs_by_status(self, status: str) -> List[Breadcrumb]:
         """Get all breadcrumbs with a specific status"""
-        return [b for b in self.breadcrumbs if b.status == status]
+        return self._lookup('status', status)
+    
+    def get_breadcrumbs_by_pattern(self, pattern: str) -> List[Breadcrumb]:
+        """Get all breadcrumbs with a specific AI_PATTERN"""
+        return self._lookup('pattern', pattern)
+    
+    def get_breadcrumbs_by_assignee(self, assigned_to: str) -> List[Breadcrumb]:
+        """Get all breadcrumbs claimed by a specific agent (AI_ASSIGNED_TO)"""
+        return self._lookup('assigned_to', assigned_to)
+    
+    def get_dependents(self, phase: str) -> List[Breadcrumb]:
+        """Get breadcrumbs that list a phase in their AI_DEPENDENCIES"""
+        return self._lookup('dependents', phase)
     
     def get_statistics(self) -> Dict[str, Any]:
         """Get statistics about parsed breadcrumbs"""
-        phases = {}
-        statuses = {}
-        
-        for bc in self.breadcrumbs:
-            if bc.phase:
-                phases[bc.phase] = phases.get(bc.phase, 0) + 1
-            if bc.status:
-                statuses[bc.status] = statuses.get(bc.status, 0) + 1
+        self._ensure_indexed()
         
         return {
-            'total_breadcrumbs': len(self.breadcrumbs),
-            'phases': phases,
-            'statuses': statuses,
-            'files_with_breadcrumbs': len(set(b.file_path for b in self.breadcrumbs))
+            'total_breadcrumbs': len(self._breadcrumbs),
+            'phases': {k: len(v) for k, v in self._indexes['phase'].items() if k},
+            'statuses': {k: len(v) for k, v in self._indexes['status'].items() if k},
+            'files_with_breadcrumbs': len(self._indexes['file'])
         }
     
     def get_breadcrumb_map(self) -> Dict[str, List[Breadcrumb]]:
@@ -322,22 +699,21 @@ class BreadcrumbParser:
         lists of breadcrumbs with that marker. This enables bidirectional
         navigation between related code components.
         """
-        breadcrumb_map = {}
+        self._ensure_indexed()
         
-        for bc in self.breadcrumbs:
-            if bc.ai_breadcrumb:
-                marker = bc.ai_breadcrumb
-                if marker not in breadcrumb_map:
-                    breadcrumb_map[marker] = []
-                breadcrumb_map[marker].append(bc)
-        
-        return breadcrumb_map
+        return {
+            marker: [self._breadcrumbs[pos] for pos in positions]
+            for marker, positions in self._indexes['marker'].items()
+            if marker
+        }
     
     def find_related_breadcrumbs(self, breadcrumb: Breadcrumb) -> List[Breadcrumb]:
         """Find all breadcrumbs related to the given breadcrumb
         
         Uses AI_BREADCRUMB markers to find bidirectionally related breadcrumbs.
         Also checks dependencies, blocks, and reference relationships.
+        Each lookup goes through the parser's indexes, and results are cached
+        until more breadcrumbs are added.
         
         Args:
             breadcrumb: The breadcrumb to find relations for
@@ -345,71 +721,150 @@ class BreadcrumbParser:
         Returns:
             List of related breadcrumbs
         """
+        self._ensure_indexed()
+        
+        cached = self._related_cache.get(id(breadcrumb))
+        if cached is not None and cached[0] is breadcrumb:
+            return list(cached[1])
+        
         related = []
         
         # Find by AI_BREADCRUMB marker
         if breadcrumb.ai_breadcrumb:
-            breadcrumb_map = self.get_breadcrumb_map()
-            marker_matches = breadcrumb_map.get(breadcrumb.ai_breadcrumb, [])
-            # Don't include the original breadcrumb
-            related.extend([bc for bc in marker_matches if bc != breadcrumb])
+            related.extend(self._lookup('marker', breadcrumb.ai_breadcrumb))
         
         # Find by dependencies and blocks (bidirectional)
         if breadcrumb.ai_dependencies:
-            deps = [d.strip() for d in breadcrumb.ai_dependencies.split(',')]
-            for bc in self.breadcrumbs:
-                if bc.phase in deps and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('phase', *_split_phases(breadcrumb.ai_dependencies)))
         
         if breadcrumb.ai_blocks:
-            blocks = [b.strip() for b in breadcrumb.ai_blocks.split(',')]
-            for bc in self.breadcrumbs:
-                if bc.phase in blocks and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('phase', *_split_phases(breadcrumb.ai_blocks)))
         
         # Find reverse dependencies (who depends on this breadcrumb)
         if breadcrumb.phase:
-            for bc in self.breadcrumbs:
-                if bc.ai_dependencies:
-                    deps = [d.strip() for d in bc.ai_dependencies.split(',')]
-                    if breadcrumb.phase in deps and bc != breadcrumb:
-                        related.append(bc)
-                if bc.ai_blocks:
-                    blocks = [b.strip() for b in bc.ai_blocks.split(',')]
-                    if breadcrumb.phase in blocks and bc != breadcrumb:
-                        related.append(bc)
+            positions = sorted(set(
+                self._indexes['dependents'].get(breadcrumb.phase, []) +
+                self._indexes['blocked_by'].get(breadcrumb.phase, [])
+            ))
+            related.extend(self._breadcrumbs[pos] for pos in positions)
         
         # Find by reference relationships (LINUX_REF, AMIGAOS_REF, etc.)
         if breadcrumb.linux_ref:
-            for bc in self.breadcrumbs:
-                if bc.linux_ref == breadcrumb.linux_ref and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('linux_ref', breadcrumb.linux_ref))
         
         if breadcrumb.amigaos_ref:
-            for bc in self.breadcrumbs:
-                if bc.amigaos_ref == breadcrumb.amigaos_ref and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('amigaos_ref', breadcrumb.amigaos_ref))
         
         # Find by correction/previous implementation relationships
         if breadcrumb.previous_implementation_ref:
             # This breadcrumb references a previous implementation
-            for bc in self.breadcrumbs:
-                if bc.correction_ref == breadcrumb.file_path and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('correction_ref', breadcrumb.file_path))
         
         if breadcrumb.correction_ref:
             # This breadcrumb is a correction
-            for bc in self.breadcrumbs:
-                if bc.previous_implementation_ref == breadcrumb.file_path and bc != breadcrumb:
-                    related.append(bc)
+            related.extend(self._lookup('previous_ref', breadcrumb.file_path))
         
-        # Remove duplicates while preserving order
+        # Remove self and duplicates while preserving order
         seen = set()
         unique_related = []
         for bc in related:
             key = (bc.file_path, bc.line_number)
-            if key not in seen:
+            if key not in seen and bc != breadcrumb:
                 seen.add(key)
                 unique_related.append(bc)
         
-        return unique_related
+        self._related_cache[id(breadcrumb)] = (breadcrumb, unique_related)
+        return list(unique_related)
+    
+    def get_related_graph(self) -> Dict[int, List[int]]:
+        """Get the full related-breadcrumb graph
+        
+        Returns:
+            Mapping from each breadcrumb's position in self.breadcrumbs to the
+            positions of its related breadcrumbs
+        """
+        position = {id(bc): pos for pos, bc in enumerate(self._breadcrumbs)}
+        return {
+            pos: [position[id(other)] for other in self.find_related_breadcrumbs(bc)]
+            for pos, bc in enumerate(self._breadcrumbs)
+        }
+
+
+def _split_phases(value: Optional[str]) -> List[str]:
+    """Split a comma-separated AI_DEPENDENCIES / AI_BLOCKS value"""
+    if not value:
+        return []
+    return [phase.strip() for phase in value.split(',')]
+
+
+def collect_source_files(directory: str, extensions: Optional[Iterable[str]] = None) -> List[str]:
+    """List source files under a directory tree, sorted by path"""
+    suffixes = tuple(extensions or DEFAULT_EXTENSIONS)
+    files = []
+    
+    for root, _dirs, names in os.walk(directory):
+        for name in names:
+            if name.endswith(suffixes):
+                files.append(os.path.join(root, name))
+    
+    files.sort()
+    return files
+
+
+def _claim_range(bounds, lock, worker: int, count: int) -> Optional[range]:
+    """Take up to count files from the front of a worker's range"""
+    with lock:
+        start, end = bounds[2 * worker], bounds[2 * worker + 1]
+        if start >= end:
+            return None
+        stop = min(start + count, end)
+        bounds[2 * worker] = stop
+    return range(start, stop)
+
+
+def _steal_range(bounds, locks, thief: int) -> bool:
+    """Move the back half of the largest remaining range to the thief
+    
+    Returns False once every range is empty.
+    """
+    workers = len(locks)
+    
+    while True:
+        # Unlocked read to pick a victim; re-checked under its lock
+        victim = max(
+            (w for w in range(workers) if w != thief),
+            key=lambda w: bounds[2 * w + 1] - bounds[2 * w]
+        )
+        with locks[victim]:
+            start, end = bounds[2 * victim], bounds[2 * victim + 1]
+            remaining = end - start
+            if remaining > 0:
+                mid = end - (remaining + 1) // 2
+                bounds[2 * victim + 1] = mid
+        
+        if remaining > 0:
+            with locks[thief]:
+                bounds[2 * thief] = mid
+                bounds[2 * thief + 1] = end
+            return True
+        
+        if all(bounds[2 * w] >= bounds[2 * w + 1] for w in range(workers)):
+            return False
+
+
+def _scan_worker(worker: int, files: List[str], bounds, locks, results, use_native: bool,
+                 compact: bool = False) -> None:
+    """Parallel scan worker: drain own range, then steal until all are empty"""
+    parser = BreadcrumbParser(use_native=use_native, compact=compact)
+    
+    while True:
+        batch = _claim_range(bounds, locks[worker], worker, _SCAN_BATCH)
+        if batch is None:
+            if not _steal_range(bounds, locks, worker):
+                break
+            continue
+        
+        for index in batch:
+            parser.parse_file(files[index])
+    
+    results.put(parser.breadcrumbs)
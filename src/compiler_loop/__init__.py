@@ -4,7 +4,9 @@ Implements the train -> develop -> compile -> errors -> learn loop
 """
 
 from .compiler import CompilerLoop
+from .compile_cache import CompileCache
+from .compile_log import CompileLog
 from .error_tracker import ErrorTracker
 from .reasoning_tracker import ReasoningTracker, ReasoningEntry
 
-__all__ = ['CompilerLoop', 'ErrorTracker', 'ReasoningTracker', 'ReasoningEntry']
+__all__ = ['CompilerLoop', 'CompileCache', 'CompileLog', 'ErrorTracker', 'ReasoningTracker', 'ReasoningEntry']
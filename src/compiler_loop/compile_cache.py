@@ -0,0 +1,157 @@
+"""
+Compile Cache
+Content-addressed cache of compilation results
+"""
+
+import os
+import re
+import copy
+import json
+import hashlib
+import threading
+from pathlib import Path
+from typing import Dict, Any, Optional, Union, Iterable, List
+
+# Environment variables make passes to the compiler
+BUILD_ENV_VARS = ('CC', 'CPP', 'CFLAGS', 'CPPFLAGS', 'LDFLAGS', 'TARGET_CFLAGS')
+
+_INCLUDE_RE = re.compile(r'^\s*#\s*include\s*[<"]([^>"]+)[>"]', re.MULTILINE)
+
+
+class CompileCache:
+    """Caches compile results by a hash of everything that affects the build
+    
+    The key covers the make target, the generated source, the contents of the
+    headers it depends on and the compiler flags. Identical inputs return the
+    stored result (errors and warnings included) without running make.
+    Entries are kept in memory and as one JSON file per key on disk.
+    """
+    
+    def __init__(self, cache_path: str):
+        self.cache_path = Path(cache_path)
+        self._entries: Dict[str, Dict[str, Any]] = {}
+        self._lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+    
+    @staticmethod
+    def make_key(
+        target: Optional[str],
+        source: Union[str, bytes] = '',
+        headers: Optional[Union[Iterable[str], Dict[str, Union[str, bytes]]]] = None,
+        flags: Optional[Iterable[str]] = None,
+        base_path: Optional[str] = None
+    ) -> str:
+        """
+        Hash the inputs of a build
+        
+        Args:
+            target: Make target (None for the default target)
+            source: Generated source code
+            headers: Header paths to read (relative to base_path), or a
+                mapping of header name to contents
+            flags: Compiler flags, in command-line order
+        
+        Returns:
+            Hex SHA-256 cache key
+        """
+        digest = hashlib.sha256()
+        
+        def feed(tag: bytes, data: Union[str, bytes]) -> None:
+            if isinstance(data, str):
+                data = data.encode('utf-8')
+            # Length-prefixed so field boundaries can't be shifted
+            digest.update(tag + len(data).to_bytes(8, 'little') + data)
+        
+        feed(b'T', target or 'all')
+        feed(b'S', source)
+        
+        if isinstance(headers, dict):
+            header_items = [(name, headers[name]) for name in sorted(headers)]
+        else:
+            header_items = []
+            for name in sorted(headers or []):
+                path = Path(base_path) / name if base_path else Path(name)
+                try:
+                    header_items.append((name, path.read_bytes()))
+                except OSError:
+                    header_items.append((name, b'\0missing'))
+        
+        for name, contents in header_items:
+            feed(b'H', name)
+            feed(b'C', contents)
+        
+        for flag in flags or []:
+            feed(b'F', flag)
+        
+        return digest.hexdigest()
+    
+    @staticmethod
+    def environment_flags(env: Optional[Dict[str, str]] = None) -> List[str]:
+        """Build variables set in the environment, as 'NAME=value' flags"""
+        env = os.environ if env is None else env
+        return [f'{name}={env[name]}' for name in BUILD_ENV_VARS if env.get(name)]
+    
+    @staticmethod
+    def included_headers(source: Union[str, bytes]) -> List[str]:
+        """Header names #included by a source file, in order of appearance"""
+        if isinstance(source, bytes):
+            source = source.decode('utf-8', errors='replace')
+        return list(dict.fromkeys(_INCLUDE_RE.findall(source)))
+    
+    def get(self, key: str) -> Optional[Dict[str, Any]]:
+        """Get a copy of a cached result, or None"""
+        with self._lock:
+            result = self._entries.get(key)
+            
+            if result is None:
+                entry_file = self._entry_file(key)
+                if entry_file.exists():
+                    try:
+                        with open(entry_file, 'r') as f:
+                            result = json.load(f)
+                        self._entries[key] = result
+                    except (json.JSONDecodeError, IOError):
+                        result = None
+            
+            if result is None:
+                self.misses += 1
+                return None
+            
+            self.hits += 1
+            return copy.deepcopy(result)
+    
+    def put(self, key: str, result: Dict[str, Any]) -> None:
+        """Store a compile result
+        
+        Only verdicts that follow from the inputs are cached. Builds that
+        were cut short (timeout, error limit), killed by a signal or never
+        started (make missing, Popen failure) depend on the machine, and
+        simulated results on chance, so they are not stored.
+        """
+        if any(result.get(flag) for flag in ('timed_out', 'stopped_early', 'signal',
+                                             'launch_failed', 'simulated')):
+            return
+        
+        stored = copy.deepcopy(result)
+        stored.pop('cached', None)
+        
+        with self._lock:
+            self._entries[key] = stored
+            entry_file = self._entry_file(key)
+            entry_file.parent.mkdir(parents=True, exist_ok=True)
+            with open(entry_file, 'w') as f:
+                json.dump(stored, f, indent=2)
+    
+    def get_statistics(self) -> Dict[str, Any]:
+        """Get cache hit statistics"""
+        lookups = self.hits + self.misses
+        return {
+            'hits': self.hits,
+            'misses': self.misses,
+            'hit_rate': self.hits / lookups if lookups else 0.0,
+            'entries_in_memory': len(self._entries)
+        }
+    
+    def _entry_file(self, key: str) -> Path:
+        return self.cache_path / key[:2] / f'{key}.json'
@@ -0,0 +1,420 @@
+"""
+Compile Log
+Segmented, append-only binary log of compilation results
+"""
+
+import os
+import json
+import mmap
+import fcntl
+import zlib
+import struct
+import threading
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, List, Any, Optional, Iterator, Tuple
+
+
+# Segment layout:
+#   file header | record* | (index record, trailer) when sealed
+# Record: length, crc32 of payload, kind, then payload
+#   KIND_COMPILE payload: fixed summary struct, target, zlib(JSON rest of
+#     result), zlib(stdout), zlib(stderr)
+#   KIND_INDEX payload: previous index offset, count, (iteration, offset)*
+# Every INDEX_INTERVAL records an index record is appended; sealing a segment
+# writes a last index followed by a trailer pointing at it.
+MAGIC = b'CLOG'
+VERSION = 1
+TRAILER_MAGIC = b'CIDX'
+
+KIND_COMPILE = 1
+KIND_INDEX = 2
+
+_FILE_HEADER = struct.Struct('<4sHH')
+_RECORD_HEADER = struct.Struct('<IIB')
+_SUMMARY = struct.Struct('<IddBBIIHIII')
+_INDEX_HEADER = struct.Struct('<QI')
+_INDEX_ENTRY = struct.Struct('<IQ')
+_TRAILER = struct.Struct('<Q4s')
+
+FLAG_TIMED_OUT = 1
+FLAG_STOPPED_EARLY = 2
+FLAG_CACHED = 4
+
+# Fields stored in the fixed summary struct or as blobs, not in the JSON part
+# (timestamp is kept in both, as an ISO string in the JSON part)
+_SUMMARY_FIELDS = ('iteration', 'duration', 'success', 'target',
+                   'timed_out', 'stopped_early', 'cached', 'stdout', 'stderr')
+
+
+class CompileLog:
+    """Append-only compile log split into fixed-size segments
+    
+    Each record carries a fixed binary summary (iteration, time, duration,
+    success, error/warning counts, target) ahead of its compressed payload, so
+    analytics and the UI can mmap the segments and scan summaries without
+    decompressing or JSON-decoding anything. Individual results can be read
+    back in full by iteration.
+    """
+    
+    INDEX_INTERVAL = 256
+    SEGMENT_BYTES = 64 * 1024 * 1024
+    
+    def __init__(self, log_path: str, segment_bytes: Optional[int] = None):
+        self.log_path = Path(log_path)
+        self.log_path.mkdir(parents=True, exist_ok=True)
+        self.segment_bytes = segment_bytes or self.SEGMENT_BYTES
+        
+        self._lock = threading.Lock()
+        self._file = None
+        self._segment: Optional[Path] = None
+        self._end = 0
+        # Records written since the last index record, and that record's offset
+        self._pending: List[Tuple[int, int]] = []
+        self._last_index = 0
+    
+    # ------------------------------------------------------------------
+    # Writing
+    
+    def append(self, result: Dict[str, Any]) -> None:
+        """Append one compile result
+        
+        Safe with several writers on the same directory: appends are
+        serialized with a lock file and each writer first catches up with
+        records the others wrote.
+        """
+        payload = _encode_result(result)
+        
+        with self._lock, open(self.log_path / 'compile_log.lock', 'a') as lock_file:
+            fcntl.flock(lock_file, fcntl.LOCK_EX)
+            
+            self._sync()
+            if self._end >= self.segment_bytes:
+                self._seal()
+                self._sync()
+            
+            offset = self._write_record(KIND_COMPILE, payload)
+            self._pending.append((int(result.get('iteration', 0)), offset))
+            if len(self._pending) >= self.INDEX_INTERVAL:
+                self._write_index()
+            self._file.flush()
+    
+    def close(self) -> None:
+        """Index any unindexed records and close the active segment"""
+        with self._lock, open(self.log_path / 'compile_log.lock', 'a') as lock_file:
+            fcntl.flock(lock_file, fcntl.LOCK_EX)
+            if self._file is not None:
+                self._sync()
+                if self._file is not None and self._pending:
+                    self._write_index()
+                    self._file.flush()
+                self._detach()
+    
+    def _sync(self) -> None:
+        """Attach to the newest unsealed segment and catch up with its records"""
+        segments = self._segments()
+        newest = segments[-1] if segments else None
+        
+        if newest is None or (newest != self._segment and _is_sealed(newest)):
+            # Start the next segment
+            self._detach()
+            number = int(newest.name.split('.')[1]) + 1 if newest else 1
+            self._segment = self.log_path / f'compile_log.{number:06d}.seg'
+            self._file = open(self._segment, 'w+b')
+            self._file.write(_FILE_HEADER.pack(MAGIC, VERSION, 0))
+            self._end, self._pending, self._last_index = _FILE_HEADER.size, [], 0
+            return
+        
+        if newest != self._segment:
+            self._detach()
+            self._segment = newest
+            self._file = open(newest, 'r+b')
+            self._end, self._pending, self._last_index = _FILE_HEADER.size, [], 0
+        
+        size = os.fstat(self._file.fileno()).st_size
+        if size == self._end:
+            return
+        if size < self._end:
+            self._end, self._pending, self._last_index = _FILE_HEADER.size, [], 0
+        
+        if _is_sealed(self._segment):
+            # Another writer sealed it
+            self._detach()
+            return self._sync()
+        
+        with _map(self._segment) as data:
+            if data is not None:
+                self._end, self._pending, self._last_index = _scan(
+                    data, self._end, self._pending, self._last_index
+                )
+        
+        # Drop a torn record left by a crashed writer
+        self._file.truncate(self._end)
+    
+    def _detach(self) -> None:
+        if self._file is not None:
+            self._file.close()
+        self._file = None
+        self._segment = None
+    
+    def _seal(self) -> None:
+        """Finish the active segment with an index and trailer"""
+        index_offset = self._write_index()
+        self._file.seek(self._end)
+        self._file.write(_TRAILER.pack(index_offset, TRAILER_MAGIC))
+        self._detach()
+    
+    def _write_record(self, kind: int, payload: bytes) -> int:
+        offset = self._end
+        self._file.seek(offset)
+        self._file.write(_RECORD_HEADER.pack(len(payload), zlib.crc32(payload), kind) + payload)
+        self._end = offset + _RECORD_HEADER.size + len(payload)
+        return offset
+    
+    def _write_index(self) -> int:
+        payload = _INDEX_HEADER.pack(self._last_index, len(self._pending)) + b''.join(
+            _INDEX_ENTRY.pack(iteration, offset) for iteration, offset in self._pending
+        )
+        self._last_index = self._write_record(KIND_INDEX, payload)
+        self._pending = []
+        return self._last_index
+    
+    # ------------------------------------------------------------------
+    # Reading
+    
+    def iter_summaries(self) -> Iterator[Dict[str, Any]]:
+        """Yield record summaries in write order, without decoding payloads"""
+        for path in self._segments():
+            with _map(path) as data:
+                if data is None:
+                    continue
+                for offset, kind, start, end in _walk(data):
+                    if kind == KIND_COMPILE:
+                        yield _decode_summary(data, start)
+    
+    def iter_results(self) -> Iterator[Dict[str, Any]]:
+        """Yield full compile results in write order"""
+        for path in self._segments():
+            with _map(path) as data:
+                if data is None:
+                    continue
+                for offset, kind, start, end in _walk(data):
+                    if kind == KIND_COMPILE:
+                        yield _decode_result(data, start)
+    
+    def get(self, iteration: int) -> Optional[Dict[str, Any]]:
+        """Get the most recent full result for an iteration"""
+        for path in reversed(self._segments()):
+            with _map(path) as data:
+                if data is None:
+                    continue
+                offsets = _segment_index(data).get(iteration)
+                if offsets:
+                    return _decode_result(data, offsets[-1] + _RECORD_HEADER.size)
+        return None
+    
+    def tail(self, count: int) -> List[Dict[str, Any]]:
+        """Get the last `count` full results, newest first"""
+        results = []
+        for path in reversed(self._segments()):
+            with _map(path) as data:
+                if data is None:
+                    continue
+                offsets = sorted(o for offs in _segment_index(data).values() for o in offs)
+                for offset in reversed(offsets):
+                    results.append(_decode_result(data, offset + _RECORD_HEADER.size))
+                    if len(results) >= count:
+                        return results
+        return results
+    
+    def get_summary(self) -> Dict[str, Any]:
+        """Error summary over the whole log (same shape as CompilerLoop.get_error_summary)"""
+        total = successful = errors = warnings = 0
+        for summary in self.iter_summaries():
+            total += 1
+            successful += summary['success']
+            errors += summary['error_count']
+            warnings += summary['warning_count']
+        
+        return {
+            'total_iterations': total,
+            'successful_compiles': successful,
+            'failed_compiles': total - successful,
+            'total_errors': errors,
+            'total_warnings': warnings
+        }
+    
+    def _segments(self) -> List[Path]:
+        return sorted(self.log_path.glob('compile_log.*.seg'))
+
+
+class _map:
+    """Read-only mmap of a segment as a context manager (None if empty)"""
+    
+    def __init__(self, path: Path):
+        self.path = path
+        self.file = None
+        self.data = None
+    
+    def __enter__(self):
+        self.file = open(self.path, 'rb')
+        if os.fstat(self.file.fileno()).st_size > _FILE_HEADER.size:
+            self.data = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        return self.data
+    
+    def __exit__(self, *exc):
+        if self.data is not None:
+            self.data.close()
+        self.file.close()
+
+
+def _walk(data) -> Iterator[Tuple[int, int, int, int]]:
+    """Yield (offset, kind, payload start, payload end) of complete records"""
+    offset = _FILE_HEADER.size
+    size = len(data)
+    
+    while offset + _RECORD_HEADER.size <= size:
+        length, crc, kind = _RECORD_HEADER.unpack_from(data, offset)
+        start = offset + _RECORD_HEADER.size
+        end = start + length
+        if kind not in (KIND_COMPILE, KIND_INDEX) or end > size:
+            # Trailer or torn write at the end
+            return
+        yield offset, kind, start, end
+        offset = end
+
+
+def _segment_index(data) -> Dict[int, List[int]]:
+    """Map iteration -> record offsets, from the index chain when sealed"""
+    index: Dict[int, List[int]] = {}
+    size = len(data)
+    
+    trailer_at = size - _TRAILER.size
+    if trailer_at > _FILE_HEADER.size:
+        index_offset, magic = _TRAILER.unpack_from(data, trailer_at)
+        if magic == TRAILER_MAGIC and _FILE_HEADER.size <= index_offset < trailer_at:
+            blocks = []
+            while index_offset:
+                start = index_offset + _RECORD_HEADER.size
+                prev, count = _INDEX_HEADER.unpack_from(data, start)
+                blocks.append((start + _INDEX_HEADER.size, count))
+                index_offset = prev
+            for start, count in reversed(blocks):
+                for i in range(count):
+                    iteration, offset = _INDEX_ENTRY.unpack_from(data, start + i * _INDEX_ENTRY.size)
+                    index.setdefault(iteration, []).append(offset)
+            return index
+    
+    # Active segment: scan record headers
+    for offset, kind, start, end in _walk(data):
+        if kind == KIND_COMPILE:
+            iteration = _SUMMARY.unpack_from(data, start)[0]
+            index.setdefault(iteration, []).append(offset)
+    return index
+
+
+def _is_sealed(path: Path) -> bool:
+    with _map(path) as data:
+        if data is None or len(data) < _FILE_HEADER.size + _TRAILER.size:
+            return False
+        index_offset, magic = _TRAILER.unpack_from(data, len(data) - _TRAILER.size)
+        if magic != TRAILER_MAGIC or not _FILE_HEADER.size <= index_offset < len(data) - _TRAILER.size:
+            return False
+        return _RECORD_HEADER.unpack_from(data, index_offset)[2] == KIND_INDEX
+
+
+def _scan(data, offset: int, pending: List[Tuple[int, int]], last_index: int) -> Tuple[int, List[Tuple[int, int]], int]:
+    """Walk intact records of an unsealed segment from offset
+    
+    Returns (end of the last intact record, records since the last index,
+    last index offset).
+    """
+    end = offset
+    size = len(data)
+    pending = list(pending)
+    
+    while end + _RECORD_HEADER.size <= size:
+        length, crc, kind = _RECORD_HEADER.unpack_from(data, end)
+        start = end + _RECORD_HEADER.size
+        stop = start + length
+        if kind not in (KIND_COMPILE, KIND_INDEX) or stop > size or zlib.crc32(data[start:stop]) != crc:
+            break
+        if kind == KIND_INDEX:
+            pending, last_index = [], end
+        else:
+            pending.append((_SUMMARY.unpack_from(data, start)[0], end))
+        end = stop
+    
+    return end, pending, last_index
+
+
+def _encode_result(result: Dict[str, Any]) -> bytes:
+    flags = ((FLAG_TIMED_OUT if result.get('timed_out') else 0) |
+             (FLAG_STOPPED_EARLY if result.get('stopped_early') else 0) |
+             (FLAG_CACHED if result.get('cached') else 0))
+    
+    timestamp = result.get('timestamp')
+    try:
+        epoch = datetime.fromisoformat(timestamp).timestamp() if timestamp else 0.0
+    except (TypeError, ValueError):
+        epoch = 0.0
+    
+    target = (result.get('target') or 'all').encode('utf-8')[:0xFFFF]
+    rest = {k: v for k, v in result.items() if k not in _SUMMARY_FIELDS}
+    meta = zlib.compress(json.dumps(rest).encode('utf-8'))
+    stdout = zlib.compress((result.get('stdout') or '').encode('utf-8', 'replace'))
+    stderr = zlib.compress((result.get('stderr') or '').encode('utf-8', 'replace'))
+    
+    summary = _SUMMARY.pack(
+        int(result.get('iteration', 0)), epoch, float(result.get('duration', 0.0)),
+        1 if result.get('success') else 0, flags,
+        len(result.get('errors', [])), len(result.get('warnings', [])),
+        len(target), len(meta), len(stdout), len(stderr)
+    )
+    return summary + target + meta + stdout + stderr
+
+
+def _decode_summary(data, start: int) -> Dict[str, Any]:
+    (iteration, epoch, duration, success, flags, error_count, warning_count,
+     target_len, _meta_len, _stdout_len, _stderr_len) = _SUMMARY.unpack_from(data, start)
+    target_at = start + _SUMMARY.size
+    
+    return {
+        'iteration': iteration,
+        'timestamp': epoch,
+        'duration': duration,
+        'success': bool(success),
+        'error_count': error_count,
+        'warning_count': warning_count,
+        'target': bytes(data[target_at:target_at + target_len]).decode('utf-8', 'replace'),
+        'timed_out': bool(flags & FLAG_TIMED_OUT),
+        'stopped_early': bool(flags & FLAG_STOPPED_EARLY),
+        'cached': bool(flags & FLAG_CACHED)
+    }
+
+
+def _decode_result(data, start: int) -> Dict[str, Any]:
+    summary = _decode_summary(data, start)
+    fields = _SUMMARY.unpack_from(data, start)
+    target_len, meta_len, stdout_len, stderr_len = fields[7:]
+    
+    pos = start + _SUMMARY.size + target_len
+    meta = json.loads(zlib.decompress(data[pos:pos + meta_len]))
+    pos += meta_len
+    stdout = zlib.decompress(data[pos:pos + stdout_len]).decode('utf-8')
+    pos += stdout_len
+    stderr = zlib.decompress(data[pos:pos + stderr_len]).decode('utf-8')
+    
+    result = {
+        'iteration': summary['iteration'],
+        'target': summary['target'],
+        'success': summary['success'],
+        'duration': summary['duration'],
+        'stdout': stdout,
+        'stderr': stderr,
+        **meta
+    }
+    for flag in ('timed_out', 'stopped_early', 'cached'):
+        if summary[flag]:
+            result[flag] = True
+    return result
@@ -5,12 +5,131 @@ Executes the compile -> error -> learn feedback cycle
 
 import subprocess
 import os
-import json
 import time
+import signal
+import select
+import threading
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
 from datetime import datetime
-from typing import Dict, List, Optional, Any
+from typing import Dict, List, Optional, Any, Callable, Iterable
 from pathlib import Path
 
+from .diagnostics import DiagnosticExtractor, extract_diagnostics
+from .compile_cache import CompileCache
+from .compile_log import CompileLog
+from ..tracing import span, traced, subprocess_env
+
+
+# Lines of stdout/stderr kept in the result when streaming
+STREAM_TAIL_LINES = 500
+
+
+class MakeJobserver:
+    """GNU make jobserver shared by concurrent builds
+    
+    A pipe holds one token per job slot. The scheduler takes a token before
+    starting each make (standing in for that make's implicit slot) and the
+    makes, plus any recursive sub-makes, take further tokens for parallel
+    jobs from the same pipe, so the whole batch never runs more than `jobs`
+    compilers at once.
+    
+    Tokens held by a make that gets killed are never returned. A release
+    that reports a killed build holds back new builds until the running ones
+    finish, then tops the pipe back up to `jobs` tokens.
+    """
+    
+    def __init__(self, jobs: int):
+        self.jobs = jobs
+        self.read_fd, self.write_fd = os.pipe()
+        os.write(self.write_fd, b'+' * jobs)
+        
+        self._cond = threading.Condition()
+        self._held = 0              # Scheduler tokens out, one per running make
+        self._refill = False
+        try:
+            # Own open file description, so non-blocking reads here don't
+            # change the mode make sees on read_fd
+            self._poll_fd = os.open(f'/proc/self/fd/{self.read_fd}', os.O_RDONLY | os.O_NONBLOCK)
+        except OSError:
+            self._poll_fd = None
+    
+    def acquire(self) -> bytes:
+        """Block until a job slot is free and take its token"""
+        if self._poll_fd is None:
+            token = self._read_token()
+            with self._cond:
+                self._held += 1
+            return token
+        
+        while True:
+            select.select([self._poll_fd], [], [])
+            # Read under the lock so a top-up sees every token we hold
+            with self._cond:
+                while self._refill:
+                    self._cond.wait()
+                try:
+                    token = os.read(self._poll_fd, 1)
+                except BlockingIOError:
+                    continue            # A make got there first
+                if token:
+                    self._held += 1
+                    return token
+    
+    def _read_token(self) -> bytes:
+        while True:
+            # make may switch the shared pipe to non-blocking mode
+            select.select([self.read_fd], [], [])
+            try:
+                token = os.read(self.read_fd, 1)
+            except BlockingIOError:
+                continue
+            if token:
+                return token
+    
+    def release(self, token: bytes, killed: bool = False) -> None:
+        """Return a job slot
+        
+        Args:
+            token: Token from acquire()
+            killed: The build was killed, so tokens its jobs held are lost
+        """
+        with self._cond:
+            os.write(self.write_fd, token)
+            self._held -= 1
+            if killed:
+                self._refill = True
+            if self._refill and self._held == 0:
+                self._top_up()
+                self._refill = False
+                self._cond.notify_all()
+    
+    def _top_up(self) -> None:
+        """Refill the pipe to `jobs` tokens; no make may be running"""
+        if self._poll_fd is None:
+            # Can't drain without blocking; leave the pipe as it is
+            return
+        while True:
+            try:
+                chunk = os.read(self._poll_fd, self.jobs)
+            except BlockingIOError:
+                break
+            if not chunk:
+                break
+        os.write(self.write_fd, b'+' * self.jobs)
+    
+    def popen_kwargs(self) -> Dict[str, Any]:
+        """Environment and inherited fds that attach make to this jobserver"""
+        env = dict(os.environ)
+        env['MAKEFLAGS'] = f'-j --jobserver-auth={self.read_fd},{self.write_fd}'
+        return {'env': env, 'pass_fds': (self.read_fd, self.write_fd)}
+    
+    def close(self) -> None:
+        if self._poll_fd is not None:
+            os.close(self._poll_fd)
+        os.close(self.read_fd)
+        os.close(self.write_fd)
+
 
 class CompilerLoop:
     """Manages the compilation and error feedback loop"""
@@ -22,13 +141,140 @@ class CompilerLoop:
         
         self.compile_history: List[Dict[str, Any]] = []
         self.current_iteration = 0
+        # Guards current_iteration and compile_history for concurrent builds
+        self._lock = threading.Lock()
+        
+        self.cache = CompileCache(str(self.log_path / 'cache'))
+        self.compile_log = CompileLog(str(self.log_path))
     
-    def compile_aros(self, target: Optional[str] = None, timeout: int = 300) -> Dict[str, Any]:
+    def compile_aros(
+        self,
+        target: Optional[str] = None,
+        timeout: int = 300,
+        stream: bool = False,
+        max_errors: Optional[int] = None,
+        on_diagnostic: Optional[Callable[[Dict[str, str]], None]] = None
+    ) -> Dict[str, Any]:
         """
         Compile AROS or a specific target
         Returns compilation result with errors
+        
+        Args:
+            target: Make target (default: all)
+            timeout: Seconds before the build is killed
+            stream: Parse stderr line by line while make runs instead of
+                buffering all output until it exits
+            max_errors: In streaming mode, stop the build once this many
+                errors have been seen
+            on_diagnostic: In streaming mode, called with each error/warning
+                as soon as it is read
+        """
+        return self._compile_target(target, timeout, stream, max_errors, on_diagnostic, {})
+    
+    def compile_cached(
+        self,
+        target: Optional[str] = None,
+        source: str = '',
+        headers: Optional[List[str]] = None,
+        flags: Optional[List[str]] = None,
+        **compile_kwargs: Any
+    ) -> Dict[str, Any]:
+        """
+        Compile unless identical inputs have been built before
+        
+        Args:
+            target: Make target (default: all)
+            source: Generated source being built
+            headers: Header paths (relative to the AROS tree) the source uses
+            flags: Compiler flags for the build; CC/CFLAGS/... from the
+                environment are added
+            **compile_kwargs: Passed to compile_aros on a cache miss
+            
+        Returns:
+            Compilation result; result['cached'] is True when make was skipped
+        """
+        flags = list(flags or []) + self.cache.environment_flags()
+        key = self.cache.make_key(target, source, headers, flags, base_path=str(self.aros_path))
+        result = self.cache.get(key)
+        
+        if result is None:
+            result = self.compile_aros(target, **compile_kwargs)
+            self.cache.put(key, result)
+            result['cached'] = False
+            return result
+        
+        with self._lock:
+            self.current_iteration += 1
+            result['iteration'] = self.current_iteration
+            result['timestamp'] = datetime.now().isoformat()
+            result['cached'] = True
+            self.compile_history.append(result)
+        
+        return result
+    
+    def compile_targets(
+        self,
+        targets: Iterable[Optional[str]],
+        jobs: Optional[int] = None,
+        timeout: int = 300,
+        stream: bool = False,
+        max_errors: Optional[int] = None
+    ) -> List[Dict[str, Any]]:
+        """
+        Compile several make targets concurrently
+        
+        All builds share one make jobserver, so the batch (including each
+        target's own parallel jobs and sub-makes) uses at most `jobs` slots.
+        Every target is recorded in compile_history as it finishes.
+        
+        Args:
+            targets: Make targets, e.g. the modules touched by a phase
+            jobs: Job slots for the whole batch (default: one per core)
+            timeout: Per-target timeout in seconds
+            stream: Parse each build's output while it runs
+            max_errors: In streaming mode, stop a build after this many errors
+            
+        Returns:
+            Per-target results, in the order the targets were given
         """
-        self.current_iteration += 1
+        targets = list(targets)
+        if not targets:
+            return []
+        
+        jobs = jobs or os.cpu_count() or 1
+        jobserver = MakeJobserver(jobs)
+        popen_kwargs = jobserver.popen_kwargs()
+        
+        def run(target):
+            token = jobserver.acquire()
+            result = {}
+            try:
+                result = self._compile_target(target, timeout, stream, max_errors, None, popen_kwargs)
+                return result
+            finally:
+                killed = bool(result.get('timed_out') or result.get('stopped_early'))
+                jobserver.release(token, killed=killed)
+        
+        try:
+            with ThreadPoolExecutor(max_workers=min(jobs, len(targets))) as pool:
+                return list(pool.map(run, targets))
+        finally:
+            jobserver.close()
+    
+    @traced('compile_aros')
+    def _compile_target(
+        self,
+        target: Optional[str],
+        timeout: int,
+        stream: bool,
+        max_errors: Optional[int],
+        on_diagnostic: Optional[Callable[[Dict[str, str]], None]],
+        popen_kwargs: Dict[str, Any]
+    ) -> Dict[str, Any]:
+        """Build one target and record the result"""
+        with self._lock:
+            self.current_iteration += 1
+            iteration = self.current_iteration
         start_time = time.time()
         
         compile_cmd = ['make']
@@ -36,7 +282,7 @@ class CompilerLoop:
             compile_cmd.append(target)
         
         result = {
-            'iteration': self.current_iteration,
+            'iteration': iteration,
             'timestamp': datetime.now().isoformat(),
             'target': target or 'all',
             'success': False,
@@ -47,14 +293,45 @@ class CompilerLoop:
             'warnings': []
         }
         
+        with span('make', target=result['target']) as make_span:
+            # Native spans of the build land under this one when tracing
+            env = subprocess_env(popen_kwargs.get('env'))
+            if env is not None:
+                popen_kwargs = {**popen_kwargs, 'env': env}
+            if stream:
+                self._compile_streaming(compile_cmd, timeout, max_errors, on_diagnostic, result, popen_kwargs)
+            else:
+                self._compile_buffered(compile_cmd, timeout, result, popen_kwargs)
+            make_span.set(success=result['success'], errors=len(result['errors']))
+        
+        result['duration'] = time.time() - start_time
+        
+        # Log the compilation
+        with span('compile_log.append'):
+            self._log_compilation(result)
+        with self._lock:
+            self.compile_history.append(result)
+        
+        return result
+    
+    def _compile_buffered(
+        self,
+        compile_cmd: List[str],
+        timeout: int,
+        result: Dict[str, Any],
+        popen_kwargs: Dict[str, Any]
+    ) -> None:
+        """Run make to completion, then parse all of stderr"""
         try:
-            # Run compilation
+            # Run compilation; new session so a timeout stops the whole tree
             process = subprocess.Popen(
                 compile_cmd,
                 cwd=self.aros_path,
                 stdout=subprocess.PIPE,
                 stderr=subprocess.PIPE,
-                text=True
+                text=True,
+                start_new_session=True,
+                **popen_kwargs
             )
             
             try:
@@ -62,58 +339,132 @@ class CompilerLoop:
                 result['stdout'] = stdout
                 result['stderr'] = stderr
                 result['success'] = process.returncode == 0
+                if process.returncode < 0:
+                    result['signal'] = -process.returncode
             except subprocess.TimeoutExpired:
-                process.kill()
+                # Sub-makes left running would hand tokens back to a
+                # jobserver that has already been topped up
+                self._kill_process_group(process)
                 result['stderr'] = f'Compilation timeout after {timeout} seconds'
+                result['timed_out'] = True
         
         except Exception as e:
             result['stderr'] = f'Compilation error: {str(e)}'
-        
-        result['duration'] = time.time() - start_time
+            result['launch_failed'] = True
         
         # Parse errors and warnings
-        result['errors'] = self._parse_errors(result['stderr'])
-        result['warnings'] = self._parse_warnings(result['stderr'])
+        with span('parse_diagnostics'):
+            result['errors'], result['warnings'] = extract_diagnostics(result['stderr'])
+    
+    def _compile_streaming(
+        self,
+        compile_cmd: List[str],
+        timeout: int,
+        max_errors: Optional[int],
+        on_diagnostic: Optional[Callable[[Dict[str, str]], None]],
+        result: Dict[str, Any],
+        popen_kwargs: Dict[str, Any]
+    ) -> None:
+        """Run make while reader threads parse its output as it arrives
         
-        # Log the compilation
-        self._log_compilation(result)
-        self.compile_history.append(result)
+        Only the last STREAM_TAIL_LINES of each stream are kept in the result.
+        Errors and warnings collected before a timeout or early stop are kept.
+        """
+        stdout_tail = deque(maxlen=STREAM_TAIL_LINES)
+        stderr_tail = deque(maxlen=STREAM_TAIL_LINES)
+        enough_errors = threading.Event()
+        extractor = DiagnosticExtractor()
+        result['errors'] = extractor.errors
+        result['warnings'] = extractor.warnings
         
-        return result
-    
-    def _parse_errors(self, stderr: str) -> List[Dict[str, str]]:
-        """Parse compiler errors from stderr"""
-        errors = []
+        def read_stdout(pipe):
+            for line in pipe:
+                stdout_tail.append(line)
         
-        for line in stderr.split('\n'):
-            # Match common compiler error patterns
-            if 'error:' in line.lower():
-                errors.append({
-                    'type': 'error',
-                    'message': line.strip()
-                })
+        def read_stderr(pipe):
+            for line in pipe:
+                stderr_tail.append(line)
+                for diagnostic in extractor.feed_line(line.rstrip('\n')):
+                    if on_diagnostic:
+                        on_diagnostic(diagnostic)
+                if max_errors and len(extractor.errors) >= max_errors:
+                    enough_errors.set()
         
-        return errors
-    
-    def _parse_warnings(self, stderr: str) -> List[Dict[str, str]]:
-        """Parse compiler warnings from stderr"""
-        warnings = []
+        try:
+            # New session so the whole make process tree can be stopped
+            process = subprocess.Popen(
+                compile_cmd,
+                cwd=self.aros_path,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+                errors='replace',
+                bufsize=1,
+                start_new_session=True,
+                **popen_kwargs
+            )
+        except Exception as e:
+            result['stderr'] = f'Compilation error: {str(e)}'
+            result['launch_failed'] = True
+            result['errors'], result['warnings'] = extract_diagnostics(result['stderr'])
+            return
+        
+        readers = [
+            threading.Thread(target=read_stdout, args=(process.stdout,), daemon=True),
+            threading.Thread(target=read_stderr, args=(process.stderr,), daemon=True)
+        ]
+        for reader in readers:
+            reader.start()
         
-        for line in stderr.split('\n'):
-            if 'warning:' in line.lower():
-                warnings.append({
-                    'type': 'warning',
-                    'message': line.strip()
-                })
+        deadline = time.time() + timeout
+        stop_reason = None
         
-        return warnings
+        while process.poll() is None:
+            if enough_errors.wait(0.05):
+                stop_reason = f'Compilation stopped after {max_errors} errors'
+                result['stopped_early'] = True
+                break
+            if time.time() >= deadline:
+                stop_reason = f'Compilation timeout after {timeout} seconds'
+                result['timed_out'] = True
+                break
+        
+        if stop_reason:
+            self._kill_process_group(process)
+        
+        process.wait()
+        for reader in readers:
+            reader.join()
+        process.stdout.close()
+        process.stderr.close()
+        
+        result['stdout'] = ''.join(stdout_tail)
+        result['stderr'] = ''.join(stderr_tail)
+        if stop_reason:
+            result['stderr'] += f'{stop_reason}\n'
+        else:
+            result['success'] = process.returncode == 0
+            if process.returncode < 0:
+                result['signal'] = -process.returncode
+    
+    def _kill_process_group(self, process: subprocess.Popen) -> None:
+        """Kill make and every compiler it spawned"""
+        try:
+            os.killpg(process.pid, signal.SIGKILL)
+        except (ProcessLookupError, PermissionError):
+            process.kill()
+    
+    def _parse_errors(self, stderr: str) -> List[Dict[str, Any]]:
+        """Parse compiler errors from stderr"""
+        return extract_diagnostics(stderr)[0]
+    
+    def _parse_warnings(self, stderr: str) -> List[Dict[str, Any]]:
+        """Parse compiler warnings from stderr"""
+        return extract_diagnostics(stderr)[1]
     
     def _log_compilation(self, result: Dict[str, Any]) -> None:
-        """Log compilation result to file"""
-        log_file = self.log_path / f"compile_{result['iteration']}_{int(time.time())}.json"
-        
-        with open(log_file, 'w') as f:
-            json.dump(result, f, indent=2)
+        """Append compilation result to the binary compile log"""
+        self.compile_log.append(result)
     
     def get_latest_errors(self) -> List[Dict[str, str]]:
         """Get errors from the most recent compilation"""
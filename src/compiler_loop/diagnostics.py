@@ -0,0 +1,172 @@
+"""
+Compiler Diagnostic Extraction
+Single-pass extraction of structured GCC/Clang diagnostics from build output
+"""
+
+import re
+from typing import Dict, List, Optional, Any, Tuple
+
+try:
+    from . import _diagnostics
+except ImportError:
+    # Native scanner not built (python3 setup.py build_ext --inplace);
+    # candidate lines are selected in Python instead
+    _diagnostics = None
+
+
+# file:line[:col]: severity: message [-Wflag]
+_DIAGNOSTIC_RE = re.compile(
+    r'^[ \t]*(?P<file>[^:\s][^:]*):(?P<line>\d+):(?:(?P<column>\d+):)?[ \t]+'
+    r'(?P<severity>fatal error|error|warning|note):[ \t]*(?P<text>.*?)'
+    r'(?:[ \t]+\[(?P<flag>-[^\]\s]+)\])?[ \t\r]*$'
+)
+
+# Lines GCC/Clang print before a diagnostic to say where it came from
+_CONTEXT_PREFIXES = ('In file included from ', 'from ')
+_CONTEXT_MARKERS = (': In ', ': At top level', 'required from', 'In instantiation of')
+
+
+def _is_context(line: str) -> bool:
+    return (line.lstrip(' \t').startswith(_CONTEXT_PREFIXES) or
+            any(marker in line for marker in _CONTEXT_MARKERS))
+
+
+def _is_candidate(line: str) -> bool:
+    """Could this line be a diagnostic or diagnostic context?"""
+    if ':' not in line:
+        return False
+    low = line.lower()
+    return 'error:' in low or 'warning:' in low or 'note:' in low or _is_context(line)
+
+
+class DiagnosticExtractor:
+    """Incremental diagnostic parser
+
+    Feed lines in order with feed_line(); each error or warning is returned as
+    soon as its line is seen. Include/function/instantiation context lines are
+    attached to the next diagnostic, and note: lines to the previous one.
+
+    Records keep the original 'type' and 'message' (stripped line) keys, plus
+    file, line, column, severity, text, flag, context and notes. Lines that
+    mention error:/warning: without the file:line: form (linker, make) become
+    records with file/line set to None.
+    """
+
+    def __init__(self):
+        self.errors: List[Dict[str, Any]] = []
+        self.warnings: List[Dict[str, Any]] = []
+        self._context: List[str] = []
+        self._last: Optional[Dict[str, Any]] = None
+        self._prev_index = -2
+        self._next_index = 0
+
+    def feed_line(self, line: str) -> List[Dict[str, Any]]:
+        """Parse the next line of output, returning any new errors/warnings"""
+        index = self._next_index
+        self._next_index += 1
+        if not _is_candidate(line):
+            return []
+        return self._consume(index, line)
+
+    def _consume(self, index: int, line: str) -> List[Dict[str, Any]]:
+        """Handle candidate line number index (line numbers as in split('\\n'))"""
+        if index != self._prev_index + 1:
+            # Something else was printed in between; context no longer applies
+            self._context = []
+        self._prev_index = index
+
+        match = _DIAGNOSTIC_RE.match(line)
+        if match:
+            severity = match.group('severity')
+            if severity == 'note':
+                if self._last is not None:
+                    self._last['notes'].append(line.strip())
+                self._context = []
+                return []
+
+            record = {
+                'type': 'warning' if severity == 'warning' else 'error',
+                'message': line.strip(),
+                'file': match.group('file'),
+                'line': int(match.group('line')),
+                'column': int(match.group('column')) if match.group('column') else None,
+                'severity': severity,
+                'text': match.group('text'),
+                'flag': match.group('flag'),
+                'context': self._context,
+                'notes': []
+            }
+            self._context = []
+            self._add(record)
+            return [record]
+
+        if _is_context(line):
+            self._context.append(line.strip())
+            return []
+
+        # Unstructured error/warning (linker, make, tools without positions)
+        self._context = []
+        low = line.lower()
+        found = []
+        for kind in ('error', 'warning'):
+            if f'{kind}:' in low:
+                record = {
+                    'type': kind,
+                    'message': line.strip(),
+                    'file': None,
+                    'line': None,
+                    'column': None,
+                    'severity': kind,
+                    'text': line.strip(),
+                    'flag': None,
+                    'context': [],
+                    'notes': []
+                }
+                self._add(record)
+                found.append(record)
+        return found
+
+    def _add(self, record: Dict[str, Any]) -> None:
+        (self.warnings if record['type'] == 'warning' else self.errors).append(record)
+        self._last = record
+
+
+def extract_diagnostics(log: str, use_native: bool = True) -> Tuple[List[Dict[str, Any]], List[Dict[str, Any]]]:
+    """Extract structured errors and warnings from a whole build log in one pass
+
+    Args:
+        log: Compiler/make output (usually stderr)
+        use_native: Use the native candidate scanner when it has been built
+
+    Returns:
+        Tuple of (errors, warnings) records, in output order
+    """
+    extractor = DiagnosticExtractor()
+
+    candidates = None
+    if use_native and _diagnostics is not None:
+        try:
+            candidates = _diagnostics.scan_candidates(log)
+        except UnicodeEncodeError:
+            # Lone surrogates can't be viewed as UTF-8
+            candidates = None
+    if candidates is None:
+        candidates = [(i, line) for i, line in enumerate(log.split('\n')) if _is_candidate(line)]
+
+    for index, line in candidates:
+        extractor._consume(index, line)
+
+    return extractor.errors, extractor.warnings
+
+
+def diagnostic_key(record: Dict[str, Any]) -> str:
+    """Stable identity of a diagnostic, independent of line shifts and context
+
+    Structured records are keyed by file, severity, flag and message text;
+    unstructured ones fall back to the stripped line.
+    """
+    if record.get('file') is None:
+        return record.get('message', '')
+    return '\x1f'.join((
+        record['file'], record['severity'], record.get('flag') or '', record['text']
+    ))
@@ -3,84 +3,298 @@ Error Tracker
 Tracks and analyzes compilation errors for AI learning
 """
 
+import os
 import json
+import time
 import hashlib
 from datetime import datetime
-from typing import Dict, List, Any, Optional
+from functools import lru_cache
+from typing import Dict, List, Any, Optional, Union, Iterable, Tuple
 from pathlib import Path
 
+from .diagnostics import diagnostic_key
+from .similarity_index import SimilarityIndex
+from ..tracing import traced
+
+
+# Snapshot key holding the last WAL sequence number folded into it
+_WAL_SEQ_KEY = '_wal_seq'
+
+
+@lru_cache(maxsize=4096)
+def _error_hash(error_key: str) -> str:
+    """Database id of an error (compile loops see the same errors repeatedly)"""
+    return hashlib.sha256(error_key.encode()).hexdigest()[:16]
+
 
 class ErrorTracker:
-    """Tracks compilation errors and their resolutions"""
+    """Tracks compilation errors and their resolutions
+    
+    The database is stored as a snapshot (error_database.json) plus a
+    write-ahead log (error_database.wal) of JSON lines, one per tracked
+    occurrence or resolution. Each change appends one line; the WAL is
+    fsynced in batches and folded into a new snapshot once it grows larger
+    than the snapshot, so the cost of a change does not grow with the size
+    of the database. Loading replays the WAL on top of the snapshot.
+    """
+    
+    # fsync the WAL after this many records, or when this many seconds have
+    # passed since the last fsync
+    FSYNC_BATCH = 64
+    FSYNC_INTERVAL = 1.0
+    # Don't compact WALs smaller than this
+    COMPACT_MIN_BYTES = 1024 * 1024
+    # find_similar_errors() minimum share of common words
+    SIMILARITY_THRESHOLD = 0.3
     
     def __init__(self, log_path: str):
         self.log_path = Path(log_path)
         self.log_path.mkdir(parents=True, exist_ok=True)
         
+        self.db_file = self.log_path / 'error_database.json'
+        self.wal_file = self.log_path / 'error_database.wal'
+        
         self.error_database: Dict[str, Dict[str, Any]] = {}
+        self._similarity: Optional[SimilarityIndex] = None
+        self._seq = 0
+        self._wal = None
+        self._wal_bytes = 0
+        self._snapshot_bytes = 0
+        self._unsynced = 0
+        self._last_sync = time.monotonic()
         self.load_database()
     
     def load_database(self) -> None:
-        """Load error database from disk"""
-        db_file = self.log_path / 'error_database.json'
+        """Load error database from disk (snapshot, then WAL replay)"""
+        self.error_database = {}
+        self._similarity = None
+        self._seq = 0
         
-        if db_file.exists():
+        if self.db_file.exists():
             try:
-                with open(db_file, 'r') as f:
+                with open(self.db_file, 'r') as f:
                     data = json.load(f)
                     # Ensure we have a dict
                     if isinstance(data, dict):
+                        self._seq = data.pop(_WAL_SEQ_KEY, 0)
                         self.error_database = data
-                    else:
-                        self.error_database = {}
+                self._snapshot_bytes = self.db_file.stat().st_size
             except (json.JSONDecodeError, IOError):
                 # If database is corrupted, start fresh
                 self.error_database = {}
+        
+        self._wal_bytes = 0
+        if self.wal_file.exists():
+            with open(self.wal_file, 'rb') as f:
+                for line in f:
+                    try:
+                        op = json.loads(line) if line.endswith(b'\n') else None
+                    except ValueError:
+                        op = None
+                    if not isinstance(op, dict):
+                        break
+                    self._wal_bytes += len(line)
+                    # Records already folded into the snapshot are skipped
+                    if op.get('seq', 0) > self._seq:
+                        self._apply(op)
+                        self._seq = op['seq']
+            
+            if self._wal_bytes < self.wal_file.stat().st_size:
+                # Drop a torn final write so new records start on a clean line
+                os.truncate(self.wal_file, self._wal_bytes)
     
+    @traced('ErrorTracker.save_database')
     def save_database(self) -> None:
-        """Save error database to disk"""
-        db_file = self.log_path / 'error_database.json'
+        """Write a full snapshot of the database and truncate the WAL"""
+        self._close_wal()
+        
+        tmp_file = self.db_file.with_suffix('.json.tmp')
+        with open(tmp_file, 'w') as f:
+            json.dump({**self.error_database, _WAL_SEQ_KEY: self._seq}, f, indent=2)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(tmp_file, self.db_file)
+        self._snapshot_bytes = self.db_file.stat().st_size
+        
+        # A crash before this point leaves WAL records the snapshot already
+        # covers; their sequence numbers make replay skip them
+        with open(self.wal_file, 'w'):
+            pass
+        self._wal_bytes = 0
+    
+    @traced('ErrorTracker.sync')
+    def sync(self) -> None:
+        """Force pending WAL records to disk"""
+        if self._wal is not None:
+            self._wal.flush()
+            os.fsync(self._wal.fileno())
+        self._unsynced = 0
+        self._last_sync = time.monotonic()
+    
+    def close(self) -> None:
+        """Sync and close the WAL"""
+        self._close_wal()
+    
+    def _close_wal(self) -> None:
+        if self._wal is not None:
+            self.sync()
+            self._wal.close()
+            self._wal = None
+    
+    def _log(self, op: Dict[str, Any]) -> None:
+        """Apply a change and append it to the WAL"""
+        self._seq += 1
+        op['seq'] = self._seq
+        self._apply(op)
+        
+        if self._wal is None:
+            self._wal = open(self.wal_file, 'ab')
+        line = json.dumps(op).encode('utf-8') + b'\n'
+        self._wal.write(line)
+        self._wal.flush()
+        self._wal_bytes += len(line)
+        self._unsynced += 1
+        
+        if (self._unsynced >= self.FSYNC_BATCH or
+                time.monotonic() - self._last_sync >= self.FSYNC_INTERVAL):
+            self.sync()
+        
+        if self._wal_bytes > max(self.COMPACT_MIN_BYTES, self._snapshot_bytes):
+            self.save_database()
+    
+    def _apply(self, op: Dict[str, Any]) -> None:
+        if op['op'] == 'batch':
+            for sub_op in op['ops']:
+                self._apply(sub_op)
+            return
         
-        with open(db_file, 'w') as f:
-            json.dump(self.error_database, f, indent=2)
+        entry = self.error_database.get(op['hash'])
+        
+        if op['op'] == 'track':
+            # Single occurrences carry 'context', batched ones 'contexts'
+            contexts = op['contexts'] if 'contexts' in op else [op['context']]
+            if entry is None or not isinstance(entry, dict):
+                entry = self.error_database[op['hash']] = {
+                    'message': op['message'],
+                    'first_seen': contexts[0]['timestamp'],
+                    'occurrences': 0,
+                    'contexts': [],
+                    'resolutions': [],
+                    'status': 'unresolved'
+                }
+                if op.get('location'):
+                    entry.update(op['location'])
+                if self._similarity is not None:
+                    self._similarity.add(op['hash'], op['message'])
+            entry['occurrences'] += len(contexts)
+            entry['contexts'].extend(contexts)
+        
+        elif op['op'] == 'resolve' and isinstance(entry, dict):
+            entry['status'] = 'resolved'
+            entry['resolutions'].append(op['resolution'])
     
-    def track_error(self, error_message: str, context: Dict[str, Any]) -> str:
+    def _describe(self, error_message: Union[str, Dict[str, Any]]) -> Tuple[str, str, Optional[Dict[str, Any]], Dict[str, Any]]:
+        """Get (hash, message, location, per-occurrence context) of an error"""
+        if not isinstance(error_message, dict):
+            return _error_hash(error_message), error_message, None, {}
+        
+        record = error_message
+        message = record.get('message', '')
+        error_hash = _error_hash(diagnostic_key(record))
+        if record.get('file') is None:
+            return error_hash, message, None, {}
+        
+        location = {
+            'file': record['file'],
+            'severity': record['severity'],
+            'flag': record.get('flag')
+        }
+        return error_hash, message, location, {'line': record.get('line'), 'column': record.get('column')}
+    
+    def track_error(self, error_message: Union[str, Dict[str, Any]], context: Dict[str, Any]) -> str:
         """
         Track a compilation error
         Returns error hash for reference
+        
+        Args:
+            error_message: Raw error message, or a structured record from
+                extract_diagnostics(); structured records are hashed by file,
+                severity, flag and text so the same diagnostic is recognised
+                after line numbers shift
+            context: Extra information stored with this occurrence
         """
-        # Generate hash for error
-        error_hash = hashlib.sha256(error_message.encode()).hexdigest()[:16]
-        
-        if error_hash not in self.error_database:
-            self.error_database[error_hash] = {
-                'message': error_message,
-                'first_seen': datetime.now().isoformat(),
-                'occurrences': 0,
-                'contexts': [],
-                'resolutions': [],
-                'status': 'unresolved'
-            }
-        
-        self.error_database[error_hash]['occurrences'] += 1
-        self.error_database[error_hash]['contexts'].append({
-            'timestamp': datetime.now().isoformat(),
-            **context
-        })
-        
-        self.save_database()
+        error_hash, message, location, extra = self._describe(error_message)
+        
+        op = {
+            'op': 'track',
+            'hash': error_hash,
+            'message': message,
+            'context': {'timestamp': datetime.now().isoformat(), **extra, **context}
+        }
+        if location is not None and error_hash not in self.error_database:
+            op['location'] = location
+        
+        self._log(op)
         return error_hash
     
+    def track_errors(
+        self,
+        errors: Union[Dict[str, Any], Iterable[Union[str, Dict[str, Any]]]],
+        context: Dict[str, Any]
+    ) -> List[str]:
+        """
+        Track all errors of one compilation as a single change
+        
+        Repeats within the batch are grouped per error, every occurrence gets
+        the same timestamp, and the whole batch is one WAL record.
+        
+        Args:
+            errors: A compile result (its 'errors' are used) or a list of
+                raw messages / structured records, as for track_error()
+            context: Extra information stored with every occurrence
+        
+        Returns:
+            Error hashes, in the order of errors
+        """
+        if isinstance(errors, dict):
+            errors = errors.get('errors', [])
+        
+        timestamp = datetime.now().isoformat()
+        groups: Dict[str, Dict[str, Any]] = {}
+        hashes = []
+        
+        for error in errors:
+            error_hash, message, location, extra = self._describe(error)
+            hashes.append(error_hash)
+            
+            group = groups.get(error_hash)
+            if group is None:
+                group = groups[error_hash] = {
+                    'op': 'track',
+                    'hash': error_hash,
+                    'message': message,
+                    'contexts': []
+                }
+                if location is not None and error_hash not in self.error_database:
+                    group['location'] = location
+            group['contexts'].append({'timestamp': timestamp, **extra, **context})
+        
+        if groups:
+            self._log({'op': 'batch', 'ops': list(groups.values())})
+        return hashes
+    
     def mark_resolved(self, error_hash: str, resolution: str, fix_commit: Optional[str] = None) -> None:
         """Mark an error as resolved"""
         if error_hash in self.error_database:
-            self.error_database[error_hash]['status'] = 'resolved'
-            self.error_database[error_hash]['resolutions'].append({
-                'timestamp': datetime.now().isoformat(),
-                'resolution': resolution,
-                'fix_commit': fix_commit
+            self._log({
+                'op': 'resolve',
+                'hash': error_hash,
+                'resolution': {
+                    'timestamp': datetime.now().isoformat(),
+                    'resolution': resolution,
+                    'fix_commit': fix_commit
+                }
             })
-            self.save_database()
     
     def get_unresolved_errors(self) -> List[Dict[str, Any]]:
         """Get all unresolved errors"""
@@ -140,13 +354,15 @@ class ErrorTracker:
             'patterns': self.get_error_patterns()
         }
     
-    def find_similar_errors(self, error_message: str, limit: int = 5) -> List[Dict[str, Any]]:
+    def find_similar_errors(self, error_message: Union[str, Dict[str, Any]], limit: int = 5) -> List[Dict[str, Any]]:
         """
         Find similar errors that have been seen before
-        Uses simple string similarity
+        Uses word-level similarity, with file paths, numbers and quoted
+        identifiers normalized so the same kind of error matches across files
         
         Args:
-            error_message: The error to find similar errors for
+            error_message: The error to find similar errors for (raw message
+                or structured record)
             limit: Maximum number of similar errors to return
             
         Returns:
@@ -154,36 +370,26 @@ class ErrorTracker:
         """
         if not isinstance(self.error_database, dict):
             return []
+        if isinstance(error_message, dict):
+            error_message = error_message.get('message', '')
         
-        similar = []
-        error_lower = error_message.lower()
-        
-        for error_hash, error_data in self.error_database.items():
-            if not isinstance(error_data, dict):
-                continue
-            
-            stored_message = error_data.get('message', '').lower()
-            
-            # Calculate simple similarity (common words)
-            error_words = set(error_lower.split())
-            stored_words = set(stored_message.split())
-            
-            if error_words and stored_words:
-                common_words = error_words & stored_words
-                similarity = len(common_words) / max(len(error_words), len(stored_words))
-                
-                if similarity > 0.3:  # At least 30% similar
-                    similar.append({
-                        'hash': error_hash,
-                        'similarity': similarity,
-                        **error_data
-                    })
-        
-        # Sort by similarity and return top matches
-        similar.sort(key=lambda x: x['similarity'], reverse=True)
-        return similar[:limit]
-    
-    def get_resolution_suggestions(self, error_message: str) -> List[str]:
+        return [
+            {'hash': error_hash, 'similarity': similarity, **self.error_database[error_hash]}
+            for error_hash, similarity in self._similarity_index().query(
+                error_message, limit, self.SIMILARITY_THRESHOLD
+            )
+        ]
+    
+    def _similarity_index(self) -> SimilarityIndex:
+        """Similarity index, built on first use and then kept up to date by _apply"""
+        if self._similarity is None:
+            self._similarity = SimilarityIndex()
+            for error_hash, error_data in self.error_database.items():
+                if isinstance(error_data, dict):
+                    self._similarity.add(error_hash, error_data.get('message', ''))
+        return self._similarity
+    
+    def get_resolution_suggestions(self, error_message: Union[str, Dict[str, Any]]) -> List[str]:
         """
         Get resolution suggestions based on similar resolved errors
         
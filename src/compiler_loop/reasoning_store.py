@@ -0,0 +1,241 @@
+"""
+Reasoning Store
+Single-file columnar store of completed reasoning entries
+"""
+
+import json
+import threading
+from array import array
+from collections import Counter
+from itertools import compress
+from pathlib import Path
+from typing import Dict, List, Any, Optional, Iterable, Tuple
+
+from ..tracing import traced
+
+
+# select() default for "any outcome" (None means no outcome recorded)
+ANY = object()
+
+
+class _CodedColumn:
+    """Dictionary-encoded column with a row index per value"""
+    
+    def __init__(self):
+        self.values: List[Any] = []
+        self.codes: Dict[Any, int] = {}
+        self.data = array('I')
+        self.rows: List[array] = []
+    
+    def code(self, value: Any) -> int:
+        code = self.codes.get(value)
+        if code is None:
+            code = self.codes[value] = len(self.values)
+            self.values.append(value)
+            self.rows.append(array('I'))
+        return code
+    
+    def append(self, row: int, value: Any) -> None:
+        code = self.code(value)
+        self.data.append(code)
+        self.rows[code].append(row)
+    
+    def lookup(self, value: Any) -> array:
+        code = self.codes.get(value)
+        return self.rows[code] if code is not None else array('I')
+
+
+class _ListColumn(_CodedColumn):
+    """Dictionary-encoded list-valued column, flattened
+    
+    data holds every element's code, owner the row it belongs to and success
+    that row's outcome, so per-value aggregates are Counter/compress passes
+    over flat arrays.
+    """
+    
+    def __init__(self):
+        super().__init__()
+        self.owner = array('I')
+        self.success = bytearray()
+    
+    def extend(self, row: int, values: Iterable[Any], success: bool) -> None:
+        seen = set()
+        for value in values:
+            code = self.code(value)
+            self.data.append(code)
+            self.owner.append(row)
+            self.success.append(1 if success else 0)
+            if code not in seen:
+                seen.add(code)
+                self.rows[code].append(row)
+    
+    def success_counts(self) -> Dict[Any, Tuple[int, int]]:
+        """value -> (uses, successful uses)"""
+        totals = Counter(self.data)
+        successes = Counter(compress(self.data, self.success))
+        return {self.values[code]: (uses, successes.get(code, 0)) for code, uses in totals.items()}
+
+
+class ReasoningStore:
+    """Completed reasoning entries in one append-only file, queried by column
+    
+    Each entry is one JSON line in reasoning_store.jsonl. In memory only the
+    columns queries need are kept (task_id, phase, outcome, confidence,
+    iterations, patterns, breadcrumbs) with an index per value of task_id,
+    phase, outcome and pattern; full entries are read back from their line
+    when a query returns them. Entries appended by another process sharing
+    the directory are picked up on the next query.
+    """
+    
+    def __init__(self, store_path: str):
+        self.store_path = Path(store_path)
+        self._lock = threading.Lock()
+        
+        self._offsets = array('Q')
+        self._lengths = array('I')
+        self.task_id = _CodedColumn()
+        self.phase = _CodedColumn()
+        self.outcome = _CodedColumn()
+        self.confidence = array('d')
+        self.iterations = array('i')
+        self.patterns = _ListColumn()
+        self.breadcrumbs = _ListColumn()
+        
+        # Bytes of the file already loaded
+        self._loaded = 0
+        self.refresh()
+    
+    def __len__(self) -> int:
+        self.refresh()
+        return len(self._offsets)
+    
+    def exists(self) -> bool:
+        return self.store_path.exists()
+    
+    @traced('ReasoningStore.append')
+    def append(self, entry: Dict[str, Any]) -> None:
+        """Store a completed entry"""
+        line = (json.dumps(entry) + '\n').encode('utf-8')
+        with self._lock, open(self.store_path, 'ab+') as f:
+            if f.tell():
+                f.seek(-1, 2)
+                if f.read(1) != b'\n':
+                    # Terminate a partial line left by a crashed writer so it
+                    # is skipped instead of swallowing this entry
+                    line = b'\n' + line
+            f.write(line)
+        self.refresh()
+    
+    def refresh(self) -> None:
+        """Load entries appended since the last call"""
+        with self._lock:
+            try:
+                size = self.store_path.stat().st_size
+            except FileNotFoundError:
+                return
+            if size <= self._loaded:
+                return
+            
+            with open(self.store_path, 'rb') as f:
+                f.seek(self._loaded)
+                for line in f:
+                    if not line.endswith(b'\n'):
+                        # Still being written
+                        break
+                    try:
+                        entry = json.loads(line)
+                    except ValueError:
+                        entry = None
+                    if isinstance(entry, dict):
+                        self._add_row(entry, self._loaded, len(line))
+                    self._loaded += len(line)
+    
+    def _add_row(self, entry: Dict[str, Any], offset: int, length: int) -> None:
+        row = len(self._offsets)
+        self._offsets.append(offset)
+        self._lengths.append(length)
+        
+        success = entry.get('success')
+        self.task_id.append(row, entry.get('task_id'))
+        self.phase.append(row, entry.get('phase'))
+        self.outcome.append(row, success)
+        self.confidence.append(float(entry.get('confidence') or 0.0))
+        self.iterations.append(int(entry.get('iterations_taken') or 0))
+        self.patterns.extend(row, entry.get('patterns_identified') or [], bool(success))
+        self.breadcrumbs.extend(row, entry.get('breadcrumbs_consulted') or [], bool(success))
+    
+    # ------------------------------------------------------------------
+    # Queries
+    
+    def select(
+        self,
+        phase: Optional[str] = None,
+        pattern: Optional[str] = None,
+        task_id: Optional[str] = None,
+        success: Any = ANY
+    ) -> List[int]:
+        """
+        Row ids matching every given filter, in insertion order
+        
+        success filters on outcome (True, False, or None for entries without
+        one); leave it as ANY to match all.
+        """
+        self.refresh()
+        
+        postings = []
+        if phase is not None:
+            postings.append(self.phase.lookup(phase))
+        if pattern is not None:
+            postings.append(self.patterns.lookup(pattern))
+        if task_id is not None:
+            postings.append(self.task_id.lookup(task_id))
+        if success is not ANY:
+            postings.append(self.outcome.lookup(success))
+        
+        if not postings:
+            return list(range(len(self._offsets)))
+        
+        postings.sort(key=len)
+        rows = set(postings[0])
+        for other in postings[1:]:
+            rows.intersection_update(other)
+        return sorted(rows)
+    
+    def entries(self, rows: Iterable[int]) -> List[Dict[str, Any]]:
+        """Read full entries by row id"""
+        results = []
+        with open(self.store_path, 'rb') as f:
+            for row in rows:
+                f.seek(self._offsets[row])
+                results.append(json.loads(f.read(self._lengths[row])))
+        return results
+    
+    def recent(self, limit: int) -> List[Dict[str, Any]]:
+        """Last `limit` entries, newest first"""
+        count = len(self)
+        return self.entries(range(count - 1, max(count - limit, 0) - 1, -1))
+    
+    def success_by_pattern(self) -> Dict[str, Tuple[int, int]]:
+        """pattern -> (uses, successful uses)"""
+        self.refresh()
+        return self.patterns.success_counts()
+    
+    def success_by_breadcrumb(self) -> Dict[str, Tuple[int, int]]:
+        """breadcrumb -> (uses, successful uses)"""
+        self.refresh()
+        return self.breadcrumbs.success_counts()
+    
+    def phase_summary(self) -> Dict[str, Dict[str, float]]:
+        """phase -> entry count, successes and mean confidence/iterations"""
+        self.refresh()
+        successful = set(self.outcome.lookup(True))
+        summary = {}
+        for phase, rows in zip(self.phase.values, self.phase.rows):
+            count = len(rows)
+            summary[phase] = {
+                'entries': count,
+                'successful': len(successful.intersection(rows)),
+                'mean_confidence': sum(map(self.confidence.__getitem__, rows)) / count,
+                'mean_iterations': sum(map(self.iterations.__getitem__, rows)) / count
+            }
+        return summary
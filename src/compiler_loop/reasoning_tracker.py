@@ -11,6 +11,9 @@ from typing import Dict, List, Any, Optional
 from pathlib import Path
 from dataclasses import dataclass, asdict
 
+from .reasoning_store import ReasoningStore
+from ..tracing import traced
+
 
 @dataclass
 class ReasoningEntry:
@@ -48,12 +51,18 @@ class ReasoningEntry:
 
 
 class ReasoningTracker:
-    """Tracks and logs AI reasoning processes"""
+    """Tracks and logs AI reasoning processes
+    
+    Completed entries go to a single columnar ReasoningStore
+    (reasoning_store.jsonl); phase/pattern/outcome/task queries and the
+    per-pattern and per-breadcrumb aggregates run on its indexes and columns.
+    """
     
     def __init__(self, log_path: str):
         self.log_path = Path(log_path)
         self.log_path.mkdir(parents=True, exist_ok=True)
         
+        self.store = ReasoningStore(str(self.log_path / 'reasoning_store.jsonl'))
         self.reasoning_database: Dict[str, ReasoningEntry] = {}
         self.current_reasoning: Optional[ReasoningEntry] = None
         
@@ -76,10 +85,29 @@ class ReasoningTracker:
                     self.total_reasoning_events = data.get('total_events', 0)
                     self.successful_decisions = data.get('successful', 0)
                     self.failed_decisions = data.get('failed', 0)
-                    # Reasoning entries are stored in individual files
             except Exception as e:
                 print(f"Warning: Could not load reasoning database: {e}")
+        
+        if not self.store.exists():
+            self._import_entry_files()
     
+    def _import_entry_files(self) -> None:
+        """Move entries from the old one-file-per-entry layout into the store"""
+        entry_files = sorted(
+            (f for f in self.log_path.glob('reasoning_*.json') if f.name != 'reasoning_database.json'),
+            key=lambda x: x.stat().st_mtime
+        )
+        for entry_file in entry_files:
+            try:
+                with open(entry_file, 'r') as f:
+                    entry = json.load(f)
+            except Exception as e:
+                print(f"Warning: Could not load {entry_file}: {e}")
+                continue
+            if isinstance(entry, dict):
+                self.store.append(entry)
+    
+    @traced('ReasoningTracker.save_database')
     def save_database(self) -> None:
         """Save reasoning database metadata to disk"""
         db_file = self.log_path / 'reasoning_database.json'
@@ -172,17 +200,9 @@ class ReasoningTracker:
             else:
                 self.failed_decisions += 1
             
-            # Save to individual file
-            self._save_reasoning_entry(reasoning_id, entry)
+            self.store.append(entry.to_dict())
             self.save_database()
     
-    def _save_reasoning_entry(self, reasoning_id: str, entry: ReasoningEntry) -> None:
-        """Save individual reasoning entry to file"""
-        entry_file = self.log_path / f"reasoning_{reasoning_id}.json"
-        
-        with open(entry_file, 'w') as f:
-            json.dump(entry.to_dict(), f, indent=2)
-    
     def get_current_reasoning(self) -> Optional[Dict[str, Any]]:
         """Get current reasoning in progress"""
         if self.current_reasoning:
@@ -191,84 +211,33 @@ class ReasoningTracker:
     
     def get_recent_reasoning(self, limit: int = 10) -> List[Dict[str, Any]]:
         """Get most recent reasoning entries"""
-        # Get recent reasoning files (excluding the database file)
-        reasoning_files = sorted(
-            [f for f in self.log_path.glob('reasoning_*.json') 
-             if f.name != 'reasoning_database.json'],
-            key=lambda x: x.stat().st_mtime,
-            reverse=True
-        )[:limit]
-        
-        entries = []
-        for file in reasoning_files:
-            try:
-                with open(file, 'r') as f:
-                    entries.append(json.load(f))
-            except Exception as e:
-                print(f"Warning: Could not load {file}: {e}")
-        
-        return entries
+        return self.store.recent(limit)
     
     def get_pattern_statistics(self) -> Dict[str, Any]:
         """Get statistics on pattern usage"""
-        pattern_counts = {}
-        pattern_success_rates = {}
-        
-        # Analyze all reasoning files
-        for reasoning_file in self.log_path.glob('reasoning_*.json'):
-            try:
-                with open(reasoning_file, 'r') as f:
-                    entry = json.load(f)
-                    
-                for pattern in entry.get('patterns_identified', []):
-                    if pattern not in pattern_counts:
-                        pattern_counts[pattern] = {'total': 0, 'successful': 0}
-                    
-                    pattern_counts[pattern]['total'] += 1
-                    if entry.get('success'):
-                        pattern_counts[pattern]['successful'] += 1
-            except Exception:
-                continue
-        
-        # Calculate success rates
-        for pattern, counts in pattern_counts.items():
-            if counts['total'] > 0:
-                pattern_success_rates[pattern] = {
-                    'uses': counts['total'],
-                    'success_rate': counts['successful'] / counts['total']
-                }
-        
-        return pattern_success_rates
+        return {
+            pattern: {'uses': uses, 'success_rate': successful / uses}
+            for pattern, (uses, successful) in self.store.success_by_pattern().items()
+        }
     
     def get_breadcrumb_effectiveness(self) -> Dict[str, Any]:
         """Analyze breadcrumb effectiveness in decision making"""
-        breadcrumb_stats = {}
-        
-        for reasoning_file in self.log_path.glob('reasoning_*.json'):
-            try:
-                with open(reasoning_file, 'r') as f:
-                    entry = json.load(f)
-                    
-                for breadcrumb in entry.get('breadcrumbs_consulted', []):
-                    if breadcrumb not in breadcrumb_stats:
-                        breadcrumb_stats[breadcrumb] = {'uses': 0, 'successful': 0}
-                    
-                    breadcrumb_stats[breadcrumb]['uses'] += 1
-                    if entry.get('success'):
-                        breadcrumb_stats[breadcrumb]['successful'] += 1
-            except Exception:
-                continue
-        
-        # Calculate effectiveness
-        effectiveness = {}
-        for bc, stats in breadcrumb_stats.items():
-            if stats['uses'] > 0:
-                effectiveness[bc] = {
-                    'uses': stats['uses'],
-                    'success_rate': stats['successful'] / stats['uses']
-                }
-        
-        return effectiveness
+        return {
+            breadcrumb: {'uses': uses, 'success_rate': successful / uses}
+            for breadcrumb, (uses, successful) in self.store.success_by_breadcrumb().items()
+        }
+    
+    def get_phase_statistics(self) -> Dict[str, Any]:
+        """Get success rate, confidence and iterations per phase"""
+        return {
+            phase: {
+                'entries': stats['entries'],
+                'success_rate': stats['successful'] / stats['entries'],
+                'mean_confidence': stats['mean_confidence'],
+                'mean_iterations': stats['mean_iterations']
+            }
+            for phase, stats in self.store.phase_summary().items()
+        }
     
     def get_statistics(self) -> Dict[str, Any]:
         """Get comprehensive reasoning statistics"""
@@ -281,50 +250,22 @@ class ReasoningTracker:
                 if self.total_reasoning_events > 0 else 0.0
             ),
             'pattern_usage': self.get_pattern_statistics(),
-            'breadcrumb_effectiveness': self.get_breadcrumb_effectiveness()
+            'breadcrumb_effectiveness': self.get_breadcrumb_effectiveness(),
+            'phase_statistics': self.get_phase_statistics()
         }
     
     def query_by_phase(self, phase: str) -> List[Dict[str, Any]]:
         """Query reasoning entries by phase"""
-        results = []
-        
-        for reasoning_file in self.log_path.glob('reasoning_*.json'):
-            try:
-                with open(reasoning_file, 'r') as f:
-                    entry = json.load(f)
-                    if entry.get('phase') == phase:
-                        results.append(entry)
-            except Exception:
-                continue
-        
-        return results
+        return self.store.entries(self.store.select(phase=phase))
     
     def query_by_pattern(self, pattern: str) -> List[Dict[str, Any]]:
         """Query reasoning entries that used a specific pattern"""
-        results = []
-        
-        for reasoning_file in self.log_path.glob('reasoning_*.json'):
-            try:
-                with open(reasoning_file, 'r') as f:
-                    entry = json.load(f)
-                    if pattern in entry.get('patterns_identified', []):
-                        results.append(entry)
-            except Exception:
-                continue
-        
-        return results
+        return self.store.entries(self.store.select(pattern=pattern))
+    
+    def query_by_task(self, task_id: str) -> List[Dict[str, Any]]:
+        """Query reasoning entries for a task, oldest first"""
+        return self.store.entries(self.store.select(task_id=task_id))
     
     def get_failed_reasoning_patterns(self) -> List[Dict[str, Any]]:
         """Get reasoning chains that led to failures for analysis"""
-        failed = []
-        
-        for reasoning_file in self.log_path.glob('reasoning_*.json'):
-            try:
-                with open(reasoning_file, 'r') as f:
-                    entry = json.load(f)
-                    if entry.get('success') is False:
-                        failed.append(entry)
-            except Exception:
-                continue
-        
-        return failed
+        return self.store.entries(self.store.select(success=False))
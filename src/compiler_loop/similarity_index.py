@@ -0,0 +1,137 @@
+"""
+Error Similarity Index
+Inverted token index over error messages for fast similar-error lookup
+"""
+
+import re
+import heapq
+from itertools import chain
+from typing import Dict, List, Set, FrozenSet, Tuple
+
+
+# Tokens that only differ between occurrences of the same kind of error
+_PATH_RE = re.compile(r'^[\w.\-+/]*(?:/[\w.\-+]*|\.(?:c|h|cc|cpp|cxx|hpp|s|o|a|so|mk))(?::\d+)*:?$')
+_NUMBER_RE = re.compile(r'^[(\[]?(?:0x[0-9a-f]+|\d+)[)\],:;.]*$')
+_QUOTED_RE = re.compile(r"^[`'‘\"].*[`'’\"][:;,.]*$")
+
+
+def tokenize(message: str) -> FrozenSet[str]:
+    """Word set of a message with paths, numbers and quoted identifiers normalized"""
+    tokens = set()
+    for word in message.lower().split():
+        if _QUOTED_RE.match(word):
+            tokens.add('<id>')
+        elif _NUMBER_RE.match(word):
+            tokens.add('<num>')
+        elif _PATH_RE.match(word):
+            tokens.add('<path>')
+        else:
+            tokens.add(word)
+    return frozenset(tokens)
+
+
+class SimilarityIndex:
+    """Finds stored messages sharing most of their words with a query
+    
+    Similarity is |common words| / max(|query words|, |stored words|), as in
+    ErrorTracker.find_similar_errors. After normalization most errors of one
+    kind have the same word set, so the index is over distinct word sets
+    (signatures), each listing its messages in insertion order.
+    
+    Results are exact: with the query's words ordered rarest first, any
+    signature above the threshold must share one of the first
+    |q| - floor(threshold * |q|) words (prefix filtering), and the scan stops
+    early once enough messages beat what unseen signatures could still
+    score, so words every error contains ('error:', 'to', ...) are rarely
+    scanned.
+    """
+    
+    def __init__(self):
+        self._postings: Dict[str, Set[int]] = {}
+        self._signatures: Dict[FrozenSet[str], int] = {}
+        self._sig_tokens: List[FrozenSet[str]] = []
+        self._sig_docs: List[List[int]] = []
+        self._keys: List[str] = []
+        self._ids: Dict[str, int] = {}
+    
+    def __len__(self) -> int:
+        return len(self._keys)
+    
+    def add(self, key: str, message: str) -> None:
+        """Index a message (messages are immutable; re-adding is a no-op)"""
+        if key in self._ids:
+            return
+        
+        doc_id = len(self._keys)
+        self._ids[key] = doc_id
+        self._keys.append(key)
+        
+        tokens = tokenize(message)
+        sig_id = self._signatures.get(tokens)
+        if sig_id is None:
+            sig_id = self._signatures[tokens] = len(self._sig_tokens)
+            self._sig_tokens.append(tokens)
+            self._sig_docs.append([])
+            for token in tokens:
+                self._postings.setdefault(token, set()).add(sig_id)
+        self._sig_docs[sig_id].append(doc_id)
+    
+    def query(self, message: str, limit: int, threshold: float) -> List[Tuple[str, float]]:
+        """
+        Get up to limit (key, similarity) pairs with similarity > threshold
+        
+        Sorted by similarity, ties in insertion order.
+        """
+        query_tokens = tokenize(message)
+        if not query_tokens or limit <= 0:
+            return []
+        
+        exact = self._signatures.get(query_tokens)
+        if exact is not None and len(self._sig_docs[exact]) >= limit:
+            # Nothing can beat similarity 1.0 or an earlier message with it
+            return [(self._keys[doc_id], 1.0) for doc_id in self._sig_docs[exact][:limit]]
+        
+        size = len(query_tokens)
+        # Rarest first; unseen words can't produce candidates but still count
+        ordered = sorted(query_tokens, key=lambda t: len(self._postings.get(t, ())))
+        prefix = size - int(threshold * size)
+        
+        max_size = size / threshold if threshold > 0 else float('inf')
+        by_similarity: Dict[float, List[int]] = {}
+        seen: Set[int] = set()
+        
+        for position, token in enumerate(ordered[:prefix]):
+            # Signatures not seen yet share none of the words so far; stop once
+            # enough messages beat the best they could still reach
+            bound = (size - position) / size
+            if position and sum(
+                len(self._sig_docs[sig_id])
+                for similarity, sig_ids in by_similarity.items() if similarity > bound
+                for sig_id in sig_ids
+            ) >= limit:
+                break
+            
+            new = self._postings.get(token, set()) - seen
+            seen |= new
+            for sig_id in new:
+                tokens = self._sig_tokens[sig_id]
+                if len(tokens) >= max_size:
+                    continue
+                similarity = len(query_tokens & tokens) / max(size, len(tokens))
+                if similarity > threshold:
+                    by_similarity.setdefault(similarity, []).append(sig_id)
+        
+        results = []
+        for similarity in sorted(by_similarity, reverse=True):
+            sig_ids = by_similarity[similarity]
+            if len(sig_ids) == 1:
+                docs = self._sig_docs[sig_ids[0]][:limit - len(results)]
+            else:
+                wanted = limit - len(results)
+                docs = heapq.nsmallest(
+                    wanted, chain.from_iterable(self._sig_docs[sig_id][:wanted] for sig_id in sig_ids)
+                )
+            results.extend((self._keys[doc_id], similarity) for doc_id in docs)
+            if len(results) >= limit:
+                break
+        return results
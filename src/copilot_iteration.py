@@ -4,10 +4,16 @@ Interactive development loop with exploration, reasoning, and local models
 """
 
 import logging
+import os
 import sys
 import json
+import queue
+import socket
+import threading
+from collections import deque
+from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Dict, Any, Optional, List
+from typing import Dict, Any, Optional, List, Tuple
 from datetime import datetime
 
 # Add parent to path
@@ -15,13 +21,40 @@ sys.path.insert(0, str(Path(__file__).parent.parent))
 
 from src.local_models import LocalModelLoader
 from src.interactive_session import SessionManager
-from src.breadcrumb_parser import BreadcrumbParser
+from src.breadcrumb_parser import BreadcrumbParser, BreadcrumbIndex
 from src.compiler_loop import CompilerLoop, ErrorTracker, ReasoningTracker
-from src.iteration_analytics import IterationAnalytics
+from src.iteration_analytics import IterationAnalytics, IterationAggregates
+from src.task_scheduler import TaskScheduler
+from src import tracing
+from src.tracing import traced
 
 logger = logging.getLogger(__name__)
 
 
+@dataclass(eq=False)
+class _PipelineItem:
+    """One task moving through the pipelined loop
+    
+    Holds what the sequential loop keeps on the iteration object (session,
+    reasoning entry, retry count), so several tasks can be in flight while
+    the trackers still only ever see one of them at a time.
+    """
+    task: Dict[str, Any]
+    iteration: int
+    lease: Any = None
+    start_time: datetime = field(default_factory=datetime.now)
+    retry_count: int = 0
+    max_retries: int = 0
+    session: Optional[Dict[str, Any]] = None
+    reasoning: Any = None
+    reasoning_id: Optional[str] = None
+    timings: Dict[str, float] = field(default_factory=dict)
+    generation: Dict[str, Any] = field(default_factory=dict)
+    review: Dict[str, Any] = field(default_factory=dict)
+    compile_result: Dict[str, Any] = field(default_factory=dict)
+    compile_seconds: float = 0.0
+
+
 class CopilotStyleIteration:
     """
     Enhanced iteration loop with exploration and interactive capabilities
@@ -35,7 +68,10 @@ class CopilotStyleIteration:
         log_path: str,
         max_iterations: int = 10,
         max_retries: int = 3,
-        adaptive_retries: bool = True
+        adaptive_retries: bool = True,
+        agent_id: Optional[str] = None,
+        pipeline_depth: int = 0,
+        trace_path: Optional[str] = None
     ):
         self.aros_path = Path(aros_path)
         self.project_name = project_name
@@ -43,12 +79,23 @@ class CopilotStyleIteration:
         self.max_iterations = max_iterations
         self.max_retries = max_retries
         self.adaptive_retries = adaptive_retries
+        # Identifies this loop's claims to agents sharing the task state file
+        self.agent_id = agent_id or f'copilot_{socket.gethostname()}_{os.getpid()}'
+        # Generated tasks allowed to queue for the compiler while the models
+        # move on to the next task; 0 runs every phase strictly in sequence
+        self.pipeline_depth = pipeline_depth
+        # Chrome trace written after run() (collapsed stacks next to it as
+        # .folded); None leaves tracing off
+        self.trace_path = Path(trace_path) if trace_path else None
         
         self.log_path.mkdir(parents=True, exist_ok=True)
+        if self.trace_path:
+            tracing.enable(native_trace_path=str(self.log_path / 'native_trace.jsonl'))
         
         # State file for UI
         self.state_file = self.log_path / 'iteration_state.json'
         self.history_file = self.log_path / 'iteration_history.json'
+        self.task_state_file = self.log_path / 'task_claims.json'
         
         # Initialize components
         logger.info("Initializing Copilot-style iteration system...")
@@ -61,6 +108,9 @@ class CopilotStyleIteration:
         )
         
         self.breadcrumb_parser = BreadcrumbParser()
+        self.breadcrumb_index = BreadcrumbIndex(
+            index_path=str(self.log_path / 'breadcrumb_index.json')
+        )
         self.compiler = CompilerLoop(
             aros_path=str(self.aros_path),
             log_path=str(self.log_path / 'compile')
@@ -71,12 +121,13 @@ class CopilotStyleIteration:
         self.reasoning_tracker = ReasoningTracker(
             log_path=str(self.log_path / 'reasoning')
         )
+        self.task_scheduler: Optional[TaskScheduler] = None
         
         self.current_iteration = 0
         self.successful_iterations = 0
         self.current_reasoning_id = None
         self.retry_count = 0
-        self.iteration_history = []  # Track history across iterations
+        self.iteration_history = []  # Track history across iterations (also resets analytics_aggregates)
         self.learned_patterns = {}  # Track learned patterns
         
         # Current state for UI
@@ -113,20 +164,7 @@ class CopilotStyleIteration:
         self.retry_count = 0
         
         # Update state for UI
-        self.current_state.update({
-            'current_iteration': self.current_iteration,
-            'total_iterations': self.max_iterations,
-            'task_description': task.get('strategy', task.get('phase', 'unknown')),
-            'current_phase': 'starting',
-            'retry_count': 0,
-            'last_update': datetime.now().isoformat()
-        })
-        self._save_state()
-        
-        logger.info(f"\n{'='*60}")
-        logger.info(f"Iteration {self.current_iteration}/{self.max_iterations}")
-        logger.info(f"Task: {task.get('phase', 'unknown')}")
-        logger.info(f"{'='*60}\n")
+        self._begin_task_state(task)
         
         # Determine max retries (adaptive or fixed)
         effective_max_retries = self.max_retries
@@ -189,6 +227,7 @@ class CopilotStyleIteration:
         
         return result
     
+    @traced('iteration')
     def _execute_iteration(
         self,
         task: Dict[str, Any],
@@ -199,23 +238,44 @@ class CopilotStyleIteration:
         
         # Start session on first attempt
         if self.retry_count == 0:
-            task_description = task.get('strategy', task.get('phase', 'unknown'))
-            context = {
-                'phase': task.get('phase', 'DEVELOPMENT'),
-                'status': task.get('status', 'IMPLEMENTING'),
-                'project': self.project_name,
-                'iteration': self.current_iteration
-            }
-            
-            session_id = self.session_manager.start_session(
-                task_description=task_description,
-                context=context
-            )
-            
-            logger.info(f"Started session: {session_id}")
+            self._start_task_session(task)
         
         phase_timings = {}
+        generation_result, review_result = self._model_phases(task, enable_exploration, phase_timings)
         
+        # Phase 5: Compilation & Testing
+        phase_start = datetime.now()
+        compile_result = self._compilation_phase(generation_result)
+        phase_timings['compilation'] = (datetime.now() - phase_start).total_seconds()
+        
+        return self._finish_attempt(generation_result, review_result, compile_result, phase_timings, start_time,
+                                    phase=task.get('phase', 'unknown'))
+    
+    @traced('start_session')
+    def _start_task_session(self, task: Dict[str, Any]) -> None:
+        """Open the interactive session a task's attempts share"""
+        task_description = task.get('strategy', task.get('phase', 'unknown'))
+        context = {
+            'phase': task.get('phase', 'DEVELOPMENT'),
+            'status': task.get('status', 'IMPLEMENTING'),
+            'project': self.project_name,
+            'iteration': self.current_iteration
+        }
+        
+        session_id = self.session_manager.start_session(
+            task_description=task_description,
+            context=context
+        )
+        
+        logger.info(f"Started session: {session_id}")
+    
+    def _model_phases(
+        self,
+        task: Dict[str, Any],
+        enable_exploration: bool,
+        phase_timings: Dict[str, float]
+    ) -> Tuple[Dict[str, Any], Dict[str, Any]]:
+        """Phases 1-4, the ones that run on the models; returns (generation, review)"""
         # Phase 1: Exploration (like Copilot gathering context)
         if enable_exploration and self.retry_count == 0:  # Only explore on first attempt
             phase_start = datetime.now()
@@ -237,11 +297,18 @@ class CopilotStyleIteration:
         review_result = self._review_phase(generation_result)
         phase_timings['review'] = (datetime.now() - phase_start).total_seconds()
         
-        # Phase 5: Compilation & Testing
-        phase_start = datetime.now()
-        compile_result = self._compilation_phase(generation_result)
-        phase_timings['compilation'] = (datetime.now() - phase_start).total_seconds()
-        
+        return generation_result, review_result
+    
+    def _finish_attempt(
+        self,
+        generation_result: Dict[str, Any],
+        review_result: Dict[str, Any],
+        compile_result: Dict[str, Any],
+        phase_timings: Dict[str, float],
+        start_time: datetime,
+        phase: str = 'unknown'
+    ) -> Dict[str, Any]:
+        """Phase 6 plus wrap-up of one attempt; returns the iteration result"""
         # Phase 6: Learning from results
         phase_start = datetime.now()
         success = self._learning_phase(compile_result, review_result)
@@ -271,6 +338,7 @@ class CopilotStyleIteration:
         
         return {
             'iteration': self.current_iteration,
+            'phase': phase,
             'session_id': self.session_manager.current_session['id'] if self.session_manager.current_session else None,
             'success': success,
             'generation': generation_result,
@@ -281,6 +349,7 @@ class CopilotStyleIteration:
             'retry_count': self.retry_count
         }
     
+    @traced('exploration')
     def _exploration_phase(self, task: Dict[str, Any]):
         """Phase 1: Explore codebase like Copilot gathering context"""
         logger.info("\n" + "="*70)
@@ -433,6 +502,7 @@ class CopilotStyleIteration:
             self.current_state['phase_progress']['reasoning'] = 'failed'
             self._save_state()
     
+    @traced('generation')
     def _generation_phase(self) -> Dict[str, Any]:
         """Phase 3: Generate code like Copilot suggesting"""
         logger.info("\n" + "="*70)
@@ -507,6 +577,7 @@ class CopilotStyleIteration:
                 'timestamp': datetime.now().isoformat()
             }
     
+    @traced('review')
     def _review_phase(self, generation_result: Dict[str, Any]) -> Dict[str, Any]:
         """Phase 4: Review generated code"""
         logger.info("\n" + "="*70)
@@ -580,6 +651,12 @@ class CopilotStyleIteration:
     
     def _compilation_phase(self, generation_result: Dict[str, Any]) -> Dict[str, Any]:
         """Phase 5: Compile and test the generated code"""
+        self._announce_compilation(generation_result)
+        compile_result = self._compile_generated(generation_result, self.current_iteration)
+        self._report_compilation(compile_result)
+        return compile_result
+    
+    def _announce_compilation(self, generation_result: Dict[str, Any]) -> None:
         logger.info("\n" + "="*70)
         logger.info("PHASE 5: COMPILATION & TESTING - Validating Solution")
         logger.info("="*70)
@@ -589,11 +666,20 @@ class CopilotStyleIteration:
         self.current_state['phase_progress']['compilation'] = 'running'
         self._save_state()
         
-        # In a real scenario, would write code to file and compile
-        # For demonstration, simulate compilation
         logger.info(f"")
         logger.info(f"🔨 Preparing to compile generated code...")
         logger.info(f"   Code size: {len(generation_result.get('code', ''))} bytes")
+    
+    @traced('compilation')
+    def _compile_generated(self, generation_result: Dict[str, Any], iteration: int) -> Dict[str, Any]:
+        """Compile generated code; returns the compile result
+        
+        Touches no shared state, so the pipelined loop runs it on its
+        compile thread while the models work on the next task.
+        """
+        # In a real scenario, would write code to file and compile
+        # (through self.compiler.compile_cached, which skips identical builds).
+        # For demonstration, simulate compilation; chance verdicts aren't cached.
         
         # Simulate: 70% success rate initially, improving with iterations
         import random
@@ -608,15 +694,24 @@ class CopilotStyleIteration:
             'success': success,
             'errors': [],
             'warnings': [],
-            'timestamp': datetime.now().isoformat()
+            'timestamp': datetime.now().isoformat(),
+            # No build ran
+            'simulated': True
         }
         
         if not success:
             # Simulate some errors
             compile_result['errors'] = [
-                f"error: undefined reference to function_{self.current_iteration}",
+                f"error: undefined reference to function_{iteration}",
                 "error: incompatible types in assignment"
             ]
+        
+        return compile_result
+    
+    def _report_compilation(self, compile_result: Dict[str, Any]) -> None:
+        """Log a compile result and record it in reasoning and UI state"""
+        success = compile_result['success']
+        if not success:
             logger.error(f"")
             logger.error(f"❌ Compilation FAILED")
             logger.error(f"   Error count: {len(compile_result['errors'])}")
@@ -648,9 +743,8 @@ class CopilotStyleIteration:
         }
         self.current_state['phase_progress']['compilation'] = 'completed' if success else 'failed'
         self._save_state()
-        
-        return compile_result
     
+    @traced('learning')
     def _learning_phase(
         self,
         compile_result: Dict[str, Any],
@@ -682,16 +776,16 @@ class CopilotStyleIteration:
         
         # Track errors and get suggestions
         if compile_result.get('errors'):
-            for error in compile_result['errors']:
-                error_hash = self.error_tracker.track_error(
-                    error_message=error,
-                    context={
-                        'iteration': self.current_iteration,
-                        'project': self.project_name,
-                        'reasoning_id': self.current_reasoning_id,
-                        'retry_count': self.retry_count
-                    }
-                )
+            error_hashes = self.error_tracker.track_errors(
+                compile_result,
+                context={
+                    'iteration': self.current_iteration,
+                    'project': self.project_name,
+                    'reasoning_id': self.current_reasoning_id,
+                    'retry_count': self.retry_count
+                }
+            )
+            for error, error_hash in zip(compile_result['errors'], error_hashes):
                 logger.info(f"Tracked error: {error_hash[:8]}")
                 
                 # Get resolution suggestions from similar errors
@@ -735,6 +829,36 @@ class CopilotStyleIteration:
         Returns:
             Summary of all iterations
         """
+        try:
+            with tracing.span('run', project=self.project_name):
+                return self._run()
+        finally:
+            if self.trace_path:
+                self.export_trace()
+    
+    def export_trace(self, trace_path: Optional[str] = None) -> Optional[Tuple[str, str]]:
+        """
+        Write the spans recorded so far, including native ones
+        
+        Args:
+            trace_path: Chrome trace / Perfetto JSON file (default: trace_path)
+            
+        Returns:
+            Paths of the trace and its collapsed stacks, or None when
+            tracing is off
+        """
+        tracer = tracing.get_tracer()
+        trace_path = Path(trace_path) if trace_path else self.trace_path
+        if tracer is None or trace_path is None:
+            return None
+        
+        chrome = tracer.export_chrome(str(trace_path))
+        collapsed = tracer.export_collapsed(str(trace_path.with_suffix('.folded')))
+        logger.info(f"Trace written to {chrome} (flamegraph stacks: {collapsed})")
+        return chrome, collapsed
+    
+    def _run(self) -> Dict[str, Any]:
+        """Body of run()"""
         logger.info("\n" + "="*70)
         logger.info("Starting Copilot-Style Iteration Loop")
         logger.info(f"Project: {self.project_name}")
@@ -755,11 +879,52 @@ class CopilotStyleIteration:
         
         logger.info(f"Found {len(tasks)} incomplete tasks")
         
-        # Run iterations
+        # Run iterations. Breadcrumb tasks are claimed one at a time from the
+        # scheduler, so other agents sharing the task state never get the
+        # same one and dependents become available as tasks complete.
+        scheduler = self.task_scheduler if self.task_scheduler is not None and self.task_scheduler.remaining() else None
+        if self.pipeline_depth > 0:
+            iteration_results = self._run_pipelined(tasks, scheduler)
+        else:
+            iteration_results = self._run_sequential(tasks, scheduler)
+        
+        # Summary
+        summary = {
+            'status': 'completed',
+            'total_iterations': len(iteration_results),
+            'successful': self.successful_iterations,
+            'failed': len(iteration_results) - self.successful_iterations,
+            'tasks_found': len(tasks),
+            'tasks_processed': len(iteration_results)
+        }
+        
+        logger.info("\n" + "="*70)
+        logger.info("Copilot-Style Iteration Loop Complete")
+        logger.info("="*70)
+        logger.info(f"Total Iterations: {summary['total_iterations']}")
+        logger.info(f"Successful: {summary['successful']}")
+        logger.info(f"Failed: {summary['failed']}")
+        logger.info(f"Success Rate: {summary['successful']/summary['total_iterations']*100:.1f}%" if summary['total_iterations'] > 0 else "N/A")
+        logger.info("="*70 + "\n")
+        
+        return summary
+    
+    def _run_sequential(self, tasks: List[Dict[str, Any]], scheduler: Optional[TaskScheduler]) -> List[Dict[str, Any]]:
+        """Run tasks one after another, every phase in sequence"""
         iteration_results = []
         
-        for i in range(min(self.max_iterations, len(tasks))):
-            task = tasks[i]
+        for i in range(self.max_iterations):
+            lease = None
+            if scheduler is not None:
+                lease = scheduler.claim(self.agent_id)
+                if lease is None:
+                    logger.info("No runnable tasks left (the rest are claimed, failed or waiting on those)")
+                    break
+                task = scheduler.get_task(lease.phase).to_dict()
+            elif i < len(tasks):
+                task = tasks[i]
+            else:
+                break
             
             try:
                 result = self.run_interactive_iteration(
@@ -771,43 +936,262 @@ class CopilotStyleIteration:
                 # Check if we should continue
                 if result['success']:
                     logger.info(f"\n✓ Task completed successfully!")
+                    if lease is not None:
+                        scheduler.complete(lease)
                 else:
                     logger.info(f"\n⚠ Task needs more work")
+                    if lease is not None:
+                        scheduler.fail(lease, 'iteration did not succeed')
                 
             except KeyboardInterrupt:
                 logger.info("\n\nInterrupted by user")
+                if lease is not None:
+                    scheduler.release(lease)
                 break
             except Exception as e:
                 logger.error(f"\n\nError in iteration: {e}")
+                if lease is not None:
+                    scheduler.fail(lease, str(e))
                 import traceback
                 traceback.print_exc()
                 break
         
-        # Summary
-        summary = {
-            'status': 'completed',
-            'total_iterations': len(iteration_results),
-            'successful': self.successful_iterations,
-            'failed': len(iteration_results) - self.successful_iterations,
-            'tasks_found': len(tasks),
-            'tasks_processed': len(iteration_results)
-        }
         
-        logger.info("\n" + "="*70)
-        logger.info("Copilot-Style Iteration Loop Complete")
-        logger.info("="*70)
-        logger.info(f"Total Iterations: {summary['total_iterations']}")
-        logger.info(f"Successful: {summary['successful']}")
-        logger.info(f"Failed: {summary['failed']}")
-        logger.info(f"Success Rate: {summary['successful']/summary['total_iterations']*100:.1f}%" if summary['total_iterations'] > 0 else "N/A")
-        logger.info("="*70 + "\n")
+        return iteration_results
+    
+    def _run_pipelined(self, tasks: List[Dict[str, Any]], scheduler: Optional[TaskScheduler]) -> List[Dict[str, Any]]:
+        """
+        Run tasks with compilation overlapping the model phases
         
-        return summary
+        The calling thread runs exploration through review for one task
+        while a compile thread builds the previous ones; compile results come
+        back through a queue and are folded in (report, learning, retry or
+        completion) between model phases. At most pipeline_depth generated
+        tasks wait for the compiler: submitting another blocks until it
+        catches up. Failed attempts go back to the front of the line with
+        their session, as in the sequential loop.
+        
+        Only this thread touches sessions, trackers and UI state; each
+        in-flight task's session and reasoning entry are swapped in while
+        it is worked on.
+        
+        Returns:
+            Iteration results in completion order
+        """
+        compile_queue: queue.Queue = queue.Queue(maxsize=self.pipeline_depth)
+        done_queue: queue.Queue = queue.Queue()
+        worker = threading.Thread(
+            target=self._compile_worker, args=(compile_queue, done_queue),
+            name='copilot-compile', daemon=True
+        )
+        worker.start()
+        
+        results: List[Dict[str, Any]] = []
+        retries: deque = deque()
+        in_flight: List[_PipelineItem] = []
+        active: Optional[_PipelineItem] = None
+        # Taken off in_flight but not settled yet
+        folding: Optional[_PipelineItem] = None
+        started = 0
+        next_task = 0
+        # Folding an older task switches current_iteration back to it
+        last_iteration = self.current_iteration
+        
+        def fold(block: bool) -> None:
+            nonlocal folding
+            while in_flight:
+                try:
+                    item = done_queue.get(block=block)
+                except queue.Empty:
+                    return
+                in_flight.remove(item)
+                folding = item
+                self._fold_compiled(item, retries, results, scheduler)
+                folding = None
+                block = False
+        
+        try:
+            while True:
+                fold(block=False)
+                
+                item = retries.popleft() if retries else None
+                if item is None and started < self.max_iterations:
+                    task, lease = None, None
+                    if scheduler is not None:
+                        lease = scheduler.claim(self.agent_id)
+                        if lease is not None:
+                            task = scheduler.get_task(lease.phase).to_dict()
+                    elif next_task < len(tasks):
+                        task = tasks[next_task]
+                        next_task += 1
+                    if task is not None:
+                        started += 1
+                        last_iteration += 1
+                        item = _PipelineItem(task=task, iteration=last_iteration,
+                                             lease=lease, max_retries=self.max_retries)
+                
+                if item is None:
+                    if not in_flight:
+                        break
+                    # Nothing to generate until a compile comes back (with a
+                    # retry, or completing a task that unblocks others)
+                    fold(block=True)
+                    continue
+                
+                active = item
+                self._activate(item)
+                try:
+                    if item.retry_count == 0:
+                        self._begin_task_state(item.task)
+                        self._start_task_session(item.task)
+                    item.generation, item.review = self._model_phases(item.task, True, item.timings)
+                    self._announce_compilation(item.generation)
+                finally:
+                    self._deactivate(item)
+                
+                in_flight.append(item)
+                active = None
+                # Blocks while pipeline_depth tasks already wait on the compiler
+                compile_queue.put(item)
+        except KeyboardInterrupt:
+            logger.info("\n\nInterrupted by user")
+        except Exception as e:
+            logger.error(f"\n\nError in pipelined iteration: {e}")
+            for failed in (active, folding):
+                if failed is not None and failed.lease is not None:
+                    scheduler.fail(failed.lease, str(e))
+            active = folding = None
+            import traceback
+            traceback.print_exc()
+        finally:
+            compile_queue.put(None)
+            worker.join()
+            # Whatever was never folded back goes back to the scheduler
+            while not done_queue.empty():
+                leftover = done_queue.get()
+                if leftover in in_flight:
+                    in_flight.remove(leftover)
+                    retries.append(leftover)
+            for item in list(retries) + in_flight + [i for i in (active, folding) if i is not None]:
+                if item.lease is not None:
+                    scheduler.release(item.lease)
+            self.current_iteration = last_iteration
+            self.current_state['current_phase'] = 'complete'
+            self._save_state()
+        
+        return results
     
+    def _compile_worker(self, compile_queue: queue.Queue, done_queue: queue.Queue) -> None:
+        """Compile thread of the pipelined loop; None on compile_queue stops it"""
+        while True:
+            item = compile_queue.get()
+            if item is None:
+                return
+            start = datetime.now()
+            try:
+                item.compile_result = self._compile_generated(item.generation, item.iteration)
+            except Exception as e:
+                logger.error(f"Compilation of iteration {item.iteration} raised: {e}")
+                item.compile_result = {
+                    'success': False,
+                    'errors': [f'compilation raised: {e}'],
+                    'warnings': [],
+                    'timestamp': datetime.now().isoformat()
+                }
+            item.compile_seconds = (datetime.now() - start).total_seconds()
+            done_queue.put(item)
+    
+    def _fold_compiled(
+        self,
+        item: _PipelineItem,
+        retries: deque,
+        results: List[Dict[str, Any]],
+        scheduler: Optional[TaskScheduler]
+    ) -> None:
+        """Report, learn from and settle one compiled attempt"""
+        self._activate(item)
+        try:
+            self._report_compilation(item.compile_result)
+            item.timings['compilation'] = item.compile_seconds
+            result = self._finish_attempt(item.generation, item.review, item.compile_result,
+                                          item.timings, item.start_time, phase=item.task.get('phase', 'unknown'))
+            
+            # On first failure with adaptive retries, recalculate retry limit
+            if not result['success'] and item.retry_count == 0 and self.adaptive_retries:
+                item.max_retries = self._calculate_adaptive_retries(item.compile_result.get('errors', []))
+                logger.info(f"Adjusted max retries to {item.max_retries} based on error complexity")
+            
+            if not result['success'] and item.retry_count < item.max_retries:
+                item.retry_count += 1
+                self.retry_count = item.retry_count
+                logger.info(f"\n⚠ Iteration {item.iteration} failed, retrying ({item.retry_count}/{item.max_retries})...")
+                if self.session_manager.current_session:
+                    self.session_manager.current_session['context'].update({
+                        'retry_count': item.retry_count,
+                        'previous_errors': item.compile_result.get('errors', []),
+                        'previous_review': item.review.get('review', '')
+                    })
+                item.timings = {}
+                retries.append(item)
+                return
+            
+            if not result['success']:
+                logger.warning(f"\n⚠ Max retries ({item.max_retries}) reached")
+            self._track_iteration_history(result)
+            self._learn_pattern(result)
+            self._add_to_history(result)
+            if self.current_iteration % 5 == 0:
+                self.save_iteration_state()
+            results.append(result)
+            
+            if item.lease is not None:
+                if result['success']:
+                    scheduler.complete(item.lease)
+                else:
+                    scheduler.fail(item.lease, 'iteration did not succeed')
+        finally:
+            self._deactivate(item)
+    
+    def _begin_task_state(self, task: Dict[str, Any]) -> None:
+        """Reset the UI state for a new task"""
+        self.current_state.update({
+            'current_iteration': self.current_iteration,
+            'total_iterations': self.max_iterations,
+            'task_description': task.get('strategy', task.get('phase', 'unknown')),
+            'current_phase': 'starting',
+            'retry_count': 0,
+            'last_update': datetime.now().isoformat()
+        })
+        self._save_state()
+        
+        logger.info(f"\n{'='*60}")
+        logger.info(f"Iteration {self.current_iteration}/{self.max_iterations}")
+        logger.info(f"Task: {task.get('phase', 'unknown')}")
+        logger.info(f"{'='*60}\n")
+    
+    def _activate(self, item: _PipelineItem) -> None:
+        """Make item the task the session manager, trackers and phases see"""
+        self.session_manager.current_session = item.session
+        self.reasoning_tracker.current_reasoning = item.reasoning
+        self.current_reasoning_id = item.reasoning_id
+        self.current_iteration = item.iteration
+        self.retry_count = item.retry_count
+        self.current_state['current_iteration'] = item.iteration
+        self.current_state['retry_count'] = item.retry_count
+    
+    def _deactivate(self, item: _PipelineItem) -> None:
+        item.session = self.session_manager.current_session
+        item.reasoning = self.reasoning_tracker.current_reasoning
+        item.reasoning_id = self.current_reasoning_id
+    
+    @traced('scan_tasks')
     def _find_incomplete_tasks(self) -> List[Dict[str, Any]]:
-        """Find incomplete tasks from breadcrumbs"""
-        tasks = []
+        """Find incomplete tasks from breadcrumbs, in scheduling order
         
+        Also (re)builds self.task_scheduler over the dependency graph of the
+        breadcrumbs found; tasks that are ready to run come first, highest
+        priority and longest critical path leading.
+        """
         # Search for C files in the project
         search_paths = [
             self.aros_path / 'workbench' / 'hidds' / self.project_name,
@@ -815,30 +1199,22 @@ class CopilotStyleIteration:
             self.aros_path / self.project_name
         ]
         
-        c_files = []
+        # Refresh the persistent index; only files changed since the last
+        # run (or since the last AROS sync) are re-parsed. A cold index parses
+        # the whole subtree, in parallel; a few changed files stay in-process.
+        breadcrumbs = []
         for search_path in search_paths:
             if search_path.exists():
-                c_files.extend(list(search_path.rglob('*.c'))[:20])
+                try:
+                    self.breadcrumb_index.refresh_from_git(str(search_path), extensions=['.c'],
+                                                           workers=os.cpu_count())
+                    breadcrumbs.extend(self.breadcrumb_index.get_breadcrumbs(str(search_path)))
+                except Exception as e:
+                    logger.warning(f"Breadcrumb index refresh failed for {search_path}: {e}")
+        self.breadcrumb_parser.breadcrumbs = breadcrumbs
         
-        # Parse breadcrumbs
-        for c_file in c_files:
-            try:
-                self.breadcrumb_parser.parse_file(str(c_file))
-            except Exception:
-                pass
-        
-        # Get incomplete tasks
-        incomplete = self.breadcrumb_parser.get_breadcrumbs_by_status('PARTIAL')
-        incomplete += self.breadcrumb_parser.get_breadcrumbs_by_status('NOT_STARTED')
-        
-        # Convert to task format
-        for bc in incomplete:
-            tasks.append({
-                'phase': bc.phase,
-                'status': bc.status,
-                'strategy': bc.strategy,
-                'file': bc.file_path
-            })
+        self.task_scheduler = TaskScheduler(breadcrumbs, state_path=str(self.task_state_file))
+        tasks = [task.to_dict() for task in self.task_scheduler.get_tasks()]
         
         # If no tasks from breadcrumbs, create a default task
         if not tasks:
@@ -850,8 +1226,8 @@ class CopilotStyleIteration:
             })
         
         return tasks
-
-
+    
+    
     def _calculate_adaptive_retries(self, errors: List[str]) -> int:
         """
         Calculate adaptive retry count based on error complexity
@@ -912,6 +1288,7 @@ class CopilotStyleIteration:
         """
         history_entry = {
             'iteration': self.current_iteration,
+            'phase': result.get('phase', 'unknown'),
             'timestamp': datetime.now().isoformat(),
             'success': result['success'],
             'retry_count': result['retry_count'],
@@ -923,8 +1300,9 @@ class CopilotStyleIteration:
         self.iteration_history.append(history_entry)
         
         # Keep only last 20 iterations in memory
+        # (in place: reassigning would rebuild the analytics aggregates)
         if len(self.iteration_history) > 20:
-            self.iteration_history = self.iteration_history[-20:]
+            del self.iteration_history[:-20]
         
         # Save to disk
         history_file = self.log_path / 'iteration_history.json'
@@ -945,7 +1323,7 @@ class CopilotStyleIteration:
             return
         
         # Extract pattern information
-        phase = result.get('generation', {}).get('context', {}).get('phase', 'unknown')
+        phase = result.get('phase', 'unknown')
         
         if phase not in self.learned_patterns:
             self.learned_patterns[phase] = {
@@ -1089,6 +1467,7 @@ class CopilotStyleIteration:
         
         return recommendation
     
+    @traced('save_iteration_state')
     def save_iteration_state(self) -> str:
         """
         Save the current iteration state for recovery
@@ -1100,6 +1479,7 @@ class CopilotStyleIteration:
             'current_iteration': self.current_iteration,
             'successful_iterations': self.successful_iterations,
             'iteration_history': self.iteration_history,
+            'analytics': self.analytics_aggregates.to_dict(),
             'learned_patterns': self.learned_patterns,
             'project_name': self.project_name,
             'timestamp': datetime.now().isoformat()
@@ -1135,6 +1515,8 @@ class CopilotStyleIteration:
             self.current_iteration = state['current_iteration']
             self.successful_iterations = state['successful_iterations']
             self.iteration_history = state['iteration_history']
+            if 'analytics' in state:
+                self.analytics_aggregates = IterationAggregates.from_dict(state['analytics'])
             self.learned_patterns = state['learned_patterns']
             
             logger.info(f"Loaded iteration state from {state_file}")
@@ -1260,8 +1642,10 @@ class CopilotStyleIteration:
         except Exception as e:
             logger.error(f"Failed to save state: {e}")
     
+    @traced('history_io')
     def _add_to_history(self, iteration_result: Dict[str, Any]):
-        """Add iteration result to history file"""
+        """Add iteration result to history file and the analytics aggregates"""
+        self.analytics_aggregates.add(iteration_result)
         try:
             # Load existing history
             history = []
@@ -1272,6 +1656,7 @@ class CopilotStyleIteration:
             # Add new iteration
             history.append({
                 'iteration': iteration_result.get('iteration'),
+                'phase': iteration_result.get('phase', 'unknown'),
                 'success': iteration_result.get('success'),
                 'timestamp': datetime.now().isoformat(),
                 'timings': iteration_result.get('timings', {}),
@@ -1289,14 +1674,30 @@ class CopilotStyleIteration:
         except Exception as e:
             logger.error(f"Failed to add to history: {e}")
     
+    @property
+    def iteration_history(self) -> List[Dict[str, Any]]:
+        """Recent iteration entries (last 20)"""
+        return self._iteration_history
+    
+    @iteration_history.setter
+    def iteration_history(self, history: List[Dict[str, Any]]) -> None:
+        # Replacing the history (restored state, tests) restarts the
+        # aggregates from it; normal runs only append
+        self._iteration_history = history
+        self.analytics_aggregates = IterationAggregates.from_history(history)
+    
     def get_analytics(self) -> IterationAnalytics:
         """
         Get analytics engine for detailed performance analysis
         
+        Queries read analytics_aggregates, which _add_to_history keeps up to
+        date for every iteration of the run, not only the last 20 in
+        iteration_history.
+        
         Returns:
             IterationAnalytics instance with current data
         """
-        return IterationAnalytics(self.iteration_history, self.learned_patterns)
+        return IterationAnalytics(self.iteration_history, self.learned_patterns, self.analytics_aggregates)
     
     def generate_analytics_report(self, output_path: Optional[str] = None) -> str:
         """
@@ -1346,6 +1747,17 @@ def main():
         default='logs/copilot_iteration',
         help='Path for logs'
     )
+    parser.add_argument(
+        '--pipeline-depth',
+        type=int,
+        default=0,
+        help='Tasks that may wait for compilation while the next one generates (0 = sequential)'
+    )
+    parser.add_argument(
+        '--trace',
+        default=None,
+        help='Write a Chrome/Perfetto trace of every phase here (plus .folded flamegraph stacks)'
+    )
     
     args = parser.parse_args()
     
@@ -1354,7 +1766,9 @@ def main():
         aros_path=args.aros_path,
         project_name=args.project,
         log_path=args.log_path,
-        max_iterations=args.max_iterations
+        max_iterations=args.max_iterations,
+        pipeline_depth=args.pipeline_depth,
+        trace_path=args.trace
     )
     
     try:
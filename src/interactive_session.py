@@ -11,6 +11,8 @@ from datetime import datetime
 import json
 from collections import defaultdict
 
+from src.tracing import span
+
 logger = logging.getLogger(__name__)
 
 
@@ -118,7 +120,8 @@ class SessionManager:
         # Ensure LLM is loaded
         if not self.llm:
             logger.info("  Loading language model for exploration...")
-            self.llm = self.model_loader.load_model('llm')
+            with span('model_load', model='llm'):
+                self.llm = self.model_loader.load_model('llm')
         
         # Find relevant files
         logger.info(f"  Searching for relevant files (max: {max_files})...")
@@ -199,11 +202,12 @@ class SessionManager:
         
         # Use LLM to explore
         logger.info(f"  Analyzing codebase with language model...")
-        exploration = self.llm.explore_codebase(
-            query=query,
-            file_contents=file_contents,
-            breadcrumbs=breadcrumbs
-        )
+        with span('llm.explore'):
+            exploration = self.llm.explore_codebase(
+                query=query,
+                file_contents=file_contents,
+                breadcrumbs=breadcrumbs
+            )
         
         # Add detailed metadata
         exploration['timestamp'] = datetime.now().isoformat()
@@ -257,7 +261,8 @@ class SessionManager:
         # Ensure LLM is loaded
         if not self.llm:
             logger.info("  Loading language model for reasoning...")
-            self.llm = self.model_loader.load_model('llm')
+            with span('model_load', model='llm'):
+                self.llm = self.model_loader.load_model('llm')
         
         task = specific_question or self.current_session['task']
         logger.info(f"  Task: {task}")
@@ -297,11 +302,12 @@ class SessionManager:
         
         # Reason about task
         logger.info(f"  Analyzing task and formulating strategy...")
-        reasoning = self.llm.reason_about_task(
-            task_description=task,
-            context=self.current_session['context'],
-            previous_attempts=previous_attempts if previous_attempts else None
-        )
+        with span('llm.reason'):
+            reasoning = self.llm.reason_about_task(
+                task_description=task,
+                context=self.current_session['context'],
+                previous_attempts=previous_attempts if previous_attempts else None
+            )
         
         # Track breadcrumb influence on reasoning
         if self.current_session['exploration_results']:
@@ -349,7 +355,8 @@ class SessionManager:
         # Ensure codegen is loaded
         if not self.codegen:
             logger.info("  Loading code generation model...")
-            self.codegen = self.model_loader.load_model('codegen')
+            with span('model_load', model='codegen'):
+                self.codegen = self.model_loader.load_model('codegen')
         
         # Build context from exploration if enabled
         context = self.current_session['context'].copy()
@@ -403,12 +410,13 @@ class SessionManager:
         if stream:
             logger.info(f"     (streaming enabled)")
         
-        generated_code = self.codegen.generate_with_breadcrumbs(
-            task_description=task_desc,
-            context=context,
-            breadcrumb_history=breadcrumb_history if breadcrumb_history else None,
-            stream=stream
-        )
+        with span('codegen.generate'):
+            generated_code = self.codegen.generate_with_breadcrumbs(
+                task_description=task_desc,
+                context=context,
+                breadcrumb_history=breadcrumb_history if breadcrumb_history else None,
+                stream=stream
+            )
         
         generation_result = {
             'code': generated_code,
@@ -477,7 +485,8 @@ class SessionManager:
         # Ensure LLM is loaded
         if not self.llm:
             logger.info("  Loading language model for review...")
-            self.llm = self.model_loader.load_model('llm')
+            with span('model_load', model='llm'):
+                self.llm = self.model_loader.load_model('llm')
         
         # Use latest generated code if not provided
         if code is None:
@@ -497,11 +506,12 @@ class SessionManager:
         
         # Review code
         logger.info(f"  Performing comprehensive code review...")
-        review = self.llm.review_code(
-            code=code,
-            requirements=self.current_session['task'],
-            errors=errors
-        )
+        with span('llm.review'):
+            review = self.llm.review_code(
+                code=code,
+                requirements=self.current_session['task'],
+                errors=errors
+            )
         
         logger.info(f"  ✓ Review complete")
         if 'review' in review:
@@ -6,7 +6,9 @@ patterns, and trends.
 """
 
 import logging
-from typing import Dict, Any, List, Optional
+import math
+from collections import Counter, deque
+from typing import Dict, Any, List, Optional, Iterable, Deque
 from pathlib import Path
 from datetime import datetime
 import json
@@ -14,22 +16,277 @@ import json
 logger = logging.getLogger(__name__)
 
 
+# Iterations behind recent_success_rate, per-phase trends and moving averages
+RECENT_WINDOW = 10
+TREND_WINDOW = 6
+MOVING_AVERAGE_WINDOW = 3
+# Points kept for get_time_series_analysis()
+SERIES_WINDOW = 1000
+
+
+def _error_type(error: str) -> str:
+    """Coarse error class used by the error analysis (simple heuristic)"""
+    error = error.lower()
+    if 'syntax' in error:
+        return 'syntax'
+    if 'undefined' in error:
+        return 'undefined_reference'
+    if 'type' in error:
+        return 'type_error'
+    if 'segmentation' in error or 'segfault' in error:
+        return 'runtime_error'
+    return 'unknown'
+
+
+class QuantileSketch:
+    """
+    Mergeable quantile sketch over positive values (durations)
+    
+    Values are counted in logarithmic buckets whose bounds grow by
+    gamma = (1 + a) / (1 - a), so every quantile comes back within relative
+    error a of the exact one. Memory depends on the value range, not the
+    number of values (about 700 buckets for 1 ms to 10 h at a = 1%), and
+    two sketches with the same accuracy merge by adding bucket counts.
+    """
+    
+    MIN_VALUE = 1e-9
+    
+    def __init__(self, relative_accuracy: float = 0.01):
+        self.relative_accuracy = relative_accuracy
+        self._gamma = (1 + relative_accuracy) / (1 - relative_accuracy)
+        self._log_gamma = math.log(self._gamma)
+        self.buckets: Dict[int, int] = {}
+        self.zero_count = 0
+        self.count = 0
+        self.total = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+    
+    def add(self, value: float) -> None:
+        if value <= self.MIN_VALUE:
+            self.zero_count += 1
+        else:
+            key = math.ceil(math.log(value) / self._log_gamma)
+            self.buckets[key] = self.buckets.get(key, 0) + 1
+        self.count += 1
+        self.total += value
+        self.min = min(self.min, value)
+        self.max = max(self.max, value)
+    
+    def merge(self, other: 'QuantileSketch') -> None:
+        if other.relative_accuracy != self.relative_accuracy:
+            raise ValueError("Cannot merge sketches with different accuracy")
+        for key, count in other.buckets.items():
+            self.buckets[key] = self.buckets.get(key, 0) + count
+        self.zero_count += other.zero_count
+        self.count += other.count
+        self.total += other.total
+        self.min = min(self.min, other.min)
+        self.max = max(self.max, other.max)
+    
+    def quantile(self, q: float) -> Optional[float]:
+        """Value at quantile q (0..1), or None if nothing was added"""
+        if not self.count:
+            return None
+        rank = q * (self.count - 1)
+        seen = self.zero_count
+        if rank < seen:
+            return max(self.min, 0.0)
+        for key in sorted(self.buckets):
+            seen += self.buckets[key]
+            if seen > rank:
+                estimate = 2 * self._gamma ** key / (self._gamma + 1)
+                return min(max(estimate, self.min), self.max)
+        return self.max
+    
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            'relative_accuracy': self.relative_accuracy,
+            'buckets': {str(key): count for key, count in self.buckets.items()},
+            'zero_count': self.zero_count,
+            'count': self.count,
+            'total': self.total,
+            'min': self.min if self.count else None,
+            'max': self.max if self.count else None
+        }
+    
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> 'QuantileSketch':
+        sketch = cls(data['relative_accuracy'])
+        sketch.buckets = {int(key): count for key, count in data['buckets'].items()}
+        sketch.zero_count = data['zero_count']
+        sketch.count = data['count']
+        sketch.total = data['total']
+        if sketch.count:
+            sketch.min, sketch.max = data['min'], data['max']
+        return sketch
+
+
+class IterationAggregates:
+    """
+    Running aggregates behind IterationAnalytics
+    
+    add() folds one finished iteration in at constant cost: counts and
+    success rates overall and per phase, quantile sketches of total and
+    per-phase durations, error counts, and fixed windows for the recent
+    success rate, per-phase trends and the time series. Queries read these
+    directly, so a dashboard refresh costs the same however long the
+    history gets.
+    
+    Accepts both history shapes in use: 'timings' / 'compilation.errors'
+    (iteration results) and 'phase_timings' / 'errors' (saved state).
+    """
+    
+    def __init__(self):
+        self.total_iterations = 0
+        self.successful_iterations = 0
+        self.failed_iterations = 0
+        self.total_time = 0.0
+        self.total_retries = 0
+        self.durations = QuantileSketch()
+        self.phase_timings: Dict[str, QuantileSketch] = {}
+        # phase -> {'iterations', 'failures', 'recent': successes in the last TREND_WINDOW}
+        self.phases: Dict[str, Dict[str, Any]] = {}
+        self.error_types: Counter = Counter()
+        self.recent: Deque[bool] = deque(maxlen=RECENT_WINDOW)
+        self.series: Dict[str, Deque] = {
+            name: deque(maxlen=SERIES_WINDOW)
+            for name in ('iterations', 'success', 'retry_count', 'total_time', 'moving_avg_success')
+        }
+        self._moving: Deque[bool] = deque(maxlen=MOVING_AVERAGE_WINDOW)
+    
+    @classmethod
+    def from_history(cls, iteration_history: Iterable[Dict[str, Any]]) -> 'IterationAggregates':
+        aggregates = cls()
+        for entry in iteration_history:
+            aggregates.add(entry)
+        return aggregates
+    
+    def add(self, entry: Dict[str, Any]) -> None:
+        """Fold one iteration entry in"""
+        success = bool(entry.get('success'))
+        total_time = entry.get('total_time', 0.0) or 0.0
+        retries = entry.get('retry_count', 0) or 0
+        phase = entry.get('phase') or 'unknown'
+        
+        self.total_iterations += 1
+        self.successful_iterations += success
+        self.failed_iterations += not success
+        self.total_time += total_time
+        self.total_retries += retries
+        self.durations.add(total_time)
+        
+        timings = entry.get('timings') or entry.get('phase_timings') or {}
+        for name, seconds in timings.items():
+            sketch = self.phase_timings.get(name)
+            if sketch is None:
+                sketch = self.phase_timings[name] = QuantileSketch()
+            sketch.add(seconds)
+        
+        stats = self.phases.get(phase)
+        if stats is None:
+            stats = self.phases[phase] = {'iterations': 0, 'failures': 0, 'recent': deque(maxlen=TREND_WINDOW)}
+        stats['iterations'] += 1
+        stats['failures'] += not success
+        stats['recent'].append(success)
+        
+        if not success:
+            errors = entry.get('compilation', {}).get('errors') or entry.get('errors') or []
+            self.error_types.update(_error_type(error) for error in errors)
+        
+        self.recent.append(success)
+        self._moving.append(success)
+        self.series['iterations'].append(entry.get('iteration'))
+        self.series['success'].append(1 if success else 0)
+        self.series['retry_count'].append(retries)
+        self.series['total_time'].append(total_time)
+        self.series['moving_avg_success'].append(sum(self._moving) / len(self._moving))
+    
+    def merge(self, other: 'IterationAggregates') -> None:
+        """Fold in another stream's aggregates, e.g. another agent's
+        
+        Counts and sketches merge exactly; the windows get other's entries
+        appended after this side's.
+        """
+        self.total_iterations += other.total_iterations
+        self.successful_iterations += other.successful_iterations
+        self.failed_iterations += other.failed_iterations
+        self.total_time += other.total_time
+        self.total_retries += other.total_retries
+        self.durations.merge(other.durations)
+        for name, sketch in other.phase_timings.items():
+            self.phase_timings.setdefault(name, QuantileSketch(sketch.relative_accuracy)).merge(sketch)
+        for phase, stats in other.phases.items():
+            mine = self.phases.setdefault(phase, {'iterations': 0, 'failures': 0, 'recent': deque(maxlen=TREND_WINDOW)})
+            mine['iterations'] += stats['iterations']
+            mine['failures'] += stats['failures']
+            mine['recent'].extend(stats['recent'])
+        self.error_types.update(other.error_types)
+        self.recent.extend(other.recent)
+        for name, values in other.series.items():
+            self.series[name].extend(values)
+    
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            'total_iterations': self.total_iterations,
+            'successful_iterations': self.successful_iterations,
+            'failed_iterations': self.failed_iterations,
+            'total_time': self.total_time,
+            'total_retries': self.total_retries,
+            'durations': self.durations.to_dict(),
+            'phase_timings': {name: sketch.to_dict() for name, sketch in self.phase_timings.items()},
+            'phases': {phase: dict(stats, recent=list(stats['recent'])) for phase, stats in self.phases.items()},
+            'error_types': dict(self.error_types),
+            'recent': list(self.recent),
+            'series': {name: list(values) for name, values in self.series.items()},
+            'moving': list(self._moving)
+        }
+    
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> 'IterationAggregates':
+        aggregates = cls()
+        for name in ('total_iterations', 'successful_iterations', 'failed_iterations',
+                     'total_time', 'total_retries'):
+            setattr(aggregates, name, data[name])
+        aggregates.durations = QuantileSketch.from_dict(data['durations'])
+        aggregates.phase_timings = {name: QuantileSketch.from_dict(sketch)
+                                    for name, sketch in data['phase_timings'].items()}
+        aggregates.phases = {
+            phase: dict(stats, recent=deque(stats['recent'], maxlen=TREND_WINDOW))
+            for phase, stats in data['phases'].items()
+        }
+        aggregates.error_types = Counter(data['error_types'])
+        aggregates.recent.extend(data['recent'])
+        for name, values in data['series'].items():
+            aggregates.series[name].extend(values)
+        aggregates._moving.extend(data['moving'])
+        return aggregates
+
+
 class IterationAnalytics:
     """
     Analytics engine for copilot iteration system
     Provides insights, trends, and performance metrics
     """
     
-    def __init__(self, iteration_history: List[Dict[str, Any]], learned_patterns: Dict[str, Any]):
+    def __init__(
+        self,
+        iteration_history: List[Dict[str, Any]],
+        learned_patterns: Dict[str, Any],
+        aggregates: Optional[IterationAggregates] = None
+    ):
         """
         Initialize analytics with iteration history and learned patterns
         
         Args:
             iteration_history: List of completed iterations
             learned_patterns: Dictionary of learned patterns by phase
+            aggregates: Running aggregates kept up to date by the caller;
+                built from iteration_history (once) when not given
         """
         self.iteration_history = iteration_history
         self.learned_patterns = learned_patterns
+        self.aggregates = aggregates if aggregates is not None else IterationAggregates.from_history(iteration_history)
     
     def get_performance_summary(self) -> Dict[str, Any]:
         """
@@ -38,46 +295,44 @@ class IterationAnalytics:
         Returns:
             Dictionary with performance metrics
         """
-        if not self.iteration_history:
+        agg = self.aggregates
+        if not agg.total_iterations:
             return {
                 'total_iterations': 0,
                 'message': 'No iteration history available'
             }
         
-        successful = [h for h in self.iteration_history if h['success']]
-        failed = [h for h in self.iteration_history if not h['success']]
-        
         summary = {
-            'total_iterations': len(self.iteration_history),
-            'successful_iterations': len(successful),
-            'failed_iterations': len(failed),
-            'success_rate': len(successful) / len(self.iteration_history),
-            'average_time': sum(h['total_time'] for h in self.iteration_history) / len(self.iteration_history),
-            'average_retries': sum(h['retry_count'] for h in self.iteration_history) / len(self.iteration_history),
-            'total_time': sum(h['total_time'] for h in self.iteration_history),
+            'total_iterations': agg.total_iterations,
+            'successful_iterations': agg.successful_iterations,
+            'failed_iterations': agg.failed_iterations,
+            'success_rate': agg.successful_iterations / agg.total_iterations,
+            'average_time': agg.total_time / agg.total_iterations,
+            'average_retries': agg.total_retries / agg.total_iterations,
+            'total_time': agg.total_time,
+            'time_quantiles': {
+                'p50': agg.durations.quantile(0.5),
+                'p90': agg.durations.quantile(0.9),
+                'p99': agg.durations.quantile(0.99)
+            }
         }
         
-        # Calculate time breakdown by phase
-        phase_times = {}
-        for history in self.iteration_history:
-            for phase, time in history.get('timings', {}).items():
-                if phase not in phase_times:
-                    phase_times[phase] = []
-                phase_times[phase].append(time)
-        
+        # Time breakdown by phase
         summary['phase_timings'] = {
             phase: {
-                'average': sum(times) / len(times),
-                'min': min(times),
-                'max': max(times),
-                'total': sum(times)
+                'average': sketch.total / sketch.count,
+                'min': sketch.min,
+                'max': sketch.max,
+                'total': sketch.total,
+                'p50': sketch.quantile(0.5),
+                'p90': sketch.quantile(0.9)
             }
-            for phase, times in phase_times.items()
+            for phase, sketch in agg.phase_timings.items()
         }
         
-        # Success rate over time (last 10 iterations)
-        recent = self.iteration_history[-10:]
-        summary['recent_success_rate'] = sum(1 for h in recent if h['success']) / len(recent) if recent else 0
+        # Success rate over time (last RECENT_WINDOW iterations)
+        recent = agg.recent
+        summary['recent_success_rate'] = sum(recent) / len(recent) if recent else 0
         
         return summary
     
@@ -100,10 +355,7 @@ class IterationAnalytics:
                 }
             
             pattern = self.learned_patterns[phase]
-            phase_history = [
-                h for h in self.iteration_history
-                if h.get('phase') == phase
-            ]
+            stats = self.aggregates.phases.get(phase)
             
             analysis = {
                 'phase': phase,
@@ -112,16 +364,17 @@ class IterationAnalytics:
                 'success_rate': pattern['successes'] / pattern['total_attempts'],
                 'avg_retries': pattern['avg_retries'],
                 'avg_time': pattern['avg_time'],
-                'iterations': len(phase_history)
+                'iterations': stats['iterations'] if stats else 0
             }
             
-            # Calculate trend (improving or declining)
-            if len(phase_history) >= 3:
-                recent = phase_history[-3:]
-                earlier = phase_history[-6:-3] if len(phase_history) >= 6 else phase_history[:-3]
+            # Calculate trend (improving or declining): last 3 against the 3 before
+            window = list(stats['recent']) if stats else []
+            if len(window) >= 3:
+                recent = window[-3:]
+                earlier = window[:-3]
                 
-                recent_success = sum(1 for h in recent if h['success']) / len(recent)
-                earlier_success = sum(1 for h in earlier if h['success']) / len(earlier) if earlier else 0
+                recent_success = sum(recent) / len(recent)
+                earlier_success = sum(earlier) / len(earlier) if earlier else 0
                 
                 if recent_success > earlier_success + 0.1:
                     analysis['trend'] = 'improving'
@@ -144,32 +397,23 @@ class IterationAnalytics:
         """
         Analyze iterations over time to identify trends
         
+        Covers the last SERIES_WINDOW iterations, in the order they finished.
+        
         Returns:
             Dictionary with time series analysis
         """
-        if not self.iteration_history:
+        series = self.aggregates.series
+        if not series['iterations']:
             return {'message': 'No iteration history available'}
         
-        # Group by iteration number
-        iterations = sorted(self.iteration_history, key=lambda x: x['iteration'])
-        
         time_series = {
-            'iterations': [h['iteration'] for h in iterations],
-            'success': [1 if h['success'] else 0 for h in iterations],
-            'retry_count': [h['retry_count'] for h in iterations],
-            'total_time': [h['total_time'] for h in iterations],
+            name: list(series[name])
+            for name in ('iterations', 'success', 'retry_count', 'total_time')
         }
         
-        # Calculate moving averages (window of 3)
-        if len(iterations) >= 3:
-            moving_avg_success = []
-            for i in range(len(iterations)):
-                start = max(0, i - 2)
-                window = iterations[start:i+1]
-                moving_avg_success.append(
-                    sum(1 for h in window if h['success']) / len(window)
-                )
-            time_series['moving_avg_success'] = moving_avg_success
+        # Moving average of success (window of MOVING_AVERAGE_WINDOW)
+        if self.aggregates.total_iterations >= MOVING_AVERAGE_WINDOW:
+            time_series['moving_avg_success'] = list(series['moving_avg_success'])
         
         return time_series
     
@@ -180,63 +424,27 @@ class IterationAnalytics:
         Returns:
             Dictionary with error analysis
         """
+        agg = self.aggregates
         error_stats = {
-            'total_failures': 0,
-            'error_types': {},
-            'most_common_errors': [],
+            'total_failures': agg.failed_iterations,
+            'error_types': dict(agg.error_types),
+            'most_common_errors': [
+                {'type': err_type, 'count': count}
+                for err_type, count in agg.error_types.most_common(5)
+            ],
             'phases_with_most_errors': []
         }
         
-        # Collect errors from failed iterations
-        for history in self.iteration_history:
-            if not history['success']:
-                error_stats['total_failures'] += 1
-                
-                # Count errors by type
-                errors = history.get('compilation', {}).get('errors', [])
-                for error in errors:
-                    # Extract error type (simple heuristic)
-                    error_type = 'unknown'
-                    if 'syntax' in error.lower():
-                        error_type = 'syntax'
-                    elif 'undefined' in error.lower():
-                        error_type = 'undefined_reference'
-                    elif 'type' in error.lower():
-                        error_type = 'type_error'
-                    elif 'segmentation' in error.lower() or 'segfault' in error.lower():
-                        error_type = 'runtime_error'
-                    
-                    error_stats['error_types'][error_type] = error_stats['error_types'].get(error_type, 0) + 1
-        
-        # Find most common errors
-        if error_stats['error_types']:
-            sorted_errors = sorted(
-                error_stats['error_types'].items(),
-                key=lambda x: x[1],
-                reverse=True
-            )
-            error_stats['most_common_errors'] = [
-                {'type': err_type, 'count': count}
-                for err_type, count in sorted_errors[:5]
-            ]
-        
         # Find phases with most errors
-        phase_errors = {}
-        for history in self.iteration_history:
-            if not history['success']:
-                phase = history.get('phase', 'unknown')
-                phase_errors[phase] = phase_errors.get(phase, 0) + 1
-        
-        if phase_errors:
-            sorted_phases = sorted(
-                phase_errors.items(),
-                key=lambda x: x[1],
-                reverse=True
-            )
-            error_stats['phases_with_most_errors'] = [
-                {'phase': phase, 'count': count}
-                for phase, count in sorted_phases[:5]
-            ]
+        phase_errors = sorted(
+            ((phase, stats['failures']) for phase, stats in agg.phases.items() if stats['failures']),
+            key=lambda x: x[1],
+            reverse=True
+        )
+        error_stats['phases_with_most_errors'] = [
+            {'phase': phase, 'count': count}
+            for phase, count in phase_errors[:5]
+        ]
         
         return error_stats
     
@@ -27,17 +27,30 @@ class CodegenModel:
         self.max_length = config.get('max_length', 512)
         self.temperature = config.get('temperature', 0.7)
         self.top_p = config.get('top_p', 0.95)
+        # Speculative decoding: {"draft": "ngram" or a draft model path,
+        # "num_draft_tokens": 4}
+        self.speculative = config.get('speculative') or {}
+        self.num_draft_tokens = self.speculative.get('num_draft_tokens', 4)
         
         self._load_model()
+        self.drafter = self._load_drafter()
     
     def _load_model(self):
         """Load the code generation model"""
         try:
             import torch
             from transformers import AutoTokenizer, AutoModelForCausalLM
+            from . import fast_weights
             
             model_path = self.config.get('model_path', 'Salesforce/codegen-350M-mono')
             
+            if self.config.get('fast_load', True):
+                snapshot = fast_weights.load(model_path, self.device)
+                if snapshot is not None:
+                    self.model, self.tokenizer = snapshot
+                    logger.info(f"Codegen model loaded from fast snapshot on {self.device}")
+                    return
+            
             logger.info(f"Loading codegen model from {model_path}...")
             
             # Load tokenizer
@@ -64,6 +77,38 @@ class CodegenModel:
             logger.error(f"Failed to load codegen model: {e}")
             raise
     
+    def _load_drafter(self):
+        """Load the draft source for speculative decoding, if configured"""
+        draft = self.speculative.get('draft')
+        if not draft or self.model is None:
+            return None
+        
+        from .speculative import NgramDrafter, ModelDrafter
+        
+        if draft == 'ngram':
+            logger.info("Speculative decoding with n-gram drafts")
+            return NgramDrafter(max_ngram=self.speculative.get('max_ngram', 3))
+        
+        import torch
+        from transformers import AutoModelForCausalLM
+        from . import fast_weights
+        
+        logger.info(f"Loading draft model from {draft}...")
+        snapshot = fast_weights.load(draft, self.device)
+        if snapshot is not None:
+            draft_model = snapshot[0]
+        else:
+            draft_model = AutoModelForCausalLM.from_pretrained(
+                draft,
+                torch_dtype=torch.float32 if self.device == 'cpu' else torch.float16,
+                low_cpu_mem_usage=True
+            )
+            draft_model.to(self.device)
+            draft_model.eval()
+        
+        logger.info(f"Speculative decoding with draft model {draft}")
+        return ModelDrafter(draft_model)
+    
     def generate_code(
         self,
         prompt: str,
@@ -98,16 +143,19 @@ class CodegenModel:
             inputs = self.tokenizer(prompt, return_tensors="pt").to(self.device)
             
             # Generate
-            with torch.no_grad():
-                outputs = self.model.generate(
-                    **inputs,
-                    max_length=max_length,
-                    temperature=temperature,
-                    top_p=self.top_p,
-                    num_return_sequences=num_return_sequences,
-                    do_sample=True,
-                    pad_token_id=self.tokenizer.eos_token_id
-                )
+            if self.drafter is not None and num_return_sequences == 1:
+                outputs = [self._generate_speculative(inputs['input_ids'], max_length, temperature)]
+            else:
+                with torch.no_grad():
+                    outputs = self.model.generate(
+                        **inputs,
+                        max_length=max_length,
+                        temperature=temperature,
+                        top_p=self.top_p,
+                        num_return_sequences=num_return_sequences,
+                        do_sample=True,
+                        pad_token_id=self.tokenizer.eos_token_id
+                    )
             
             # Decode outputs
             generated_codes = []
@@ -132,6 +180,24 @@ class CodegenModel:
             logger.error(f"Error generating code: {e}")
             raise
     
+    def _generate_speculative(self, input_ids, max_length: int, temperature: float) -> List[int]:
+        """Prompt and generated token ids, drafted by self.drafter"""
+        from .speculative import SpeculativeDecoder
+        
+        decoder = SpeculativeDecoder(self.model, self.drafter, self.num_draft_tokens)
+        tokens = input_ids[0].tolist()
+        for new_tokens in decoder.generate(
+            input_ids,
+            max_new_tokens=max(max_length - len(tokens), 0),
+            temperature=temperature,
+            top_p=self.top_p,
+            eos_token_id=self.tokenizer.eos_token_id
+        ):
+            tokens.extend(new_tokens)
+        
+        logger.debug(f"Draft acceptance rate: {decoder.acceptance_rate:.0%}")
+        return tokens
+    
     def generate_with_breadcrumbs(
         self,
         task_description: str,
@@ -189,7 +255,9 @@ class CodegenModel:
                 self.tokenizer,
                 inputs['input_ids'],
                 max_length=self.max_length,
-                temperature=self.temperature
+                temperature=self.temperature,
+                drafter=self.drafter,
+                num_draft_tokens=self.num_draft_tokens
             ):
                 full_text += token
                 handler.callback(token)
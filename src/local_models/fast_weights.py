@@ -0,0 +1,291 @@
+"""
+Fast Model Weights
+Pre-converted, memory-mapped model snapshots for quick startup
+"""
+
+import os
+import re
+import sys
+import json
+import mmap
+import shutil
+import struct
+import logging
+import argparse
+from pathlib import Path
+from typing import Dict, Any, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+
+# Bump when the snapshot layout changes; older snapshots are ignored
+FORMAT_VERSION = 1
+
+WEIGHTS_FILE = 'weights.safetensors'
+MANIFEST_FILE = 'fast_manifest.json'
+
+# safetensors dtype names -> torch dtype attribute names
+_DTYPES = {
+    'F64': 'float64', 'F32': 'float32', 'F16': 'float16', 'BF16': 'bfloat16',
+    'I64': 'int64', 'I32': 'int32', 'I16': 'int16', 'I8': 'int8', 'U8': 'uint8',
+    'BOOL': 'bool'
+}
+
+
+def default_cache_dir() -> Path:
+    """Where snapshots live (override with AROS_FAST_MODEL_DIR)"""
+    return Path(os.environ.get('AROS_FAST_MODEL_DIR') or
+                Path.home() / ".cache" / "aros-cognito" / "fast_models")
+
+
+def default_dtype(device: str) -> str:
+    """Same precision choice as CodegenModel/LocalLLM"""
+    return 'float32' if device == 'cpu' else 'float16'
+
+
+def snapshot_dir(model_path: str, dtype: str, cache_dir: Optional[Path] = None) -> Path:
+    slug = re.sub(r'[^\w.-]+', '--', str(model_path)).strip('-')
+    return Path(cache_dir or default_cache_dir()) / f"{slug}-{dtype}"
+
+
+def source_fingerprint(model_path: str) -> Optional[str]:
+    """
+    Cheap identifier of the source weights' version
+    
+    File sizes and mtimes for a local directory, the cached commit for a
+    Hugging Face hub id; None when it can't be determined.
+    """
+    path = Path(model_path)
+    if path.is_dir():
+        entries = sorted(
+            f"{f.name}:{f.stat().st_size}:{int(f.stat().st_mtime)}"
+            for f in path.iterdir() if f.is_file()
+        )
+        return ';'.join(entries)
+    
+    hub_cache = Path(os.environ.get('HF_HUB_CACHE') or
+                     Path.home() / ".cache" / "huggingface" / "hub")
+    ref = hub_cache / f"models--{str(model_path).replace('/', '--')}" / "refs" / "main"
+    try:
+        return ref.read_text().strip()
+    except OSError:
+        return None
+
+
+def read_manifest(directory: Path) -> Optional[Dict[str, Any]]:
+    try:
+        with open(directory / MANIFEST_FILE, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def find_snapshot(model_path: str, dtype: str, cache_dir: Optional[Path] = None) -> Optional[Path]:
+    """Snapshot directory for model_path in dtype, if one exists and is current"""
+    directory = snapshot_dir(model_path, dtype, cache_dir)
+    manifest = read_manifest(directory)
+    if manifest is None or not (directory / WEIGHTS_FILE).exists():
+        return None
+    if manifest.get('format_version') != FORMAT_VERSION or manifest.get('source') != str(model_path):
+        return None
+    
+    fingerprint = source_fingerprint(model_path)
+    if fingerprint is not None and manifest.get('source_fingerprint') not in (None, fingerprint):
+        logger.warning(f"Fast snapshot of {model_path} is stale; re-run convert to refresh it")
+        return None
+    return directory
+
+
+def read_header(weights_path: Path) -> Tuple[Dict[str, Any], int]:
+    """safetensors header (name -> dtype/shape/data_offsets) and where data starts"""
+    with open(weights_path, 'rb') as f:
+        (header_len,) = struct.unpack('<Q', f.read(8))
+        header = json.loads(f.read(header_len))
+    header.pop('__metadata__', None)
+    return header, 8 + header_len
+
+
+def mmap_tensors(weights_path: Path) -> Dict[str, Any]:
+    """
+    Tensors of a safetensors file as views of a private memory map
+    
+    Nothing is read up front: pages load on first touch and stay in the page
+    cache, shared by every process that maps the same snapshot. The map is
+    copy-on-write, so in-place updates never reach the file.
+    """
+    import torch
+    
+    header, data_start = read_header(weights_path)
+    with open(weights_path, 'rb') as f:
+        buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+    
+    tensors = {}
+    for name, info in header.items():
+        dtype = getattr(torch, _DTYPES[info['dtype']])
+        start, end = info['data_offsets']
+        shape = info['shape']
+        if end == start:
+            tensors[name] = torch.empty(shape, dtype=dtype)
+            continue
+        count = (end - start) // torch.tensor([], dtype=dtype).element_size()
+        tensors[name] = torch.frombuffer(
+            buffer, dtype=dtype, count=count, offset=data_start + start
+        ).view(shape)
+    return tensors
+
+
+def convert(model_path: str, dtype: str = 'float16', cache_dir: Optional[Path] = None, **load_kwargs) -> Path:
+    """
+    Convert a model once into a fast-loading snapshot
+    
+    The snapshot is the config, tokenizer, and one safetensors file holding the
+    parameters and buffers already in dtype, so loading is a memory map
+    instead of unpickling and casting. Tied parameters are stored once.
+    """
+    import torch
+    from safetensors.torch import save_file
+    from transformers import AutoTokenizer, AutoModelForCausalLM
+    
+    target = snapshot_dir(model_path, dtype, cache_dir)
+    staging = target.with_name(target.name + '.tmp')
+    shutil.rmtree(staging, ignore_errors=True)
+    staging.mkdir(parents=True)
+    
+    logger.info(f"Converting {model_path} to a {dtype} fast snapshot...")
+    tokenizer = AutoTokenizer.from_pretrained(model_path, **load_kwargs)
+    model = AutoModelForCausalLM.from_pretrained(
+        model_path, torch_dtype=getattr(torch, dtype), low_cpu_mem_usage=True, **load_kwargs
+    )
+    model.eval()
+    
+    # Parameters and persistent buffers come back from state_dict(); keep
+    # non-persistent buffers (e.g. rotary tables) too so nothing needs
+    # re-initializing at load time
+    tensors: Dict[str, Any] = {}
+    aliases: Dict[str, str] = {}
+    by_storage: Dict[Tuple[int, int, tuple], str] = {}
+    named = dict(model.state_dict(keep_vars=False))
+    buffers = []
+    for name, buffer in model.named_buffers():
+        if name not in named:
+            named[name] = buffer
+            buffers.append(name)
+    
+    for name, tensor in named.items():
+        key = (tensor.data_ptr(), tensor.storage_offset(), tuple(tensor.shape))
+        if tensor.numel() and key in by_storage:
+            aliases[name] = by_storage[key]
+            continue
+        by_storage[key] = name
+        tensors[name] = tensor.detach().contiguous()
+    
+    save_file(tensors, str(staging / WEIGHTS_FILE), metadata={'format': 'pt'})
+    model.config.save_pretrained(staging)
+    if getattr(model, 'generation_config', None) is not None:
+        model.generation_config.save_pretrained(staging)
+    tokenizer.save_pretrained(staging)
+    
+    manifest = {
+        'format_version': FORMAT_VERSION,
+        'source': str(model_path),
+        'source_fingerprint': source_fingerprint(model_path),
+        'dtype': dtype,
+        'aliases': aliases,
+        'non_persistent_buffers': buffers
+    }
+    with open(staging / MANIFEST_FILE, 'w') as f:
+        json.dump(manifest, f, indent=2)
+    
+    shutil.rmtree(target, ignore_errors=True)
+    os.replace(staging, target)
+    logger.info(f"Fast snapshot written to {target}")
+    return target
+
+
+def load(model_path: str, device: str = 'cpu', dtype: Optional[str] = None,
+         cache_dir: Optional[Path] = None) -> Optional[Tuple[Any, Any]]:
+    """
+    Load (model, tokenizer) from a fast snapshot
+    
+    Returns None when there is no current snapshot, so callers fall back to
+    from_pretrained(). The model is built on the meta device (no weight
+    initialization) and its tensors are assigned straight from the memory
+    map; on a GPU only the final copy to the device reads the file.
+    """
+    dtype = dtype or default_dtype(device)
+    directory = find_snapshot(model_path, dtype, cache_dir)
+    if directory is None:
+        return None
+    
+    import torch
+    
+    # A truncated or corrupt weights file falls back the same as a missing one
+    try:
+        tensors = mmap_tensors(directory / WEIGHTS_FILE)
+    except (OSError, ValueError, KeyError, struct.error) as e:
+        logger.warning(f"Fast snapshot of {model_path} is unreadable ({e}); using the regular loader")
+        return None
+    
+    from transformers import AutoConfig, AutoTokenizer, AutoModelForCausalLM
+    
+    manifest = read_manifest(directory)
+    config = AutoConfig.from_pretrained(directory)
+    with torch.device('meta'):
+        model = AutoModelForCausalLM.from_config(config, torch_dtype=getattr(torch, dtype))
+    
+    for alias, name in manifest.get('aliases', {}).items():
+        tensors[alias] = tensors[name]
+    
+    buffers = set(manifest.get('non_persistent_buffers', []))
+    state = {name: tensor for name, tensor in tensors.items() if name not in buffers}
+    try:
+        model.load_state_dict(state, strict=False, assign=True)
+    except TypeError:
+        # assign= needs torch 2.1+
+        logger.warning("Fast snapshot loading needs torch >= 2.1; using the regular loader")
+        return None
+    for name in buffers:
+        module_name, _, buffer_name = name.rpartition('.')
+        module = model.get_submodule(module_name) if module_name else model
+        module._buffers[buffer_name] = tensors[name]
+    
+    missing = [name for name, tensor in model.state_dict().items() if tensor.is_meta]
+    if missing:
+        logger.warning(f"Fast snapshot of {model_path} lacks {len(missing)} tensors; using the regular loader")
+        return None
+    
+    model.tie_weights()
+    if device != 'cpu':
+        model.to(device)
+    model.eval()
+    
+    tokenizer = AutoTokenizer.from_pretrained(directory)
+    return model, tokenizer
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pre-convert models into fast-loading snapshots')
+    parser.add_argument('models', nargs='*', default=['codegen', 'llm'],
+                        help="Model names from the config or model paths (default: codegen llm)")
+    parser.add_argument('--device', help='Target device; picks the dtype the models load in')
+    parser.add_argument('--dtype', choices=['float32', 'float16', 'bfloat16'],
+                        help='Override the stored dtype')
+    parser.add_argument('--config', help='Model config path (default: config/models.json)')
+    parser.add_argument('--cache-dir', help=f'Snapshot directory (default: {default_cache_dir()})')
+    args = parser.parse_args()
+    
+    logging.basicConfig(level=logging.INFO)
+    
+    from .model_loader import LocalModelLoader
+    config = LocalModelLoader(args.config).config
+    
+    for name in args.models:
+        model_config = config.get(name, {}) if name in ('codegen', 'llm') else {'model_path': name}
+        model_path = model_config.get('model_path', name)
+        dtype = args.dtype or default_dtype(args.device or model_config.get('device', 'cpu'))
+        convert(model_path, dtype, Path(args.cache_dir) if args.cache_dir else None)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,494 @@
+"""
+Shared Inference Server
+Loads each model once and batches generation requests from every agent
+"""
+
+import os
+import sys
+import time
+import logging
+import argparse
+import threading
+from queue import Queue, Empty
+from multiprocessing.connection import Listener, Client
+from typing import Dict, Any, Optional, List, Callable, Tuple
+
+from .codegen_model import CodegenModel
+from .llm_interface import LocalLLM
+
+logger = logging.getLogger(__name__)
+
+
+DEFAULT_ADDRESS = ('127.0.0.1', 7650)
+# Shared secret for the connection handshake. There is deliberately no
+# default: connections unpickle what they receive, so a known key would let
+# anyone who can reach the port run code in the server.
+AUTHKEY_ENV = 'AROS_INFERENCE_AUTHKEY'
+
+# Ops understood by the server
+OP_GENERATE = 'generate'
+OP_COUNT_TOKENS = 'count_tokens'
+OP_PING = 'ping'
+
+
+def parse_address(address: str) -> Tuple[str, int]:
+    """'host:port' -> (host, port)"""
+    host, _, port = address.rpartition(':')
+    return host or DEFAULT_ADDRESS[0], int(port)
+
+
+def _authkey() -> bytes:
+    key = os.environ.get(AUTHKEY_ENV, '').encode()
+    if not key:
+        raise ValueError(f"{AUTHKEY_ENV} is not set; set it to the same secret for the server and its agents")
+    return key
+
+
+class _Pending:
+    """A submitted request waiting for its batch to run"""
+    
+    __slots__ = ('params', 'done', 'result', 'error')
+    
+    def __init__(self, params: Dict[str, Any]):
+        self.params = params
+        self.done = threading.Event()
+        self.result = None
+        self.error: Optional[BaseException] = None
+
+
+class BatchingWorker:
+    """Runs one model's generation requests in batches
+    
+    Requests queue up while a batch is generating; when the model is free the
+    worker takes everything waiting (up to max_batch), after giving late
+    arrivals batch_window seconds to join, and hands it to generate_batch in
+    one call.
+    
+    generate_batch(list of params) returns one list of completions per request.
+    """
+    
+    def __init__(
+        self,
+        generate_batch: Callable[[List[Dict[str, Any]]], List[List[str]]],
+        max_batch: int = 8,
+        batch_window: float = 0.01
+    ):
+        self.generate_batch = generate_batch
+        self.max_batch = max_batch
+        self.batch_window = batch_window
+        self.batch_sizes: List[int] = []
+        
+        self._queue: Queue = Queue()
+        self._running = True
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+    
+    def submit(self, params: Dict[str, Any]) -> List[str]:
+        """Queue a request and wait for its completions"""
+        pending = _Pending(params)
+        self._queue.put(pending)
+        pending.done.wait()
+        if pending.error is not None:
+            raise pending.error
+        return pending.result
+    
+    def stop(self) -> None:
+        self._running = False
+        self._queue.put(None)
+        self._thread.join()
+    
+    def _run(self) -> None:
+        while self._running:
+            first = self._queue.get()
+            if first is None:
+                break
+            
+            batch = [first]
+            deadline = time.monotonic() + self.batch_window
+            while len(batch) < self.max_batch:
+                try:
+                    pending = self._queue.get(timeout=max(deadline - time.monotonic(), 0))
+                except Empty:
+                    break
+                if pending is None:
+                    self._running = False
+                    break
+                batch.append(pending)
+            
+            self._run_batch(batch)
+    
+    def _run_batch(self, batch: List[_Pending]) -> None:
+        self.batch_sizes.append(len(batch))
+        try:
+            results = self.generate_batch([pending.params for pending in batch])
+            for pending, result in zip(batch, results):
+                pending.result = result
+        except Exception as e:
+            logger.error(f"Batch of {len(batch)} failed: {e}")
+            for pending in batch:
+                pending.error = e
+        finally:
+            for pending in batch:
+                pending.done.set()
+
+
+class TransformersBackend:
+    """Batched generate() for a loaded CodegenModel or LocalLLM
+    
+    Prompts are left-padded into one batch. Requests asking for different
+    sampling settings are generated in separate sub-batches; each request
+    keeps its own max_length budget.
+    """
+    
+    def __init__(self, model_obj):
+        self.model = model_obj.model
+        self.tokenizer = model_obj.tokenizer
+        self.device = model_obj.device
+        
+        self.tokenizer.padding_side = 'left'
+        if self.tokenizer.pad_token_id is None:
+            self.tokenizer.pad_token = self.tokenizer.eos_token
+    
+    def count_tokens(self, text: str) -> int:
+        return len(self.tokenizer.encode(text))
+    
+    def __call__(self, requests: List[Dict[str, Any]]) -> List[List[str]]:
+        groups: Dict[Tuple, List[int]] = {}
+        for i, params in enumerate(requests):
+            key = (params['temperature'], params['top_p'], params['num_return_sequences'])
+            groups.setdefault(key, []).append(i)
+        
+        results: List[List[str]] = [[] for _ in requests]
+        for (temperature, top_p, num_sequences), indexes in groups.items():
+            completions = self._generate(
+                [requests[i] for i in indexes], temperature, top_p, num_sequences
+            )
+            for i, texts in zip(indexes, completions):
+                results[i] = texts
+        return results
+    
+    def _generate(self, requests, temperature, top_p, num_sequences) -> List[List[str]]:
+        import torch
+        
+        prompts = [params['prompt'] for params in requests]
+        inputs = self.tokenizer(prompts, return_tensors='pt', padding=True).to(self.device)
+        prompt_lengths = inputs['attention_mask'].sum(dim=1).tolist()
+        budgets = [max(params['max_length'] - length, 1)
+                   for params, length in zip(requests, prompt_lengths)]
+        
+        with torch.no_grad():
+            outputs = self.model.generate(
+                **inputs,
+                max_new_tokens=max(budgets),
+                temperature=temperature,
+                top_p=top_p,
+                num_return_sequences=num_sequences,
+                do_sample=True,
+                pad_token_id=self.tokenizer.pad_token_id
+            )
+        
+        # Only the new tokens, cut to each request's own budget
+        new_tokens = outputs[:, inputs['input_ids'].shape[1]:]
+        completions = []
+        for i, budget in enumerate(budgets):
+            rows = new_tokens[i * num_sequences:(i + 1) * num_sequences, :budget]
+            completions.append(self.tokenizer.batch_decode(rows, skip_special_tokens=True))
+        return completions
+
+
+class InferenceServer:
+    """Serves generation for several models from one process
+    
+    Run one per GPU. Each model is loaded once and gets a BatchingWorker, so
+    concurrent requests from all connected agents share batches. Clients
+    connect with InferenceClient (multiprocessing.connection, authenticated).
+    """
+    
+    def __init__(
+        self,
+        backends: Dict[str, Callable],
+        address: Tuple[str, int] = DEFAULT_ADDRESS,
+        authkey: Optional[bytes] = None,
+        max_batch: int = 8,
+        batch_window: float = 0.01
+    ):
+        self.backends = backends
+        self.workers = {
+            name: BatchingWorker(backend, max_batch=max_batch, batch_window=batch_window)
+            for name, backend in backends.items()
+        }
+        self._authkey = authkey or _authkey()
+        # Listener's default backlog of 1 stalls agents that connect at once
+        self._listener = Listener(address, backlog=64, authkey=self._authkey)
+        self._running = False
+        self._thread: Optional[threading.Thread] = None
+    
+    @classmethod
+    def from_loader(cls, loader, model_names: List[str], device: Optional[str] = None, **kwargs) -> 'InferenceServer':
+        """Load models through a LocalModelLoader and serve them"""
+        overrides = {'device': device} if device else {}
+        backends = {
+            name: TransformersBackend(loader.load_model(name, use_server=False, **overrides))
+            for name in model_names
+        }
+        return cls(backends, **kwargs)
+    
+    @property
+    def address(self) -> Tuple[str, int]:
+        return self._listener.address
+    
+    def serve_forever(self) -> None:
+        self._running = True
+        logger.info(f"Inference server listening on {self.address[0]}:{self.address[1]}")
+        while self._running:
+            try:
+                conn = self._listener.accept()
+            except OSError:
+                # Listener closed by shutdown()
+                break
+            except Exception as e:
+                # Failed handshake
+                logger.warning(f"Rejected inference client: {e}")
+                continue
+            if not self._running:
+                conn.close()
+                break
+            threading.Thread(target=self._handle, args=(conn,), daemon=True).start()
+    
+    def start(self) -> None:
+        """Serve from a background thread"""
+        self._thread = threading.Thread(target=self.serve_forever, daemon=True)
+        self._thread.start()
+    
+    def shutdown(self) -> None:
+        self._running = False
+        if self._thread is not None:
+            # Closing the listener doesn't interrupt a blocked accept(); a
+            # throwaway connection does
+            try:
+                Client(self.address, authkey=self._authkey).close()
+            except OSError:
+                pass
+            self._thread.join()
+        self._listener.close()
+        for worker in self.workers.values():
+            worker.stop()
+    
+    def _handle(self, conn) -> None:
+        with conn:
+            while True:
+                try:
+                    request = conn.recv()
+                except (EOFError, OSError):
+                    return
+                try:
+                    reply = {'ok': True, 'result': self._dispatch(request)}
+                except Exception as e:
+                    reply = {'ok': False, 'error': f"{type(e).__name__}: {e}"}
+                try:
+                    conn.send(reply)
+                except OSError:
+                    return
+    
+    def _dispatch(self, request: Dict[str, Any]) -> Any:
+        op = request.get('op')
+        if op == OP_PING:
+            return sorted(self.workers)
+        
+        model = request.get('model')
+        if model not in self.workers:
+            raise ValueError(f"Model not served: {model}")
+        
+        if op == OP_GENERATE:
+            return self.workers[model].submit(request['params'])
+        if op == OP_COUNT_TOKENS:
+            backend = self.backends[model]
+            if hasattr(backend, 'count_tokens'):
+                return backend.count_tokens(request['text'])
+            return len(request['text']) // 4
+        raise ValueError(f"Unknown op: {op}")
+
+
+class InferenceClient:
+    """Connection to an InferenceServer
+    
+    Safe to share between threads; each thread gets its own connection so
+    requests from concurrent threads can land in the same batch.
+    """
+    
+    def __init__(self, address: Tuple[str, int] = DEFAULT_ADDRESS, authkey: Optional[bytes] = None):
+        self.address = address
+        self.authkey = authkey or _authkey()
+        self._local = threading.local()
+        self._connections = []
+        self._lock = threading.Lock()
+        # Fail now rather than on the first request if nothing is listening
+        self._connection()
+    
+    def _connection(self):
+        conn = getattr(self._local, 'conn', None)
+        if conn is None:
+            conn = self._local.conn = Client(self.address, authkey=self.authkey)
+            with self._lock:
+                self._connections.append(conn)
+        return conn
+    
+    def request(self, op: str, **fields) -> Any:
+        conn = self._connection()
+        conn.send({'op': op, **fields})
+        reply = conn.recv()
+        if not reply['ok']:
+            raise RuntimeError(f"Inference server error: {reply['error']}")
+        return reply['result']
+    
+    def generate(
+        self,
+        model: str,
+        prompt: str,
+        max_length: int,
+        temperature: float,
+        top_p: float = 0.95,
+        num_return_sequences: int = 1
+    ) -> List[str]:
+        """Generate completions (new text only, prompt excluded)"""
+        return self.request(OP_GENERATE, model=model, params={
+            'prompt': prompt,
+            'max_length': max_length,
+            'temperature': temperature,
+            'top_p': top_p,
+            'num_return_sequences': num_return_sequences
+        })
+    
+    def close(self) -> None:
+        with self._lock:
+            for conn in self._connections:
+                conn.close()
+            self._connections = []
+
+
+class RemoteCodegenModel(CodegenModel):
+    """CodegenModel whose generation runs on an InferenceServer"""
+    
+    def __init__(self, config: Dict[str, Any], client: InferenceClient):
+        self.client = client
+        super().__init__(config)
+    
+    def _load_model(self):
+        # Weights live in the server process
+        pass
+    
+    def generate_code(
+        self,
+        prompt: str,
+        max_length: Optional[int] = None,
+        temperature: Optional[float] = None,
+        num_return_sequences: int = 1,
+        stop_sequences: Optional[List[str]] = None
+    ) -> List[str]:
+        completions = self.client.generate(
+            'codegen', prompt,
+            max_length=max_length or self.max_length,
+            temperature=temperature or self.temperature,
+            top_p=self.top_p,
+            num_return_sequences=num_return_sequences
+        )
+        
+        generated_codes = []
+        for code in completions:
+            if stop_sequences:
+                for stop_seq in stop_sequences:
+                    if stop_seq in code:
+                        code = code[:code.index(stop_seq)]
+            generated_codes.append(code.strip())
+        return generated_codes
+    
+    def _generate_streaming(self, prompt: str) -> str:
+        # The server returns whole completions; show it as one chunk
+        from src.streaming_output import StreamingHandler
+        
+        code = self.generate_code(prompt)[0]
+        StreamingHandler().callback(code)
+        return code
+    
+    def estimate_tokens(self, text: str) -> int:
+        return self.client.request(OP_COUNT_TOKENS, model='codegen', text=text)
+    
+    def is_loaded(self) -> bool:
+        return True
+
+
+class RemoteLLM(LocalLLM):
+    """LocalLLM whose generation runs on an InferenceServer
+    
+    Conversation history stays in the client; each turn sends the formatted
+    conversation as the prompt.
+    """
+    
+    def __init__(self, config: Dict[str, Any], client: InferenceClient):
+        self.client = client
+        super().__init__(config)
+    
+    def _load_model(self):
+        # Weights live in the server process
+        pass
+    
+    def _generate_response(self) -> str:
+        response = self.client.generate(
+            'llm', self._format_conversation(),
+            max_length=self.max_length,
+            temperature=self.temperature,
+            top_p=0.95
+        )[0]
+        
+        marker = "Assistant: "
+        idx = response.rfind(marker)
+        if idx != -1:
+            response = response[idx + len(marker):]
+        return response.strip()
+    
+    def is_loaded(self) -> bool:
+        return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Shared batched inference server (run one per GPU)')
+    parser.add_argument('--models', default='codegen,llm',
+                        help='Comma-separated models to serve (default: codegen,llm)')
+    parser.add_argument('--device', help='Device override, e.g. cuda:0')
+    parser.add_argument('--address', default=f'{DEFAULT_ADDRESS[0]}:{DEFAULT_ADDRESS[1]}',
+                        help='host:port to listen on')
+    parser.add_argument('--config', help='Model config path (default: config/models.json)')
+    parser.add_argument('--max-batch', type=int, default=8, help='Largest batch per model')
+    parser.add_argument('--batch-window', type=float, default=0.01,
+                        help='Seconds to wait for more requests before starting a batch')
+    args = parser.parse_args()
+    
+    logging.basicConfig(level=logging.INFO)
+    
+    # Before loading any model
+    try:
+        authkey = _authkey()
+    except ValueError as e:
+        logger.error(str(e))
+        return 2
+    
+    from .model_loader import LocalModelLoader
+    
+    server = InferenceServer.from_loader(
+        LocalModelLoader(args.config),
+        [name.strip() for name in args.models.split(',') if name.strip()],
+        device=args.device,
+        address=parse_address(args.address),
+        authkey=authkey,
+        max_batch=args.max_batch,
+        batch_window=args.batch_window
+    )
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        server.shutdown()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
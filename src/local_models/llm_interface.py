@@ -44,9 +44,17 @@ class LocalLLM:
         try:
             import torch
             from transformers import AutoTokenizer, AutoModelForCausalLM
+            from . import fast_weights
             
             model_path = self.config.get('model_path', 'meta-llama/Llama-2-7b-chat-hf')
             
+            if self.config.get('fast_load', True):
+                snapshot = fast_weights.load(model_path, self.device)
+                if snapshot is not None:
+                    self.model, self.tokenizer = snapshot
+                    logger.info(f"LLM loaded from fast snapshot on {self.device}")
+                    return
+            
             logger.info(f"Loading LLM from {model_path}...")
             
             # Load tokenizer
@@ -90,7 +98,7 @@ class LocalLLM:
         Returns:
             LLM response
         """
-        if self.model is None:
+        if not self.is_loaded():
             raise RuntimeError("Model not loaded")
         
         if reset_history:
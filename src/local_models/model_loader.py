@@ -19,6 +19,7 @@ class LocalModelLoader:
         self.config_path = config_path or self._default_config_path()
         self.config = self._load_config()
         self.models = {}
+        self._inference_client = None
         
     def _default_config_path(self) -> str:
         """Get default config path"""
@@ -141,7 +142,16 @@ class LocalModelLoader:
         """Get exploration configuration"""
         return self.config.get("exploration", {})
     
-    def load_model(self, model_name: str, use_mock: bool = False, **kwargs):
+    def get_inference_server_address(self) -> Optional[str]:
+        """Shared inference server 'host:port', if one is configured
+        
+        Set with the AROS_INFERENCE_SERVER environment variable or
+        "inference_server": {"address": ...} in the model config.
+        """
+        return (os.environ.get('AROS_INFERENCE_SERVER') or
+                self.config.get('inference_server', {}).get('address'))
+    
+    def load_model(self, model_name: str, use_mock: bool = False, use_server: Optional[bool] = None, **kwargs):
         """
         Load a model by name
         Returns the loaded model instance
@@ -149,6 +159,8 @@ class LocalModelLoader:
         Args:
             model_name: Name of the model to load ('codegen', 'llm')
             use_mock: If True, explicitly use mock model (for testing only)
+            use_server: Use the shared inference server instead of loading
+                weights in this process (default: when one is configured)
             **kwargs: Additional configuration options
         """
         if model_name in self.models:
@@ -159,6 +171,10 @@ class LocalModelLoader:
         if use_mock:
             return self._load_mock_model(model_name)
         
+        server_address = self.get_inference_server_address()
+        if server_address and use_server is not False:
+            return self._load_remote_model(model_name, server_address, **kwargs)
+        
         try:
             if model_name == "codegen":
                 from .codegen_model import CodegenModel
@@ -281,6 +297,32 @@ Note: You can use --use-mock flag for testing without real models,
       but this will only provide template-based responses.
 """
     
+    def _load_remote_model(self, model_name: str, address: str, **kwargs):
+        """Connect to a model served by a shared InferenceServer"""
+        from .inference_server import InferenceClient, RemoteCodegenModel, RemoteLLM, parse_address
+        
+        if model_name == "codegen":
+            model_class, config = RemoteCodegenModel, self.get_codegen_config()
+        elif model_name == "llm":
+            model_class, config = RemoteLLM, self.get_llm_config()
+        else:
+            raise ValueError(f"Unknown model name: {model_name}")
+        config.update(kwargs)
+        
+        try:
+            if self._inference_client is None:
+                self._inference_client = InferenceClient(parse_address(address))
+        except (OSError, ValueError) as e:
+            raise RuntimeError(
+                f"Could not reach inference server at {address}: {e}\n"
+                f"Start one with: python3 -m src.local_models.inference_server --address {address}"
+            ) from e
+        
+        model = model_class(config, self._inference_client)
+        self.models[model_name] = model
+        logger.info(f"Using {model_name} from inference server at {address}")
+        return model
+    
     def _load_mock_model(self, model_name: str):
         """
         Load a mock model for testing when explicitly requested
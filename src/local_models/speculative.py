@@ -0,0 +1,230 @@
+"""
+Speculative Decoding
+Cheap drafts of several tokens, verified by the main model in one forward pass
+"""
+
+import logging
+from typing import Dict, Iterator, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+
+def crop_cache(past_key_values, length: int):
+    """KV cache truncated to its first `length` positions"""
+    if past_key_values is None:
+        return None
+    if hasattr(past_key_values, 'crop'):
+        past_key_values.crop(length)
+        return past_key_values
+    # Legacy tuple of (key, value) per layer, [batch, heads, seq, head_dim]
+    return tuple(tuple(t[:, :, :length] for t in layer) for layer in past_key_values)
+
+
+def sampling_probs(logits, temperature: float, top_p: float = 1.0):
+    """Next-token distribution per row of logits, or None for greedy decoding"""
+    import torch
+    
+    if temperature <= 0:
+        return None
+    probs = torch.softmax(logits.float() / temperature, dim=-1)
+    if top_p < 1.0:
+        sorted_probs, order = probs.sort(dim=-1, descending=True)
+        # Smallest prefix holding top_p of the mass
+        sorted_probs[sorted_probs.cumsum(dim=-1) - sorted_probs > top_p] = 0
+        probs = torch.zeros_like(probs).scatter_(-1, order, sorted_probs)
+        probs = probs / probs.sum(dim=-1, keepdim=True)
+    return probs
+
+
+class NgramDrafter:
+    """Drafts by copying what followed the latest earlier match of the last n tokens
+    
+    Needs no second model. Breadcrumb-annotated C repeats itself heavily
+    (comment prefixes, AI_* tags, boilerplate echoed from the prompt), so the
+    continuation seen last time is usually right.
+    """
+    
+    def __init__(self, max_ngram: int = 3, min_ngram: int = 1):
+        self.max_ngram = max_ngram
+        self.min_ngram = min_ngram
+        self.reset()
+    
+    def reset(self) -> None:
+        # n-gram -> position of the token that followed its latest occurrence
+        self._follows: Dict[Tuple[int, ...], int] = {}
+        self._indexed = 0
+    
+    def propose(self, tokens: List[int], count: int, temperature: float = 0.0, top_p: float = 1.0):
+        """Up to count draft tokens; no distribution (the draft is deterministic)"""
+        for end in range(max(self._indexed, 1), len(tokens)):
+            for n in range(self.min_ngram, min(self.max_ngram, end) + 1):
+                self._follows[tuple(tokens[end - n:end])] = end
+        self._indexed = len(tokens)
+        
+        for n in range(min(self.max_ngram, len(tokens)), self.min_ngram - 1, -1):
+            start = self._follows.get(tuple(tokens[-n:]))
+            if start is not None:
+                return tokens[start:start + count], None
+        return [], None
+    
+    def rollback(self, length: int) -> None:
+        # Only accepted tokens are ever indexed
+        pass
+
+
+class ModelDrafter:
+    """Drafts with a small causal LM that shares the main model's tokenizer"""
+    
+    def __init__(self, model):
+        self.model = model
+        self.reset()
+    
+    def reset(self) -> None:
+        self._past = None
+        self._cached = 0
+    
+    def propose(self, tokens: List[int], count: int, temperature: float = 0.0, top_p: float = 1.0):
+        """Up to count draft tokens and the distributions they were sampled from"""
+        import torch
+        
+        device = next(self.model.parameters()).device
+        feed = tokens[self._cached:]
+        draft, dists = [], []
+        with torch.no_grad():
+            for _ in range(count):
+                outputs = self.model(
+                    torch.tensor([feed], device=device),
+                    past_key_values=self._past,
+                    use_cache=True
+                )
+                self._past = getattr(outputs, 'past_key_values', None)
+                self._cached = self._cached + len(feed) if self._past is not None else 0
+                logits = outputs.logits[0, -1]
+                
+                probs = sampling_probs(logits, temperature, top_p)
+                token = int(logits.argmax()) if probs is None else int(torch.multinomial(probs, 1))
+                draft.append(token)
+                dists.append(probs)
+                feed = (tokens + draft)[self._cached:]
+        
+        if not draft or dists[0] is None:
+            return draft, None
+        return draft, torch.stack(dists)
+    
+    def rollback(self, length: int) -> None:
+        """Drop cached positions past the accepted tokens"""
+        if self._cached > length:
+            self._past = crop_cache(self._past, length)
+            self._cached = length
+
+
+class SpeculativeDecoder:
+    """Generates with a drafter proposing tokens and the model verifying them
+    
+    Each step the drafter proposes up to num_draft_tokens; the model scores
+    them all in one forward pass over its KV cache and keeps the longest
+    prefix it agrees with, plus one token of its own. Greedy decoding matches
+    token for token; with sampling, drafts are accepted by rejection sampling,
+    so outputs follow the model's own distribution.
+    """
+    
+    def __init__(self, model, drafter, num_draft_tokens: int = 4):
+        self.model = model
+        self.drafter = drafter
+        self.num_draft_tokens = num_draft_tokens
+        self.proposed = 0
+        self.accepted = 0
+    
+    @property
+    def acceptance_rate(self) -> float:
+        return self.accepted / self.proposed if self.proposed else 0.0
+    
+    def generate(
+        self,
+        input_ids,
+        max_new_tokens: int,
+        temperature: float = 0.0,
+        top_p: float = 1.0,
+        eos_token_id: Optional[int] = None
+    ) -> Iterator[List[int]]:
+        """
+        Yield new token ids, one list per verification step
+        
+        Stops after max_new_tokens or at EOS (included in the last list).
+        """
+        import torch
+        
+        device = input_ids.device
+        tokens = input_ids[0].tolist()
+        limit = len(tokens) + max_new_tokens
+        self.drafter.reset()
+        
+        past_key_values = None
+        cached = 0
+        with torch.no_grad():
+            while len(tokens) < limit:
+                # Leave room for the model's own token
+                count = min(self.num_draft_tokens, limit - len(tokens) - 1)
+                draft, draft_probs = self.drafter.propose(tokens, count, temperature, top_p) if count > 0 else ([], None)
+                
+                outputs = self.model(
+                    torch.tensor([tokens[cached:] + draft], device=device),
+                    past_key_values=past_key_values,
+                    use_cache=True
+                )
+                logits = outputs.logits[0, -(len(draft) + 1):]
+                new = self._verify(draft, logits, sampling_probs(logits, temperature, top_p), draft_probs)
+                self.proposed += len(draft)
+                self.accepted += len(new) - 1
+                
+                # The cache also holds the rejected drafts; keep the accepted part
+                past_key_values = getattr(outputs, 'past_key_values', None)
+                cached = len(tokens) + len(new) - 1 if past_key_values is not None else 0
+                past_key_values = crop_cache(past_key_values, cached)
+                tokens.extend(new)
+                self.drafter.rollback(len(tokens) - 1)
+                
+                if eos_token_id is not None and eos_token_id in new:
+                    yield new[:new.index(eos_token_id) + 1]
+                    break
+                yield new
+        
+        logger.debug(f"Speculative decoding accepted {self.accepted}/{self.proposed} draft tokens")
+    
+    def _verify(self, draft: List[int], logits, probs, draft_probs) -> List[int]:
+        """Accepted prefix of draft followed by one token from the model"""
+        import torch
+        
+        if probs is None:
+            targets = logits.argmax(dim=-1).tolist()
+            accepted = 0
+            while accepted < len(draft) and draft[accepted] == targets[accepted]:
+                accepted += 1
+            return draft[:accepted] + [targets[accepted]]
+        
+        if draft_probs is not None:
+            # Draft and model vocabularies may be padded differently
+            vocab = probs.shape[-1]
+            draft_probs = draft_probs[:, :vocab]
+            if draft_probs.shape[-1] < vocab:
+                draft_probs = torch.nn.functional.pad(draft_probs, (0, vocab - draft_probs.shape[-1]))
+        
+        for i, token in enumerate(draft):
+            p = probs[i]
+            if draft_probs is None:
+                # Deterministic draft: q is one-hot on token
+                accept = float(p[token])
+                residual = p.clone()
+                residual[token] = 0
+            else:
+                q = draft_probs[i]
+                accept = min(1.0, float(p[token] / q[token])) if q[token] > 0 else 0.0
+                residual = (p - q).clamp(min=0)
+            
+            if float(torch.rand(())) < accept:
+                continue
+            if float(residual.sum()) <= 0:
+                residual = p
+            return draft[:i] + [int(torch.multinomial(residual / residual.sum(), 1))]
+        
+        return draft + [int(torch.multinomial(probs[len(draft)], 1))]
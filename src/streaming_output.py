@@ -22,6 +22,8 @@ class StreamingHandler:
         """
         self.callback = callback or self._default_callback
         self.is_streaming = False
+        # Share of draft tokens kept in the last speculative generation
+        self.last_acceptance_rate = 0.0
         self.buffer = Queue()
         
     def _default_callback(self, token: str):
@@ -34,64 +36,198 @@ class StreamingHandler:
         tokenizer,
         input_ids,
         max_length: int = 512,
-        temperature: float = 0.7
+        temperature: float = 0.7,
+        decode_every: int = 8,
+        drafter=None,
+        num_draft_tokens: int = 4
     ) -> Iterator[str]:
         """
         Stream model generation token by token
         
+        The prompt is run through the model once; every later step feeds only
+        the newest token and reuses the model's KV cache (past_key_values).
+        Models that return no cache fall back to re-running the sequence.
+        New tokens are written into a preallocated id buffer and turned into
+        text every decode_every tokens.
+        
+        With a drafter (see src.local_models.speculative) tokens come from
+        speculative decoding instead, several per forward pass of model.
+        
         Args:
             model: The model to generate from
             tokenizer: The tokenizer
             input_ids: Input token IDs
             max_length: Maximum generation length
-            temperature: Sampling temperature
+            temperature: Sampling temperature (0 for greedy)
+            decode_every: Tokens sampled between host syncs / text chunks
+            drafter: Optional NgramDrafter/ModelDrafter for speculative decoding
+            num_draft_tokens: Draft tokens verified per forward pass
             
         Yields:
-            Generated tokens as strings
+            Generated text, in chunks of up to decode_every tokens
         """
         import torch
         
+        if drafter is not None:
+            yield from self._stream_speculative(
+                model, tokenizer, input_ids, max_length, temperature, decode_every,
+                drafter, num_draft_tokens
+            )
+            return
+        
         self.is_streaming = True
-        generated_ids = input_ids.clone()
+        prompt_length = input_ids.shape[1]
+        end = max(max_length, prompt_length)
+        
+        # Prompt followed by every generated token; no per-token torch.cat
+        ids = torch.empty((1, end), dtype=input_ids.dtype, device=input_ids.device)
+        ids[:, :prompt_length] = input_ids[:1]
+        
+        detokenizer = _IncrementalDetokenizer(tokenizer)
+        eos_token_id = tokenizer.eos_token_id
+        
+        def drain(start: int, stop: int):
+            """Text of ids[start:stop], and whether EOS was among them"""
+            token_ids = ids[0, start:stop].tolist()
+            if eos_token_id is not None and eos_token_id in token_ids:
+                return detokenizer.push(token_ids[:token_ids.index(eos_token_id)], final=True), True
+            return detokenizer.push(token_ids, final=stop == end), False
         
         try:
             with torch.no_grad():
-                for _ in range(max_length - len(input_ids[0])):
-                    if not self.is_streaming:
-                        break
-                    
-                    # Generate next token
-                    outputs = model(generated_ids)
+                past_key_values = None
+                length = prompt_length
+                drained = prompt_length
+                
+                while length < end and self.is_streaming:
+                    if past_key_values is None:
+                        outputs = model(ids[:, :length], use_cache=True)
+                    else:
+                        outputs = model(
+                            ids[:, length - 1:length],
+                            past_key_values=past_key_values,
+                            use_cache=True
+                        )
+                    past_key_values = getattr(outputs, 'past_key_values', None)
                     next_token_logits = outputs.logits[0, -1, :]
                     
-                    # Apply temperature
-                    next_token_logits = next_token_logits / temperature
+                    if temperature > 0:
+                        probs = torch.nn.functional.softmax(next_token_logits / temperature, dim=-1)
+                        next_token = torch.multinomial(probs, num_samples=1)
+                    else:
+                        next_token = next_token_logits.argmax(dim=-1, keepdim=True)
                     
-                    # Sample
-                    probs = torch.nn.functional.softmax(next_token_logits, dim=-1)
-                    next_token = torch.multinomial(probs, num_samples=1)
+                    # Stays on the device; only drain() syncs with the host
+                    ids[0, length] = next_token[0]
+                    length += 1
                     
-                    # Decode token
-                    token_str = tokenizer.decode([next_token.item()])
-                    
-                    # Check for EOS
-                    if next_token.item() == tokenizer.eos_token_id:
-                        break
-                    
-                    # Append to generated sequence
-                    generated_ids = torch.cat([generated_ids, next_token.unsqueeze(0)], dim=1)
-                    
-                    # Yield token
-                    yield token_str
+                    if length - drained >= decode_every or length == end:
+                        text, hit_eos = drain(drained, length)
+                        drained = length
+                        if text:
+                            yield text
+                        if hit_eos:
+                            return
+                
+                # Stopped early: emit what was sampled but not yet decoded
+                text, _ = drain(drained, length)
+                text += detokenizer.push([], final=True)
+                if text:
+                    yield text
                     
         finally:
             self.is_streaming = False
     
+    def _stream_speculative(
+        self,
+        model,
+        tokenizer,
+        input_ids,
+        max_length: int,
+        temperature: float,
+        decode_every: int,
+        drafter,
+        num_draft_tokens: int
+    ) -> Iterator[str]:
+        """stream_generation() with tokens from a SpeculativeDecoder"""
+        from src.local_models.speculative import SpeculativeDecoder
+        
+        self.is_streaming = True
+        decoder = SpeculativeDecoder(model, drafter, num_draft_tokens)
+        detokenizer = _IncrementalDetokenizer(tokenizer)
+        eos_token_id = tokenizer.eos_token_id
+        pending = []
+        
+        try:
+            for new_tokens in decoder.generate(
+                input_ids,
+                max_new_tokens=max(max_length - input_ids.shape[1], 0),
+                temperature=temperature,
+                eos_token_id=eos_token_id
+            ):
+                if eos_token_id is not None and new_tokens[-1] == eos_token_id:
+                    new_tokens = new_tokens[:-1]
+                pending.extend(new_tokens)
+                if len(pending) >= decode_every:
+                    text = detokenizer.push(pending)
+                    pending = []
+                    if text:
+                        yield text
+                if not self.is_streaming:
+                    break
+            
+            text = detokenizer.push(pending, final=True)
+            if text:
+                yield text
+        finally:
+            self.last_acceptance_rate = decoder.acceptance_rate
+            self.is_streaming = False
+    
     def stop_streaming(self):
         """Stop streaming generation"""
         self.is_streaming = False
 
 
+class _IncrementalDetokenizer:
+    """Turns a growing token sequence into text chunks
+    
+    Each chunk is decoded together with the chunk before it, and only the
+    text past that context is emitted, so multi-byte characters and
+    tokenizers that drop leading spaces on lone tokens come out right while
+    every push decodes only two chunks. Text ending in an incomplete
+    character is held back until the next chunk.
+    """
+    
+    def __init__(self, tokenizer):
+        self.tokenizer = tokenizer
+        # Already emitted context tokens, then tokens not yet emitted
+        self.tokens = []
+        self.context = 0
+    
+    def push(self, token_ids, final: bool = False) -> str:
+        self.tokens.extend(token_ids)
+        if len(self.tokens) == self.context:
+            if final:
+                self.tokens = []
+                self.context = 0
+            return ''
+        
+        prefix = self.tokenizer.decode(self.tokens[:self.context]) if self.context else ''
+        text = self.tokenizer.decode(self.tokens)
+        if (text.endswith('\ufffd') or len(text) <= len(prefix)) and not final:
+            return ''
+        
+        new_text = text[len(prefix):]
+        if final:
+            self.tokens = []
+            self.context = 0
+        else:
+            # This chunk becomes the context of the next one
+            del self.tokens[:self.context]
+            self.context = len(self.tokens)
+        return new_text
+
+
 class ProgressIndicator:
     """Shows progress indicator during long operations"""
     
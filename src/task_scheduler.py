@@ -0,0 +1,646 @@
+"""
+Task Scheduler
+Dependency- and priority-aware scheduling of breadcrumb tasks across agents
+"""
+
+import os
+import re
+import json
+import time
+import uuid
+import fcntl
+import heapq
+import hashlib
+import logging
+import threading
+from contextlib import contextmanager
+from dataclasses import dataclass
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, Any, Optional, List, Iterable, Tuple
+
+logger = logging.getLogger(__name__)
+
+
+# Task states
+PENDING = 'PENDING'          # Waiting on dependencies
+READY = 'READY'              # In the ready queue
+CLAIMED = 'CLAIMED'          # Leased to an agent
+DONE = 'DONE'
+FAILED = 'FAILED'            # Out of retries; dependents stay PENDING
+
+# AI_STATUS values that count as finished work
+DONE_STATUSES = ('IMPLEMENTED', 'FIXED')
+
+# Work estimate (hours) when a breadcrumb has no AI_ESTIMATED_TIME
+COMPLEXITY_HOURS = {'LOW': 0.5, 'MEDIUM': 1.0, 'HIGH': 2.0, 'CRITICAL': 4.0}
+DEFAULT_PRIORITY = 5
+
+STATE_VERSION = 1
+
+# Breadcrumb fields that describe the work; editing any of them starts the
+# task's retry count over. Claim bookkeeping tags are left out.
+SOURCE_FIELDS = (
+    'status', 'pattern', 'strategy', 'details', 'compiler_err', 'runtime_err',
+    'fix_reason', 'ai_note', 'ai_context', 'ai_estimated_time', 'ai_priority',
+    'ai_dependencies', 'ai_blocks', 'ai_complexity', 'ai_max_retries'
+)
+
+_DURATION_RE = re.compile(r'^\s*(\d+(?:\.\d+)?)\s*([smhd]?)\s*$', re.IGNORECASE)
+_DURATION_UNITS = {'s': 1, 'm': 60, 'h': 3600, 'd': 86400, '': 3600}
+
+
+def parse_duration(text: Optional[str]) -> Optional[float]:
+    """Seconds in an AI_ESTIMATED_TIME style duration ("2.5h", "45m"); bare numbers are hours"""
+    match = _DURATION_RE.match(text) if text else None
+    if not match:
+        return None
+    return float(match.group(1)) * _DURATION_UNITS[match.group(2).lower()]
+
+
+def parse_timestamp(text: Optional[str]) -> Optional[float]:
+    """Epoch seconds of an ISO 8601 timestamp such as AI_TIMEOUT; naive times are UTC"""
+    if not text:
+        return None
+    try:
+        moment = datetime.fromisoformat(text.strip().replace('Z', '+00:00'))
+    except ValueError:
+        return None
+    if moment.tzinfo is None:
+        moment = moment.replace(tzinfo=timezone.utc)
+    return moment.timestamp()
+
+
+def _parse_int(text: Optional[str], default: int) -> int:
+    try:
+        return int(str(text).strip())
+    except (TypeError, ValueError):
+        return default
+
+
+def _split_phases(text: Optional[str]) -> List[str]:
+    return [phase.strip() for phase in text.split(',') if phase.strip()] if text else []
+
+
+def source_digest(breadcrumbs: Iterable[Any]) -> str:
+    """Short hash of the SOURCE_FIELDS of a phase's breadcrumbs"""
+    values = [[getattr(bc, name, None) for name in SOURCE_FIELDS] for bc in breadcrumbs]
+    return hashlib.sha1(json.dumps(values, sort_keys=True, default=str).encode()).hexdigest()[:16]
+
+
+@dataclass
+class Task:
+    """One schedulable phase
+    
+    dependencies holds every phase that must be DONE first, whether it came
+    from this breadcrumb's AI_DEPENDENCIES or from another one's AI_BLOCKS;
+    dependents is the reverse. weight and critical_path are in seconds of
+    estimated work, critical_path being the longest chain of remaining work
+    from this task through its dependents.
+    """
+    phase: str
+    breadcrumb: Any
+    priority: int
+    weight: float
+    lease_seconds: float
+    max_retries: int
+    order: int
+    dependencies: Tuple[str, ...] = ()
+    dependents: Tuple[str, ...] = ()
+    critical_path: float = 0.0
+    state: str = PENDING
+    agent_id: Optional[str] = None
+    token: Optional[str] = None
+    claimed_at: Optional[float] = None
+    expires_at: Optional[float] = None
+    retry_count: int = 0
+    last_error: Optional[str] = None
+    # source_digest() of the breadcrumbs this task was built from
+    source: Optional[str] = None
+    # Bumped on every change; heap entries from older versions are stale
+    version: int = 0
+    
+    def to_dict(self) -> Dict[str, Any]:
+        """Task in the dict form CopilotStyleIteration works with
+        
+        Tags the breadcrumb doesn't set are left out, so callers' .get()
+        defaults apply.
+        """
+        bc = self.breadcrumb
+        task = {
+            'phase': self.phase,
+            'status': bc.status,
+            'strategy': bc.strategy,
+            'file': bc.file_path,
+            'line': bc.line_number,
+            'priority': self.priority,
+            'complexity': bc.ai_complexity,
+            'dependencies': list(self.dependencies),
+            'critical_path_hours': self.critical_path / 3600,
+            'retry_count': self.retry_count,
+            'max_retries': self.max_retries,
+            'scheduler_state': self.state
+        }
+        return {key: value for key, value in task.items() if value is not None}
+    
+    def _shared_state(self) -> Dict[str, Any]:
+        return {
+            'state': self.state,
+            'agent_id': self.agent_id,
+            'token': self.token,
+            'claimed_at': self.claimed_at,
+            'expires_at': self.expires_at,
+            'retry_count': self.retry_count,
+            'last_error': self.last_error,
+            'source': self.source
+        }
+
+
+@dataclass(frozen=True)
+class TaskLease:
+    """An agent's claim on a task
+    
+    Only the holder of the current token can complete, fail, renew or
+    release the task; once the lease has expired and the task was handed to
+    another agent, the old lease is rejected.
+    """
+    phase: str
+    agent_id: str
+    token: str
+    expires_at: float
+    attempt: int
+
+
+class TaskScheduler:
+    """Ready queue over the breadcrumb dependency DAG
+    
+    Tasks whose dependencies are all DONE sit in a heap ordered by
+    AI_PRIORITY, then by critical path, then by source order; claim() pops
+    the best one and leases it to the calling agent for the task's timeout
+    (AI_TIMEOUT - AI_CLAIMED_AT when both are set, AI_TIMEOUT as a duration,
+    or default_lease). Expired leases and failures count against
+    AI_MAX_RETRIES; a task out of retries is FAILED and its dependents are
+    left waiting. Completing a task moves its dependents into the queue as
+    soon as their last dependency is done, so no agent waits behind an
+    unrelated blocked task.
+    
+    Breadcrumbs already carrying AI_ASSIGNED_TO start out claimed by that
+    agent until their AI_TIMEOUT; the agent can pick the lease back up with
+    resume().
+    
+    With state_path set, claim state lives in that JSON file and every
+    operation runs under an exclusive lock on state_path + '.lock', first
+    catching up with changes other schedulers made. Agents on several nodes
+    sharing the file never hold the same task at once. Retry counts and
+    failures recorded there are dropped once the phase's breadcrumbs are
+    edited (any of SOURCE_FIELDS), so reworked tasks get their retries back,
+    and a phase whose breadcrumbs are all finished stays DONE.
+    """
+    
+    def __init__(
+        self,
+        breadcrumbs: Iterable[Any] = (),
+        state_path: Optional[str] = None,
+        default_lease: float = 3600.0,
+        default_max_retries: int = 3,
+        missing_dependencies_done: bool = True,
+        clock=time.time
+    ):
+        """
+        Args:
+            breadcrumbs: Parsed breadcrumbs (Breadcrumb or CompactBreadcrumb)
+            state_path: Shared claim file for schedulers in other processes
+            default_lease: Lease length in seconds when AI_TIMEOUT says nothing
+            default_max_retries: Used when AI_MAX_RETRIES is missing
+            missing_dependencies_done: Treat dependencies on phases that have
+                no breadcrumb as satisfied (they usually live outside the
+                scanned tree) instead of blocking on them forever
+            clock: Returns the current time in epoch seconds
+        """
+        self.state_path = Path(state_path) if state_path else None
+        self.default_lease = default_lease
+        self.default_max_retries = default_max_retries
+        self.missing_dependencies_done = missing_dependencies_done
+        self._clock = clock
+        
+        self._lock = threading.RLock()
+        self._tasks: Dict[str, Task] = {}
+        self._ready: List[Tuple] = []
+        self._leases: List[Tuple[float, int, str]] = []
+        self._missing: Dict[str, List[str]] = {}
+        self._cycles: List[str] = []
+        # Shared-state bookkeeping: tasks of other trees, last generation seen
+        self._foreign: Dict[str, Dict[str, Any]] = {}
+        self._generation = 0
+        self._dirty = False
+        
+        self._build(breadcrumbs)
+        if self.state_path is not None:
+            self.state_path.parent.mkdir(parents=True, exist_ok=True)
+            # Adopt the shared claims, publishing any phase they don't have yet
+            with self._transaction():
+                pass
+    
+    def __len__(self) -> int:
+        return len(self._tasks)
+    
+    # ------------------------------------------------------------------
+    # Graph construction
+    
+    def _build(self, breadcrumbs: Iterable[Any]) -> None:
+        now = self._clock()
+        groups: Dict[str, List[Any]] = {}
+        for bc in breadcrumbs:
+            if bc.phase:
+                groups.setdefault(bc.phase, []).append(bc)
+        
+        dependencies: Dict[str, set] = {}
+        for order, (phase, group) in enumerate(groups.items()):
+            # A phase is done once none of its breadcrumbs is unfinished; the
+            # first unfinished one describes the remaining work
+            open_work = [bc for bc in group if bc.status not in DONE_STATUSES]
+            bc = open_work[0] if open_work else group[0]
+            
+            estimate = parse_duration(bc.ai_estimated_time)
+            if estimate is None:
+                estimate = COMPLEXITY_HOURS.get((bc.ai_complexity or '').upper(), 1.0) * 3600
+            task = Task(
+                phase=phase,
+                breadcrumb=bc,
+                priority=_parse_int(bc.ai_priority, DEFAULT_PRIORITY),
+                weight=estimate if open_work else 0.0,
+                lease_seconds=self._lease_seconds(bc),
+                max_retries=_parse_int(bc.ai_max_retries, self.default_max_retries),
+                order=order,
+                retry_count=_parse_int(bc.ai_retry_count, 0),
+                source=source_digest(group)
+            )
+            if not open_work:
+                task.state = DONE
+            elif bc.ai_assigned_to:
+                task.state = CLAIMED
+                task.agent_id = bc.ai_assigned_to
+                task.token = uuid.uuid4().hex
+                task.claimed_at = parse_timestamp(bc.ai_claimed_at)
+                task.expires_at = parse_timestamp(bc.ai_timeout)
+                if task.expires_at is None:
+                    task.expires_at = (task.claimed_at or now) + task.lease_seconds
+            self._tasks[phase] = task
+            
+            deps = dependencies.setdefault(phase, set())
+            for bc in group:
+                deps.update(_split_phases(bc.ai_dependencies))
+                for blocked in _split_phases(bc.ai_blocks):
+                    dependencies.setdefault(blocked, set()).add(phase)
+        
+        dependents: Dict[str, set] = {phase: set() for phase in self._tasks}
+        for phase, deps in dependencies.items():
+            deps.discard(phase)
+            if phase not in self._tasks:
+                continue
+            self._tasks[phase].dependencies = tuple(sorted(deps))
+            for dep in deps:
+                if dep in self._tasks:
+                    dependents[dep].add(phase)
+                else:
+                    self._missing.setdefault(dep, []).append(phase)
+        for phase, task in self._tasks.items():
+            task.dependents = tuple(sorted(dependents[phase], key=lambda p: self._tasks[p].order))
+        
+        self._compute_critical_paths()
+        self._rebuild()
+        
+        if self._missing:
+            logger.info(f"Dependencies without breadcrumbs ({'assumed done' if self.missing_dependencies_done else 'blocking'}): "
+                        f"{', '.join(sorted(self._missing))}")
+        if self._cycles:
+            logger.warning(f"Dependency cycle, these tasks can never become ready: {', '.join(self._cycles)}")
+    
+    def _lease_seconds(self, bc: Any) -> float:
+        timeout = parse_timestamp(bc.ai_timeout)
+        claimed = parse_timestamp(bc.ai_claimed_at)
+        if timeout is not None and claimed is not None and timeout > claimed:
+            return timeout - claimed
+        duration = parse_duration(bc.ai_timeout)
+        return duration if duration else self.default_lease
+    
+    def _compute_critical_paths(self) -> None:
+        """Longest remaining-work chain from each task, in reverse topological order"""
+        unmet = {phase: sum(1 for dep in task.dependencies if dep in self._tasks)
+                 for phase, task in self._tasks.items()}
+        stack = [phase for phase, count in unmet.items() if count == 0]
+        topo = []
+        while stack:
+            phase = stack.pop()
+            topo.append(phase)
+            for dependent in self._tasks[phase].dependents:
+                unmet[dependent] -= 1
+                if unmet[dependent] == 0:
+                    stack.append(dependent)
+        
+        for phase in reversed(topo):
+            task = self._tasks[phase]
+            task.critical_path = task.weight + max(
+                (self._tasks[d].critical_path for d in task.dependents), default=0.0)
+        
+        self._cycles = [phase for phase, count in unmet.items() if count > 0]
+        for phase in self._cycles:
+            self._tasks[phase].critical_path = self._tasks[phase].weight
+    
+    # ------------------------------------------------------------------
+    # Queue bookkeeping (callers hold self._lock)
+    
+    def _dependencies_done(self, task: Task) -> bool:
+        for dep in task.dependencies:
+            other = self._tasks.get(dep)
+            if other is None:
+                if not self.missing_dependencies_done:
+                    return False
+            elif other.state != DONE:
+                return False
+        return True
+    
+    def _set_state(self, task: Task, state: str) -> None:
+        task.state = state
+        task.version += 1
+        self._dirty = True
+        if state == READY:
+            heapq.heappush(self._ready, (-task.priority, -task.critical_path, task.order, task.version, task.phase))
+        elif state == CLAIMED:
+            heapq.heappush(self._leases, (task.expires_at, task.version, task.phase))
+    
+    def _make_runnable(self, task: Task) -> bool:
+        """Move an unclaimed task to READY or PENDING; True if it is now READY"""
+        task.agent_id = task.token = task.claimed_at = task.expires_at = None
+        ready = self._dependencies_done(task)
+        self._set_state(task, READY if ready else PENDING)
+        return ready
+    
+    def _rebuild(self) -> None:
+        """Recompute readiness and both heaps from task states"""
+        self._ready, self._leases = [], []
+        for task in self._tasks.values():
+            if task.state in (PENDING, READY):
+                self._make_runnable(task)
+            elif task.state == CLAIMED:
+                self._set_state(task, CLAIMED)
+    
+    def _retry(self, task: Task, error: str) -> bool:
+        task.retry_count += 1
+        task.last_error = error
+        if task.retry_count >= task.max_retries:
+            task.agent_id = task.token = task.claimed_at = task.expires_at = None
+            self._set_state(task, FAILED)
+            logger.warning(f"Task {task.phase} failed after {task.retry_count} attempts: {error}")
+            return False
+        self._make_runnable(task)
+        return True
+    
+    def _expire(self, now: float) -> List[str]:
+        expired = []
+        while self._leases and self._leases[0][0] <= now:
+            _, version, phase = heapq.heappop(self._leases)
+            task = self._tasks[phase]
+            if task.version != version or task.state != CLAIMED:
+                continue
+            logger.info(f"Lease on {phase} held by {task.agent_id} expired")
+            self._retry(task, f'lease held by {task.agent_id} expired')
+            expired.append(phase)
+        return expired
+    
+    def _held(self, lease: TaskLease) -> Optional[Task]:
+        task = self._tasks.get(lease.phase)
+        if task is None or task.state != CLAIMED or task.token != lease.token:
+            logger.warning(f"Stale lease on {lease.phase} from {lease.agent_id} ignored")
+            return None
+        return task
+    
+    @staticmethod
+    def _lease(task: Task) -> TaskLease:
+        return TaskLease(task.phase, task.agent_id, task.token, task.expires_at, task.retry_count)
+    
+    # ------------------------------------------------------------------
+    # Shared state
+    
+    @contextmanager
+    def _transaction(self):
+        """Hold the scheduler (and with state_path, the shared file) exclusively"""
+        with self._lock:
+            if self.state_path is None:
+                yield
+                return
+            with open(str(self.state_path) + '.lock', 'a') as lock_file:
+                fcntl.flock(lock_file, fcntl.LOCK_EX)
+                self._load_shared()
+                try:
+                    yield
+                except BaseException:
+                    # In-memory state may be half-updated; take the file's next time
+                    self._generation = -1
+                    raise
+                if self._dirty:
+                    self._save_shared()
+    
+    def _load_shared(self) -> None:
+        try:
+            with open(self.state_path) as f:
+                data = json.load(f)
+        except FileNotFoundError:
+            return
+        except (OSError, ValueError) as e:
+            logger.warning(f"Ignoring unreadable task state {self.state_path}: {e}")
+            return
+        if data.get('generation') == self._generation:
+            return
+        
+        self._foreign = {}
+        edited = False
+        for phase, record in data.get('tasks', {}).items():
+            task = self._tasks.get(phase)
+            if task is None:
+                self._foreign[phase] = record
+                continue
+            task.state = record['state']
+            task.agent_id = record.get('agent_id')
+            task.token = record.get('token')
+            task.claimed_at = record.get('claimed_at')
+            task.expires_at = record.get('expires_at')
+            task.retry_count = record.get('retry_count', task.retry_count)
+            task.last_error = record.get('last_error')
+            if record.get('source', task.source) != task.source:
+                # The breadcrumb changed since these attempts were recorded;
+                # they were at other work. Claims and completions stand.
+                edited = True
+                task.retry_count = _parse_int(task.breadcrumb.ai_retry_count, 0)
+                task.last_error = None
+                if task.state == FAILED:
+                    task.state = PENDING
+            if task.breadcrumb.status in DONE_STATUSES and task.state != DONE:
+                # The breadcrumbs say the work is finished, whatever was recorded
+                edited = True
+                task.agent_id = task.token = task.claimed_at = task.expires_at = None
+                task.last_error = None
+                task.state = DONE
+        self._generation = data.get('generation', 0)
+        self._rebuild()
+        self._dirty = edited or any(phase not in data.get('tasks', {}) for phase in self._tasks)
+    
+    def _save_shared(self) -> None:
+        tasks = dict(self._foreign)
+        for phase, task in self._tasks.items():
+            tasks[phase] = task._shared_state()
+        self._generation = max(self._generation, 0) + 1
+        
+        tmp_path = self.state_path.with_name(f'{self.state_path.name}.{os.getpid()}.tmp')
+        with open(tmp_path, 'w') as f:
+            json.dump({'version': STATE_VERSION, 'generation': self._generation, 'tasks': tasks}, f)
+        os.replace(tmp_path, self.state_path)
+        self._dirty = False
+    
+    # ------------------------------------------------------------------
+    # Agent API
+    
+    def claim(self, agent_id: str, now: Optional[float] = None) -> Optional[TaskLease]:
+        """
+        Lease the best ready task to agent_id
+        
+        Expired leases are reclaimed first. Returns None when nothing is
+        ready (everything left is claimed, failed or waiting on those).
+        """
+        now = self._clock() if now is None else now
+        with self._transaction():
+            self._expire(now)
+            while self._ready:
+                *_, version, phase = heapq.heappop(self._ready)
+                task = self._tasks[phase]
+                if task.version != version or task.state != READY:
+                    continue
+                task.agent_id = agent_id
+                task.token = uuid.uuid4().hex
+                task.claimed_at = now
+                task.expires_at = now + task.lease_seconds
+                self._set_state(task, CLAIMED)
+                return self._lease(task)
+            return None
+    
+    def resume(self, agent_id: str, phase: str) -> Optional[TaskLease]:
+        """Lease of a task agent_id already holds, e.g. from AI_ASSIGNED_TO or before a restart"""
+        with self._transaction():
+            task = self._tasks.get(phase)
+            if task is None or task.state != CLAIMED or task.agent_id != agent_id:
+                return None
+            return self._lease(task)
+    
+    def renew(self, lease: TaskLease, now: Optional[float] = None) -> Optional[TaskLease]:
+        """Extend a lease by the task's lease length; None if it is no longer held"""
+        now = self._clock() if now is None else now
+        with self._transaction():
+            task = self._held(lease)
+            if task is None:
+                return None
+            task.expires_at = now + task.lease_seconds
+            self._set_state(task, CLAIMED)
+            return self._lease(task)
+    
+    def complete(self, lease: TaskLease) -> List[str]:
+        """
+        Mark a leased task DONE
+        
+        A lease that ran out is still accepted as long as nobody reclaimed
+        the task. Returns the phases that became ready as a result.
+        """
+        with self._transaction():
+            task = self._held(lease)
+            if task is None:
+                return []
+            task.agent_id = task.token = task.claimed_at = task.expires_at = None
+            task.last_error = None
+            self._set_state(task, DONE)
+            return [dependent for dependent in task.dependents
+                    if self._tasks[dependent].state == PENDING
+                    and self._make_runnable(self._tasks[dependent])]
+    
+    def fail(self, lease: TaskLease, error: str = '') -> bool:
+        """Record a failed attempt; True if the task goes back into the queue"""
+        with self._transaction():
+            task = self._held(lease)
+            return task is not None and self._retry(task, error or 'failed')
+    
+    def release(self, lease: TaskLease) -> bool:
+        """Hand a task back without counting an attempt"""
+        with self._transaction():
+            task = self._held(lease)
+            if task is None:
+                return False
+            self._make_runnable(task)
+            return True
+    
+    def expire_leases(self, now: Optional[float] = None) -> List[str]:
+        """Reclaim every expired lease now; returns the affected phases"""
+        now = self._clock() if now is None else now
+        with self._transaction():
+            return self._expire(now)
+    
+    # ------------------------------------------------------------------
+    # Queries
+    
+    def get_task(self, phase: str) -> Optional[Task]:
+        with self._transaction():
+            return self._tasks.get(phase)
+    
+    def remaining(self) -> int:
+        """Tasks that are neither DONE nor FAILED"""
+        with self._transaction():
+            return sum(1 for task in self._tasks.values() if task.state not in (DONE, FAILED))
+    
+    def ready_tasks(self) -> List[Task]:
+        """Ready tasks in the order claim() would hand them out"""
+        with self._transaction():
+            ready = [task for task in self._tasks.values() if task.state == READY]
+        return sorted(ready, key=lambda t: (-t.priority, -t.critical_path, t.order))
+    
+    def get_tasks(self) -> List[Task]:
+        """Unfinished tasks: ready ones in claim order, then claimed, then waiting"""
+        with self._transaction():
+            tasks = [task for task in self._tasks.values() if task.state not in (DONE, FAILED)]
+        rank = {READY: 0, CLAIMED: 1, PENDING: 2}
+        return sorted(tasks, key=lambda t: (rank[t.state], -t.priority, -t.critical_path, t.order))
+    
+    def critical_path(self) -> List[str]:
+        """Phases on the longest chain of unfinished work"""
+        with self._transaction():
+            return self._critical_path()
+    
+    def _critical_path(self) -> List[str]:
+        heads = [t for t in self._tasks.values() if t.state != DONE and t.phase not in self._cycles
+                 and all(self._tasks.get(d) is None or self._tasks[d].state == DONE for d in t.dependencies)]
+        if not heads:
+            return []
+        task = max(heads, key=lambda t: (t.critical_path, -t.order))
+        path = [task.phase]
+        while True:
+            nexts = [self._tasks[d] for d in task.dependents if self._tasks[d].state != DONE]
+            if not nexts:
+                return path
+            task = max(nexts, key=lambda t: (t.critical_path, -t.order))
+            path.append(task.phase)
+    
+    def get_statistics(self) -> Dict[str, Any]:
+        """Counts by state, claims per agent, failures, cycles and missing dependencies"""
+        with self._transaction():
+            states = {state: 0 for state in (PENDING, READY, CLAIMED, DONE, FAILED)}
+            agents: Dict[str, int] = {}
+            for task in self._tasks.values():
+                states[task.state] += 1
+                if task.state == CLAIMED:
+                    agents[task.agent_id] = agents.get(task.agent_id, 0) + 1
+            return {
+                'total_tasks': len(self._tasks),
+                'states': states,
+                'claims_by_agent': agents,
+                'failed': [t.phase for t in self._tasks.values() if t.state == FAILED],
+                'cycles': list(self._cycles),
+                'missing_dependencies': {dep: list(phases) for dep, phases in self._missing.items()},
+                'critical_path': self._critical_path(),
+                'critical_path_hours': max((t.critical_path for t in self._tasks.values()), default=0.0) / 3600
+            }
@@ -0,0 +1,299 @@
+"""
+Tracing
+Per-phase latency spans for the iteration loop, exported for flamegraphs
+
+Tracing is off by default. While it is off, span() hands back one shared
+no-op object and @traced functions test a single global before calling
+through, so instrumented code pays about one extra call per span.
+
+enable() starts collecting spans from every thread. export_chrome() writes
+them as a Chrome trace (chrome://tracing, ui.perfetto.dev) and
+export_collapsed() as collapsed stacks of self time (flamegraph.pl,
+speedscope).
+
+Native programs started with subprocess_env() add their ring_log spans and
+log records to the same trace (see AROS_TRACE_FILE in examples/ring_log.h).
+Both sides stamp events with CLOCK_REALTIME, so Python and native time land
+on one timeline, and native root spans hang under the Python span that
+launched them.
+"""
+
+import os
+import json
+import time
+import functools
+import itertools
+import threading
+from collections import defaultdict
+from pathlib import Path
+from typing import Dict, Any, Optional, List, Callable
+
+# Read by examples/ring_log.h in native processes
+TRACE_FILE_ENV = 'AROS_TRACE_FILE'
+TRACE_PARENT_ENV = 'AROS_TRACE_PARENT'
+
+
+class _NullSpan:
+    """What span() returns while tracing is disabled"""
+    
+    __slots__ = ()
+    
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, exc_type, exc, tb):
+        return False
+    
+    def set(self, **args: Any) -> None:
+        pass
+
+
+_NULL_SPAN = _NullSpan()
+
+
+class _Span:
+    """One timed region; recorded when the with-block exits"""
+    
+    __slots__ = ('tracer', 'name', 'args', 'id', 'parent', 'start')
+    
+    def __init__(self, tracer: 'Tracer', name: str, args: Optional[Dict[str, Any]]):
+        self.tracer = tracer
+        self.name = name
+        self.args = args
+    
+    def set(self, **args: Any) -> None:
+        """Attach arguments known only once the span is running"""
+        if self.args is None:
+            self.args = {}
+        self.args.update(args)
+    
+    def __enter__(self):
+        stack = self.tracer._stack()
+        self.parent = stack[-1].id if stack else None
+        self.id = next(self.tracer._ids)
+        stack.append(self)
+        self.start = time.time_ns()
+        return self
+    
+    def __exit__(self, exc_type, exc, tb):
+        end = time.time_ns()
+        stack = self.tracer._stack()
+        if stack and stack[-1] is self:
+            stack.pop()
+        elif self in stack:
+            stack.remove(self)
+        if exc_type is not None:
+            self.set(error=exc_type.__name__)
+        # list.append is atomic, so threads record without a lock
+        self.tracer._spans.append(
+            (self.name, self.start, end, threading.get_native_id(), self.id, self.parent, self.args)
+        )
+        return False
+
+
+class Tracer:
+    """Collects spans of one process and merges in its native children's"""
+    
+    def __init__(self, native_trace_path: Optional[str] = None):
+        """
+        Args:
+            native_trace_path: File native processes append their events to
+                (JSON lines); without one, subprocess_env() leaves native
+                tracing off
+        """
+        self.pid = os.getpid()
+        self.native_trace_path = str(native_trace_path) if native_trace_path else None
+        self._spans: List[tuple] = []
+        self._ids = itertools.count(1)
+        self._local = threading.local()
+        self._threads: Dict[int, str] = {}
+        
+        if self.native_trace_path:
+            Path(self.native_trace_path).parent.mkdir(parents=True, exist_ok=True)
+            open(self.native_trace_path, 'w').close()
+    
+    def _stack(self) -> List[_Span]:
+        stack = getattr(self._local, 'stack', None)
+        if stack is None:
+            stack = self._local.stack = []
+            self._threads[threading.get_native_id()] = threading.current_thread().name
+        return stack
+    
+    def span(self, name: str, **args: Any) -> _Span:
+        return _Span(self, name, args or None)
+    
+    def current_span_id(self) -> Optional[int]:
+        stack = self._stack()
+        return stack[-1].id if stack else None
+    
+    def subprocess_env(self, env: Optional[Dict[str, str]] = None) -> Dict[str, str]:
+        """Environment for a child process whose native spans join this trace"""
+        env = dict(os.environ if env is None else env)
+        if self.native_trace_path:
+            env[TRACE_FILE_ENV] = self.native_trace_path
+            parent = self.current_span_id()
+            if parent is not None:
+                env[TRACE_PARENT_ENV] = str(parent)
+            else:
+                env.pop(TRACE_PARENT_ENV, None)
+        return env
+    
+    def clear(self) -> None:
+        """Drop everything recorded so far"""
+        self._spans = []
+        if self.native_trace_path:
+            open(self.native_trace_path, 'w').close()
+    
+    def native_events(self) -> List[Dict[str, Any]]:
+        """Events native processes have written so far"""
+        if not self.native_trace_path or not os.path.exists(self.native_trace_path):
+            return []
+        events = []
+        with open(self.native_trace_path, 'r', errors='replace') as f:
+            for line in f:
+                try:
+                    event = json.loads(line)
+                except ValueError:
+                    continue            # Torn line from a killed process
+                if isinstance(event, dict) and 'ph' in event:
+                    events.append(event)
+        return events
+    
+    def chrome_events(self) -> List[Dict[str, Any]]:
+        """All events in Chrome trace event format"""
+        events = [{
+            'name': 'process_name', 'ph': 'M', 'pid': self.pid,
+            'args': {'name': f'python {self.pid}'}
+        }]
+        for tid, name in list(self._threads.items()):
+            events.append({'name': 'thread_name', 'ph': 'M', 'pid': self.pid, 'tid': tid, 'args': {'name': name}})
+        
+        for name, start, end, tid, span_id, parent, args in list(self._spans):
+            event = {
+                'name': name, 'cat': 'python', 'ph': 'X',
+                'ts': start / 1000, 'dur': (end - start) / 1000,
+                'pid': self.pid, 'tid': tid,
+                'args': dict(args or {}, span_id=span_id)
+            }
+            if parent is not None:
+                event['args']['parent'] = parent
+            events.append(event)
+        
+        events.extend(self.native_events())
+        return events
+    
+    def collapsed_stacks(self) -> Dict[str, int]:
+        """Self time in microseconds per stack ('root;child;leaf')"""
+        # node -> [name, parent node, duration ns]
+        nodes: Dict[Any, list] = {}
+        for name, start, end, _, span_id, parent, _ in list(self._spans):
+            nodes[span_id] = [name, parent, end - start]
+        
+        open_spans: Dict[tuple, list] = defaultdict(list)
+        for index, event in enumerate(self.native_events()):
+            thread = (event.get('pid'), event.get('tid'))
+            stack = open_spans[thread]
+            if event['ph'] == 'B':
+                stack.append((('native', index), event))
+            elif event['ph'] == 'E' and stack:
+                key, begin = stack.pop()
+                if stack:
+                    parent = stack[-1][0]
+                else:
+                    try:
+                        parent = int(begin.get('args', {}).get('parent'))
+                    except (TypeError, ValueError):
+                        parent = None
+                nodes[key] = [begin['name'], parent if parent in nodes or stack else None,
+                              int((event['ts'] - begin['ts']) * 1000)]
+        
+        child_time: Dict[Any, int] = defaultdict(int)
+        for _, parent, duration in nodes.values():
+            if parent is not None:
+                child_time[parent] += duration
+        
+        paths: Dict[Any, str] = {}
+        
+        def path_of(key):
+            if key not in paths:
+                name, parent, _ = nodes[key]
+                paths[key] = f'{path_of(parent)};{name}' if parent in nodes else name
+            return paths[key]
+        
+        stacks: Dict[str, int] = defaultdict(int)
+        for key, (_, _, duration) in nodes.items():
+            # Children running in parallel (threads, processes) can add up
+            # to more than their parent
+            self_ns = max(duration - child_time[key], 0)
+            stacks[path_of(key)] += self_ns // 1000
+        return dict(stacks)
+    
+    def export_chrome(self, path: str) -> str:
+        """Write a Chrome trace / Perfetto JSON file"""
+        with open(path, 'w') as f:
+            json.dump({'traceEvents': self.chrome_events(), 'displayTimeUnit': 'ms'}, f)
+        return str(path)
+    
+    def export_collapsed(self, path: str) -> str:
+        """Write collapsed stacks, one 'stack microseconds' line each"""
+        with open(path, 'w') as f:
+            for stack, micros in sorted(self.collapsed_stacks().items()):
+                if micros > 0:
+                    f.write(f'{stack} {micros}\n')
+        return str(path)
+
+
+_tracer: Optional[Tracer] = None
+
+
+def enable(native_trace_path: Optional[str] = None) -> Tracer:
+    """Start tracing in this process (replaces any active tracer)"""
+    global _tracer
+    _tracer = Tracer(native_trace_path)
+    return _tracer
+
+
+def disable() -> Optional[Tracer]:
+    """Stop tracing; returns the tracer that was active, for exporting"""
+    global _tracer
+    tracer, _tracer = _tracer, None
+    return tracer
+
+
+def get_tracer() -> Optional[Tracer]:
+    return _tracer
+
+
+def span(name: str, **args: Any):
+    """Context manager timing the enclosed block as a span"""
+    tracer = _tracer
+    if tracer is None:
+        return _NULL_SPAN
+    return _Span(tracer, name, args or None)
+
+
+def traced(name: Optional[str] = None) -> Callable:
+    """Decorator timing every call of a function as a span"""
+    def decorate(func):
+        label = name or func.__qualname__
+        
+        @functools.wraps(func)
+        def wrapper(*args, **kwargs):
+            tracer = _tracer
+            if tracer is None:
+                return func(*args, **kwargs)
+            with _Span(tracer, label, None):
+                return func(*args, **kwargs)
+        return wrapper
+    return decorate
+
+
+def subprocess_env(env: Optional[Dict[str, str]] = None) -> Optional[Dict[str, str]]:
+    """env for subprocess.Popen that carries the current span to the child
+    
+    Returns env unchanged while tracing is disabled.
+    """
+    tracer = _tracer
+    if tracer is None:
+        return env
+    return tracer.subprocess_env(env)
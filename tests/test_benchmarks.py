@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+Tests for the benchmark suite
+Covers corpus determinism and caching, result summaries, baseline comparison
+and the C hot path benchmark binary, at sizes small enough for every run.
+"""
+
+import sys
+import json
+import shutil
+import tempfile
+import subprocess
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+sys.path.insert(0, str(project_root / 'benchmarks'))
+
+import corpus
+import run_benchmarks
+from src.breadcrumb_parser import BreadcrumbParser
+from src.compiler_loop import CompilerLoop
+
+
+def test_corpus_generation():
+    """Test generated trees are deterministic, cached and parseable"""
+    print("\n=== Testing Corpus Generation ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        first = corpus.generate_tree(str(Path(tmp) / 'a'), 20, breadcrumbs_per_file=4)
+        second = corpus.generate_tree(str(Path(tmp) / 'b'), 20, breadcrumbs_per_file=4)
+        assert [Path(p).read_text() for p in first] == [Path(p).read_text() for p in second]
+        print("✓ Same parameters give the same tree")
+        
+        mtime = Path(first[0]).stat().st_mtime_ns
+        assert corpus.generate_tree(str(Path(tmp) / 'a'), 20, breadcrumbs_per_file=4) == first
+        assert Path(first[0]).stat().st_mtime_ns == mtime
+        print("✓ Cached tree is reused")
+        
+        parser = BreadcrumbParser(use_native=False)
+        crumbs = parser.parse_file(first[0])
+        assert len(crumbs) == 4
+        assert all(c.phase and c.status for c in crumbs)
+        text = Path(first[0]).read_text()
+        assert '// AI_PHASE' in text or ' * AI_PHASE' in text
+        print(f"✓ Parser finds all {len(crumbs)} breadcrumbs of a generated file")
+        
+        log = corpus.generate_gcc_log(str(Path(tmp) / 'log' / 'build.log'), 1)
+        size = Path(log).stat().st_size
+        assert 1024 * 1024 <= size < 2 * 1024 * 1024
+        loop = CompilerLoop(aros_path=tmp, log_path=str(Path(tmp) / 'logs'))
+        errors = loop._parse_errors(Path(log).read_text()[:200000])
+        assert errors and all(e['file'] and e['line'] for e in errors)
+        print(f"✓ GCC log of {size // 1024} KB yields {len(errors)} diagnostics per 200 KB")
+    
+    return True
+
+
+def test_summary_and_compare():
+    """Test percentiles and regression detection"""
+    print("\n=== Testing Summary And Compare ===")
+    
+    latencies = [0.001] * 98 + [0.010, 0.100]
+    result = run_benchmarks.summarize('x', latencies, 'calls/s')
+    assert result['calls'] == 100
+    assert abs(result['p50_us'] - 1000) < 1e-6
+    assert abs(result['p99_us'] - 10000) < 1e-6
+    assert abs(result['throughput'] - 100 / sum(latencies)) < 1e-6
+    print("✓ p50, p99 and throughput computed from per-call latencies")
+    
+    baseline = {'results': {'x': dict(result)}}
+    assert run_benchmarks.compare([result], baseline, 0.25) == []
+    slower = dict(result, throughput=result['throughput'] * 0.5, p50_us=result['p50_us'] * 2)
+    regressions = run_benchmarks.compare([slower], baseline, 0.25)
+    assert len(regressions) == 2 and all(r.startswith('x:') for r in regressions)
+    assert run_benchmarks.compare([dict(result, name='new')], baseline, 0.25) == []
+    print("✓ Slowdowns beyond tolerance are reported, new benchmarks are not")
+    
+    return True
+
+
+def test_error_tracker_bench():
+    """Test the tracker benchmark reports both operations"""
+    print("\n=== Testing Error Tracker Benchmark ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        results = run_benchmarks.bench_error_tracker({'errors': 300, 'queries': 20}, Path(tmp))
+    names = [r['name'] for r in results]
+    assert names == ['track_error', 'find_similar_errors']
+    assert results[0]['calls'] == 300 and results[1]['calls'] == 20
+    assert all(r['throughput'] > 0 for r in results)
+    print(f"✓ {results[0]['entries']} tracked entries, index built in {results[1]['index_build_s']:.3f}s")
+    
+    return True
+
+
+def test_c_hot_paths():
+    """Test the C benchmark builds and prints one record per hot path"""
+    print("\n=== Testing C Hot Paths ===")
+    
+    if shutil.which('gcc') is None and shutil.which('cc') is None:
+        print("⚠ No C compiler, skipping")
+        return True
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        results = run_benchmarks.bench_c_hot_paths({'c_calls': 6400}, Path(tmp))
+    assert [r['name'] for r in results] == ['memory_alloc', 'network_send', 'log_message']
+    assert all(r['calls'] == 6400 and r['throughput'] > 0 and r['p99_us'] >= r['p50_us'] for r in results)
+    print("✓ memory_alloc, network_send and log_message measured")
+    
+    return True
+
+
+def test_cli_baseline_roundtrip():
+    """Test --save-baseline then a comparing run"""
+    print("\n=== Testing Baseline Roundtrip ===")
+    
+    script = project_root / 'benchmarks' / 'run_benchmarks.py'
+    with tempfile.TemporaryDirectory() as tmp:
+        common = [sys.executable, str(script), '--scale', 'smoke', '--only', 'parse_file',
+                  '--corpus-dir', str(Path(tmp) / 'corpus'), '--baseline', str(Path(tmp) / 'base.json')]
+        saved = subprocess.run(common + ['--save-baseline'], capture_output=True, text=True)
+        assert saved.returncode == 0, saved.stderr
+        with open(Path(tmp) / 'base.json') as f:
+            baseline = json.load(f)
+        assert 'parse_file_python' in baseline['results']
+        
+        # A tolerance this wide only fails on a crash
+        checked = subprocess.run(common + ['--tolerance', '100'], capture_output=True, text=True)
+        assert checked.returncode == 0, checked.stdout + checked.stderr
+        assert 'No regressions' in checked.stdout
+    print("✓ Baseline saved and compared through the CLI")
+    
+    return True
+
+
+def run_all_tests():
+    """Run all benchmark suite tests"""
+    print("=" * 60)
+    print("  Benchmark Suite Test Suite")
+    print("=" * 60)
+    
+    tests = [
+        test_corpus_generation,
+        test_summary_and_compare,
+        test_error_tracker_bench,
+        test_c_hot_paths,
+        test_cli_baseline_roundtrip,
+    ]
+    
+    passed = 0
+    failed = 0
+    
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+    
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+    
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
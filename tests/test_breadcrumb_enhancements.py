@@ -12,7 +12,7 @@ from pathlib import Path
 project_root = Path(__file__).parent.parent
 sys.path.insert(0, str(project_root))
 
-from src.breadcrumb_parser.parser import BreadcrumbParser, TAG_SET
+from src.breadcrumb_parser.parser import BreadcrumbParser, Breadcrumb, TAG_SET
 
 
 def test_ai_breadcrumb_tag_in_tagset():
@@ -298,6 +298,61 @@ void util_a() {}
         Path(test_file).unlink()
 
 
+def test_indexed_queries_stay_consistent():
+    """Test that lookup indexes follow parses, appends and reassignment"""
+    print("\n=== Testing Indexed Breadcrumb Queries ===")
+    
+    with tempfile.NamedTemporaryFile(mode='w', suffix='.c', delete=False) as f:
+        f.write("""
+// AI_PHASE: NET_INIT
+// AI_STATUS: PARTIAL
+// AI_PATTERN: DEVICE_INIT
+// AI_ASSIGNED_TO: agent-1
+void net_init() {}
+
+// AI_PHASE: NET_SEND
+// AI_STATUS: NOT_STARTED
+// AI_DEPENDENCIES: NET_INIT, MEMORY_INIT
+void net_send() {}
+""")
+        test_file = f.name
+    
+    try:
+        parser = BreadcrumbParser()
+        parser.parse_file(test_file)
+        
+        assert [bc.phase for bc in parser.get_breadcrumbs_by_status('PARTIAL')] == ['NET_INIT']
+        assert [bc.phase for bc in parser.get_breadcrumbs_by_pattern('DEVICE_INIT')] == ['NET_INIT']
+        assert [bc.phase for bc in parser.get_breadcrumbs_by_assignee('agent-1')] == ['NET_INIT']
+        assert [bc.phase for bc in parser.get_dependents('MEMORY_INIT')] == ['NET_SEND']
+        print("✓ Status, pattern, assignee and dependency lookups")
+        
+        init_bc = parser.get_breadcrumbs_by_phase('NET_INIT')[0]
+        assert [bc.phase for bc in parser.find_related_breadcrumbs(init_bc)] == ['NET_SEND']
+        
+        # A second file adds a reverse dependency; cached relations must refresh
+        parser.parse_file(test_file)
+        assert len(parser.get_breadcrumbs_by_phase('NET_INIT')) == 2
+        assert len(parser.find_related_breadcrumbs(init_bc)) == 1  # same file/line deduplicated
+        
+        # Direct appends and reassignment are picked up too
+        parser.breadcrumbs.append(Breadcrumb(file_path='other.c', line_number=1,
+                                             phase='NET_TEST', ai_blocks='NET_INIT'))
+        assert [bc.phase for bc in parser.find_related_breadcrumbs(init_bc)] == ['NET_SEND', 'NET_TEST']
+        
+        parser.breadcrumbs = parser.breadcrumbs[:2]
+        assert parser.get_statistics()['total_breadcrumbs'] == 2
+        assert parser.get_breadcrumbs_by_phase('NET_TEST') == []
+        
+        graph = parser.get_related_graph()
+        assert graph == {0: [1], 1: [0]}, f"Unexpected graph {graph}"
+        print("✓ Indexes follow appends and reassignment")
+        return True
+        
+    finally:
+        Path(test_file).unlink()
+
+
 def run_all_tests():
     """Run all breadcrumb enhancement tests"""
     print("=" * 60)
@@ -312,6 +367,7 @@ def run_all_tests():
         test_reference_based_relationships,
         test_block_comment_ai_breadcrumb,
         test_multiple_markers,
+        test_indexed_queries_stay_consistent,
     ]
     
     passed = 0
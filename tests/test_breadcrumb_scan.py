@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+"""
+Test script for repository-wide breadcrumb scanning
+Tests the parallel directory scan against a serial file-by-file parse
+and the incremental on-disk breadcrumb index
+"""
+
+import sys
+import subprocess
+import multiprocessing
+import tempfile
+from dataclasses import asdict
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.breadcrumb_parser.parser import BreadcrumbParser, collect_source_files
+from src.breadcrumb_parser.index import BreadcrumbIndex
+
+
+def _make_tree(root: Path, modules: int = 12, files_per_module: int = 10) -> None:
+    """Create a small AROS-like tree with uneven file sizes"""
+    for m in range(modules):
+        module_dir = root / f'module_{m:02d}' / 'src'
+        module_dir.mkdir(parents=True)
+        for f in range(files_per_module):
+            # Every tenth file is much larger to exercise stealing
+            padding = 'int filler;\n' * (2000 if f % 10 == 0 else 5)
+            (module_dir / f'file_{f:02d}.c').write_text(f"""
+// AI_PHASE: PHASE_{m}
+// AI_STATUS: {'PARTIAL' if f % 2 else 'IMPLEMENTED'}
+// AI_STRATEGY: Strategy {m}.{f}
+void func_{f}(void);
+{padding}
+/*
+ * AI_PHASE: BLOCK_{m}
+ * AI_CONTEXT: {{
+ *   "module": {m},
+ *   "file": {f}
+ * }}
+ */
+void block_{f}(void);
+""")
+        (module_dir / 'README.txt').write_text('// AI_PHASE: NOT_SCANNED\n')
+
+
+def test_collect_source_files():
+    """Test that source discovery is sorted and filtered by extension"""
+    print("\n=== Testing Source File Discovery ===")
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir)
+        _make_tree(root, modules=2, files_per_module=3)
+
+        files = collect_source_files(str(root))
+        assert len(files) == 6, f"Expected 6 files, got {len(files)}"
+        assert files == sorted(files)
+        assert all(f.endswith('.c') for f in files)
+
+        print(f"✓ Found {len(files)} source files in sorted order")
+        return True
+
+
+def test_parallel_scan_matches_serial():
+    """Test that the parallel scan returns the same breadcrumbs as a serial parse"""
+    print("\n=== Testing Parallel Directory Scan ===")
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir)
+        _make_tree(root)
+
+        serial = BreadcrumbParser()
+        for file_path in collect_source_files(str(root)):
+            serial.parse_file(file_path)
+
+        parallel = BreadcrumbParser()
+        found = parallel.parse_directory(str(root), workers=4)
+
+        assert len(found) == 240, f"Expected 240 breadcrumbs, got {len(found)}"
+        assert [asdict(b) for b in found] == [asdict(b) for b in serial.breadcrumbs]
+        assert parallel.breadcrumbs == found
+        assert found[1].ai_context == {'module': 0, 'file': 0}
+
+        print(f"✓ Parallel scan with 4 workers matches serial parse ({len(found)} breadcrumbs)")
+
+        # Deterministic regardless of worker count
+        again = BreadcrumbParser().parse_directory(str(root), workers=3)
+        assert [asdict(b) for b in again] == [asdict(b) for b in found]
+        print("✓ Results are identical across worker counts")
+
+        return True
+
+
+def test_dead_worker_raises():
+    """Test that a worker dying mid-scan fails the scan instead of hanging it"""
+    print("\n=== Testing Dead Scan Worker ===")
+
+    import os
+    import time
+    from src.breadcrumb_parser import parser as parser_module
+
+    if multiprocessing.get_start_method() != 'fork':
+        print("⚠ Needs the fork start method, skipping")
+        return True
+
+    scan_worker = parser_module._scan_worker
+
+    def dying_worker(worker, *args):
+        if worker == 0:
+            os._exit(9)
+        scan_worker(worker, *args)
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir)
+        _make_tree(root, modules=4)
+        parser_module._scan_worker = dying_worker
+        start = time.monotonic()
+        try:
+            BreadcrumbParser().parse_directory(str(root), workers=3)
+            assert False, "Expected the scan to fail"
+        except RuntimeError as e:
+            assert 'exit code 9' in str(e), e
+        finally:
+            parser_module._scan_worker = scan_worker
+        assert time.monotonic() - start < 10
+        print("✓ Scan raised RuntimeError when a worker died")
+
+    return True
+
+
+def test_scan_script_jobs_with_max_files():
+    """Test that scan_breadcrumbs.py parallelizes a --max-files scan"""
+    print("\n=== Testing --jobs With --max-files ===")
+
+    sys.path.insert(0, str(project_root / 'scripts'))
+    import scan_breadcrumbs
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir)
+        _make_tree(root, modules=6)
+        files = collect_source_files(str(root))[:40]
+
+        calls = []
+        parse_files = BreadcrumbParser.parse_files
+
+        def recording(self, file_list, workers=None):
+            calls.append((len(file_list), workers))
+            return parse_files(self, file_list, workers)
+
+        BreadcrumbParser.parse_files = recording
+        try:
+            parser, _ = scan_breadcrumbs.scan_directory(root, max_files=40, extensions=['.c'], jobs=2)
+        finally:
+            BreadcrumbParser.parse_files = parse_files
+
+        assert calls == [(40, 2)], calls
+        assert {b.file_path for b in parser.breadcrumbs} == set(files)
+        print("✓ The first 40 files were scanned by 2 workers")
+
+    return True
+
+
+def test_index_reparses_only_changed_files():
+    """Test that the index re-parses only modified, added or removed files"""
+    print("\n=== Testing Incremental Breadcrumb Index ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir) / 'aros-src'
+        _make_tree(root, modules=3, files_per_module=4)
+        index_path = Path(temp_dir) / 'index.json'
+        
+        index = BreadcrumbIndex(str(index_path))
+        stats = index.refresh(str(root))
+        assert stats['reparsed'] == 12
+        assert index_path.exists()
+        expected = BreadcrumbParser().parse_directory(str(root), workers=1)
+        assert [asdict(b) for b in index.get_breadcrumbs(str(root))] == [asdict(b) for b in expected]
+        print(f"✓ Cold index built ({len(expected)} breadcrumbs)")
+        
+        # Warm index from disk: nothing to re-parse
+        index = BreadcrumbIndex(str(index_path))
+        stats = index.refresh(str(root))
+        assert stats['reparsed'] == 0 and stats['removed'] == 0
+        assert len(index.get_breadcrumbs()) == len(expected)
+        print("✓ Warm refresh re-parses nothing")
+        
+        # Touch without changing content: hash matches, no re-parse
+        touched = root / 'module_00' / 'src' / 'file_01.c'
+        touched.write_text(touched.read_text())
+        assert index.refresh(str(root))['reparsed'] == 0
+        
+        # Edit one file, add one, remove one
+        changed = root / 'module_01' / 'src' / 'file_02.c'
+        changed.write_text("// AI_PHASE: EDITED\n// AI_STATUS: NOT_STARTED\nint x;\n")
+        (root / 'module_02' / 'src' / 'new.c').write_text("// AI_PHASE: NEW\nint y;\n")
+        (root / 'module_00' / 'src' / 'file_03.c').unlink()
+        
+        stats = index.refresh(str(root))
+        assert stats['reparsed'] == 2, f"Expected 2 re-parsed, got {stats}"
+        assert stats['removed'] == 1
+        
+        phases = {b.phase for b in BreadcrumbIndex(str(index_path)).get_breadcrumbs()}
+        assert 'EDITED' in phases and 'NEW' in phases
+        print("✓ Only edited, added and removed files are updated")
+        
+        return True
+
+
+def test_index_refresh_from_git():
+    """Test that git-driven refresh skips the walk and picks up changed paths"""
+    print("\n=== Testing Git-Driven Index Refresh ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        root = Path(temp_dir) / 'aros-src'
+        _make_tree(root, modules=2, files_per_module=3)
+        
+        def git(*args):
+            subprocess.run(['git', '-C', str(root), *args], check=True, capture_output=True)
+        
+        try:
+            git('init', '-q')
+            git('add', '-A')
+            git('-c', 'user.name=test', '-c', 'user.email=test@example.com', 'commit', '-qm', 'init')
+        except (OSError, subprocess.CalledProcessError):
+            print("⚠ git not available, skipping")
+            return True
+        
+        index = BreadcrumbIndex(str(Path(temp_dir) / 'index.json'))
+        assert index.refresh_from_git(str(root))['reparsed'] == 6
+        
+        stats = index.refresh_from_git(str(root))
+        assert stats['checked'] == 0, f"Expected no files checked, got {stats}"
+        print("✓ Unchanged checkout checks no files")
+        
+        (root / 'module_01' / 'src' / 'file_00.c').write_text("// AI_PHASE: SYNCED\n")
+        (root / 'module_01' / 'src' / 'extra.c').write_text("// AI_PHASE: UNTRACKED\n")
+        git('-c', 'user.name=test', '-c', 'user.email=test@example.com', 'commit', '-qam', 'sync')
+        
+        stats = index.refresh_from_git(str(root))
+        assert stats['checked'] == 2 and stats['reparsed'] == 2, f"Unexpected stats {stats}"
+        phases = {b.phase for b in index.get_breadcrumbs()}
+        assert {'SYNCED', 'UNTRACKED'} <= phases
+        print("✓ Committed and untracked changes picked up from git diff")
+        
+        edited = root / 'module_00' / 'src' / 'file_01.c'
+        original = edited.read_text()
+        edited.write_text("// AI_PHASE: UNCOMMITTED\n")
+        index.refresh_from_git(str(root))
+        assert 'UNCOMMITTED' in {b.phase for b in index.get_breadcrumbs()}
+        git('checkout', '--', str(edited))
+        assert edited.read_text() == original
+        index.refresh_from_git(str(root))
+        assert 'UNCOMMITTED' not in {b.phase for b in index.get_breadcrumbs()}
+        print("✓ Reverted uncommitted edit is re-checked")
+        
+        git('mv', 'module_00/src/file_02.c', 'module_00/src/renamed.c')
+        git('-c', 'user.name=test', '-c', 'user.email=test@example.com', 'commit', '-qm', 'rename')
+        index.refresh_from_git(str(root))
+        files = {b.file_path for b in index.get_breadcrumbs()}
+        assert str(root / 'module_00' / 'src' / 'renamed.c') in files
+        assert str(root / 'module_00' / 'src' / 'file_02.c') not in files, files
+        print("✓ Renamed file leaves no entry under its old path")
+        
+        return True
+
+
+def run_all_tests():
+    """Run all breadcrumb scanning tests"""
+    print("=" * 60)
+    print("  Breadcrumb Scan Test Suite")
+    print("=" * 60)
+
+    tests = [
+        test_collect_source_files,
+        test_parallel_scan_matches_serial,
+        test_dead_worker_raises,
+        test_scan_script_jobs_with_max_files,
+        test_index_reparses_only_changed_files,
+        test_index_refresh_from_git,
+    ]
+
+    passed = 0
+    failed = 0
+
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
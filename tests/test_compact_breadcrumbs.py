@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Tests for compact breadcrumb storage
+Checks that BreadcrumbParser(compact=True) yields records equal to the full
+Breadcrumbs, shares interned values between them, defers AI_CONTEXT parsing,
+and actually uses less memory.
+"""
+
+import sys
+import pickle
+import tempfile
+import tracemalloc
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.breadcrumb_parser import parser as parser_module
+from src.breadcrumb_parser.parser import BreadcrumbParser, CompactBreadcrumb
+
+
+BLOCK = '''// AI_PHASE: GRAPHICS_PIPELINE
+// AI_STATUS: PARTIAL
+// AI_PATTERN: GPU_INIT_V2
+// AI_STRATEGY: Initialize GPU pipeline for RadeonSI driver {n}
+// AI_COMPLEXITY: HIGH
+// AI_PRIORITY: 8
+// AI_DEPENDENCIES: MEMORY_MANAGER, LLVM_INIT
+// LINUX_REF: drivers/gpu/drm/radeon/radeon_cs.c
+// AI_CONTEXT: {{
+//   "gpu_family": "GCN",
+//   "vulkan_support": false
+// }}
+int f{n}(void) {{ return 0; }}
+'''
+
+
+def _write_files(directory: str, count: int, per_file: int):
+    paths = []
+    for i in range(count):
+        path = Path(directory) / f"f{i}.c"
+        path.write_text(''.join(BLOCK.format(n=j) for j in range(per_file)))
+        paths.append(str(path))
+    return paths
+
+
+def _modes():
+    modes = [False]
+    if parser_module._scanner is not None:
+        modes.append(True)
+    else:
+        print("⚠ Native scanner not built, checking the Python path only")
+    return modes
+
+
+def test_compact_matches_full():
+    """Test compact records read the same as full Breadcrumbs"""
+    print("\n=== Testing Compact Records Match Full ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        files = _write_files(tmp, 3, 4)
+        for native in _modes():
+            full = BreadcrumbParser(use_native=native)
+            full.parse_files(files, workers=1)
+            compact = BreadcrumbParser(use_native=native, compact=True)
+            compact.parse_files(files, workers=1)
+            
+            assert len(compact.breadcrumbs) == len(full.breadcrumbs) == 12
+            for c, f in zip(compact.breadcrumbs, full.breadcrumbs):
+                assert isinstance(c, CompactBreadcrumb)
+                assert c.to_breadcrumb() == f
+                assert c == f
+                assert c.ai_dependencies == f.ai_dependencies
+                assert c.ai_context == f.ai_context == {"gpu_family": "GCN", "vulkan_support": False}
+                assert c.raw_tags == f.raw_tags
+            print(f"✓ {'Native' if native else 'Python'} path matches full records")
+    
+    return True
+
+
+def test_lazy_context():
+    """Test AI_CONTEXT stays text until read"""
+    print("\n=== Testing Lazy AI_CONTEXT ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        path = Path(tmp) / "ctx.c"
+        path.write_text('// AI_PHASE: GOOD\n// AI_CONTEXT: {"a": [1, 2]}\nint a;\n'
+                        '// AI_PHASE: BAD\n// AI_CONTEXT: {"broken": }\nint b;\n')
+        for native in _modes():
+            good, bad = BreadcrumbParser(use_native=native, compact=True).parse_file(str(path))
+            assert isinstance(good._context, str)
+            assert good.ai_context == {"a": [1, 2]}
+            assert isinstance(good._context, dict)
+            assert bad.ai_context is None
+        print("✓ Context parsed on first access; invalid JSON reads as None")
+    
+    return True
+
+
+def test_interning():
+    """Test repeated values are shared between records and survive pickling"""
+    print("\n=== Testing Value Interning ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        files = _write_files(tmp, 2, 2)
+        for native in _modes():
+            parser = BreadcrumbParser(use_native=native, compact=True)
+            parser.parse_files(files, workers=1)
+            a, b = parser.breadcrumbs[0], parser.breadcrumbs[-1]
+            assert a.file_path != b.file_path
+            assert a.status is b.status and a.phase is b.phase
+            assert a._layout is b._layout
+            assert parser.breadcrumbs[0].file_path is parser.breadcrumbs[1].file_path
+            
+            c = pickle.loads(pickle.dumps(a))
+            assert c == a
+            assert c.status is a.status and c._layout is a._layout
+        print("✓ Values, paths and tag layouts are shared, also after a pickle roundtrip")
+    
+    return True
+
+
+def test_compact_memory():
+    """Test compact storage is much smaller than full Breadcrumbs"""
+    print("\n=== Testing Compact Memory Use ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        files = _write_files(tmp, 40, 25)
+        sizes = {}
+        for compact in (False, True):
+            tracemalloc.start()
+            parser = BreadcrumbParser(use_native=False, compact=compact)
+            parser.parse_files(files, workers=1)
+            sizes[compact] = tracemalloc.get_traced_memory()[0]
+            tracemalloc.stop()
+            assert len(parser.breadcrumbs) == 1000
+            del parser
+        
+        ratio = sizes[False] / sizes[True]
+        assert ratio > 5, ratio
+        print(f"✓ {sizes[False] // 1000} → {sizes[True] // 1000} bytes per breadcrumb ({ratio:.1f}x)")
+    
+    return True
+
+
+def run_all_tests():
+    """Run all compact breadcrumb tests"""
+    print("=" * 60)
+    print("  Compact Breadcrumb Test Suite")
+    print("=" * 60)
+    
+    tests = [
+        test_compact_matches_full,
+        test_lazy_context,
+        test_interning,
+        test_compact_memory,
+    ]
+    
+    passed = 0
+    failed = 0
+    
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+    
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+    
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
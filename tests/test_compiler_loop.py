@@ -0,0 +1,639 @@
+#!/usr/bin/env python3
+"""
+Test script for the compiler loop
+Runs CompilerLoop against small fake Makefiles to test streaming output parsing,
+and checks structured diagnostic extraction
+"""
+
+import os
+import sys
+import time
+import random
+import shutil
+import tempfile
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.compiler_loop.compiler import CompilerLoop
+from src.compiler_loop.error_tracker import ErrorTracker
+from src.compiler_loop.compile_log import CompileLog
+from src.compiler_loop.similarity_index import tokenize
+from src.compiler_loop import diagnostics
+from src.compiler_loop.diagnostics import extract_diagnostics
+
+
+FAKE_MAKEFILE = """
+all:
+\t@echo "Compiling a.c"
+\t@echo "a.c:10:5: error: 'foo' undeclared" >&2
+\t@echo "a.c:12:1: warning: unused variable 'x'" >&2
+\t@sleep 5
+\t@echo "b.c:3:1: error: expected ';'" >&2
+\t@false
+
+quick:
+\t@echo "Compiling c.c"
+\t@echo "c.c:1:1: warning: implicit declaration" >&2
+\t@echo "c.c:2:1: error: conflicting types" >&2
+\t@echo "c.c:3:1: Error: upper case" >&2
+\t@false
+
+clean_build:
+\t@echo "Nothing to do"
+
+# make itself dies from a signal
+killed:
+\t@kill -9 $$PPID
+
+# Each module is a recursive make with two parallel jobs
+mod_%:
+\t@$(MAKE) --no-print-directory job_$*_1 job_$*_2
+
+job_%:
+\t@echo start >> $(CURDIR)/jobs.log; sleep 0.3; echo end >> $(CURDIR)/jobs.log
+
+# Holds a jobserver token for its second job until killed
+hog:
+\t@$(MAKE) --no-print-directory hog_1 hog_2
+
+hog_%:
+\t@sleep 30
+"""
+
+
+GCC_LOG = """make[2]: Entering directory '/aros/workbench/hidds/vmwaresvga'
+In file included from vmwaresvga_hardware.c:12:
+vmwaresvga_hardware.h:40:5: error: unknown type name 'ULONG'
+   40 |     ULONG fifo_min;
+      |     ^~~~~
+vmwaresvga_hardware.c: In function 'initVMWareSVGAHW':
+vmwaresvga_hardware.c:88:9: warning: unused variable 'id' [-Wunused-variable]
+vmwaresvga_hardware.c:91:12: error: implicit declaration of function 'vmwareReadReg' [-Werror=implicit-function-declaration]
+vmwaresvga_hardware.h:12:6: note: previous declaration of 'vmwareReadReg' was here
+vmwaresvga_hardware.c:120: error: expected ';' before '}' token
+ld: error: undefined symbol: VMWareSVGA_Init
+collect2: error: ld returned 1 exit status
+make[2]: *** [mmakefile:45: vmwaresvga_hardware.o] Error 1
+"""
+
+# Lines mixed into generated logs for native/Python comparison
+LOG_LINES = GCC_LOG.split('\n') + [
+    '', ':', 'ERROR: upper', 'Warning:x', 'a.c:1:2: note: n', 'x NOTE: y',
+    '   from b.h:3,', 'from', 'In instantiation of foo', 'src.c:4:1:   required from here',
+    ': At top level:', 'caf\u00e9.c:3:1: error: caf\u00e9', 'no colon here', 'x:y:z',
+    '\tIn file included from z.h:1:', 'a.c:1:1: error:', 'b.c:2:3: warning: w [-Wall]  ',
+    'd.c:9:9: fatal error: x.h: No such file or directory', 'strange: error:\r',
+]
+
+
+def _make_loop(temp_dir: str) -> CompilerLoop:
+    aros_path = Path(temp_dir) / 'aros-src'
+    aros_path.mkdir()
+    (aros_path / 'Makefile').write_text(FAKE_MAKEFILE)
+    return CompilerLoop(aros_path=str(aros_path), log_path=str(Path(temp_dir) / 'logs'))
+
+
+def _have_make() -> bool:
+    if shutil.which('make') is None:
+        print("⚠ make not available, skipping")
+        return False
+    return True
+
+
+def test_streaming_matches_buffered():
+    """Test that streaming and buffered modes parse the same diagnostics"""
+    print("\n=== Testing Streaming vs Buffered Parsing ===")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        
+        buffered = loop.compile_aros('quick')
+        streamed = loop.compile_aros('quick', stream=True)
+        
+        assert not buffered['success'] and not streamed['success']
+        assert streamed['errors'] == buffered['errors']
+        assert streamed['warnings'] == buffered['warnings']
+        assert len(streamed['errors']) == 2
+        assert 'Compiling c.c' in streamed['stdout']
+        print(f"✓ Both modes found {len(streamed['errors'])} errors, {len(streamed['warnings'])} warnings")
+        
+        ok = loop.compile_aros('clean_build', stream=True)
+        assert ok['success'] and ok['errors'] == []
+        print("✓ Successful streaming build reported")
+        
+        assert len(loop.compile_history) == 3
+        return True
+
+
+def test_streaming_stops_at_max_errors():
+    """Test that the build is killed once max_errors is reached"""
+    print("\n=== Testing Early Stop on Max Errors ===")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        seen = []
+        
+        start = time.time()
+        result = loop.compile_aros(stream=True, max_errors=1, on_diagnostic=seen.append)
+        elapsed = time.time() - start
+        
+        assert elapsed < 4, f"Build should stop early, took {elapsed:.1f}s"
+        assert result['stopped_early']
+        assert not result['success']
+        assert len(result['errors']) == 1
+        assert "'foo' undeclared" in result['errors'][0]['message']
+        assert seen and seen[0] == result['errors'][0]
+        print(f"✓ Stopped after first error in {elapsed:.2f}s")
+        return True
+
+
+def test_streaming_keeps_partial_results_on_timeout():
+    """Test that a timeout keeps diagnostics parsed so far"""
+    print("\n=== Testing Partial Results on Timeout ===")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        
+        result = loop.compile_aros(timeout=1, stream=True)
+        
+        assert result['timed_out']
+        assert result['duration'] < 4
+        assert len(result['errors']) == 1
+        assert len(result['warnings']) == 1
+        assert 'Compilation timeout after 1 seconds' in result['stderr']
+        assert loop.get_latest_errors() == result['errors']
+        print(f"✓ Kept {len(result['errors'])} error and {len(result['warnings'])} warning after timeout")
+        return True
+
+
+def test_compile_targets_shares_job_slots():
+    """Test that concurrent targets share one jobserver budget"""
+    print("\n=== Testing Parallel Multi-Target Compile ===")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        targets = ['mod_a', 'mod_b', 'mod_c', 'mod_d']
+        
+        start = time.time()
+        results = loop.compile_targets(targets, jobs=3)
+        elapsed = time.time() - start
+        
+        assert [r['target'] for r in results] == targets
+        assert all(r['success'] for r in results), [r['stderr'] for r in results]
+        assert len(loop.compile_history) == 4
+        assert sorted(r['iteration'] for r in results) == [1, 2, 3, 4]
+        
+        # 8 jobs of 0.3s: serial would take 2.4s
+        running = peak = 0
+        for line in (loop.aros_path / 'jobs.log').read_text().split():
+            running += 1 if line == 'start' else -1
+            peak = max(peak, running)
+        assert peak <= 3, f"Job budget exceeded: {peak} concurrent jobs"
+        assert peak >= 2 and elapsed < 2.0, f"Targets did not run in parallel ({elapsed:.1f}s)"
+        
+        print(f"✓ {len(targets)} targets in {elapsed:.2f}s, peak {peak} of 3 job slots")
+        return True
+
+
+def test_jobserver_refills_after_kill():
+    """Test that tokens lost with a killed make are put back"""
+    print("\n=== Testing Jobserver Top-Up After Kill ===")
+    
+    from src.compiler_loop.compiler import MakeJobserver
+    
+    jobserver = MakeJobserver(3)
+    token = jobserver.acquire()
+    # A job of the build takes two more tokens and is killed with them
+    os.read(jobserver.read_fd, 2)
+    jobserver.release(token, killed=True)
+    tokens = [jobserver.acquire() for _ in range(3)]
+    assert len(tokens) == 3
+    for token in tokens:
+        jobserver.release(token)
+    jobserver.close()
+    print("✓ Pipe topped back up to 3 tokens once idle")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        targets = ['hog', 'mod_a', 'mod_b', 'mod_c']
+        results = loop.compile_targets(targets, jobs=2, timeout=1)
+        assert results[0]['timed_out'] and all(r['success'] for r in results[1:]), \
+            [r['stderr'] for r in results]
+        
+        running = peak = 0
+        for line in (loop.aros_path / 'jobs.log').read_text().split():
+            running += 1 if line == 'start' else -1
+            peak = max(peak, running)
+        assert peak == 2, f"Builds after the kill ran {peak} jobs at once, expected 2"
+        print("✓ Builds after a timed-out make still get both job slots")
+    
+    return True
+
+
+def test_compile_cache_skips_identical_builds():
+    """Test that identical target/source/headers/flags reuse the stored result"""
+    print("\n=== Testing Content-Addressed Compile Cache ===")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        (loop.aros_path / 'gfx.h').write_text('#define GFX 1\n')
+        jobs_log = loop.aros_path / 'jobs.log'
+        
+        def builds():
+            return jobs_log.read_text().split().count('start') if jobs_log.exists() else 0
+        
+        first = loop.compile_cached('job_gfx', source='int gfx;', headers=['gfx.h'], flags=['-O2'])
+        second = loop.compile_cached('job_gfx', source='int gfx;', headers=['gfx.h'], flags=['-O2'])
+        assert not first['cached'] and second['cached']
+        assert second['success'] == first['success'] and second['errors'] == first['errors']
+        assert second['iteration'] == first['iteration'] + 1
+        assert builds() == 1, "Second build should not run make"
+        print("✓ Identical inputs reuse the cached result")
+        
+        # Any input change is a miss
+        loop.compile_cached('job_gfx', source='int gfx = 1;', headers=['gfx.h'], flags=['-O2'])
+        loop.compile_cached('job_gfx', source='int gfx;', headers=['gfx.h'], flags=['-O0'])
+        (loop.aros_path / 'gfx.h').write_text('#define GFX 2\n')
+        loop.compile_cached('job_gfx', source='int gfx;', headers=['gfx.h'], flags=['-O2'])
+        assert builds() == 4
+        print("✓ Source, flag and header changes rebuild")
+        
+        # Failed builds are cached with their errors, and persist on disk
+        failed = loop.compile_cached('quick', source='bad code')
+        again = CompilerLoop(str(loop.aros_path), str(loop.log_path)).compile_cached('quick', source='bad code')
+        assert again['cached'] and again['errors'] == failed['errors'] and len(again['errors']) == 2
+        assert loop.cache.get_statistics()['hits'] == 1
+        print("✓ Errors are cached and survive a restart")
+        
+        previous = os.environ.get('CFLAGS')
+        os.environ['CFLAGS'] = '-O3 -DGFX_DEBUG'
+        try:
+            flagged = loop.compile_cached('job_gfx', source='int gfx;', headers=['gfx.h'], flags=['-O2'])
+        finally:
+            if previous is None:
+                del os.environ['CFLAGS']
+            else:
+                os.environ['CFLAGS'] = previous
+        assert not flagged['cached'] and builds() == 5
+        print("✓ CFLAGS from the environment are part of the key")
+        
+        # Verdicts that come from the environment are not stored
+        killed = loop.compile_cached('killed', source='int k;')
+        assert killed['signal'] == 9 and not killed['success']
+        assert not loop.compile_cached('killed', source='int k;')['cached']
+        missing = CompilerLoop(str(Path(temp_dir) / 'no-such-tree'), str(loop.log_path))
+        failed = missing.compile_cached('quick', source='int m;')
+        assert failed['launch_failed'] and not missing.compile_cached('quick', source='int m;')['cached']
+        loop.cache.put('simulated', {'success': True, 'errors': [], 'simulated': True})
+        assert loop.cache.get('simulated') is None
+        print("✓ Builds killed by a signal or never started are not cached")
+        
+        code = '#include <exec/types.h>\n  # include "gfx.h"\n#include "gfx.h"\nint x;\n'
+        assert loop.cache.included_headers(code) == ['exec/types.h', 'gfx.h']
+        print("✓ Included headers found for the cache key")
+        return True
+
+
+def _fake_result(iteration: int, success: bool = False) -> dict:
+    return {
+        'iteration': iteration,
+        'target': 'quick',
+        'timestamp': '2026-01-01T12:00:00',
+        'duration': 0.5,
+        'success': success,
+        'stdout': 'building\n' * 20,
+        'stderr': '' if success else f'gfx.c:{iteration}:1: error: bad\n',
+        'errors': [] if success else [{'type': 'error', 'message': f'gfx.c:{iteration}:1: error: bad'}],
+        'warnings': []
+    }
+
+
+def test_compile_log_segments():
+    """Test the segmented binary compile log"""
+    print("\n=== Testing Binary Compile Log ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        log = CompileLog(temp_dir, segment_bytes=4096)
+        log.INDEX_INTERVAL = 8
+        for i in range(1, 101):
+            log.append(_fake_result(i, success=(i % 4 == 0)))
+        
+        segments = sorted(Path(temp_dir).glob('compile_log.*.seg'))
+        assert len(segments) > 2, "Small segments should roll over"
+        assert log.get(37) == _fake_result(37)
+        assert log.get(1) == _fake_result(1) and log.get(500) is None
+        assert [r['iteration'] for r in log.tail(3)] == [100, 99, 98]
+        print(f"✓ {len(segments)} segments, lookups by iteration through sealed indexes")
+        
+        summaries = list(log.iter_summaries())
+        assert [s['iteration'] for s in summaries] == list(range(1, 101))
+        assert summaries[3]['success'] and summaries[0]['error_count'] == 1
+        assert log.get_summary() == {
+            'total_iterations': 100, 'successful_compiles': 25, 'failed_compiles': 75,
+            'total_errors': 75, 'total_warnings': 0
+        }
+        print("✓ Summary scan without decoding payloads")
+        
+        # A second writer on the same directory continues the same segment
+        other = CompileLog(temp_dir, segment_bytes=4096)
+        other.append(_fake_result(101))
+        log.append(_fake_result(102))
+        assert [r['iteration'] for r in CompileLog(temp_dir).tail(3)] == [102, 101, 100]
+        
+        # A torn write at the end is dropped on the next append
+        active = sorted(Path(temp_dir).glob('compile_log.*.seg'))[-1]
+        with open(active, 'ab') as f:
+            f.write(b'\x40\x00\x00\x00garbage')
+        CompileLog(temp_dir).append(_fake_result(103))
+        assert [s['iteration'] for s in CompileLog(temp_dir).iter_summaries()][-4:] == [100, 101, 102, 103]
+        print("✓ Multiple writers and torn tail recovery")
+    
+    if not _have_make():
+        return True
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        loop = _make_loop(temp_dir)
+        result = loop.compile_aros('quick')
+        assert not list(loop.log_path.glob('compile_*.json'))
+        assert loop.compile_log.get(result['iteration'])['errors'] == result['errors']
+        print("✓ CompilerLoop writes to the compile log")
+    return True
+
+
+def test_structured_diagnostics():
+    """Test extraction of structured GCC/Clang diagnostics"""
+    print("\n=== Testing Structured Diagnostic Extraction ===")
+    
+    errors, warnings = extract_diagnostics(GCC_LOG)
+    
+    assert [e['file'] for e in errors] == [
+        'vmwaresvga_hardware.h', 'vmwaresvga_hardware.c', 'vmwaresvga_hardware.c', None, None
+    ]
+    first = errors[0]
+    assert (first['line'], first['column'], first['severity']) == (40, 5, 'error')
+    assert first['text'] == "unknown type name 'ULONG'"
+    assert first['context'] == ['In file included from vmwaresvga_hardware.c:12:']
+    assert first['message'] == "vmwaresvga_hardware.h:40:5: error: unknown type name 'ULONG'"
+    print("✓ File, line, column, severity and include context")
+    
+    assert len(warnings) == 1
+    assert warnings[0]['flag'] == '-Wunused-variable'
+    assert warnings[0]['context'] == ["vmwaresvga_hardware.c: In function 'initVMWareSVGAHW':"]
+    assert errors[1]['flag'] == '-Werror=implicit-function-declaration'
+    assert errors[1]['context'] == []
+    assert errors[1]['notes'] == ["vmwaresvga_hardware.h:12:6: note: previous declaration of 'vmwareReadReg' was here"]
+    assert errors[2]['column'] is None
+    print("✓ Warning flags, function context and notes")
+    
+    assert errors[3]['message'] == 'ld: error: undefined symbol: VMWareSVGA_Init'
+    print("✓ Unstructured linker errors kept")
+    return True
+
+
+def test_native_extractor_matches_python():
+    """Test the native candidate scanner against the Python fallback"""
+    print("\n=== Testing Native Diagnostic Scanner ===")
+    
+    if diagnostics._diagnostics is None:
+        print("⚠ Native diagnostic scanner not built, skipping")
+        return True
+    
+    rng = random.Random(42)
+    logs = 300
+    
+    for _ in range(logs):
+        log = '\n'.join(rng.choice(LOG_LINES) for _ in range(rng.randint(0, 80)))
+        if rng.random() < 0.2:
+            log += '\n' * rng.randint(1, 3)
+        assert extract_diagnostics(log, use_native=True) == extract_diagnostics(log, use_native=False), \
+            f"Mismatch for {log!r}"
+    
+    # Long lines cross SIMD block boundaries
+    long_line = 'x' * 37 + ': ' + 'y' * 50 + ' Error: late' + 'z' * 20
+    assert extract_diagnostics(long_line, use_native=True) == extract_diagnostics(long_line, use_native=False)
+    
+    print(f"✓ {logs} generated logs extract identically")
+    return True
+
+
+def test_error_tracker_structured_hash():
+    """Test that structured errors are tracked independent of line shifts"""
+    print("\n=== Testing Structured Error Tracking ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        tracker = ErrorTracker(log_path=temp_dir)
+        
+        before, _ = extract_diagnostics("a.c:10:5: error: 'foo' undeclared")
+        after, _ = extract_diagnostics("a.c:14:5: error: 'foo' undeclared")
+        other, _ = extract_diagnostics("b.c:14:5: error: 'foo' undeclared")
+        
+        hash1 = tracker.track_error(before[0], {'iteration': 1})
+        hash2 = tracker.track_error(after[0], {'iteration': 2})
+        hash3 = tracker.track_error(other[0], {'iteration': 2})
+        
+        assert hash1 == hash2 and hash1 != hash3
+        entry = tracker.error_database[hash1]
+        assert entry['occurrences'] == 2
+        assert entry['file'] == 'a.c'
+        assert [c['line'] for c in entry['contexts']] == [10, 14]
+        
+        # Raw strings still hash as before
+        assert tracker.track_error('plain error', {}) == tracker.track_error('plain error', {})
+        print("✓ Same diagnostic after a line shift shares one entry")
+        return True
+
+
+def test_error_tracker_write_ahead_log():
+    """Test WAL replay, compaction and torn-write recovery"""
+    print("\n=== Testing Error Tracker Write-Ahead Log ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        tracker = ErrorTracker(log_path=temp_dir)
+        hashes = [tracker.track_error(f'gfx.c: error: bad {i % 50}', {'iteration': i}) for i in range(500)]
+        tracker.mark_resolved(hashes[0], 'Fixed it', 'abc123')
+        assert not tracker.db_file.exists(), "Small WAL should not be compacted"
+        
+        reloaded = ErrorTracker(log_path=temp_dir)
+        assert reloaded.error_database == tracker.error_database
+        assert reloaded.error_database[hashes[0]]['occurrences'] == 10
+        assert reloaded.error_database[hashes[0]]['status'] == 'resolved'
+        print("✓ Database rebuilt from the WAL")
+        
+        # Compaction folds the WAL into the snapshot
+        stale_wal = tracker.wal_file.read_bytes()
+        tracker.COMPACT_MIN_BYTES = 0
+        tracker.track_error('gfx.c: error: bad 1', {'iteration': 500})
+        assert tracker.db_file.exists() and tracker.wal_file.stat().st_size == 0
+        tracker.track_error('gfx.c: error: bad 2', {'iteration': 501})
+        tracker.close()
+        compacted = ErrorTracker(log_path=temp_dir)
+        assert compacted.error_database == tracker.error_database
+        assert '_wal_seq' not in compacted.error_database
+        print("✓ Compacted snapshot plus WAL replays identically")
+        
+        # WAL records already in the snapshot (crash before truncation) are
+        # not applied twice
+        live_wal = tracker.wal_file.read_bytes()
+        tracker.wal_file.write_bytes(stale_wal + live_wal)
+        assert ErrorTracker(log_path=temp_dir).error_database == tracker.error_database
+        expected = tracker.error_database[hashes[3]]['occurrences']
+        
+        # A torn final line is dropped and later records still load
+        with open(tracker.wal_file, 'ab') as f:
+            f.write(b'{"op": "track", "ha')
+        recovered = ErrorTracker(log_path=temp_dir)
+        recovered.track_error('gfx.c: error: bad 3', {'iteration': 503})
+        recovered.close()
+        assert ErrorTracker(log_path=temp_dir).error_database[hashes[3]]['occurrences'] == expected + 1
+        print("✓ Duplicate and torn WAL records are ignored")
+        return True
+
+
+def test_error_tracker_batch():
+    """Test tracking a whole compile result as one batch"""
+    print("\n=== Testing Batched Error Tracking ===")
+    
+    log = "\n".join([
+        "a.c:10:5: error: 'foo' undeclared",
+        "a.c:22:5: error: 'foo' undeclared",
+        "b.c:3:1: error: expected ';' before '}' token",
+        "ld: error: undefined symbol: bar"
+    ])
+    errors, _ = extract_diagnostics(log)
+    
+    with tempfile.TemporaryDirectory() as batch_dir, tempfile.TemporaryDirectory() as single_dir:
+        batch = ErrorTracker(log_path=batch_dir)
+        single = ErrorTracker(log_path=single_dir)
+        
+        hashes = batch.track_errors({'success': False, 'errors': errors}, {'iteration': 1})
+        assert hashes == [single.track_error(e, {'iteration': 1}) for e in errors]
+        assert hashes[0] == hashes[1] and len(set(hashes)) == 3
+        
+        entry = batch.error_database[hashes[0]]
+        assert entry['occurrences'] == 2 and entry['file'] == 'a.c'
+        assert [c['line'] for c in entry['contexts']] == [10, 22]
+        assert len({c['timestamp'] for e in batch.error_database.values() for c in e['contexts']}) == 1
+        print("✓ Batch matches per-error tracking, with one timestamp")
+        
+        assert len(batch.wal_file.read_bytes().splitlines()) == 1
+        assert batch.track_errors([], {}) == []
+        batch.track_errors(['plain error', 'plain error'], {'iteration': 2})
+        batch.close()
+        reloaded = ErrorTracker(log_path=batch_dir)
+        assert reloaded.error_database == batch.error_database
+        assert reloaded.get_statistics()['total_occurrences'] == 6
+        print("✓ One WAL record per batch, replayed on load")
+        return True
+
+
+def test_similarity_index_matches_scan():
+    """Test the similarity index against a full scan of the database"""
+    print("\n=== Testing Error Similarity Index ===")
+    
+    rng = random.Random(7)
+    kinds = ["undefined reference to", "implicit declaration of function",
+             "incompatible types in assignment to", "expected ';' before", "unknown type name"]
+    words = [f'w{i}' for i in range(40)]
+    
+    def message():
+        extra = ' '.join(rng.sample(words, rng.randrange(0, 4)))
+        return f"{rng.choice(['gfx.c', 'src/os/exec.c'])}:{rng.randrange(99)}: error: {rng.choice(kinds)} '{rng.choice(words)}' {extra}"
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        tracker = ErrorTracker(log_path=temp_dir)
+        tracker.find_similar_errors('warm up the index')
+        tracker.track_errors([message() for _ in range(600)], {})
+        
+        for _ in range(200):
+            query = message() if rng.random() < 0.5 else f"{message()} {rng.choice(words)}x"
+            query_words = tokenize(query)
+            expected = []
+            for error_hash, entry in tracker.error_database.items():
+                stored = tokenize(entry['message'])
+                similarity = len(query_words & stored) / max(len(query_words), len(stored))
+                if similarity > 0.3:
+                    expected.append((error_hash, similarity))
+            expected.sort(key=lambda x: x[1], reverse=True)
+            
+            limit = rng.choice([1, 5, 50])
+            found = [(e['hash'], e['similarity']) for e in tracker.find_similar_errors(query, limit)]
+            assert found == expected[:limit], query
+        print("✓ Top-k results identical to a full scan")
+        
+        # Identifiers, paths and line numbers don't hide the match
+        similar = tracker.find_similar_errors("drivers/gfx/vmware.c:812: error: unknown type name 'ULONG'")
+        assert similar and similar[0]['similarity'] == 1.0
+        assert ErrorTracker(log_path=temp_dir).find_similar_errors(similar[0]['message'])[0]['similarity'] == 1.0
+        print("✓ Normalized paths/identifiers match across files")
+        return True
+
+
+def run_all_tests():
+    """Run all compiler loop tests"""
+    print("=" * 60)
+    print("  Compiler Loop Test Suite")
+    print("=" * 60)
+    
+    tests = [
+        test_streaming_matches_buffered,
+        test_streaming_stops_at_max_errors,
+        test_streaming_keeps_partial_results_on_timeout,
+        test_compile_targets_shares_job_slots,
+        test_jobserver_refills_after_kill,
+        test_compile_cache_skips_identical_builds,
+        test_compile_log_segments,
+        test_structured_diagnostics,
+        test_native_extractor_matches_python,
+        test_error_tracker_structured_hash,
+        test_error_tracker_write_ahead_log,
+        test_error_tracker_batch,
+        test_similarity_index_matches_scan,
+    ]
+    
+    passed = 0
+    failed = 0
+    
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+    
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+    
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
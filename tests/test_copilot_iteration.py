@@ -189,6 +189,22 @@ def test_copilot_iteration_structure():
         assert len(tasks) > 0  # Should create default task
         print(f"✓ Task finding works (found {len(tasks)} tasks)")
         
+        # A cold index over the project tree is parsed by every core
+        (aros_path / 'test').mkdir()
+        (aros_path / 'test' / 'a.c').write_text('// AI_PHASE: A\n// AI_STATUS: PARTIAL\n')
+        calls = []
+        refresh_from_git = iteration.breadcrumb_index.refresh_from_git
+        
+        def recording(root, **kwargs):
+            calls.append(kwargs.get('workers'))
+            return refresh_from_git(root, **kwargs)
+        
+        iteration.breadcrumb_index.refresh_from_git = recording
+        tasks = iteration._find_incomplete_tasks()
+        assert calls == [os.cpu_count()], calls
+        assert [t['phase'] for t in tasks] == ['A']
+        print("✓ Index refresh uses one worker per core")
+        
         return True
 
 
@@ -220,6 +236,55 @@ def test_streaming_output():
     return True
 
 
+def test_incremental_detokenizer():
+    """Test streamed text matches a full decode at bounded decode cost"""
+    print("\n=== Testing Incremental Detokenizer ===")
+    
+    from src.streaming_output import _IncrementalDetokenizer
+    
+    class ByteTokenizer:
+        """One token per UTF-8 byte; counts decoded tokens"""
+        def __init__(self):
+            self.decoded = 0
+        
+        def decode(self, ids):
+            self.decoded += len(ids)
+            return bytes(ids).decode('utf-8', errors='replace')
+    
+    class PieceTokenizer:
+        """SentencePiece-like: '_' marks a space, dropped at the start"""
+        pieces = ['_int', '_x', '_=', '_1', ';', '\n', '_return']
+        
+        def decode(self, ids):
+            return ''.join(self.pieces[i] for i in ids).replace('_', ' ').lstrip(' ')
+    
+    tokenizer = ByteTokenizer()
+    text = 'int x = 0; /* ünïcødé → ok */ ' * 100
+    ids = list(text.encode('utf-8'))
+    assert b'\n' not in bytes(ids)
+    
+    detokenizer = _IncrementalDetokenizer(tokenizer)
+    chunks = [detokenizer.push(ids[i:i + 3]) for i in range(0, len(ids), 3)]
+    chunks.append(detokenizer.push([], final=True))
+    assert ''.join(chunks) == text
+    assert all('\ufffd' not in chunk for chunk in chunks)
+    print("✓ Multi-byte characters split across pushes come out whole")
+    
+    # Each push decodes the previous chunk and the current one; a full
+    # re-decode per push would be ~len(ids) ** 2 / 6
+    assert tokenizer.decoded < 10 * len(ids), tokenizer.decoded
+    print(f"✓ {len(ids)} tokens without a newline took {tokenizer.decoded} decoded tokens")
+    
+    tokenizer = PieceTokenizer()
+    ids = [0, 1, 2, 3, 4, 5, 6, 1, 4]
+    detokenizer = _IncrementalDetokenizer(tokenizer)
+    streamed = ''.join(detokenizer.push([i]) for i in ids) + detokenizer.push([], final=True)
+    assert streamed == tokenizer.decode(ids), repr(streamed)
+    print("✓ Leading spaces kept on single-token pushes")
+    
+    return True
+
+
 def test_reasoning_tracker():
     """Test reasoning tracker integration"""
     print("\n=== Testing Reasoning Tracker ===")
@@ -269,6 +334,60 @@ def test_reasoning_tracker():
         return True
 
 
+def test_reasoning_store_queries():
+    """Test the columnar reasoning store queries and aggregates"""
+    print("\n=== Testing Reasoning Store ===")
+    
+    from src.compiler_loop.reasoning_tracker import ReasoningTracker
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        # An entry in the old one-file-per-entry layout is imported once
+        legacy = {'task_id': 'old_task', 'phase': 'analyzing', 'patterns_identified': ['SHADER_V2'],
+                  'breadcrumbs_consulted': [], 'success': True, 'confidence': 0.5}
+        with open(Path(temp_dir) / 'reasoning_old_task_1.json', 'w') as f:
+            json.dump(legacy, f)
+        
+        tracker = ReasoningTracker(log_path=temp_dir)
+        runs = [
+            ('gfx_init', 'analyzing', ['SHADER_V2', 'NIR'], True),
+            ('gfx_init', 'implementing', ['SHADER_V2'], False),
+            ('exec_lib', 'analyzing', ['NIR'], False),
+            ('exec_lib', 'implementing', [], True),
+        ]
+        for task_id, phase, patterns, success in runs:
+            reasoning_id = tracker.start_reasoning(task_id, phase, ['AI_PHASE: GFX'])
+            for pattern in patterns:
+                tracker.add_pattern(pattern)
+            tracker.set_decision('implementation', 'approach', 0.8)
+            tracker.complete_reasoning(reasoning_id, success=success, iterations=2)
+        
+        assert not list(Path(temp_dir).glob('reasoning_gfx_init_*.json'))
+        assert len(tracker.query_by_phase('analyzing')) == 3
+        assert [e['task_id'] for e in tracker.query_by_pattern('SHADER_V2')] == ['old_task', 'gfx_init', 'gfx_init']
+        assert [e['phase'] for e in tracker.query_by_task('exec_lib')] == ['analyzing', 'implementing']
+        assert [e['patterns_identified'] for e in tracker.get_failed_reasoning_patterns()] == [['SHADER_V2'], ['NIR']]
+        assert tracker.get_recent_reasoning(limit=2)[0]['task_id'] == 'exec_lib'
+        print("✓ Phase, pattern, task and outcome queries")
+        
+        patterns = tracker.get_pattern_statistics()
+        assert patterns['SHADER_V2'] == {'uses': 3, 'success_rate': 2 / 3}
+        assert patterns['NIR'] == {'uses': 2, 'success_rate': 0.5}
+        assert tracker.get_breadcrumb_effectiveness()['AI_PHASE: GFX'] == {'uses': 4, 'success_rate': 0.5}
+        phases = tracker.get_phase_statistics()
+        assert phases['implementing']['entries'] == 2 and phases['implementing']['mean_iterations'] == 2
+        print("✓ Per-pattern, per-breadcrumb and per-phase aggregates")
+        
+        # A second tracker on the same directory sees new entries
+        reader = ReasoningTracker(log_path=temp_dir)
+        reasoning_id = tracker.start_reasoning('late_task', 'evaluating', [])
+        tracker.complete_reasoning(reasoning_id, success=True)
+        assert [e['task_id'] for e in reader.query_by_phase('evaluating')] == ['late_task']
+        assert len(reader.store) == 6
+        print("✓ Entries from another tracker picked up without reopening files")
+        
+        return True
+
+
 def test_iteration_context():
     """Test iteration context management"""
     print("\n=== Testing Iteration Context ===")
@@ -838,6 +957,108 @@ def test_analytics():
         return True
 
 
+def test_streaming_analytics():
+    """Test streamed analytics aggregates against full-history results"""
+    print("\n=== Testing Streaming Analytics ===")
+    
+    import math
+    import random
+    from src.copilot_iteration import CopilotStyleIteration
+    from src.iteration_analytics import IterationAnalytics, IterationAggregates, QuantileSketch
+    
+    rng = random.Random(5)
+    errors = ['syntax error near }', 'undefined reference to foo', 'type mismatch', 'segfault', 'linker']
+    history = []
+    for i in range(300):
+        success = rng.random() < 0.6
+        history.append({
+            'iteration': i + 1,
+            'phase': rng.choice(['GPU', 'MEMORY', 'NETWORK']),
+            'success': success,
+            'retry_count': rng.randint(0, 3),
+            'total_time': rng.uniform(1, 90),
+            'timings': {'generation': rng.uniform(1, 20), 'compilation': rng.uniform(1, 30)},
+            'compilation': {'errors': [] if success else rng.sample(errors, 2)}
+        })
+    analytics = IterationAnalytics(history, {})
+    
+    summary = analytics.get_performance_summary()
+    assert summary['total_iterations'] == 300
+    assert math.isclose(summary['success_rate'], sum(h['success'] for h in history) / 300)
+    assert math.isclose(summary['average_time'], sum(h['total_time'] for h in history) / 300)
+    assert summary['recent_success_rate'] == sum(h['success'] for h in history[-10:]) / 10
+    compile_times = [h['timings']['compilation'] for h in history]
+    compilation = summary['phase_timings']['compilation']
+    assert compilation['min'] == min(compile_times) and compilation['max'] == max(compile_times)
+    assert math.isclose(compilation['total'], sum(compile_times))
+    print("✓ Summary matches the full-history computation")
+    
+    series = analytics.get_time_series_analysis()
+    assert series['iterations'] == list(range(1, 301))
+    assert series['success'] == [1 if h['success'] else 0 for h in history]
+    for i, value in enumerate(series['moving_avg_success']):
+        window = series['success'][max(0, i - 2):i + 1]
+        assert math.isclose(value, sum(window) / len(window))
+    print("✓ Time series and moving average match")
+    
+    failures = [h for h in history if not h['success']]
+    error_stats = analytics.get_error_analysis()
+    assert error_stats['total_failures'] == len(failures)
+    assert sum(error_stats['error_types'].values()) == 2 * len(failures)
+    assert error_stats['error_types']['runtime_error'] == sum('segfault' in h['compilation']['errors'] for h in failures)
+    worst = error_stats['phases_with_most_errors'][0]
+    assert worst['count'] == max(sum(h['phase'] == p for h in failures) for p in ('GPU', 'MEMORY', 'NETWORK'))
+    print("✓ Error analysis matches")
+    
+    values = [rng.lognormvariate(1, 1.5) for _ in range(20000)]
+    sketch, left, right = QuantileSketch(), QuantileSketch(), QuantileSketch()
+    for i, value in enumerate(values):
+        sketch.add(value)
+        (left if i % 2 else right).add(value)
+    left.merge(right)
+    ordered = sorted(values)
+    for q in (0.5, 0.9, 0.99, 0.999):
+        exact = ordered[int(q * (len(values) - 1))]
+        assert abs(sketch.quantile(q) - exact) <= 0.01 * exact * 1.0001, (q, sketch.quantile(q), exact)
+        assert left.quantile(q) == sketch.quantile(q)
+    assert len(sketch.buckets) < 1000
+    restored = QuantileSketch.from_dict(json.loads(json.dumps(sketch.to_dict())))
+    assert restored.quantile(0.99) == sketch.quantile(0.99)
+    print(f"✓ Sketch quantiles within 1% using {len(sketch.buckets)} buckets; merge is exact")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        aros_path = Path(temp_dir) / 'aros-src'
+        aros_path.mkdir()
+        iteration = CopilotStyleIteration(
+            aros_path=str(aros_path),
+            project_name='test',
+            log_path=str(Path(temp_dir) / 'logs')
+        )
+        for entry in history[:50]:
+            iteration._add_to_history(entry)
+        assert iteration.get_analytics().get_performance_summary()['total_iterations'] == 50
+        print("✓ _add_to_history feeds the aggregates beyond the in-memory history")
+        
+        iteration.save_iteration_state()
+        resumed = CopilotStyleIteration(
+            aros_path=str(aros_path),
+            project_name='test',
+            log_path=str(Path(temp_dir) / 'logs')
+        )
+        assert resumed.load_iteration_state()
+        assert resumed.get_analytics().get_performance_summary() == iteration.get_analytics().get_performance_summary()
+        print("✓ Aggregates survive save/load of iteration state")
+        
+        merged = IterationAggregates.from_history(history[:150])
+        merged.merge(IterationAggregates.from_history(history[150:]))
+        whole = IterationAggregates.from_history(history)
+        assert merged.error_types == whole.error_types
+        assert merged.durations.quantile(0.9) == whole.durations.quantile(0.9)
+        print("✓ Aggregates from two streams merge into the combined result")
+    
+    return True
+
+
 def run_all_tests():
     """Run all tests"""
     print("\n" + "="*60)
@@ -850,7 +1071,9 @@ def run_all_tests():
         ("File Exploration", test_file_exploration),
         ("Copilot Iteration", test_copilot_iteration_structure),
         ("Streaming Output", test_streaming_output),
+        ("Incremental Detokenizer", test_incremental_detokenizer),
         ("Reasoning Tracker", test_reasoning_tracker),
+        ("Reasoning Store", test_reasoning_store_queries),
         ("Iteration Context", test_iteration_context),
         ("Performance Tracking", test_performance_tracking),
         ("Error Similarity", test_error_similarity),
@@ -862,6 +1085,7 @@ def run_all_tests():
         ("Checkpoint Diff", test_checkpoint_diff),
         ("Pattern Export/Import", test_pattern_export_import),
         ("Analytics", test_analytics),
+        ("Streaming Analytics", test_streaming_analytics),
     ]
     
     passed = 0
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+Tests for the shared batched inference server
+"""
+
+import os
+import sys
+import time
+import threading
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.local_models import LocalModelLoader
+from src.local_models.inference_server import (
+    InferenceServer, InferenceClient, RemoteCodegenModel, RemoteLLM, BatchingWorker
+)
+
+
+class FakeBackend:
+    """Echoes prompts; slow enough that concurrent requests pile up"""
+
+    def __init__(self, delay: float = 0.05):
+        self.delay = delay
+        self.batches = []
+
+    def __call__(self, requests):
+        self.batches.append(len(requests))
+        time.sleep(self.delay)
+        return [
+            [f"{params['prompt']}|{params['temperature']}|{n}" for n in range(params['num_return_sequences'])]
+            for params in requests
+        ]
+
+    def count_tokens(self, text):
+        return len(text.split())
+
+
+def _start_server(**kwargs):
+    backends = {'codegen': FakeBackend(), 'llm': FakeBackend()}
+    server = InferenceServer(backends, address=('127.0.0.1', 0), authkey=b'test', **kwargs)
+    server.start()
+    return server, backends
+
+
+def test_batching_worker():
+    """Test that concurrent requests share batches and get their own results"""
+    print("\n=== Testing Batching Worker ===")
+
+    backend = FakeBackend(delay=0.05)
+    worker = BatchingWorker(backend, max_batch=4, batch_window=0.01)
+    results = {}
+
+    def submit(i):
+        results[i] = worker.submit({'prompt': f'p{i}', 'temperature': 0.5, 'num_return_sequences': 1})
+
+    threads = [threading.Thread(target=submit, args=(i,)) for i in range(10)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    worker.stop()
+
+    assert results == {i: [f'p{i}|0.5|0'] for i in range(10)}
+    assert sum(backend.batches) == 10 and max(backend.batches) == 4
+    assert len(backend.batches) < 10
+    print(f"✓ 10 requests in {len(backend.batches)} batches: {backend.batches}")
+
+    failing = BatchingWorker(lambda requests: 1 / 0)
+    try:
+        failing.submit({})
+        return False
+    except ZeroDivisionError:
+        print("✓ Backend errors reach every caller in the batch")
+    finally:
+        failing.stop()
+    return True
+
+
+def test_remote_models_share_server():
+    """Test that several agents' clients are batched by one server"""
+    print("\n=== Testing Shared Inference Server ===")
+
+    server, backends = _start_server(max_batch=8, batch_window=0.02)
+    try:
+        outputs = []
+
+        def agent(i):
+            client = InferenceClient(server.address, authkey=b'test')
+            codegen = RemoteCodegenModel({'max_length': 64, 'temperature': 0.2}, client)
+            outputs.append(codegen.generate_code(f'agent{i}', stop_sequences=['|0.2'])[0])
+            client.close()
+
+        threads = [threading.Thread(target=agent, args=(i,)) for i in range(6)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert sorted(outputs) == [f'agent{i}' for i in range(6)]
+        assert sum(backends['codegen'].batches) == 6 and len(backends['codegen'].batches) < 6
+        print(f"✓ 6 agents served in batches {backends['codegen'].batches}")
+
+        client = InferenceClient(server.address, authkey=b'test')
+        llm = RemoteLLM({'temperature': 0.8}, client)
+        response = llm.chat('hello', system_prompt='be brief')
+        # The fake backend echoes the prompt, which ends with the 'Assistant: ' cue
+        assert response == '|0.8|0'
+        assert len(llm.get_conversation_history()) == 3
+        assert RemoteCodegenModel({}, client).estimate_tokens('a b c') == 3
+        print("✓ Remote LLM keeps history client-side")
+
+        try:
+            client.request('generate', model='vision', params={})
+            return False
+        except RuntimeError as e:
+            assert 'Model not served' in str(e)
+            print("✓ Server errors raised in the client")
+        client.close()
+    finally:
+        server.shutdown()
+    return True
+
+
+def test_loader_uses_configured_server():
+    """Test LocalModelLoader returning remote models when a server is configured"""
+    print("\n=== Testing Loader With Inference Server ===")
+
+    server, backends = _start_server()
+    try:
+        loader = LocalModelLoader()
+        loader.config['inference_server'] = {'address': f'{server.address[0]}:{server.address[1]}'}
+
+        os.environ['AROS_INFERENCE_AUTHKEY'] = 'test'
+        try:
+            codegen = loader.load_model('codegen')
+            llm = loader.load_model('llm')
+        finally:
+            del os.environ['AROS_INFERENCE_AUTHKEY']
+
+        assert isinstance(codegen, RemoteCodegenModel) and isinstance(llm, RemoteLLM)
+        assert codegen.client is llm.client
+        assert 'AI_PHASE: TEST' in codegen.generate_with_breadcrumbs('Init', {'phase': 'TEST'})
+        print("✓ Loader connects to the configured server")
+    finally:
+        server.shutdown()
+
+    loader = LocalModelLoader()
+    loader.config['inference_server'] = {'address': '127.0.0.1:1'}
+    os.environ['AROS_INFERENCE_AUTHKEY'] = 'test'
+    try:
+        loader.load_model('codegen')
+        return False
+    except RuntimeError as e:
+        assert 'inference_server' in str(e)
+        print("✓ Unreachable server gives a helpful error")
+    finally:
+        del os.environ['AROS_INFERENCE_AUTHKEY']
+    return True
+
+
+def test_authkey_required():
+    """Test that neither side falls back to a built-in authkey"""
+    print("\n=== Testing Required Authkey ===")
+
+    os.environ.pop('AROS_INFERENCE_AUTHKEY', None)
+    for connect in (lambda: InferenceServer({'llm': FakeBackend()}, address=('127.0.0.1', 0)),
+                    lambda: InferenceClient(('127.0.0.1', 1))):
+        try:
+            connect()
+            return False
+        except ValueError as e:
+            assert 'AROS_INFERENCE_AUTHKEY' in str(e)
+    print("✓ Server and client refuse to run without AROS_INFERENCE_AUTHKEY")
+
+    loader = LocalModelLoader()
+    loader.config['inference_server'] = {'address': '127.0.0.1:1'}
+    try:
+        loader.load_model('codegen')
+        return False
+    except RuntimeError as e:
+        assert 'AROS_INFERENCE_AUTHKEY' in str(e)
+    print("✓ Loader reports the missing key")
+    return True
+
+
+def run_all_tests():
+    """Run all inference server tests"""
+    print("=" * 60)
+    print("  Inference Server Test Suite")
+    print("=" * 60)
+
+    tests = [
+        test_batching_worker,
+        test_remote_models_share_server,
+        test_loader_uses_configured_server,
+        test_authkey_required,
+    ]
+
+    passed = 0
+    failed = 0
+
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
@@ -4,7 +4,9 @@ Test script to verify mock model fallback functionality
 """
 
 import sys
+import time
 import tempfile
+from datetime import datetime
 from pathlib import Path
 
 # Add project to path
@@ -194,6 +196,108 @@ def test_iteration_with_mocks():
     return True
 
 
+def test_pipelined_iteration_with_mocks():
+    """Test the pipelined loop overlaps generation with compilation"""
+    print("\n=== Testing Pipelined Iteration Loop with Mock Models ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        aros_path = Path(temp_dir) / 'aros-src'
+        (aros_path / 'test').mkdir(parents=True)
+        (aros_path / 'test' / 'gpu.c').write_text(
+            ''.join(f'// AI_PHASE: PHASE_{i}\n// AI_STATUS: NOT_STARTED\n// AI_PRIORITY: {9 - i}\n'
+                    f'// AI_STRATEGY: Implement part {i}\nvoid part{i}(void);\n' for i in range(3))
+        )
+        
+        iteration = CopilotStyleIteration(
+            aros_path=str(aros_path),
+            project_name='test',
+            log_path=str(Path(temp_dir) / 'logs'),
+            max_iterations=3,
+            pipeline_depth=1
+        )
+        iteration.model_loader.load_model('llm', use_mock=True)
+        iteration.model_loader.load_model('codegen', use_mock=True)
+        
+        # Slow, deterministic compiler: the first attempt of iteration 1 fails
+        compiles, generations = [], []
+        
+        def compile_generated(generation_result, number):
+            start = time.monotonic()
+            time.sleep(0.2)
+            first = not any(n == number for n, _, _ in compiles)
+            compiles.append((number, start, time.monotonic()))
+            errors = ['error: undefined reference to foo'] if number == 1 and first else []
+            return {'success': not errors, 'errors': errors, 'warnings': [],
+                    'timestamp': datetime.now().isoformat()}
+        
+        generation_phase = iteration._generation_phase
+        
+        def timed_generation():
+            generations.append((iteration.current_iteration, time.monotonic()))
+            return generation_phase()
+        
+        iteration._compile_generated = compile_generated
+        iteration._generation_phase = timed_generation
+        iteration._review_phase = lambda generation: {'review': 'ok', 'has_errors': False}
+        
+        summary = iteration.run()
+        
+        assert summary['tasks_processed'] == 3, summary
+        assert summary['successful'] == 3, summary
+        assert iteration.task_scheduler.remaining() == 0
+        print("✓ All tasks completed through the scheduler, with one retry")
+        
+        overlapped = [g for g_iter, g in generations for c_iter, start, end in compiles
+                      if g_iter != c_iter and start < g < end]
+        assert overlapped, (generations, compiles)
+        print(f"✓ {len(overlapped)} generation(s) ran while another task compiled")
+        
+        history = iteration.iteration_history
+        assert sorted(h['retry_count'] for h in history) == [0, 0, 1]
+        assert sorted(h['iteration'] for h in history) == [1, 2, 3]
+        print("✓ Retry state stayed with its own task")
+        
+    return True
+
+
+def test_pipelined_fold_error_settles_lease():
+    """Test a task whose compile result fails to fold does not stay claimed"""
+    print("\n=== Testing Pipelined Fold Error ===")
+    
+    with tempfile.TemporaryDirectory() as temp_dir:
+        aros_path = Path(temp_dir) / 'aros-src'
+        (aros_path / 'test').mkdir(parents=True)
+        (aros_path / 'test' / 'gpu.c').write_text(
+            '// AI_PHASE: PHASE_0\n// AI_STATUS: NOT_STARTED\n// AI_STRATEGY: Part 0\nvoid part0(void);\n'
+        )
+        
+        iteration = CopilotStyleIteration(
+            aros_path=str(aros_path),
+            project_name='test',
+            log_path=str(Path(temp_dir) / 'logs'),
+            max_iterations=1,
+            pipeline_depth=1
+        )
+        iteration.model_loader.load_model('llm', use_mock=True)
+        iteration.model_loader.load_model('codegen', use_mock=True)
+        
+        def finish_attempt(*args, **kwargs):
+            raise RuntimeError('report failed')
+        
+        iteration._compile_generated = lambda generation, number: {
+            'success': True, 'errors': [], 'warnings': [], 'timestamp': datetime.now().isoformat()
+        }
+        iteration._review_phase = lambda generation: {'review': 'ok', 'has_errors': False}
+        iteration._finish_attempt = finish_attempt
+        
+        iteration.run()
+        states = iteration.task_scheduler.get_statistics()['states']
+        assert states['CLAIMED'] == 0, states
+        print(f"✓ No task left claimed after the fold raised ({states})")
+        
+    return True
+
+
 def main():
     """Run all mock model tests"""
     print("\n" + "="*60)
@@ -205,6 +309,8 @@ def main():
         ("Error Messages", test_error_messages),
         ("Session with Mocks (Explicit)", test_session_with_mocks),
         ("Iteration with Mocks (Explicit)", test_iteration_with_mocks),
+        ("Pipelined Iteration with Mocks", test_pipelined_iteration_with_mocks),
+        ("Pipelined Fold Error", test_pipelined_fold_error_settles_lease),
     ]
     
     passed = 0
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Test script for the native breadcrumb scanner
+Checks that the C scanner produces exactly the same Breadcrumb records as the
+regex loop in BreadcrumbParser. Skipped when the extension is not built
+(python3 setup.py build_ext --inplace).
+"""
+
+import sys
+import random
+import tempfile
+from dataclasses import asdict
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.breadcrumb_parser import parser as parser_module
+from src.breadcrumb_parser.parser import BreadcrumbParser
+
+
+# Lines chosen to hit every branch of BreadcrumbParser._parse_line
+CORPUS_LINES = [
+    '// AI_PHASE: GRAPHICS', '//AI_STATUS:PARTIAL', '// ai_note: lower case tag',
+    '/*', '*/', ' * AI_STRATEGY: block strategy', 'AI_NOTE: bare in block',
+    '// AI_CONTEXT: {', '//   "gpu": "GCN",', '//   "level": 3', '// }',
+    '// AI_CONTEXT: {"inline": [1, 2]}', '// AI_CONTEXT: {"broken": }',
+    ' *   "key": "value"', ' * }', '', '    ', 'int x = a / b;', '/* inline */',
+    '// plain comment', '// TODO: not a tag', '/// AI_PHASE: triple slash',
+    '\t/*\t', ' */ ', '// AI_PHASE:', '\u00a0// AI_PHASE: nbsp indent',
+    '// AI_DETAILS: café', '** AI_PHASE: double star', '\ufeff// bom',
+]
+LINE_ENDINGS = [b'\n', b'\n', b'\n', b'\r\n', b'\r']
+NOISE = [b'\xff', b'\xc3', b'\xe2\x82']
+
+
+def _records(use_native: bool, path: str):
+    return [asdict(bc) for bc in BreadcrumbParser(use_native=use_native).parse_file(path)]
+
+
+def _write(data: bytes) -> str:
+    with tempfile.NamedTemporaryFile(mode='wb', suffix='.c', delete=False) as f:
+        f.write(data)
+        return f.name
+
+
+def _native_available() -> bool:
+    if parser_module._scanner is None:
+        print("⚠ Native scanner not built, skipping")
+        return False
+    return True
+
+
+def test_native_matches_python_on_samples():
+    """Test the native scanner on hand-written breadcrumb files"""
+    print("\n=== Testing Native Scanner on Samples ===")
+
+    if not _native_available():
+        return True
+
+    samples = [
+        # Line comments with multi-line JSON context, flushed by code
+        "// AI_PHASE: MEMORY\n// AI_CONTEXT: {\n//   \"a\": 1\n// }\nint f(void);\n",
+        # Block comment with JSON and a trailing breadcrumb flushed at EOF
+        "/*\n * AI_PHASE: BLOCK\n * AI_CONTEXT: {\n *   \"k\": true\n * }\n */\n// AI_STATUS: PARTIAL",
+        # CRLF endings and an unterminated JSON block
+        "// AI_PHASE: CRLF\r\n// AI_CONTEXT: {\r\nint x;\r\n// AI_NOTE: n\r\n",
+        # Empty file
+        "",
+    ]
+
+    for sample in samples:
+        path = _write(sample.encode('utf-8'))
+        try:
+            assert _records(True, path) == _records(False, path), f"Mismatch for {sample!r}"
+        finally:
+            Path(path).unlink()
+
+    print(f"✓ {len(samples)} sample files parse identically")
+    return True
+
+
+def test_native_matches_python_on_random_corpus():
+    """Test the native scanner against the regex loop on generated files"""
+    print("\n=== Testing Native Scanner on Random Corpus ===")
+
+    if not _native_available():
+        return True
+
+    rng = random.Random(1234)
+    files = 300
+
+    for _ in range(files):
+        data = b''
+        for _ in range(rng.randint(0, 60)):
+            line = rng.choice(CORPUS_LINES).encode('utf-8')
+            if rng.random() < 0.05:
+                # Invalid UTF-8 is dropped by errors='ignore'
+                pos = rng.randint(0, len(line))
+                line = line[:pos] + rng.choice(NOISE) + line[pos:]
+            data += line + rng.choice(LINE_ENDINGS)
+
+        path = _write(data)
+        try:
+            assert _records(True, path) == _records(False, path), f"Mismatch for {data!r}"
+        finally:
+            Path(path).unlink()
+
+    print(f"✓ {files} generated files parse identically")
+    return True
+
+
+def test_native_missing_file():
+    """Test that a missing file is reported, not raised"""
+    print("\n=== Testing Native Scanner Error Handling ===")
+
+    parser = BreadcrumbParser()
+    assert parser.parse_file('/nonexistent/breadcrumbs.c') == []
+    assert parser.breadcrumbs == []
+
+    print("✓ Missing file yields no breadcrumbs")
+    return True
+
+
+def run_all_tests():
+    """Run all native scanner tests"""
+    print("=" * 60)
+    print("  Native Scanner Test Suite")
+    print("=" * 60)
+
+    tests = [
+        test_native_matches_python_on_samples,
+        test_native_matches_python_on_random_corpus,
+        test_native_missing_file,
+    ]
+
+    passed = 0
+    failed = 0
+
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Tests for speculative decoding drafters and draft verification
+(verification is skipped without torch)
+"""
+
+import sys
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.local_models.speculative import NgramDrafter
+
+
+def test_ngram_drafter():
+    """Test n-gram drafts copy the latest continuation of the current suffix"""
+    print("\n=== Testing N-gram Drafter ===")
+    
+    drafter = NgramDrafter(max_ngram=3)
+    # "// AI_PHASE: X\n" style repetition, as token ids
+    tokens = [1, 2, 3, 9, 1, 2, 3, 8, 7, 1, 2]
+    
+    draft, probs = drafter.propose(tokens, 3)
+    assert probs is None
+    assert draft == [3, 8, 7], draft
+    print("✓ Longest match wins, latest occurrence first")
+    
+    tokens += [3, 8]
+    draft, _ = drafter.propose(tokens, 4)
+    assert draft == [7, 1, 2, 3], draft
+    print("✓ Index extended incrementally as tokens are accepted")
+    
+    drafter.reset()
+    assert drafter.propose([5, 6], 4) == ([], None)
+    assert drafter.propose([5, 6, 5], 4) == ([6, 5], None)
+    print("✓ No draft without an earlier match; drafts stop at the end")
+    
+    return True
+
+
+def test_verify_acceptance():
+    """Test the accept, reject/resample and bonus token rules on fixed logits"""
+    print("\n=== Testing Draft Verification ===")
+    
+    try:
+        import torch
+    except ImportError:
+        print("⚠ torch not available, skipping")
+        return True
+    from src.local_models.speculative import SpeculativeDecoder
+    
+    decoder = SpeculativeDecoder(model=None, drafter=NgramDrafter())
+    
+    def one_hot(rows, vocab=6):
+        probs = torch.zeros(len(rows), vocab)
+        for i, token in enumerate(rows):
+            probs[i, token] = 1.0
+        return probs
+    
+    # The model predicts 2, 3, 4 after each draft position, then 5
+    logits = one_hot([2, 3, 4, 5]) * 10
+    assert decoder._verify([2, 3, 4], logits, None, None) == [2, 3, 4, 5]
+    assert decoder._verify([2, 1, 4], logits, None, None) == [2, 3]
+    assert decoder._verify([], logits[:1], None, None) == [2]
+    print("✓ Greedy keeps the agreeing prefix plus the model's token")
+    
+    torch.manual_seed(0)
+    probs = one_hot([2, 3, 4, 5])
+    assert decoder._verify([2, 3, 4], logits, probs, None) == [2, 3, 4, 5]
+    assert decoder._verify([2, 0, 4], logits, probs, None) == [2, 3]
+    print("✓ Deterministic draft rejected where the model gives it no mass, resampled without it")
+    
+    # q puts all mass on token 0, p only half: accepted half the time,
+    # otherwise resampled from max(p - q, 0), so the output still follows p
+    p = torch.tensor([[0.5, 0.5, 0, 0, 0, 0], [0, 0, 0, 0, 0, 1.0]])
+    q = torch.tensor([[1.0, 0, 0, 0]])
+    outcomes = [decoder._verify([0], logits[:2], p, q) for _ in range(2000)]
+    assert all(o in ([0, 5], [1]) for o in outcomes), set(map(tuple, outcomes))
+    accepted = sum(o == [0, 5] for o in outcomes) / len(outcomes)
+    assert 0.45 < accepted < 0.55, accepted
+    print(f"✓ Sampled draft accepted at p/q ({accepted:.2f}), bonus token after acceptance")
+    
+    wide = torch.cat([one_hot([2]), torch.full((1, 2), 0.5)], dim=-1)
+    assert decoder._verify([2], logits[:2], one_hot([3, 4]), wide) == [3]
+    print("✓ Draft distribution over a larger vocabulary is cut to the model's")
+    
+    return True
+
+
+def run_all_tests():
+    """Run all speculative decoding tests"""
+    print("=" * 60)
+    print("  Speculative Decoding Test Suite")
+    print("=" * 60)
+    
+    tests = [
+        test_ngram_drafter,
+        test_verify_acceptance,
+    ]
+    
+    passed = 0
+    failed = 0
+    
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+    
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+    
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+"""
+Tests for the breadcrumb task scheduler
+"""
+
+import sys
+import time
+import random
+import tempfile
+import threading
+import multiprocessing
+from pathlib import Path
+
+# Add project to path
+project_root = Path(__file__).parent.parent
+sys.path.insert(0, str(project_root))
+
+from src.breadcrumb_parser import Breadcrumb
+from src.task_scheduler import TaskScheduler, parse_timestamp, READY, PENDING, CLAIMED, DONE, FAILED
+
+
+def _bc(phase, status='NOT_STARTED', **fields):
+    return Breadcrumb(file_path='test.c', line_number=1, phase=phase, status=status, **fields)
+
+
+def _random_dag(count, seed):
+    rng = random.Random(seed)
+    crumbs = []
+    for i in range(count):
+        deps = rng.sample(range(i), min(i, rng.randint(0, 3)))
+        crumbs.append(_bc(f'T{i}', ai_priority=str(rng.randint(1, 10)),
+                          ai_dependencies=', '.join(f'T{d}' for d in deps) or None))
+    return crumbs
+
+
+def _check_order(crumbs, finished):
+    """Every phase finished exactly once, each after all of its dependencies"""
+    assert sorted(finished) == sorted(bc.phase for bc in crumbs), finished
+    position = {phase: i for i, phase in enumerate(finished)}
+    for bc in crumbs:
+        for dep in (bc.ai_dependencies or '').split(','):
+            if dep.strip():
+                assert position[dep.strip()] < position[bc.phase], (dep, bc.phase)
+
+
+def test_dependency_ordering():
+    """Test the ready queue follows dependencies, priority and critical path"""
+    print("\n=== Testing Dependency Ordering ===")
+    
+    crumbs = [
+        _bc('MEMORY_MANAGER', status='IMPLEMENTED'),
+        _bc('SHADER_COMPILER', ai_priority='8', ai_complexity='HIGH', ai_dependencies='MEMORY_MANAGER, LLVM_INIT',
+            ai_blocks='RENDER_PIPELINE'),
+        _bc('RENDER_PIPELINE', ai_priority='9', ai_estimated_time='3h'),
+        _bc('LOGGING', ai_priority='3', ai_complexity='LOW'),
+        _bc('DOCS', ai_priority='3', ai_complexity='LOW', ai_blocks='EXAMPLES'),
+        _bc('EXAMPLES', ai_priority='1'),
+    ]
+    scheduler = TaskScheduler(crumbs)
+    
+    assert [t.phase for t in scheduler.ready_tasks()] == ['SHADER_COMPILER', 'DOCS', 'LOGGING']
+    assert scheduler.get_task('RENDER_PIPELINE').dependencies == ('SHADER_COMPILER',)
+    assert scheduler.get_task('RENDER_PIPELINE').state == PENDING
+    assert scheduler.critical_path() == ['SHADER_COMPILER', 'RENDER_PIPELINE']
+    assert abs(scheduler.get_task('SHADER_COMPILER').critical_path - 5 * 3600) < 1e-6
+    print("✓ AI_DEPENDENCIES and AI_BLOCKS build one DAG; priority, then critical path")
+    
+    lease = scheduler.claim('agent_a', now=0)
+    assert lease.phase == 'SHADER_COMPILER'
+    assert scheduler.complete(lease) == ['RENDER_PIPELINE']
+    assert scheduler.claim('agent_a', now=0).phase == 'RENDER_PIPELINE'
+    print("✓ Completing a task releases its dependents into the queue")
+    
+    stats = scheduler.get_statistics()
+    assert stats['missing_dependencies'] == {'LLVM_INIT': ['SHADER_COMPILER']}
+    strict = TaskScheduler(crumbs, missing_dependencies_done=False)
+    assert strict.get_task('SHADER_COMPILER').state == PENDING
+    print("✓ Dependencies without breadcrumbs are reported and optionally blocking")
+    
+    cyclic = TaskScheduler([_bc('A', ai_dependencies='B'), _bc('B', ai_dependencies='A'), _bc('C')])
+    assert sorted(cyclic.get_statistics()['cycles']) == ['A', 'B']
+    assert [t.phase for t in cyclic.ready_tasks()] == ['C']
+    print("✓ Cycles are detected and never become ready")
+    
+    return True
+
+
+def test_leases_and_retries():
+    """Test lease expiry, stale leases and retry accounting"""
+    print("\n=== Testing Leases and Retries ===")
+    
+    scheduler = TaskScheduler([
+        _bc('NETWORK_STACK', ai_claimed_at='2025-10-15T15:00:00Z', ai_timeout='2025-10-15T18:30:00Z',
+            ai_retry_count='1', ai_max_retries='3'),
+    ])
+    task = scheduler.get_task('NETWORK_STACK')
+    assert task.lease_seconds == 3.5 * 3600
+    
+    first = scheduler.claim('agent_a', now=1000)
+    assert first.expires_at == 1000 + 3.5 * 3600
+    assert scheduler.claim('agent_b', now=1001) is None
+    print("✓ Lease length comes from AI_TIMEOUT - AI_CLAIMED_AT; no double claims")
+    
+    second = scheduler.claim('agent_b', now=first.expires_at)
+    assert second is not None and second.agent_id == 'agent_b'
+    assert task.retry_count == 2
+    assert not scheduler.complete(first) and task.state == CLAIMED
+    print("✓ Expired lease is reclaimed by another agent; the old lease is rejected")
+    
+    renewed = scheduler.renew(second, now=second.expires_at - 1)
+    assert renewed.expires_at > second.expires_at
+    assert scheduler.expire_leases(now=second.expires_at) == []
+    assert not scheduler.fail(renewed, 'compile error')
+    assert task.state == FAILED and task.last_error == 'compile error'
+    assert scheduler.get_statistics()['failed'] == ['NETWORK_STACK']
+    print("✓ Renewal extends the lease; AI_MAX_RETRIES attempts end in FAILED")
+    
+    assigned = TaskScheduler([
+        _bc('GPU', ai_assigned_to='agent_gpu', ai_timeout='2025-10-15T16:30:00Z'),
+    ])
+    assert assigned.get_task('GPU').state == CLAIMED
+    assert assigned.resume('agent_other', 'GPU') is None
+    lease = assigned.resume('agent_gpu', 'GPU')
+    assert lease.expires_at == parse_timestamp('2025-10-15T16:30:00Z')
+    assert assigned.release(lease) and assigned.get_task('GPU').state == READY
+    assert assigned.get_task('GPU').retry_count == 0
+    print("✓ AI_ASSIGNED_TO tasks start claimed and can be resumed or released")
+    
+    return True
+
+
+def test_concurrent_agents():
+    """Test many threads claiming from one scheduler"""
+    print("\n=== Testing Concurrent Agents ===")
+    
+    crumbs = _random_dag(200, seed=7)
+    scheduler = TaskScheduler(crumbs)
+    finished = []
+    finished_lock = threading.Lock()
+    
+    def agent(name):
+        idle = 0
+        while scheduler.remaining() and idle < 10000:
+            lease = scheduler.claim(name)
+            if lease is None:
+                idle += 1
+                continue
+            with finished_lock:
+                finished.append(lease.phase)
+            scheduler.complete(lease)
+    
+    threads = [threading.Thread(target=agent, args=(f'agent_{i}',)) for i in range(8)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    
+    _check_order(crumbs, finished)
+    assert scheduler.get_statistics()['states'][DONE] == 200
+    print("✓ 8 agents finished 200 tasks, each once and after its dependencies")
+    
+    return True
+
+
+def _process_agent(name, state_path, seed, results):
+    scheduler = TaskScheduler(_random_dag(60, seed), state_path=state_path)
+    idle = 0
+    while scheduler.remaining() and idle < 20000:
+        lease = scheduler.claim(name)
+        if lease is None:
+            idle += 1
+            continue
+        # Queue feeder threads may reorder puts; the monotonic clock is system-wide
+        results.put((time.monotonic(), lease.phase))
+        scheduler.complete(lease)
+
+
+def test_shared_state_across_processes():
+    """Test schedulers in separate processes sharing a claim file"""
+    print("\n=== Testing Shared Claim State ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        state_path = str(Path(tmp) / 'task_claims.json')
+        
+        node_a = TaskScheduler(_random_dag(10, 3), state_path=state_path)
+        node_b = TaskScheduler(_random_dag(10, 3), state_path=state_path)
+        lease = node_a.claim('agent_a')
+        assert node_b.get_task(lease.phase).state == CLAIMED
+        assert node_b.claim('agent_b').phase != lease.phase
+        node_a.complete(lease)
+        assert node_b.get_task(lease.phase).state == DONE
+        print("✓ Claims and completions made by one scheduler are seen by the other")
+        
+        state_path = str(Path(tmp) / 'procs.json')
+        context = multiprocessing.get_context('fork')
+        results = context.Queue()
+        workers = [context.Process(target=_process_agent, args=(f'node_{i}', state_path, 11, results))
+                   for i in range(4)]
+        for worker in workers:
+            worker.start()
+        finished = [phase for _, phase in sorted(results.get(timeout=60) for _ in range(60))]
+        for worker in workers:
+            worker.join(timeout=60)
+        assert results.empty()
+        _check_order(_random_dag(60, 11), finished)
+        print("✓ 4 processes finished 60 tasks without double claims")
+    
+    return True
+
+
+def test_edited_breadcrumb_resets_retries():
+    """Test shared retry counts start over when a breadcrumb changes"""
+    print("\n=== Testing Retry Reset On Breadcrumb Edit ===")
+    
+    with tempfile.TemporaryDirectory() as tmp:
+        state_path = str(Path(tmp) / 'task_claims.json')
+        crumbs = [_bc('A', ai_max_retries='2'), _bc('B', ai_max_retries='2')]
+        
+        scheduler = TaskScheduler(crumbs, state_path=state_path)
+        for _ in range(2):
+            lease = scheduler.claim('agent')
+            scheduler.fail(lease, 'broken')
+        held = scheduler.claim('agent')
+        assert scheduler.get_task('A').state == FAILED and held.phase == 'B'
+        
+        again = TaskScheduler(crumbs, state_path=state_path)
+        assert again.get_task('A').state == FAILED and again.get_task('A').retry_count == 2
+        print("✓ Unchanged breadcrumbs keep their recorded failures")
+        
+        edited = [_bc('A', ai_max_retries='2', strategy='Try another approach'),
+                  _bc('B', ai_max_retries='2', status='PARTIAL')]
+        reworked = TaskScheduler(edited, state_path=state_path)
+        task = reworked.get_task('A')
+        assert task.state == READY and task.retry_count == 0 and task.last_error is None
+        assert reworked.get_task('B').state == CLAIMED
+        assert reworked.claim('other').phase == 'A'
+        print("✓ Edited breadcrumb starts over; the live claim on another is kept")
+        
+        assert scheduler.complete(held) == [] and scheduler.get_task('B').state == DONE
+        later = TaskScheduler(edited, state_path=state_path)
+        assert later.get_task('A').state == CLAIMED and later.get_task('B').state == DONE
+        print("✓ The reset is shared; a completion from the older scheduler still counts")
+        
+        state_path = str(Path(tmp) / 'synced.json')
+        upstream = TaskScheduler([_bc('NET', 'PARTIAL'), _bc('GFX', 'PARTIAL')], state_path=state_path)
+        assert upstream.claim('agent').phase == 'NET'
+        synced = TaskScheduler([_bc('NET', 'IMPLEMENTED'), _bc('GFX', 'FIXED')], state_path=state_path)
+        for phase in ('NET', 'GFX'):
+            task = synced.get_task(phase)
+            assert task.state == DONE and task.agent_id is None and task.token is None, task
+        assert synced.claim('other') is None
+        assert upstream.get_task('GFX').state == DONE
+        print("✓ Breadcrumbs finished upstream stay DONE over claimed and ready records")
+    
+    return True
+
+
+def run_all_tests():
+    """Run all task scheduler tests"""
+    print("=" * 60)
+    print("  Task Scheduler Test Suite")
+    print("=" * 60)
+    
+    tests = [
+        test_dependency_ordering,
+        test_leases_and_retries,
+        test_concurrent_agents,
+        test_shared_state_across_processes,
+        test_edited_breadcrumb_resets_retries,
+    ]
+    
+    passed = 0
+    failed = 0
+    
+    for test in tests:
+        try:
+            if test():
+                passed += 1
+            else:
+                failed += 1
+                print(f"✗ {test.__name__} failed")
+        except Exception as e:
+            failed += 1
+            print(f"✗ {test.__name__} raised exception: {e}")
+            import traceback
+            traceback.print_exc()
+    
+    print("\n" + "=" * 60)
+    print(f"  Results: {passed} passed, {failed} failed")
+    print("=" * 60)
+    
+    return failed == 0
+
+
+if __name__ == '__main__':
+    success = run_all_tests()
+    sys.exit(0 if success else 1)
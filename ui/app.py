@@ -16,7 +16,7 @@ import threading
 sys.path.insert(0, str(Path(__file__).parent.parent))
 
 from src.breadcrumb_parser import BreadcrumbParser, BreadcrumbValidator
-from src.compiler_loop import CompilerLoop, ErrorTracker, ReasoningTracker
+from src.compiler_loop import CompilerLoop, CompileLog, ErrorTracker, ReasoningTracker
 
 app = Flask(__name__)
 
@@ -451,6 +451,12 @@ def api_compilation():
     """Get compilation statistics"""
     if compiler_loop:
         return jsonify(compiler_loop.get_error_summary())
+    
+    compile_log_dir = logs_path / 'compile'
+    if compile_log_dir.exists():
+        summary = CompileLog(str(compile_log_dir)).get_summary()
+        if summary['total_iterations']:
+            return jsonify(summary)
     return jsonify({'message': 'No compilation runs yet'})
 
 
@@ -501,6 +507,10 @@ def api_logs(log_type):
     if not log_dir.exists():
         return jsonify({'logs': []})
     
+    if log_type == 'compile':
+        # Compile results live in the segmented binary log
+        return jsonify({'logs': CompileLog(str(log_dir)).tail(5)})
+    
     # Get most recent log files
     log_files = sorted(log_dir.glob('*.json'), key=lambda x: x.stat().st_mtime, reverse=True)[:5]
     